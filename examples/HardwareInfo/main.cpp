@@ -44,6 +44,8 @@ int main()
 		oss << "Report des capacites: " << std::endl;
 		printCap(oss, "-64bits", NzHardwareInfo::HasCapability(nzProcessorCap_x64));
 		printCap(oss, "-AVX", NzHardwareInfo::HasCapability(nzProcessorCap_AVX));
+		printCap(oss, "-AVX2", NzHardwareInfo::HasCapability(nzProcessorCap_AVX2));
+		printCap(oss, "-AVX-512F", NzHardwareInfo::HasCapability(nzProcessorCap_AVX512F));
 		printCap(oss, "-FMA3", NzHardwareInfo::HasCapability(nzProcessorCap_FMA3));
 		printCap(oss, "-FMA4", NzHardwareInfo::HasCapability(nzProcessorCap_FMA4));
 		printCap(oss, "-MMX", NzHardwareInfo::HasCapability(nzProcessorCap_MMX));
@@ -30,10 +30,12 @@
 #define NAZARA_GLOBAL_AUDIO_HPP
 
 #include <Nazara/Audio/Audio.hpp>
+#include <Nazara/Audio/AudioDevice.hpp>
 #include <Nazara/Audio/Config.hpp>
 #include <Nazara/Audio/Enums.hpp>
 #include <Nazara/Audio/Sound.hpp>
 #include <Nazara/Audio/SoundBuffer.hpp>
 #include <Nazara/Audio/SoundEmitter.hpp>
+#include <Nazara/Audio/VoiceManager.hpp>
 
 #endif // NAZARA_GLOBAL_AUDIO_HPP
@@ -16,7 +16,7 @@
 class NAZARA_API NzAudio
 {
 	friend class NzMusic;
-	friend class NzSoundBuffer;
+	friend class NzOpenALDevice;
 
 	public:
 		NzAudio() = delete;
@@ -49,6 +49,8 @@ class NAZARA_API NzAudio
 
 		static void Uninitialize();
 
+		static void Update();
+
 	private:
 		static unsigned int GetOpenALFormat(nzAudioFormat format);
 
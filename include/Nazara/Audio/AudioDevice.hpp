@@ -0,0 +1,53 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Audio module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_AUDIODEVICE_HPP
+#define NAZARA_AUDIODEVICE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Audio/Enums.hpp>
+#include <Nazara/Math/Vector3.hpp>
+
+struct NzAudioSourceParameters
+{
+	NzVector3f position = NzVector3f::Zero();
+	NzVector3f velocity = NzVector3f::Zero();
+	float attenuation = 1.f;
+	float minDistance = 1.f;
+	float pitch = 1.f;
+	float volume = 100.f;
+	bool looping = false;
+	bool spatialized = false;
+};
+
+// Interface entre le gestionnaire de voix et le matériel (OpenAL en temps normal)
+// Une implémentation factice permet de tester l'ordonnancement des voix sans périphérique audio
+class NAZARA_API NzAudioDevice
+{
+	public:
+		NzAudioDevice() = default;
+		virtual ~NzAudioDevice();
+
+		virtual unsigned int CreateBuffer(nzAudioFormat format, const nzInt16* samples, unsigned int sampleCount, unsigned int sampleRate) = 0; // Zéro en cas d'échec
+		virtual unsigned int CreateSource() = 0; // Zéro en cas d'échec
+		virtual void DestroyBuffer(unsigned int buffer) = 0;
+		virtual void DestroySource(unsigned int source) = 0;
+
+		virtual NzVector3f GetListenerPosition() const = 0;
+		virtual nzUInt32 GetSourceOffset(unsigned int source) const = 0;
+		virtual nzSoundStatus GetSourceStatus(unsigned int source) const = 0;
+
+		virtual void PauseSource(unsigned int source) = 0;
+		virtual void PlaySource(unsigned int source) = 0;
+
+		virtual void SetSourceBuffer(unsigned int source, unsigned int buffer) = 0;
+		virtual void SetSourceOffset(unsigned int source, nzUInt32 offset) = 0;
+		virtual void SetSourceParameters(unsigned int source, const NzAudioSourceParameters& parameters) = 0;
+
+		virtual void StopSource(unsigned int source) = 0;
+};
+
+#endif // NAZARA_AUDIODEVICE_HPP
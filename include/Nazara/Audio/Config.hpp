@@ -29,6 +29,15 @@
 
 /// Chaque modification d'un paramètre du module nécessite une recompilation de celui-ci
 
+// Nombre maximal de sources réelles (voix matérielles) réparties entre les émetteurs par le gestionnaire de voix
+#define NAZARA_AUDIO_MAX_SOURCES 32
+
+// Intervalle minimal (en millisecondes) entre deux mises à jour automatiques du gestionnaire de voix, déclenchées par la lecture d'un son
+#define NAZARA_AUDIO_VOICE_UPDATE_INTERVAL 100
+
+// Budget mémoire (en octets) du cache des échantillons décodés des buffers compressés (Modifiable à l'exécution)
+#define NAZARA_AUDIO_PCMCACHE_BUDGET 8*1024*1024
+
 // Utilise un tracker pour repérer les éventuels leaks (Ralentit l'exécution)
 #define NAZARA_AUDIO_MEMORYLEAKTRACKER 0
 
@@ -22,6 +22,15 @@ enum nzAudioFormat
 	nzAudioFormat_Max = nzAudioFormat_7_1
 };
 
+enum nzSoundBufferStorage
+{
+	nzSoundBufferStorage_ADPCM,   // Échantillons compressés en IMA ADPCM (4:1), décodés à la première lecture
+	nzSoundBufferStorage_Encoded, // Fichier d'origine conservé tel quel, décodé par les loaders à la première lecture
+	nzSoundBufferStorage_PCM,     // Échantillons décodés au chargement et conservés (comportement par défaut)
+
+	nzSoundBufferStorage_Max = nzSoundBufferStorage_PCM
+};
+
 enum nzSoundStatus
 {
 	nzSoundStatus_Playing,
@@ -14,6 +14,8 @@
 
 class NAZARA_API NzSound : public NzSoundEmitter
 {
+	friend NzSoundBuffer;
+
 	public:
 		NzSound() = default;
 		NzSound(const NzSoundBuffer* soundBuffer);
@@ -14,12 +14,29 @@
 #include <Nazara/Core/Resource.hpp>
 #include <Nazara/Core/ResourceLoader.hpp>
 #include <Nazara/Core/ResourceRef.hpp>
+#include <vector>
 
 struct NzSoundBufferParams
 {
+	// Mode de conservation des échantillons, les modes compressés sont décodés à la première lecture dans un cache
+	// partagé dont la taille est bornée (voir NzSoundBuffer::SetCacheBudget)
+	///DOC: Ce décodage est synchrone : la lecture qui le déclenche (premier Play, ou après éviction du cache) le paye
+	///     sur le thread appelant, en temps proportionnel à la durée du son (voir NzSoundCacheStats::decodeTime).
+	///     Les sons devant démarrer sans latence sont donc à conserver en PCM.
+	nzSoundBufferStorage storage = nzSoundBufferStorage_PCM;
+
 	bool IsValid() const;
 };
 
+struct NzSoundCacheStats
+{
+	nzUInt64 decodedBytes = 0;
+	nzUInt64 decodeTime = 0; // En microsecondes
+	unsigned int evictionCount = 0;
+	unsigned int hitCount = 0;
+	unsigned int missCount = 0;
+};
+
 class NzSound;
 class NzSoundBuffer;
 
@@ -39,25 +56,41 @@ class NAZARA_API NzSoundBuffer : public NzResource, public NzNonCopyable
 		NzSoundBuffer(nzAudioFormat format, unsigned int sampleCount, unsigned int sampleRate, const nzInt16* samples);
 		~NzSoundBuffer();
 
-		bool Create(nzAudioFormat format, unsigned int sampleCount, unsigned int sampleRate, const nzInt16* samples);
+		bool Create(nzAudioFormat format, unsigned int sampleCount, unsigned int sampleRate, const nzInt16* samples, nzSoundBufferStorage storage = nzSoundBufferStorage_PCM);
 		void Destroy();
 
 		nzUInt32 GetDuration() const;
 		nzAudioFormat GetFormat() const;
+		unsigned int GetMemoryUsage() const;
 		const nzInt16* GetSamples() const;
 		unsigned int GetSampleCount() const;
 		unsigned int GetSampleRate() const;
+		nzSoundBufferStorage GetStorage() const;
 
+		bool IsResident() const;
 		bool IsValid() const;
 
 		bool LoadFromFile(const NzString& filePath, const NzSoundBufferParams& params = NzSoundBufferParams());
 		bool LoadFromMemory(const void* data, std::size_t size, const NzSoundBufferParams& params = NzSoundBufferParams());
 		bool LoadFromStream(NzInputStream& stream, const NzSoundBufferParams& params = NzSoundBufferParams());
 
+		static void ClearCache();
+		static nzUInt64 GetCacheBudget();
+		static NzSoundCacheStats GetCacheStats();
+		static nzUInt64 GetCacheUsage();
 		static bool IsFormatSupported(nzAudioFormat format);
+		static void ResetCacheStats();
+		static void SetCacheBudget(nzUInt64 budget);
 
 	private:
-		unsigned int GetOpenALBuffer() const;
+		unsigned int AcquireBuffer(NzSound* user) const;
+		bool CreateEncoded(std::vector<nzUInt8>&& data);
+		bool Decode() const;
+		bool EnsureMetadata() const;
+		void ReleaseBuffer(NzSound* user) const;
+
+		static void Evict(NzSoundBufferImpl* impl);
+		static void TrimCache(const NzSoundBufferImpl* keep);
 
 		NzSoundBufferImpl* m_impl = nullptr;
 
@@ -8,6 +8,7 @@
 #define NAZARA_SOUNDEMITTER_HPP
 
 #include <Nazara/Prerequesites.hpp>
+#include <Nazara/Audio/AudioDevice.hpp>
 #include <Nazara/Audio/Enums.hpp>
 #include <Nazara/Core/InputStream.hpp>
 #include <Nazara/Core/NonCopyable.hpp>
@@ -15,8 +16,12 @@
 
 ///TODO: Faire hériter SoundEmitter de Node
 
+// Un émetteur est une voix virtuelle, il ne possède une source réelle que lorsque le gestionnaire de voix
+// le juge suffisamment audible, sa lecture progressant virtuellement le reste du temps
 class NAZARA_API NzSoundEmitter
 {
+	friend class NzVoiceManager;
+
 	public:
 		virtual ~NzSoundEmitter();
 
@@ -24,17 +29,20 @@ class NAZARA_API NzSoundEmitter
 		void EnableSpatialization(bool spatialization);
 
 		float GetAttenuation() const;
+		float GetAudibility() const;
 		virtual nzUInt32 GetDuration() const = 0;
 		float GetMinDistance() const;
 		float GetPitch() const;
 		virtual nzUInt32 GetPlayingOffset() const = 0;
 		NzVector3f GetPosition() const;
+		int GetPriority() const;
 		NzVector3f GetVelocity() const;
 		virtual nzSoundStatus GetStatus() const = 0;
 		float GetVolume() const;
 
 		virtual bool IsLooping() const = 0;
 		bool IsSpatialized() const;
+		bool IsVirtual() const;
 
 		virtual void Pause() = 0;
 		virtual bool Play() = 0;
@@ -44,6 +52,7 @@ class NAZARA_API NzSoundEmitter
 		void SetPitch(float pitch);
 		void SetPosition(const NzVector3f& position);
 		void SetPosition(float x, float y, float z);
+		void SetPriority(int priority);
 		void SetVelocity(const NzVector3f& velocity);
 		void SetVelocity(float velX, float velY, float velZ);
 		void SetVolume(float volume);
@@ -54,9 +63,34 @@ class NAZARA_API NzSoundEmitter
 		NzSoundEmitter();
 		NzSoundEmitter(const NzSoundEmitter& emitter);
 
+		unsigned int GetInternalBuffer() const;
 		nzSoundStatus GetInternalStatus() const;
+		nzUInt32 GetInternalOffset() const;
+
+		void InternalPause();
+		void InternalPlay();
+		void InternalStop();
+
+		void SetInternalBuffer(unsigned int buffer);
+		void SetInternalLooping(bool loop);
+		void SetInternalOffset(nzUInt32 offset);
 
+		NzAudioSourceParameters m_parameters;
 		unsigned int m_source;
+
+	private:
+		void AcquireSource(unsigned int source);
+		float GetAudibility(const NzVector3f& listenerPosition) const;
+		nzUInt32 GetVirtualOffset(nzUInt64 now) const;
+		void RebaseVirtualOffset();
+		void ReleaseSource();
+		void UpdateParameters();
+
+		nzSoundStatus m_status;
+		nzUInt64 m_playStart; // Instant (ms) de la dernière reprise de lecture
+		nzUInt32 m_playOffset; // Position de lecture (ms) à cet instant
+		unsigned int m_buffer;
+		int m_priority;
 };
 
 #endif // NAZARA_SOUNDEMITTER_HPP
@@ -0,0 +1,51 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Audio module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_VOICEMANAGER_HPP
+#define NAZARA_VOICEMANAGER_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Audio/Config.hpp>
+#include <Nazara/Core/Clock.hpp>
+
+class NzAudioDevice;
+class NzSoundEmitter;
+
+class NAZARA_API NzVoiceManager
+{
+	friend NzSoundEmitter;
+
+	public:
+		NzVoiceManager() = delete;
+		~NzVoiceManager() = delete;
+
+		static NzAudioDevice* GetDevice();
+		static unsigned int GetFreeSourceCount();
+		static unsigned int GetSourceCount();
+		static nzUInt64 GetTime();
+		static unsigned int GetVirtualVoiceCount();
+		static unsigned int GetVoiceCount();
+
+		static bool Initialize(NzAudioDevice* device, unsigned int maxSourceCount = NAZARA_AUDIO_MAX_SOURCES);
+
+		static bool IsInitialized();
+
+		static void SetClockFunction(NzClockFunction clockFunction);
+
+		static void Uninitialize();
+
+		static void Update();
+
+	private:
+		static void ReclaimSources();
+		static void RegisterEmitter(NzSoundEmitter* emitter);
+		static void ReleaseSource(NzSoundEmitter* emitter);
+		static bool RequestSource(NzSoundEmitter* emitter);
+		static void UnregisterEmitter(NzSoundEmitter* emitter);
+		static void UpdateIfNeeded();
+};
+
+#endif // NAZARA_VOICEMANAGER_HPP
@@ -31,6 +31,7 @@
 
 #include <Nazara/Core/AbstractHash.hpp>
 #include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/Callable.hpp>
 #include <Nazara/Core/Clock.hpp>
 #include <Nazara/Core/Color.hpp>
 #include <Nazara/Core/ConditionVariable.hpp>
@@ -41,8 +42,10 @@
 #include <Nazara/Core/Endianness.hpp>
 #include <Nazara/Core/Enums.hpp>
 #include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/Event.hpp>
 #include <Nazara/Core/File.hpp>
 #include <Nazara/Core/Format.hpp>
+#include <Nazara/Core/FunctionRef.hpp>
 #include <Nazara/Core/Functor.hpp>
 #include <Nazara/Core/HardwareInfo.hpp>
 #include <Nazara/Core/Hash.hpp>
@@ -52,7 +55,9 @@
 #include <Nazara/Core/InputStream.hpp>
 #include <Nazara/Core/LockGuard.hpp>
 #include <Nazara/Core/Log.hpp>
+#include <Nazara/Core/MemoryHelper.hpp>
 #include <Nazara/Core/MemoryStream.hpp>
+#include <Nazara/Core/MPMCQueue.hpp>
 #include <Nazara/Core/Mutex.hpp>
 #include <Nazara/Core/NonCopyable.hpp>
 #include <Nazara/Core/PluginManager.hpp>
@@ -62,7 +67,11 @@
 #include <Nazara/Core/ResourceListener.hpp>
 #include <Nazara/Core/ResourceLoader.hpp>
 #include <Nazara/Core/ResourceRef.hpp>
+#include <Nazara/Core/RWLock.hpp>
 #include <Nazara/Core/Semaphore.hpp>
+#include <Nazara/Core/SimdDispatch.hpp>
+#include <Nazara/Core/SpinMutex.hpp>
+#include <Nazara/Core/SPSCQueue.hpp>
 #include <Nazara/Core/Stream.hpp>
 #include <Nazara/Core/String.hpp>
 #include <Nazara/Core/StringStream.hpp>
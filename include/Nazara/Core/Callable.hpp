@@ -0,0 +1,74 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_CALLABLE_HPP
+#define NAZARA_CALLABLE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Config.hpp>
+#include <cstddef>
+#include <type_traits>
+
+// Équivalent de std::function, déplaçable uniquement, sans allocation pour les pointeurs de fonction
+// et les foncteurs (lambdas) tenant dans NAZARA_CORE_CALLABLE_BUFFERSIZE octets
+template<typename Signature> class NzCallable;
+
+template<typename R, typename... Args>
+class NzCallable<R(Args...)>
+{
+	public:
+		NzCallable();
+		NzCallable(std::nullptr_t);
+		NzCallable(R (*function)(Args...));
+		template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, NzCallable>::value>::type> NzCallable(F&& functor);
+		template<typename C> NzCallable(R (C::*method)(Args...), C* object);
+		NzCallable(const NzCallable&) = delete;
+		NzCallable(NzCallable&& callable) noexcept;
+		~NzCallable();
+
+		bool IsHeapAllocated() const;
+		bool IsValid() const;
+
+		void Reset();
+
+		explicit operator bool() const;
+		R operator()(Args... args) const;
+
+		NzCallable& operator=(std::nullptr_t);
+		NzCallable& operator=(const NzCallable&) = delete;
+		NzCallable& operator=(NzCallable&& callable) noexcept;
+
+	private:
+		enum Operation
+		{
+			Operation_Destroy,
+			Operation_Move
+		};
+
+		typedef typename std::aligned_storage<NAZARA_CORE_CALLABLE_BUFFERSIZE>::type Storage;
+		typedef R (*Invoker)(void* storage, Args&&... args);
+		typedef void (*Manager)(Operation operation, void* storage, void* source);
+
+		template<typename F> struct IsInlinable;
+
+		template<typename F> void Construct(F&& functor, std::true_type inlinable);
+		template<typename F> void Construct(F&& functor, std::false_type inlinable);
+
+		static R InvokeFunction(void* storage, Args&&... args);
+		template<typename F> static R InvokeHeap(void* storage, Args&&... args);
+		template<typename F> static R InvokeInline(void* storage, Args&&... args);
+		template<typename F> static void ManageHeap(Operation operation, void* storage, void* source);
+		template<typename F> static void ManageInline(Operation operation, void* storage, void* source);
+
+		mutable Storage m_storage;
+		Invoker m_invoker;
+		Manager m_manager; // Nul si le contenu peut être déplacé par simple copie mémoire (pointeur de fonction)
+		bool m_heapAllocated;
+};
+
+#include <Nazara/Core/Callable.inl>
+
+#endif // NAZARA_CALLABLE_HPP
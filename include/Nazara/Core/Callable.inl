@@ -0,0 +1,249 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/MemoryHelper.hpp>
+#include <cstring>
+#include <utility>
+#include <Nazara/Core/Debug.hpp>
+
+template<typename R, typename... Args>
+template<typename F>
+struct NzCallable<R(Args...)>::IsInlinable : std::integral_constant<bool, sizeof(F) <= sizeof(Storage) &&
+                                                                          std::alignment_of<Storage>::value % std::alignment_of<F>::value == 0 &&
+                                                                          std::is_nothrow_move_constructible<F>::value>
+{
+};
+
+template<typename R, typename... Args>
+NzCallable<R(Args...)>::NzCallable() :
+m_invoker(nullptr),
+m_manager(nullptr),
+m_heapAllocated(false)
+{
+}
+
+template<typename R, typename... Args>
+NzCallable<R(Args...)>::NzCallable(std::nullptr_t) :
+NzCallable()
+{
+}
+
+template<typename R, typename... Args>
+NzCallable<R(Args...)>::NzCallable(R (*function)(Args...)) :
+m_manager(nullptr),
+m_heapAllocated(false)
+{
+	// Chemin rapide: le pointeur est stocké tel quel, le déplacement se résume à une copie mémoire
+	typedef R (*FunctionPtr)(Args...);
+	NzPlacementNew<FunctionPtr>(&m_storage, function);
+
+	m_invoker = (function) ? &InvokeFunction : nullptr;
+}
+
+template<typename R, typename... Args>
+template<typename F, typename>
+NzCallable<R(Args...)>::NzCallable(F&& functor)
+{
+	typedef typename std::decay<F>::type Functor;
+
+	Construct(std::forward<F>(functor), IsInlinable<Functor>());
+}
+
+template<typename R, typename... Args>
+template<typename C>
+NzCallable<R(Args...)>::NzCallable(R (C::*method)(Args...), C* object) :
+NzCallable([method, object](Args... args) -> R { return (object->*method)(std::forward<Args>(args)...); })
+{
+}
+
+template<typename R, typename... Args>
+NzCallable<R(Args...)>::NzCallable(NzCallable&& callable) noexcept :
+m_invoker(callable.m_invoker),
+m_manager(callable.m_manager),
+m_heapAllocated(callable.m_heapAllocated)
+{
+	if (m_manager)
+		m_manager(Operation_Move, &m_storage, &callable.m_storage);
+	else
+		std::memcpy(&m_storage, &callable.m_storage, sizeof(Storage));
+
+	callable.m_invoker = nullptr;
+	callable.m_manager = nullptr;
+	callable.m_heapAllocated = false;
+}
+
+template<typename R, typename... Args>
+NzCallable<R(Args...)>::~NzCallable()
+{
+	Reset();
+}
+
+template<typename R, typename... Args>
+bool NzCallable<R(Args...)>::IsHeapAllocated() const
+{
+	return m_heapAllocated;
+}
+
+template<typename R, typename... Args>
+bool NzCallable<R(Args...)>::IsValid() const
+{
+	return m_invoker != nullptr;
+}
+
+template<typename R, typename... Args>
+void NzCallable<R(Args...)>::Reset()
+{
+	if (m_manager)
+	{
+		m_manager(Operation_Destroy, &m_storage, nullptr);
+		m_manager = nullptr;
+	}
+
+	m_invoker = nullptr;
+	m_heapAllocated = false;
+}
+
+template<typename R, typename... Args>
+NzCallable<R(Args...)>::operator bool() const
+{
+	return m_invoker != nullptr;
+}
+
+template<typename R, typename... Args>
+R NzCallable<R(Args...)>::operator()(Args... args) const
+{
+	#if NAZARA_CORE_SAFE
+	if (!m_invoker)
+	{
+		NazaraError("Invalid callable");
+		return R();
+	}
+	#endif
+
+	return m_invoker(&m_storage, std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args>
+NzCallable<R(Args...)>& NzCallable<R(Args...)>::operator=(std::nullptr_t)
+{
+	Reset();
+
+	return *this;
+}
+
+template<typename R, typename... Args>
+NzCallable<R(Args...)>& NzCallable<R(Args...)>::operator=(NzCallable&& callable) noexcept
+{
+	if (this != &callable)
+	{
+		Reset();
+
+		m_invoker = callable.m_invoker;
+		m_manager = callable.m_manager;
+		m_heapAllocated = callable.m_heapAllocated;
+
+		if (m_manager)
+			m_manager(Operation_Move, &m_storage, &callable.m_storage);
+		else
+			std::memcpy(&m_storage, &callable.m_storage, sizeof(Storage));
+
+		callable.m_invoker = nullptr;
+		callable.m_manager = nullptr;
+		callable.m_heapAllocated = false;
+	}
+
+	return *this;
+}
+
+template<typename R, typename... Args>
+template<typename F>
+void NzCallable<R(Args...)>::Construct(F&& functor, std::true_type inlinable)
+{
+	NazaraUnused(inlinable);
+
+	typedef typename std::decay<F>::type Functor;
+
+	NzPlacementNew<Functor>(&m_storage, std::forward<F>(functor));
+
+	m_invoker = &InvokeInline<Functor>;
+	m_manager = &ManageInline<Functor>;
+	m_heapAllocated = false;
+}
+
+template<typename R, typename... Args>
+template<typename F>
+void NzCallable<R(Args...)>::Construct(F&& functor, std::false_type inlinable)
+{
+	NazaraUnused(inlinable);
+
+	typedef typename std::decay<F>::type Functor;
+
+	// Trop gros pour le stockage interne, seul le pointeur y est conservé
+	NzPlacementNew<Functor*>(&m_storage, new Functor(std::forward<F>(functor)));
+
+	m_invoker = &InvokeHeap<Functor>;
+	m_manager = &ManageHeap<Functor>;
+	m_heapAllocated = true;
+}
+
+template<typename R, typename... Args>
+R NzCallable<R(Args...)>::InvokeFunction(void* storage, Args&&... args)
+{
+	typedef R (*FunctionPtr)(Args...);
+
+	return (*static_cast<FunctionPtr*>(storage))(std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args>
+template<typename F>
+R NzCallable<R(Args...)>::InvokeHeap(void* storage, Args&&... args)
+{
+	return (**static_cast<F**>(storage))(std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args>
+template<typename F>
+R NzCallable<R(Args...)>::InvokeInline(void* storage, Args&&... args)
+{
+	return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args>
+template<typename F>
+void NzCallable<R(Args...)>::ManageHeap(Operation operation, void* storage, void* source)
+{
+	switch (operation)
+	{
+		case Operation_Destroy:
+			delete *static_cast<F**>(storage);
+			break;
+
+		case Operation_Move:
+			*static_cast<F**>(storage) = *static_cast<F**>(source);
+			break;
+	}
+}
+
+template<typename R, typename... Args>
+template<typename F>
+void NzCallable<R(Args...)>::ManageInline(Operation operation, void* storage, void* source)
+{
+	switch (operation)
+	{
+		case Operation_Destroy:
+			static_cast<F*>(storage)->~F();
+			break;
+
+		case Operation_Move:
+		{
+			F* functor = static_cast<F*>(source);
+			NzPlacementNew<F>(storage, std::move(*functor));
+			functor->~F();
+			break;
+		}
+	}
+}
+
+#include <Nazara/Core/DebugOff.hpp>
@@ -29,6 +29,12 @@
 
 /// Chaque modification d'un paramètre du module nécessite une recompilation de celui-ci
 
+// Taille d'une ligne de cache, utilisée pour séparer les données manipulées par des threads différents (faux partage)
+#define NAZARA_CORE_CACHE_LINE_SIZE 64
+
+// Taille du stockage interne de NzCallable, les foncteurs plus gros sont alloués dynamiquement
+#define NAZARA_CORE_CALLABLE_BUFFERSIZE 48
+
 // Duplique la sortie du log sur le flux de sortie standard (cout)
 #define NAZARA_CORE_DUPLICATE_LOG_TO_COUT 0
 
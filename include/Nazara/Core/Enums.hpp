@@ -79,6 +79,8 @@ enum nzProcessorCap
 {
 	nzProcessorCap_x64,
 	nzProcessorCap_AVX,
+	nzProcessorCap_AVX2,
+	nzProcessorCap_AVX512F,
 	nzProcessorCap_FMA3,
 	nzProcessorCap_FMA4,
 	nzProcessorCap_MMX,
@@ -114,6 +116,17 @@ enum nzProcessorVendor
 	nzProcessorVendor_Max = nzProcessorVendor_Vortex
 };
 
+enum nzSimdLevel
+{
+	nzSimdLevel_Scalar,
+	nzSimdLevel_SSE2,
+	nzSimdLevel_SSE41,
+	nzSimdLevel_AVX2,   // Implique FMA3
+	nzSimdLevel_AVX512, // AVX-512F
+
+	nzSimdLevel_Max = nzSimdLevel_AVX512
+};
+
 enum nzSphereType
 {
 	nzSphereType_Cubic,
@@ -141,4 +154,15 @@ enum nzTernary
 	nzTernary_Max = nzTernary_Unknown
 };
 
+enum nzThreadPriority
+{
+	nzThreadPriority_Lowest,
+	nzThreadPriority_Low,
+	nzThreadPriority_Normal,
+	nzThreadPriority_High,
+	nzThreadPriority_Highest,
+
+	nzThreadPriority_Max = nzThreadPriority_Highest
+};
+
 #endif // NAZARA_ENUMS_CORE_HPP
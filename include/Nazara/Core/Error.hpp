@@ -9,42 +9,64 @@
 
 #include <Nazara/Prerequesites.hpp>
 #include <Nazara/Core/Config.hpp>
-#include <Nazara/Core/Directory.hpp>
 #include <Nazara/Core/Enums.hpp>
 #include <Nazara/Core/String.hpp>
 
+#include <type_traits>
+
+// Chemin du fichier source relatif au moteur, calculé à la compilation
+#define NazaraSourceFile (&__FILE__[std::integral_constant<unsigned int, NzError::GetSourceFileOffset(__FILE__)>::value])
+
 #if NAZARA_CORE_ENABLE_ASSERTS || defined(NAZARA_DEBUG)
-	#define NazaraAssert(a, err) if (!(a)) NzError::Error(nzErrorType_AssertFailed, err, __LINE__, NzDirectory::GetCurrentFileRelativeToEngine(__FILE__), NAZARA_FUNCTION)
+	#define NazaraAssert(a, err) if (!(a)) NzError::Error(nzErrorType_AssertFailed, err, __LINE__, NazaraSourceFile, NAZARA_FUNCTION)
 #else
 	#define NazaraAssert(a, err)
 #endif
 
-#define NazaraError(err) NzError::Error(nzErrorType_Normal, err, __LINE__, NzDirectory::GetCurrentFileRelativeToEngine(__FILE__), NAZARA_FUNCTION)
-#define NazaraInternalError(err) NzError::Error(nzErrorType_Internal, err, __LINE__, NzDirectory::GetCurrentFileRelativeToEngine(__FILE__), NAZARA_FUNCTION)
-#define NazaraWarning(err) NzError::Error(nzErrorType_Warning, err, __LINE__, NzDirectory::GetCurrentFileRelativeToEngine(__FILE__), NAZARA_FUNCTION)
+// Si les erreurs sont silencieuses, l'erreur est seulement retenue (sans passer par le log ni son formatage)
+#define NazaraReport(type, err) do { if (NzError::IsSilent()) NzError::SetLastError(err, 0, __LINE__, NazaraSourceFile, NAZARA_FUNCTION); else NzError::Error(type, err, __LINE__, NazaraSourceFile, NAZARA_FUNCTION); } while (false)
+
+#define NazaraError(err) NazaraReport(nzErrorType_Normal, err)
+#define NazaraInternalError(err) NazaraReport(nzErrorType_Internal, err)
+#define NazaraWarning(err) NazaraReport(nzErrorType_Warning, err)
 
+// Variante associant un code à l'erreur, consultable via NzError::GetLastErrorCode
+#define NazaraErrorCode(code, err) do { if (NzError::IsSilent()) NzError::SetLastError(err, code, __LINE__, NazaraSourceFile, NAZARA_FUNCTION); else NzError::Error(nzErrorType_Normal, code, err, __LINE__, NazaraSourceFile, NAZARA_FUNCTION); } while (false)
+
+// L'état de la dernière erreur ainsi que les flags sont propres à chaque thread
 class NAZARA_API NzError
 {
 	public:
 		NzError() = delete;
 		~NzError() = delete;
 
+		static void Error(nzErrorType type, const char* error);
 		static void Error(nzErrorType type, const NzString& error);
+		static void Error(nzErrorType type, const char* error, unsigned int line, const char* file, const char* function);
 		static void Error(nzErrorType type, const NzString& error, unsigned int line, const char* file, const char* function);
+		static void Error(nzErrorType type, unsigned int code, const char* error, unsigned int line, const char* file, const char* function);
+		static void Error(nzErrorType type, unsigned int code, const NzString& error, unsigned int line, const char* file, const char* function);
 
 		static nzUInt32 GetFlags();
 		static NzString GetLastError(const char** file = nullptr, unsigned int* line = nullptr, const char** function = nullptr);
+		static unsigned int GetLastErrorCode();
 		static unsigned int GetLastSystemErrorCode();
 		static NzString GetLastSystemError(unsigned int code = GetLastSystemErrorCode());
+		static constexpr unsigned int GetSourceFileOffset(const char* path, unsigned int i = 0, unsigned int offset = 0);
+
+		static bool IsSilent();
 
 		static void SetFlags(nzUInt32 flags);
+		static void SetLastError(const char* error, unsigned int code = 0, unsigned int line = 0, const char* file = "", const char* function = "");
+		static void SetLastError(const NzString& error, unsigned int code = 0, unsigned int line = 0, const char* file = "", const char* function = "");
 
 	private:
-		static nzUInt32 s_flags;
-		static NzString s_lastError;
-		static const char* s_lastErrorFunction;
-		static const char* s_lastErrorFile;
-		static unsigned int s_lastErrorLine;
+		static constexpr bool IsPathSeparator(char character);
+		static constexpr bool IsSourceDirectory(const char* path);
+		static constexpr bool MatchDirectory(const char* path, const char* directory);
+		static void Report(nzErrorType type, unsigned int line, const char* file, const char* function);
 };
 
+#include <Nazara/Core/Error.inl>
+
 #endif // NAZARA_ERROR_HPP
@@ -0,0 +1,31 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Debug.hpp>
+
+// Fonctions constexpr (une seule instruction en C++11), évaluées à la compilation via NazaraSourceFile
+// Le chemin est coupé au dernier dossier "include", "src" ou "plugins" rencontré
+
+constexpr unsigned int NzError::GetSourceFileOffset(const char* path, unsigned int i, unsigned int offset)
+{
+	return (path[i] == '\0') ? offset :
+	       GetSourceFileOffset(path, i+1, (IsPathSeparator(path[i]) && IsSourceDirectory(&path[i+1])) ? i+1 : offset);
+}
+
+constexpr bool NzError::IsPathSeparator(char character)
+{
+	return character == '/' || character == '\\';
+}
+
+constexpr bool NzError::IsSourceDirectory(const char* path)
+{
+	return MatchDirectory(path, "include") || MatchDirectory(path, "plugins") || MatchDirectory(path, "src");
+}
+
+constexpr bool NzError::MatchDirectory(const char* path, const char* directory)
+{
+	return (*directory == '\0') ? IsPathSeparator(*path) : (*path == *directory && MatchDirectory(path+1, directory+1));
+}
+
+#include <Nazara/Core/DebugOff.hpp>
@@ -0,0 +1,38 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_EVENT_HPP
+#define NAZARA_EVENT_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/ConditionVariable.hpp>
+#include <Nazara/Core/Mutex.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+
+class NAZARA_API NzEvent : NzNonCopyable
+{
+	public:
+		NzEvent(bool autoReset = true, bool signaled = false);
+		~NzEvent() = default;
+
+		bool IsAutoReset() const;
+		bool IsSignaled() const;
+
+		void Reset();
+
+		void Signal();
+
+		void Wait();
+		bool Wait(nzUInt32 timeout);
+
+	private:
+		mutable NzMutex m_mutex;
+		NzConditionVariable m_condition;
+		bool m_autoReset;
+		bool m_signaled;
+};
+
+#endif // NAZARA_EVENT_HPP
@@ -0,0 +1,47 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_FUNCTIONREF_HPP
+#define NAZARA_FUNCTIONREF_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <type_traits>
+
+// Référence non-propriétaire vers un appelable, deux pointeurs et aucune allocation
+// L'appelable référencé doit survivre à la référence (à utiliser pour les paramètres de fonctions)
+template<typename Signature> class NzFunctionRef;
+
+template<typename R, typename... Args>
+class NzFunctionRef<R(Args...)>
+{
+	public:
+		NzFunctionRef(R (*function)(Args...));
+		template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, NzFunctionRef>::value>::type> NzFunctionRef(F&& functor);
+		NzFunctionRef(const NzFunctionRef& functionRef) = default;
+		~NzFunctionRef() = default;
+
+		R operator()(Args... args) const;
+
+		NzFunctionRef& operator=(const NzFunctionRef& functionRef) = default;
+
+	private:
+		typedef R (*Invoker)(const NzFunctionRef& ref, Args&&... args);
+
+		static R InvokeFunction(const NzFunctionRef& ref, Args&&... args);
+		template<typename F> static R InvokeFunctor(const NzFunctionRef& ref, Args&&... args);
+
+		union
+		{
+			void* m_object;
+			R (*m_function)(Args...);
+		};
+
+		Invoker m_invoker;
+};
+
+#include <Nazara/Core/FunctionRef.inl>
+
+#endif // NAZARA_FUNCTIONREF_HPP
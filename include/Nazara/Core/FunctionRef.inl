@@ -0,0 +1,43 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <memory>
+#include <utility>
+#include <Nazara/Core/Debug.hpp>
+
+template<typename R, typename... Args>
+NzFunctionRef<R(Args...)>::NzFunctionRef(R (*function)(Args...)) :
+m_function(function),
+m_invoker(&InvokeFunction)
+{
+}
+
+template<typename R, typename... Args>
+template<typename F, typename>
+NzFunctionRef<R(Args...)>::NzFunctionRef(F&& functor) :
+m_object(const_cast<void*>(static_cast<const void*>(std::addressof(functor)))),
+m_invoker(&InvokeFunctor<typename std::remove_reference<F>::type>)
+{
+}
+
+template<typename R, typename... Args>
+R NzFunctionRef<R(Args...)>::operator()(Args... args) const
+{
+	return m_invoker(*this, std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args>
+R NzFunctionRef<R(Args...)>::InvokeFunction(const NzFunctionRef& ref, Args&&... args)
+{
+	return ref.m_function(std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args>
+template<typename F>
+R NzFunctionRef<R(Args...)>::InvokeFunctor(const NzFunctionRef& ref, Args&&... args)
+{
+	return (*static_cast<F*>(ref.m_object))(std::forward<Args>(args)...);
+}
+
+#include <Nazara/Core/DebugOff.hpp>
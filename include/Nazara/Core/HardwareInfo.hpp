@@ -14,8 +14,16 @@
 class NAZARA_API NzHardwareInfo
 {
 	public:
+		static unsigned int GetCacheLineSize();
+		static unsigned int GetCacheSize(unsigned int level);
+		static unsigned int GetNumaNodeCount();
+		static unsigned int GetPackageCount();
+		static unsigned int GetPhysicalCoreCount();
 		static NzString GetProcessorBrandString();
+		static unsigned int GetProcessorCore(unsigned int processor);
 		static unsigned int GetProcessorCount();
+		static unsigned int GetProcessorNumaNode(unsigned int processor);
+		static unsigned int GetProcessorPackage(unsigned int processor);
 		static nzProcessorVendor GetProcessorVendor();
 		static NzString GetProcessorVendorName();
 
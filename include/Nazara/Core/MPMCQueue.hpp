@@ -0,0 +1,53 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_MPMCQUEUE_HPP
+#define NAZARA_MPMCQUEUE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Config.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// File bornée sans verrou pour plusieurs producteurs et consommateurs (algorithme de D. Vyukov)
+// Chaque case porte un numéro de séquence indiquant si elle est prête à être écrite ou lue
+// La capacité est arrondie à la puissance de deux supérieure
+template<typename T>
+class NzMPMCQueue : NzNonCopyable
+{
+	public:
+		NzMPMCQueue(unsigned int capacity);
+		~NzMPMCQueue();
+
+		unsigned int GetCapacity() const;
+
+		bool Pop(T* value);
+		bool Push(const T& value);
+		bool Push(T&& value);
+
+	private:
+		struct Cell
+		{
+			std::atomic_size_t sequence;
+			typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+		};
+
+		template<typename U> bool Emplace(U&& value);
+
+		Cell* m_cells;
+		std::size_t m_mask;
+		char m_padding0[NAZARA_CORE_CACHE_LINE_SIZE];
+		std::atomic_size_t m_enqueuePos;
+		char m_padding1[NAZARA_CORE_CACHE_LINE_SIZE - sizeof(std::atomic_size_t)];
+		std::atomic_size_t m_dequeuePos;
+		char m_padding2[NAZARA_CORE_CACHE_LINE_SIZE - sizeof(std::atomic_size_t)];
+};
+
+#include <Nazara/Core/MPMCQueue.inl>
+
+#endif // NAZARA_MPMCQUEUE_HPP
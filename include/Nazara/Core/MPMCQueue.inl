@@ -0,0 +1,122 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/MemoryHelper.hpp>
+#include <utility>
+#include <Nazara/Core/Debug.hpp>
+
+template<typename T>
+NzMPMCQueue<T>::NzMPMCQueue(unsigned int capacity) :
+m_enqueuePos(0),
+m_dequeuePos(0)
+{
+	#if NAZARA_CORE_SAFE
+	if (capacity < 2)
+	{
+		NazaraError("Capacity must be at least 2");
+		capacity = 2;
+	}
+	#endif
+
+	std::size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+
+	m_mask = size-1;
+	m_cells = new Cell[size];
+	for (std::size_t i = 0; i < size; ++i)
+		m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+NzMPMCQueue<T>::~NzMPMCQueue()
+{
+	// Destruction des éléments restants, sans exiger de constructeur par défaut
+	std::size_t end = m_enqueuePos.load(std::memory_order_acquire);
+	for (std::size_t i = m_dequeuePos.load(std::memory_order_acquire); i != end; ++i)
+		reinterpret_cast<T*>(&m_cells[i & m_mask].storage)->~T();
+
+	delete[] m_cells;
+}
+
+template<typename T>
+unsigned int NzMPMCQueue<T>::GetCapacity() const
+{
+	return static_cast<unsigned int>(m_mask+1);
+}
+
+template<typename T>
+bool NzMPMCQueue<T>::Pop(T* value)
+{
+	Cell* cell;
+	std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		cell = &m_cells[pos & m_mask];
+		std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos+1);
+		if (diff == 0)
+		{
+			// La case est remplie, on tente de la réserver
+			if (m_dequeuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // Vide
+		else
+			pos = m_dequeuePos.load(std::memory_order_relaxed); // Un autre consommateur nous a devancé
+	}
+
+	T* object = reinterpret_cast<T*>(&cell->storage);
+	*value = std::move(*object);
+	object->~T();
+
+	// La case pourra être réécrite au prochain tour
+	cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+	return true;
+}
+
+template<typename T>
+bool NzMPMCQueue<T>::Push(const T& value)
+{
+	return Emplace(value);
+}
+
+template<typename T>
+bool NzMPMCQueue<T>::Push(T&& value)
+{
+	return Emplace(std::move(value));
+}
+
+template<typename T>
+template<typename U>
+bool NzMPMCQueue<T>::Emplace(U&& value)
+{
+	Cell* cell;
+	std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		cell = &m_cells[pos & m_mask];
+		std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+		if (diff == 0)
+		{
+			if (m_enqueuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // Pleine
+		else
+			pos = m_enqueuePos.load(std::memory_order_relaxed);
+	}
+
+	NzPlacementNew<T>(&cell->storage, std::forward<U>(value));
+	cell->sequence.store(pos+1, std::memory_order_release);
+
+	return true;
+}
+
+#include <Nazara/Core/DebugOff.hpp>
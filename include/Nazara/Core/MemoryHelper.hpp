@@ -0,0 +1,18 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_MEMORYHELPER_HPP
+#define NAZARA_MEMORYHELPER_HPP
+
+#include <Nazara/Prerequesites.hpp>
+
+// Construit un objet dans une mémoire déjà allouée, utilisable depuis un fichier incluant Debug.hpp
+// (dont la redéfinition de new par le traqueur de fuites est incompatible avec le placement new)
+template<typename T, typename... Args> T* NzPlacementNew(void* ptr, Args&&... args);
+
+#include <Nazara/Core/MemoryHelper.inl>
+
+#endif // NAZARA_MEMORYHELPER_HPP
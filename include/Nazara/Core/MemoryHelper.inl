@@ -0,0 +1,14 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <new>
+#include <utility>
+
+// Pas de Debug.hpp ici : le placement new doit rester celui du langage
+
+template<typename T, typename... Args>
+T* NzPlacementNew(void* ptr, Args&&... args)
+{
+	return ::new (ptr) T(std::forward<Args>(args)...);
+}
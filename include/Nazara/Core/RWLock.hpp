@@ -0,0 +1,52 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_RWLOCK_HPP
+#define NAZARA_RWLOCK_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+
+class NzRWLockImpl;
+
+class NAZARA_API NzRWLock : NzNonCopyable
+{
+	public:
+		NzRWLock();
+		~NzRWLock();
+
+		void LockRead();
+		void LockWrite();
+		bool TryLockRead();
+		bool TryLockWrite();
+		void UnlockRead();
+		void UnlockWrite();
+
+	private:
+		NzRWLockImpl* m_impl;
+};
+
+class NAZARA_API NzReadLockGuard
+{
+	public:
+		NzReadLockGuard(NzRWLock& lock);
+		~NzReadLockGuard();
+
+	private:
+		NzRWLock& m_lock;
+};
+
+class NAZARA_API NzWriteLockGuard
+{
+	public:
+		NzWriteLockGuard(NzRWLock& lock);
+		~NzWriteLockGuard();
+
+	private:
+		NzRWLock& m_lock;
+};
+
+#endif // NAZARA_RWLOCK_HPP
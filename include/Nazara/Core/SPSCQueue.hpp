@@ -0,0 +1,51 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_SPSCQUEUE_HPP
+#define NAZARA_SPSCQUEUE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Config.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// File bornée sans verrou, pour un unique producteur et un unique consommateur
+// La capacité est arrondie à la puissance de deux supérieure
+template<typename T>
+class NzSPSCQueue : NzNonCopyable
+{
+	public:
+		NzSPSCQueue(unsigned int capacity);
+		~NzSPSCQueue();
+
+		unsigned int GetCapacity() const;
+		unsigned int GetSize() const;
+
+		bool IsEmpty() const;
+
+		bool Pop(T* value);
+		bool Push(const T& value);
+		bool Push(T&& value);
+
+	private:
+		typedef typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type Slot;
+
+		template<typename U> bool Emplace(U&& value);
+
+		Slot* m_slots;
+		std::size_t m_mask;
+		char m_padding0[NAZARA_CORE_CACHE_LINE_SIZE];
+		std::atomic_size_t m_head; // Modifié par le consommateur uniquement
+		char m_padding1[NAZARA_CORE_CACHE_LINE_SIZE - sizeof(std::atomic_size_t)];
+		std::atomic_size_t m_tail; // Modifié par le producteur uniquement
+		char m_padding2[NAZARA_CORE_CACHE_LINE_SIZE - sizeof(std::atomic_size_t)];
+};
+
+#include <Nazara/Core/SPSCQueue.inl>
+
+#endif // NAZARA_SPSCQUEUE_HPP
@@ -0,0 +1,104 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/MemoryHelper.hpp>
+#include <utility>
+#include <Nazara/Core/Debug.hpp>
+
+template<typename T>
+NzSPSCQueue<T>::NzSPSCQueue(unsigned int capacity) :
+m_head(0),
+m_tail(0)
+{
+	#if NAZARA_CORE_SAFE
+	if (capacity == 0)
+	{
+		NazaraError("Capacity must be over 0");
+		capacity = 1;
+	}
+	#endif
+
+	std::size_t size = 1;
+	while (size < capacity)
+		size <<= 1;
+
+	m_mask = size-1;
+	m_slots = new Slot[size];
+}
+
+template<typename T>
+NzSPSCQueue<T>::~NzSPSCQueue()
+{
+	// Destruction des éléments restants, sans exiger de constructeur par défaut
+	std::size_t tail = m_tail.load(std::memory_order_acquire);
+	for (std::size_t i = m_head.load(std::memory_order_acquire); i != tail; ++i)
+		reinterpret_cast<T*>(&m_slots[i & m_mask])->~T();
+
+	delete[] m_slots;
+}
+
+template<typename T>
+unsigned int NzSPSCQueue<T>::GetCapacity() const
+{
+	return static_cast<unsigned int>(m_mask+1);
+}
+
+template<typename T>
+unsigned int NzSPSCQueue<T>::GetSize() const
+{
+	// Approximatif si la file est modifiée en parallèle
+	return static_cast<unsigned int>(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+}
+
+template<typename T>
+bool NzSPSCQueue<T>::IsEmpty() const
+{
+	return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+}
+
+template<typename T>
+bool NzSPSCQueue<T>::Pop(T* value)
+{
+	std::size_t head = m_head.load(std::memory_order_relaxed);
+	if (head == m_tail.load(std::memory_order_acquire))
+		return false;
+
+	T* slot = reinterpret_cast<T*>(&m_slots[head & m_mask]);
+	*value = std::move(*slot);
+	slot->~T();
+
+	m_head.store(head+1, std::memory_order_release);
+
+	return true;
+}
+
+template<typename T>
+bool NzSPSCQueue<T>::Push(const T& value)
+{
+	return Emplace(value);
+}
+
+template<typename T>
+bool NzSPSCQueue<T>::Push(T&& value)
+{
+	return Emplace(std::move(value));
+}
+
+template<typename T>
+template<typename U>
+bool NzSPSCQueue<T>::Emplace(U&& value)
+{
+	std::size_t tail = m_tail.load(std::memory_order_relaxed);
+	if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+		return false; // Pleine
+
+	NzPlacementNew<T>(&m_slots[tail & m_mask], std::forward<U>(value));
+
+	m_tail.store(tail+1, std::memory_order_release);
+
+	return true;
+}
+
+#include <Nazara/Core/DebugOff.hpp>
@@ -0,0 +1,105 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_SIMDDISPATCH_HPP
+#define NAZARA_SIMDDISPATCH_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Enums.hpp>
+
+// Permet de compiler une fonction pour un jeu d'instructions particulier sans changer les options du reste du fichier
+// Visual C++ accepte les intrinsèques de tous les jeux d'instructions sans option particulière
+#if defined(NAZARA_COMPILER_CLANG) || defined(NAZARA_COMPILER_GCC) || defined(NAZARA_COMPILER_INTEL)
+	#define NAZARA_SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+	#define NAZARA_SIMD_TARGET_SSE41 __attribute__((target("sse4.1")))
+	#define NAZARA_SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+	#define NAZARA_SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+	#define NAZARA_SIMD_TARGET_SSE2
+	#define NAZARA_SIMD_TARGET_SSE41
+	#define NAZARA_SIMD_TARGET_AVX2
+	#define NAZARA_SIMD_TARGET_AVX512
+#endif
+
+class NzSimdFunctionBase;
+
+class NAZARA_API NzSimdDispatch
+{
+	friend class NzSimdFunctionBase;
+
+	public:
+		NzSimdDispatch() = delete;
+		~NzSimdDispatch() = delete;
+
+		static nzSimdLevel GetLevel();
+		static nzSimdLevel GetSupportedLevel();
+
+		static bool Initialize();
+
+		static bool IsInitialized();
+		static bool IsLevelSupported(nzSimdLevel level);
+
+		static bool SetLevel(nzSimdLevel level);
+
+		static void Uninitialize();
+
+	private:
+		static void Register(NzSimdFunctionBase* function);
+		static void Unregister(NzSimdFunctionBase* function);
+};
+
+class NAZARA_API NzSimdFunctionBase
+{
+	friend class NzSimdDispatch;
+
+	public:
+		NzSimdFunctionBase(const NzSimdFunctionBase&) = delete;
+		NzSimdFunctionBase(NzSimdFunctionBase&&) = delete;
+
+		NzSimdFunctionBase& operator=(const NzSimdFunctionBase&) = delete;
+		NzSimdFunctionBase& operator=(NzSimdFunctionBase&&) = delete;
+
+	protected:
+		NzSimdFunctionBase();
+		virtual ~NzSimdFunctionBase();
+
+		virtual void Resolve(nzSimdLevel level) = 0;
+
+	private:
+		NzSimdFunctionBase* m_next;
+		NzSimdFunctionBase* m_previous;
+};
+
+template<typename Signature> class NzSimdFunction;
+
+// Table d'implémentations d'un noyau de calcul, la meilleure implémentation disponible est choisie une seule fois
+// (à l'initialisation de NzCore ou lors d'un NzSimdDispatch::SetLevel), l'appel se résume ensuite à un appel indirect
+template<typename R, typename... Args>
+class NzSimdFunction<R(Args...)> : public NzSimdFunctionBase
+{
+	public:
+		using Function = R (*)(Args...);
+
+		NzSimdFunction(Function scalar, Function sse2 = nullptr, Function sse41 = nullptr, Function avx2 = nullptr, Function avx512 = nullptr);
+		~NzSimdFunction() = default;
+
+		Function GetFunction() const;
+		Function GetImplementation(nzSimdLevel level) const;
+		nzSimdLevel GetLevel() const;
+
+		R operator()(Args... args) const;
+
+	private:
+		void Resolve(nzSimdLevel level) override;
+
+		Function m_function;
+		Function m_implementations[nzSimdLevel_Max+1];
+		nzSimdLevel m_level;
+};
+
+#include <Nazara/Core/SimdDispatch.inl>
+
+#endif // NAZARA_SIMDDISPATCH_HPP
@@ -0,0 +1,62 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Debug.hpp>
+
+template<typename R, typename... Args>
+NzSimdFunction<R(Args...)>::NzSimdFunction(Function scalar, Function sse2, Function sse41, Function avx2, Function avx512) :
+m_function(scalar),
+m_level(nzSimdLevel_Scalar)
+{
+	m_implementations[nzSimdLevel_Scalar] = scalar;
+	m_implementations[nzSimdLevel_SSE2] = sse2;
+	m_implementations[nzSimdLevel_SSE41] = sse41;
+	m_implementations[nzSimdLevel_AVX2] = avx2;
+	m_implementations[nzSimdLevel_AVX512] = avx512;
+
+	// Noyau construit après l'initialisation (variable statique locale par exemple)
+	if (NzSimdDispatch::IsInitialized())
+		Resolve(NzSimdDispatch::GetLevel());
+}
+
+template<typename R, typename... Args>
+typename NzSimdFunction<R(Args...)>::Function NzSimdFunction<R(Args...)>::GetFunction() const
+{
+	return m_function;
+}
+
+template<typename R, typename... Args>
+typename NzSimdFunction<R(Args...)>::Function NzSimdFunction<R(Args...)>::GetImplementation(nzSimdLevel level) const
+{
+	return m_implementations[level];
+}
+
+template<typename R, typename... Args>
+nzSimdLevel NzSimdFunction<R(Args...)>::GetLevel() const
+{
+	return m_level;
+}
+
+template<typename R, typename... Args>
+R NzSimdFunction<R(Args...)>::operator()(Args... args) const
+{
+	return m_function(args...);
+}
+
+template<typename R, typename... Args>
+void NzSimdFunction<R(Args...)>::Resolve(nzSimdLevel level)
+{
+	// On prend la meilleure implémentation ne dépassant pas le niveau demandé, la version scalaire existe toujours
+	for (int i = level; i >= nzSimdLevel_Scalar; --i)
+	{
+		if (m_implementations[i])
+		{
+			m_function = m_implementations[i];
+			m_level = static_cast<nzSimdLevel>(i);
+			break;
+		}
+	}
+}
+
+#include <Nazara/Core/DebugOff.hpp>
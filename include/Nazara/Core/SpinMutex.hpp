@@ -0,0 +1,47 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_SPINMUTEX_HPP
+#define NAZARA_SPINMUTEX_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Core/Semaphore.hpp>
+#include <atomic>
+
+// Mutex adaptatif: tente d'abord d'acquérir le verrou en espace utilisateur pendant un nombre d'essais
+// ajusté selon les succès précédents, avant de s'endormir sur un sémaphore (futex sous Linux)
+class NAZARA_API NzSpinMutex : NzNonCopyable
+{
+	public:
+		NzSpinMutex();
+		~NzSpinMutex() = default;
+
+		void Lock();
+		bool TryLock();
+		void Unlock();
+
+	private:
+		void LockContended();
+
+		NzSemaphore m_semaphore;
+		std::atomic_int m_count; // Nombre de threads possédant ou attendant le verrou
+		std::atomic_int m_spinCount;
+};
+
+class NAZARA_API NzSpinLockGuard
+{
+	public:
+		NzSpinLockGuard(NzSpinMutex& mutex);
+		~NzSpinLockGuard();
+
+	private:
+		NzSpinMutex& m_mutex;
+};
+
+#include <Nazara/Core/SpinMutex.inl>
+
+#endif // NAZARA_SPINMUTEX_HPP
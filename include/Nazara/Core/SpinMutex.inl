@@ -0,0 +1,39 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Debug.hpp>
+
+inline void NzSpinMutex::Lock()
+{
+	// Chemin rapide: verrou libre, aucun appel système
+	int expected = 0;
+	if (!m_count.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+		LockContended();
+}
+
+inline bool NzSpinMutex::TryLock()
+{
+	int expected = 0;
+	return m_count.compare_exchange_strong(expected, 1, std::memory_order_acquire);
+}
+
+inline void NzSpinMutex::Unlock()
+{
+	// S'il reste des threads enregistrés, l'un d'eux est (ou sera) endormi sur le sémaphore
+	if (m_count.fetch_sub(1, std::memory_order_release) > 1)
+		m_semaphore.Post();
+}
+
+inline NzSpinLockGuard::NzSpinLockGuard(NzSpinMutex& mutex) :
+m_mutex(mutex)
+{
+	m_mutex.Lock();
+}
+
+inline NzSpinLockGuard::~NzSpinLockGuard()
+{
+	m_mutex.Unlock();
+}
+
+#include <Nazara/Core/DebugOff.hpp>
@@ -8,7 +8,8 @@
 #define NAZARA_TASKSCHEDULER_HPP
 
 #include <Nazara/Prerequesites.hpp>
-#include <Nazara/Core/Functor.hpp>
+#include <Nazara/Core/Enums.hpp>
+#include <Nazara/Core/Callable.hpp>
 #include <Nazara/Core/Thread.hpp>
 
 class NAZARA_API NzTaskScheduler
@@ -20,14 +21,18 @@ class NAZARA_API NzTaskScheduler
 		template<typename F> static void AddTask(F function);
 		template<typename F, typename... Args> static void AddTask(F function, Args... args);
 		template<typename C> static void AddTask(void (C::*function)(), C* object);
+		static void EnableWorkerPinning(bool pinning);
 		static unsigned int GetWorkerCount();
+		static nzThreadPriority GetWorkerPriority();
 		static bool Initialize();
+		static bool IsWorkerPinningEnabled();
 		static void SetWorkerCount(unsigned int workerCount);
+		static void SetWorkerPriority(nzThreadPriority priority);
 		static void Uninitialize();
 		static void WaitForTasks();
 
 	private:
-		static void AddTaskFunctor(NzFunctor* taskFunctor);
+		static void AddTaskCallable(NzCallable<void()>&& task);
 };
 
 #include <Nazara/Core/TaskScheduler.inl>
@@ -8,8 +8,10 @@
 #define NAZARA_THREAD_HPP
 
 #include <Nazara/Prerequesites.hpp>
-#include <Nazara/Core/Functor.hpp>
+#include <Nazara/Core/Enums.hpp>
+#include <Nazara/Core/Callable.hpp>
 #include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Core/String.hpp>
 #include <ostream>
 
 class NzThreadImpl;
@@ -31,13 +33,20 @@ class NAZARA_API NzThread : NzNonCopyable
 		bool IsJoinable() const;
 		void Join();
 
+		bool SetAffinity(nzUInt64 processorMask);
+		bool SetName(const NzString& name);
+		bool SetPriority(nzThreadPriority priority);
+
 		NzThread& operator=(NzThread&& thread);
 
 		static unsigned int HardwareConcurrency();
+		static bool SetCurrentThreadAffinity(nzUInt64 processorMask);
+		static bool SetCurrentThreadName(const NzString& name);
+		static bool SetCurrentThreadPriority(nzThreadPriority priority);
 		static void Sleep(nzUInt32 milliseconds);
 
 	private:
-		void CreateImpl(NzFunctor* functor);
+		void CreateImpl(NzCallable<void()>&& function);
 
 		NzThreadImpl* m_impl;
 };
@@ -6,6 +6,7 @@
 
 #include <Nazara/Core/LockGuard.hpp>
 #include <Nazara/Core/Mutex.hpp>
+#include <Nazara/Core/RWLock.hpp>
 
 // Ces macros peuvent changer pour n'importe quel fichier qui l'utilise dans une même unité de compilation
 #undef NazaraLock
@@ -14,6 +15,9 @@
 #undef NazaraMutexLock
 #undef NazaraMutexUnlock
 #undef NazaraNamedLock
+#undef NazaraReadLock
+#undef NazaraRWLockAttrib
+#undef NazaraWriteLock
 
 #define NazaraLock(mutex) NzLockGuard lock_mutex(mutex);
 #define NazaraMutex(name) NzMutex name;
@@ -21,3 +25,6 @@
 #define NazaraMutexLock(mutex) mutex.Lock();
 #define NazaraMutexUnlock(mutex) mutex.Unlock();
 #define NazaraNamedLock(mutex, name) NzLockGuard lock_##name(mutex);
+#define NazaraReadLock(lock) NzReadLockGuard readLock_##lock(lock);
+#define NazaraRWLockAttrib(name, attribute) attribute NzRWLock name;
+#define NazaraWriteLock(lock) NzWriteLockGuard writeLock_##lock(lock);
@@ -0,0 +1,53 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_ANIMATIONLOD_HPP
+#define NAZARA_ANIMATIONLOD_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Graphics/Enums.hpp>
+#include <Nazara/Math/BoundingVolume.hpp>
+#include <vector>
+
+class NzAbstractViewer;
+class NzSkeleton;
+
+struct NzAnimationLODLevel
+{
+	std::vector<unsigned int> joints; // Joints animés à ce niveau, tous si vide
+	float threshold;
+	unsigned int updateInterval; // Nombre de mises à jour de la scène entre deux échantillonnages du squelette, la pose étant interpolée entre-temps
+};
+
+class NAZARA_API NzAnimationLOD
+{
+	public:
+		NzAnimationLOD(nzAnimationLODMetric metric = nzAnimationLODMetric_Distance);
+		~NzAnimationLOD() = default;
+
+		unsigned int AddLevel(float threshold, unsigned int updateInterval, std::vector<unsigned int> joints = std::vector<unsigned int>());
+
+		float ComputeMetric(const NzAbstractViewer* viewer, const NzBoundingVolumef& boundingVolume) const;
+
+		void EnableOffscreenFreeze(bool freeze);
+
+		const NzAnimationLODLevel& GetLevel(unsigned int level) const;
+		unsigned int GetLevelCount() const;
+		nzAnimationLODMetric GetMetric() const;
+
+		bool IsOffscreenFreezeEnabled() const;
+
+		unsigned int SelectLevel(float metric) const;
+
+		static std::vector<unsigned int> BuildJointList(const NzSkeleton* skeleton, unsigned int leafDepth);
+
+	private:
+		std::vector<NzAnimationLODLevel> m_levels;
+		nzAnimationLODMetric m_metric;
+		bool m_offscreenFreeze;
+};
+
+#endif // NAZARA_ANIMATIONLOD_HPP
@@ -38,4 +38,13 @@
 // Active les tests de sécurité basés sur le code (Conseillé pour le développement)
 #define NAZARA_GRAPHICS_SAFE 1
 
+// Taille maximale (en pixels) du niveau de mipmap gardé en permanence par les textures diffusées
+#define NAZARA_GRAPHICS_TEXTURESTREAMING_BASE_SIZE 64
+
+// Budget mémoire (en octets) des textures diffusées (Modifiable à l'exécution)
+#define NAZARA_GRAPHICS_TEXTURESTREAMING_MEMORY_BUDGET 256*1024*1024
+
+// Quantité maximale de pixels (en octets) envoyée au GPU à chaque frame par la diffusion des textures (Modifiable à l'exécution)
+#define NAZARA_GRAPHICS_TEXTURESTREAMING_UPLOAD_BUDGET 4*1024*1024
+
 #endif // NAZARA_CONFIG_GRAPHICS_HPP
@@ -7,6 +7,14 @@
 #ifndef NAZARA_ENUMS_GRAPHICS_HPP
 #define NAZARA_ENUMS_GRAPHICS_HPP
 
+enum nzAnimationLODMetric
+{
+	nzAnimationLODMetric_Distance,      // Distance entre l'observateur et le centre du modèle
+	nzAnimationLODMetric_ProjectedSize, // Taille projetée du modèle, relativement à la hauteur de l'écran
+
+	nzAnimationLODMetric_Max = nzAnimationLODMetric_ProjectedSize
+};
+
 enum nzBackgroundType
 {
 	nzBackgroundType_Color,   // NzColorBackground
@@ -39,13 +47,34 @@ enum nzRenderTechniqueType
 
 enum nzSceneNodeType
 {
-	nzSceneNodeType_Light,  // NzLight
-	nzSceneNodeType_Model,  // NzModel
-	nzSceneNodeType_Root,   // NzSceneRoot
-	nzSceneNodeType_Sprite, // NzSprite
+	nzSceneNodeType_Light,       // NzLight
+	nzSceneNodeType_Model,       // NzModel
+	nzSceneNodeType_Root,        // NzSceneRoot
+	nzSceneNodeType_Sprite,      // NzSprite
 	nzSceneNodeType_User,
+	nzSceneNodeType_StaticBatch, // NzStaticBatch (ajouté après User pour en conserver la valeur)
+
+	nzSceneNodeType_Max = nzSceneNodeType_StaticBatch
+};
+
+enum nzTransformBatchFlags
+{
+	nzTransformBatch_Compact3x4    = 0x01, // Matrice monde réduite à trois vecteurs (transposée, la dernière colonne étant implicite)
+	nzTransformBatch_Compact       = 0x02, // Matrice monde décomposée en rotation (quaternion), translation et échelle
+	nzTransformBatch_Normal        = 0x04, // Transposée de l'inverse de la partie 3x3 de la matrice monde
+	nzTransformBatch_WorldView     = 0x08,
+	nzTransformBatch_WorldViewProj = 0x10,
+
+	nzTransformBatch_Default = nzTransformBatch_WorldView | nzTransformBatch_WorldViewProj
+};
+
+enum nzUpdateFrequency
+{
+	nzUpdateFrequency_Always, // À chaque mise à jour, indépendamment du budget
+	nzUpdateFrequency_Normal, // À chaque mise à jour si le budget le permet, sinon reporté à la suivante
+	nzUpdateFrequency_Low,    // Par tranches, en tourniquet, si le budget le permet
 
-	nzSceneNodeType_Max = nzSceneNodeType_User
+	nzUpdateFrequency_Max = nzUpdateFrequency_Low
 };
 
 #endif // NAZARA_ENUMS_GRAPHICS_HPP
@@ -52,6 +52,7 @@ class NAZARA_API NzForwardRenderQueue : public NzAbstractRenderQueue, NzResource
 		struct StaticData
 		{
 			NzMatrix4f transformMatrix;
+			unsigned int transformIndex; // Dans le NzTransformBatch de la technique
 		};
 
 		struct TransparentModel
@@ -59,6 +60,7 @@ class NAZARA_API NzForwardRenderQueue : public NzAbstractRenderQueue, NzResource
 			NzMatrix4f transformMatrix;
 			NzSpheref boundingSphere;
 			const NzMaterial* material;
+			unsigned int transformIndex;
 		};
 
 		struct TransparentSkeletalModel : public TransparentModel
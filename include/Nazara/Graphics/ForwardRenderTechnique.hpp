@@ -11,6 +11,7 @@
 #include <Nazara/Graphics/AbstractRenderTechnique.hpp>
 #include <Nazara/Graphics/ForwardRenderQueue.hpp>
 #include <Nazara/Graphics/LightManager.hpp>
+#include <Nazara/Graphics/TransformBatch.hpp>
 #include <Nazara/Utility/IndexBuffer.hpp>
 #include <Nazara/Utility/VertexBuffer.hpp>
 
@@ -33,11 +34,13 @@ class NAZARA_API NzForwardRenderTechnique : public NzAbstractRenderTechnique
 		void DrawOpaqueModels(const NzScene* scene);
 		void DrawSprites(const NzScene* scene);
 		void DrawTransparentModels(const NzScene* scene);
+		void UpdateTransforms(const NzScene* scene);
 
 		NzForwardRenderQueue m_renderQueue;
 		NzIndexBufferRef m_indexBuffer;
 		NzLightManager m_directionalLights;
 		NzLightManager m_lights;
+		NzTransformBatch m_transforms;
 		NzVertexBuffer m_spriteBuffer;
 		unsigned int m_maxLightsPerObject;
 };
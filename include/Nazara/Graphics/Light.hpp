@@ -24,6 +24,7 @@ class NAZARA_API NzLight : public NzSceneNode
 		void AddToRenderQueue(NzAbstractRenderQueue* renderQueue) const override;
 
 		void Enable(const NzShaderProgram* program, unsigned int lightUnit) const;
+		void EnableShadowCasting(bool shadowCasting);
 
 		float GetAmbientFactor() const;
 		float GetAttenuation() const;
@@ -37,6 +38,7 @@ class NAZARA_API NzLight : public NzSceneNode
 		nzSceneNodeType GetSceneNodeType() const;
 
 		bool IsDrawable() const;
+		bool IsShadowCastingEnabled() const;
 
 		void SetAmbientFactor(float factor);
 		void SetAttenuation(float attenuation);
@@ -62,6 +64,7 @@ class NAZARA_API NzLight : public NzSceneNode
 		mutable NzBoundingVolumef m_boundingVolume;
 		NzColor m_color;
 		mutable bool m_boundingVolumeUpdated;
+		bool m_shadowCasting;
 		float m_ambientFactor;
 		float m_attenuation;
 		float m_diffuseFactor;
@@ -10,6 +10,7 @@
 #include <Nazara/Prerequesites.hpp>
 #include <Nazara/Core/ResourceLoader.hpp>
 #include <Nazara/Core/Updatable.hpp>
+#include <Nazara/Graphics/AnimationLOD.hpp>
 #include <Nazara/Graphics/SceneNode.hpp>
 #include <Nazara/Renderer/Material.hpp>
 #include <Nazara/Utility/Animation.hpp>
@@ -19,6 +20,7 @@ struct NAZARA_API NzModelParameters
 {
 	bool loadAnimation = true;
 	bool loadMaterials = true;
+	bool mergeMaterials = true; // Les matériaux chargés sont fusionnés avec leurs équivalents via NzMaterialRegistry (voir NzModel::EditMaterial)
 	NzAnimationParams animation;
 	NzMaterialParams material;
 	NzMeshParams mesh;
@@ -44,14 +46,18 @@ class NAZARA_API NzModel : public NzSceneNode, public NzUpdatable
 		void AddToRenderQueue(NzAbstractRenderQueue* renderQueue) const override;
 		void AdvanceAnimation(float elapsedTime);
 
+		NzMaterial* EditMaterial(unsigned int matIndex);
+		NzMaterial* EditMaterial(unsigned int skinIndex, unsigned int matIndex);
 		void EnableAnimation(bool animation);
 
 		NzAnimation* GetAnimation() const;
+		const NzAnimationLOD* GetAnimationLOD() const;
+		unsigned int GetAnimationLODLevel() const;
 		const NzBoundingVolumef& GetBoundingVolume() const;
-		NzMaterial* GetMaterial(const NzString& subMeshName) const;
-		NzMaterial* GetMaterial(unsigned int matIndex) const;
-		NzMaterial* GetMaterial(unsigned int skinIndex, const NzString& subMeshName) const;
-		NzMaterial* GetMaterial(unsigned int skinIndex, unsigned int matIndex) const;
+		const NzMaterial* GetMaterial(const NzString& subMeshName) const;
+		const NzMaterial* GetMaterial(unsigned int matIndex) const;
+		const NzMaterial* GetMaterial(unsigned int skinIndex, const NzString& subMeshName) const;
+		const NzMaterial* GetMaterial(unsigned int skinIndex, unsigned int matIndex) const;
 		unsigned int GetMaterialCount() const;
 		unsigned int GetSkin() const;
 		unsigned int GetSkinCount() const;
@@ -64,6 +70,7 @@ class NAZARA_API NzModel : public NzSceneNode, public NzUpdatable
 
 		bool IsAnimationEnabled() const;
 		bool IsDrawable() const;
+		bool IsStatic() const;
 
 		bool LoadFromFile(const NzString& filePath, const NzModelParameters& params = NzModelParameters());
 		bool LoadFromMemory(const void* data, std::size_t size, const NzModelParameters& params = NzModelParameters());
@@ -72,6 +79,7 @@ class NAZARA_API NzModel : public NzSceneNode, public NzUpdatable
 		void Reset();
 
 		bool SetAnimation(NzAnimation* animation);
+		void SetAnimationLOD(const NzAnimationLOD* animationLOD);
 		bool SetMaterial(const NzString& subMeshName, NzMaterial* material);
 		void SetMaterial(unsigned int matIndex, NzMaterial* material);
 		bool SetMaterial(unsigned int skinIndex, const NzString& subMeshName, NzMaterial* material);
@@ -81,32 +89,53 @@ class NAZARA_API NzModel : public NzSceneNode, public NzUpdatable
 		void SetSequence(unsigned int sequenceIndex);
 		void SetSkin(unsigned int skin);
 		void SetSkinCount(unsigned int skinCount);
+		void SetStatic(bool isStatic);
 
 		NzModel& operator=(const NzModel& node);
 		NzModel& operator=(NzModel&& node);
 
 	private:
+		struct JointPose
+		{
+			NzQuaternionf rotation;
+			NzVector3f position;
+			NzVector3f scale;
+		};
+
+		void AdvanceFrames(float elapsedTime);
+		void BlendPoses(const NzAnimationLODLevel& level, float interpolation);
 		bool FrustumCull(const NzFrustumf& frustum) override;
 		void Invalidate() override;
+		void OnVisibilityChange(bool visibility) override;
 		void Register() override;
 		void Unregister() override;
+		void StorePose(const NzAnimationLODLevel& level);
 		void Update() override;
 		void UpdateBoundingVolume() const;
+		void UpdateSkeleton(const NzAnimationLODLevel* level);
 
 		std::vector<NzMaterialRef> m_materials;
+		std::vector<JointPose> m_previousPose; // Avant-dernière pose échantillonnée (LOD à fréquence réduite)
+		std::vector<JointPose> m_sampledPose; // Dernière pose échantillonnée (LOD à fréquence réduite)
 		NzAnimationRef m_animation;
+		const NzAnimationLOD* m_animationLOD; // Non-possédé, doit survivre au modèle
 		mutable NzBoundingVolumef m_boundingVolume;
 		NzMeshRef m_mesh;
 		NzSkeleton m_skeleton; // Uniquement pour les animations squelettiques
 		const NzSequence* m_currentSequence;
 		bool m_animationEnabled;
 		mutable bool m_boundingVolumeUpdated;
+		bool m_static;
 		float m_interpolation;
+		float m_pendingAnimationTime;
+		unsigned int m_animationLODLevel;
 		unsigned int m_currentFrame;
 		unsigned int m_matCount;
 		unsigned int m_nextFrame;
+		unsigned int m_sampledLODLevel;
 		unsigned int m_skin;
 		unsigned int m_skinCount;
+		unsigned int m_updateCounter;
 
 		static NzModelLoader::LoaderList s_loaders;
 };
@@ -0,0 +1,116 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_PORTALSYSTEM_HPP
+#define NAZARA_PORTALSYSTEM_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Frustum.hpp>
+#include <Nazara/Math/Plane.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <unordered_map>
+#include <vector>
+
+class NzNode;
+class NzSceneNode;
+
+// Visibilité par cellules et portails, pour les scènes d'intérieur :
+// - les cellules sont des volumes (AABB) reliés entre eux par des portails (polygones convexes)
+// - chaque noeud est rattaché aux cellules que sa boîte englobante recoupe, rattachement recalculé
+//   lors de l'Update si le noeud a bougé
+// - ComputeVisibility parcourt récursivement les portails depuis la cellule de l'observateur
+//   en réduisant le frustum aux bords de chaque portail visible
+// Un noeud hors de toute cellule (ou tant que l'observateur est lui-même hors de toute cellule)
+// n'est soumis qu'au frustum culling habituel
+// Les noeuds se retirent d'eux-mêmes du système lorsqu'ils sont détruits ou quittent leur scène
+class NAZARA_API NzPortalSystem : NzNonCopyable
+{
+	public:
+		NzPortalSystem();
+		~NzPortalSystem();
+
+		unsigned int AddCell(const NzBoxf& bounds);
+		void AddNode(NzSceneNode* node);
+		void AddNodes(NzNode* root);
+		unsigned int AddPortal(unsigned int cellA, unsigned int cellB, const NzVector3f* vertices, unsigned int vertexCount);
+
+		void Clear();
+		void ClearNodes();
+
+		void ComputeVisibility(const NzVector3f& eyePosition, const NzFrustumf& frustum);
+
+		unsigned int GetCameraCell() const;
+		unsigned int GetCell(const NzVector3f& point) const;
+		const NzBoxf& GetCellBounds(unsigned int cell) const;
+		unsigned int GetCellCount() const;
+		unsigned int GetMaxDepth() const;
+		unsigned int GetNodeCellCount(const NzSceneNode* node) const;
+		unsigned int GetNodeCount() const;
+		unsigned int GetPortalCount() const;
+		unsigned int GetPortalTraversalCount() const;
+		unsigned int GetVisibleCellCount() const;
+
+		bool HasNode(const NzSceneNode* node) const;
+
+		bool IsCellVisible(unsigned int cell) const;
+		bool IsNodeInCell(const NzSceneNode* node, unsigned int cell) const;
+		bool IsNodeOccluded(const NzSceneNode* node) const;
+
+		void RemoveNode(NzSceneNode* node);
+
+		void SetMaxDepth(unsigned int maxDepth);
+
+		void Update();
+
+		static const unsigned int InvalidCell = 0xFFFFFFFF;
+
+	private:
+		struct Cell
+		{
+			NzBoxf bounds;
+			std::vector<unsigned int> nodes;
+			std::vector<unsigned int> portals;
+			unsigned int visibleFrame;
+		};
+
+		struct Node
+		{
+			NzBoxf aabb;
+			NzSceneNode* node;
+			std::vector<unsigned int> cells;
+			unsigned int visibleFrame;
+			bool bounded; // Volume englobant fini, le noeud est rattaché aux cellules qu'il recoupe (aucune : jamais occulté)
+		};
+
+		struct Portal
+		{
+			NzPlanef plane; // Orienté vers la cellule B
+			std::vector<NzVector3f> vertices;
+			unsigned int cells[2];
+			bool traversing;
+		};
+
+		void AssignNode(unsigned int nodeIndex);
+		void UnassignNode(unsigned int nodeIndex);
+		void VisitCell(unsigned int cell, const NzVector3f& eyePosition, const std::vector<NzPlanef>& planes, unsigned int depth);
+
+		std::unordered_map<const NzSceneNode*, unsigned int> m_nodeIndices;
+		std::vector<Cell> m_cells;
+		std::vector<Node> m_nodes;
+		std::vector<Portal> m_portals;
+		std::vector<unsigned int> m_freeNodes;
+		std::vector<NzVector3f> m_clipBuffers[2];
+		NzPlanef m_farPlane;
+		unsigned int m_cameraCell;
+		unsigned int m_frame;
+		unsigned int m_maxDepth;
+		unsigned int m_portalTraversalCount;
+		unsigned int m_visibleCellCount;
+};
+
+#endif // NAZARA_PORTALSYSTEM_HPP
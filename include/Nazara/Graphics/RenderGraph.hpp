@@ -0,0 +1,136 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_RENDERGRAPH_HPP
+#define NAZARA_RENDERGRAPH_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Callable.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Core/String.hpp>
+#include <Nazara/Renderer/RenderTexture.hpp>
+#include <Nazara/Renderer/Texture.hpp>
+#include <Nazara/Utility/Enums.hpp>
+#include <memory>
+#include <vector>
+
+struct NzRenderGraphTextureInfo
+{
+	nzPixelFormat format;
+	unsigned int height;
+	unsigned int width;
+};
+
+struct NzRenderGraphStats
+{
+	unsigned int activePassCount;
+	unsigned int culledPassCount;
+	unsigned int physicalTextureCount;
+	unsigned int renderTextureCount;
+	unsigned int transientTextureCount;
+};
+
+// Graphe de rendu : les passes déclarent les textures qu'elles lisent et écrivent, le graphe en déduit
+// les passes inutiles, la durée de vie des textures transitoires et le partage de celles-ci via un pool
+// Les passes sont exécutées dans leur ordre de déclaration, qui définit les dépendances entre elles
+class NzScene;
+
+class NAZARA_API NzRenderGraph : NzNonCopyable
+{
+	public:
+		using ExecuteFunction = NzCallable<void(const NzScene* scene)>;
+
+		NzRenderGraph();
+		~NzRenderGraph();
+
+		unsigned int AddPass(const NzString& name, ExecuteFunction execute);
+		void AddPassInput(unsigned int pass, unsigned int texture);
+		void AddPassOutput(unsigned int pass, unsigned int texture, bool preserveContent = true);
+		unsigned int AddTexture(const NzString& name, const NzRenderGraphTextureInfo& info);
+
+		void Clear();
+		bool Compile();
+
+		bool Execute(const NzScene* scene);
+
+		const NzString& GetPassName(unsigned int pass) const;
+		unsigned int GetPassCount() const;
+		int GetPhysicalTextureIndex(unsigned int texture) const;
+		NzRenderGraphStats GetStats() const;
+		NzTexture* GetTexture(unsigned int texture) const;
+		unsigned int GetTextureCount() const;
+		const NzString& GetTextureName(unsigned int texture) const;
+
+		unsigned int ImportTexture(const NzString& name, NzTexture* texture);
+
+		bool IsCompiled() const;
+		bool IsPassActive(unsigned int pass) const;
+
+		void ReleasePool();
+
+		void SetPassExternalOutput(unsigned int pass, bool externalOutput);
+
+	private:
+		struct Output
+		{
+			unsigned int texture;
+			bool preserveContent;
+		};
+
+		struct Pass
+		{
+			ExecuteFunction execute;
+			NzString name;
+			std::vector<Output> outputs;
+			std::vector<unsigned int> inputs;
+			int renderTexture;
+			bool active;
+			bool externalOutput;
+		};
+
+		struct PhysicalTexture
+		{
+			NzRenderGraphTextureInfo info;
+			NzTextureRef texture;
+			bool used;
+		};
+
+		struct RenderTextureEntry
+		{
+			std::unique_ptr<NzRenderTexture> renderTexture;
+			std::vector<unsigned int> attachmentKeys;
+			std::vector<unsigned int> colorTextures;
+			std::vector<nzUInt8> colorTargets;
+			int depthTexture;
+		};
+
+		struct Texture
+		{
+			NzRenderGraphTextureInfo info;
+			NzString name;
+			NzTextureRef importedTexture;
+			int physicalTexture;
+			unsigned int firstUse;
+			unsigned int lastUse;
+		};
+
+		void AssignPhysicalTextures();
+		bool CheckPass(unsigned int pass) const;
+		void ComputeLifetimes();
+		void CullPasses();
+		unsigned int GetAttachmentKey(unsigned int texture) const;
+		bool Realize();
+		void SetupRenderTextures();
+
+		std::vector<Pass> m_passes;
+		std::vector<PhysicalTexture> m_pool;
+		std::vector<RenderTextureEntry> m_renderTextures;
+		std::vector<Texture> m_textures;
+		bool m_compiled;
+		bool m_realized;
+};
+
+#endif // NAZARA_RENDERGRAPH_HPP
@@ -8,11 +8,16 @@
 #define NAZARA_SCENE_HPP
 
 #include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Clock.hpp>
 #include <Nazara/Core/Color.hpp>
 #include <Nazara/Core/Updatable.hpp>
 #include <Nazara/Graphics/AbstractBackground.hpp>
 #include <Nazara/Graphics/AbstractRenderTechnique.hpp>
+#include <Nazara/Graphics/Enums.hpp>
+#include <Nazara/Graphics/SceneOctree.hpp>
+#include <Nazara/Math/Box.hpp>
 #include <Nazara/Math/Frustum.hpp>
+#include <Nazara/Math/Sphere.hpp>
 
 class NzAbstractRenderQueue;
 class NzAbstractViewer;
@@ -20,6 +25,7 @@ class NzCamera;
 class NzLight;
 class NzModel;
 class NzNode;
+class NzPortalSystem;
 class NzRenderQueue;
 class NzSceneNode;
 struct NzSceneImpl;
@@ -27,6 +33,7 @@ struct NzSceneImpl;
 class NAZARA_API NzScene
 {
 	friend NzCamera;
+	friend NzSceneNode;
 
 	public:
 		NzScene();
@@ -37,32 +44,56 @@ class NAZARA_API NzScene
 		void Cull();
 		void Draw();
 
+		void EnableParallelUpdate(bool parallel);
+
 		NzColor GetAmbientColor() const;
 		NzAbstractBackground* GetBackground() const;
+		NzPortalSystem* GetPortalSystem() const;
 		NzAbstractRenderTechnique* GetRenderTechnique() const;
 		NzSceneNode& GetRoot() const;
 		NzAbstractViewer* GetViewer() const;
+		float GetUpdateBudget() const;
+		unsigned int GetUpdateDeferredCount() const;
 		float GetUpdateTime() const;
 		unsigned int GetUpdatePerSecond() const;
+		unsigned int GetUpdateSliceCount() const;
+
+		bool IsParallelUpdateEnabled() const;
+
+		unsigned int QueryBox(const NzBoxf& box, NzSceneNode** results, unsigned int maxResults, nzUInt32 mask = 0xFFFFFFFF) const;
+		void QueryBoxes(const NzBoxf* boxes, unsigned int queryCount, NzSceneNode** results, unsigned int maxResultsPerQuery, unsigned int* resultCounts, nzUInt32 mask = 0xFFFFFFFF) const;
+		unsigned int QueryRay(const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzSceneQueryHit* hits, unsigned int maxHits, nzUInt32 mask = 0xFFFFFFFF) const;
+		void QueryRays(const NzVector3f* origins, const NzVector3f* directions, unsigned int queryCount, float maxDistance, NzSceneQueryHit* hits, unsigned int maxHitsPerQuery, unsigned int* hitCounts, nzUInt32 mask = 0xFFFFFFFF) const;
+		unsigned int QuerySphere(const NzSpheref& sphere, NzSceneNode** results, unsigned int maxResults, nzUInt32 mask = 0xFFFFFFFF) const;
+		void QuerySpheres(const NzSpheref* spheres, unsigned int queryCount, NzSceneNode** results, unsigned int maxResultsPerQuery, unsigned int* resultCounts, nzUInt32 mask = 0xFFFFFFFF) const;
 
-		void RegisterForUpdate(NzUpdatable* object);
+		void RegisterForUpdate(NzUpdatable* object, nzUpdateFrequency frequency = nzUpdateFrequency_Always, bool parallel = false);
 
 		void SetAmbientColor(const NzColor& color);
 		void SetBackground(NzAbstractBackground* background);
+		void SetClockFunction(NzClockFunction clockFunction);
+		void SetPortalSystem(NzPortalSystem* portalSystem);
 		void SetRenderTechnique(NzAbstractRenderTechnique* renderTechnique);
 		void SetViewer(NzAbstractViewer* viewer);
 		void SetViewer(NzAbstractViewer& viewer);
+		void SetUpdateBudget(float milliseconds);
+		void SetUpdateFrequency(NzUpdatable* object, nzUpdateFrequency frequency);
 		void SetUpdatePerSecond(unsigned int updatePerSecond);
+		void SetUpdateSliceCount(unsigned int sliceCount);
 
 		void UnregisterForUpdate(NzUpdatable* object);
 
 		void Update();
+		void UpdateSpatialIndex();
 		void UpdateVisible();
 
 		operator const NzSceneNode&() const;
 
 	private:
+		void AddToSpatialIndex(NzSceneNode* node);
+		void InvalidateSpatialIndex(NzSceneNode* node);
 		void RecursiveFrustumCull(NzAbstractRenderQueue* renderQueue, const NzFrustumf& frustum, NzNode* node);
+		void RemoveFromSpatialIndex(NzSceneNode* node);
 
 		NzSceneImpl* m_impl;
 };
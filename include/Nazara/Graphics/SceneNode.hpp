@@ -14,8 +14,11 @@
 #include <Nazara/Math/Frustum.hpp>
 #include <Nazara/Utility/Node.hpp>
 
+class NzPortalSystem;
+
 class NAZARA_API NzSceneNode : public NzNode
 {
+	friend class NzPortalSystem;
 	friend class NzScene;
 
 	public:
@@ -29,6 +32,7 @@ class NAZARA_API NzSceneNode : public NzNode
 
 		virtual const NzBoundingVolumef& GetBoundingVolume() const = 0;
 		nzNodeType GetNodeType() const final;
+		nzUInt32 GetQueryMask() const;
 		NzScene* GetScene() const;
 		virtual nzSceneNodeType GetSceneNodeType() const = 0;
 
@@ -36,10 +40,14 @@ class NAZARA_API NzSceneNode : public NzNode
 		bool IsDrawingEnabled() const;
 		bool IsVisible() const;
 
+		void SetQueryMask(nzUInt32 queryMask);
+
 		NzSceneNode& operator=(const NzSceneNode& sceneNode);
 		NzSceneNode& operator=(NzSceneNode&& sceneNode);
 
 	protected:
+		virtual void Invalidate() override;
+		void NotifyBoundingVolumeChange();
 		virtual void OnParenting(const NzNode* parent) override;
 		virtual void OnVisibilityChange(bool visibility);
 		virtual bool FrustumCull(const NzFrustumf& frustum) = 0;
@@ -50,11 +58,15 @@ class NAZARA_API NzSceneNode : public NzNode
 		virtual void Update();
 
 		NzScene* m_scene;
+		nzUInt32 m_queryMask;
 		bool m_drawingEnabled;
 		bool m_visible;
 
 	private:
-		void UpdateVisibility(const NzFrustumf& frustum);
+		void SetSpatialScene(NzScene* scene);
+		void UpdateVisibility(const NzFrustumf& frustum, bool occluded = false);
+
+		NzPortalSystem* m_portalSystem; // Système de portails où le noeud est enregistré, qui ne doit pas lui survivre
 };
 
 #endif // NAZARA_SCENENODE_HPP
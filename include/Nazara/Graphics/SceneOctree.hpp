@@ -0,0 +1,105 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_SCENEOCTREE_HPP
+#define NAZARA_SCENEOCTREE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Sphere.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <unordered_map>
+#include <vector>
+
+class NzSceneNode;
+
+struct NzSceneQueryHit
+{
+	NzSceneNode* node;
+	float distance; // Distance d'entrée du rayon dans la boîte englobante (nulle si l'origine y est)
+};
+
+// Octree "lâche" (chaque cellule accepte les objets débordant de la moitié de sa taille, et n'est
+// subdivisée qu'une fois assez peuplée), indexant les boîtes englobantes des noeuds de scène pour les requêtes spatiales :
+// - les noeuds invalidés (déplacés, modifiés) ne sont relus qu'au prochain Update, et ne changent
+//   de cellule que s'ils ne tiennent plus dans la leur
+// - la racine s'agrandit d'elle-même pour englober les noeuds qui en sortent
+// - les requêtes écrivent dans les buffers de l'appelant (sans allocation) et renvoient le nombre
+//   total de résultats, éventuellement supérieur au nombre de résultats écrits
+// - les noeuds de volume infini (lumières directionnelles, ...) restent indexés mais ne sont renvoyés par aucune requête
+// Les requêtes sont constantes et peuvent être lancées en parallèle tant que l'octree n'est pas modifié
+class NAZARA_API NzSceneOctree : NzNonCopyable
+{
+	public:
+		NzSceneOctree(float rootSize = 1024.f, unsigned int maxDepth = 8);
+		~NzSceneOctree();
+
+		void Clear();
+
+		unsigned int GetCellCount() const;
+		unsigned int GetDepth() const;
+		unsigned int GetNodeCount() const;
+		float GetRootSize() const;
+
+		bool HasNode(const NzSceneNode* node) const;
+		bool HasPendingUpdates() const;
+
+		void Insert(NzSceneNode* node);
+		void Invalidate(NzSceneNode* node);
+
+		unsigned int QueryBox(const NzBoxf& box, NzSceneNode** results, unsigned int maxResults, nzUInt32 mask = 0xFFFFFFFF) const;
+		unsigned int QueryRay(const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzSceneQueryHit* hits, unsigned int maxHits, nzUInt32 mask = 0xFFFFFFFF) const;
+		unsigned int QuerySphere(const NzSpheref& sphere, NzSceneNode** results, unsigned int maxResults, nzUInt32 mask = 0xFFFFFFFF) const;
+
+		void Remove(NzSceneNode* node);
+
+		void Update();
+
+	private:
+		struct Cell
+		{
+			NzVector3f center;
+			std::vector<unsigned int> entries;
+			float halfSize;
+			unsigned int children; // Index du premier des huit fils, zéro si la cellule est une feuille
+			unsigned int depth;
+			unsigned int parent;
+			unsigned int subtreeCount; // Nombre d'entrées dans la cellule et ses descendants
+		};
+
+		struct Entry
+		{
+			NzBoxf aabb;
+			NzSceneNode* node;
+			nzUInt32 mask;
+			unsigned int cell;
+			unsigned int slot; // Position dans la liste d'entrées de la cellule
+			bool dirty;
+		};
+
+		bool Fits(const Cell& cell, const NzBoxf& aabb) const;
+		void Grow(const NzBoxf& aabb);
+		void InsertEntry(unsigned int entryIndex);
+		void RemoveEntry(unsigned int entryIndex);
+		void Split(unsigned int cellIndex);
+		template<typename CellTest, typename EntryFunc> void Traverse(unsigned int cellIndex, const CellTest& cellTest, const EntryFunc& entryFunc) const;
+
+		static const unsigned int InfiniteCell = 0xFFFFFFFE;
+		static const unsigned int NoCell = 0xFFFFFFFF;
+
+		std::unordered_map<const NzSceneNode*, unsigned int> m_entryIndices;
+		std::vector<Cell> m_cells;
+		std::vector<Entry> m_entries;
+		std::vector<unsigned int> m_dirtyEntries;
+		std::vector<unsigned int> m_freeEntries;
+		std::vector<unsigned int> m_infiniteEntries;
+		float m_initialSize;
+		unsigned int m_initialDepth;
+		unsigned int m_maxDepth;
+};
+
+#endif // NAZARA_SCENEOCTREE_HPP
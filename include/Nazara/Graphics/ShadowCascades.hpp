@@ -0,0 +1,105 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_SHADOWCASCADES_HPP
+#define NAZARA_SHADOWCASCADES_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Graphics/ForwardRenderQueue.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Matrix4.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <memory>
+#include <vector>
+
+class NzAbstractViewer;
+class NzLight;
+class NzNode;
+class NzSceneNode;
+
+struct NzShadowCascade
+{
+	NzMatrix4f projectionMatrix;
+	NzMatrix4f viewMatrix;
+	NzMatrix4f viewProjMatrix;
+	NzVector3f center;  // Centre de la sphère englobant la tranche, aligné sur la grille des texels
+	float radius;
+	float splitFar;     // Distances à l'observateur délimitant la tranche du frustum
+	float splitNear;
+	float texelSize;    // Taille d'un texel de la shadow map, en unités du monde
+};
+
+// Partie CPU des shadow maps en cascade d'une lumière directionnelle :
+// - découpage du frustum de l'observateur et ajustement stable (rayon invariant par rotation, alignement sur les texels)
+// - culling des projeteurs en un seul parcours de la scène, les volumes étant étirés dans la direction de la lumière
+// - construction des files de rendu de chaque cascade, en parallèle via le NzTaskScheduler
+class NAZARA_API NzShadowCascades : NzNonCopyable
+{
+	public:
+		NzShadowCascades(unsigned int cascadeCount = 4, unsigned int resolution = 2048);
+		~NzShadowCascades();
+
+		void Clear();
+		void ComputeCascades(const NzAbstractViewer* viewer, const NzLight* light);
+		void ComputeCascades(const NzAbstractViewer* viewer, const NzVector3f& lightDirection);
+		void CullCasters(const NzNode& root);
+
+		void EnableParallelCulling(bool parallel);
+
+		unsigned int GetCandidateCount() const;
+		const NzShadowCascade& GetCascade(unsigned int cascade) const;
+		unsigned int GetCascadeCount() const;
+		const std::vector<const NzSceneNode*>& GetCasters(unsigned int cascade) const;
+		NzForwardRenderQueue* GetRenderQueue(unsigned int cascade) const;
+		unsigned int GetResolution() const;
+		float GetShadowDistance() const;
+		float GetSplitLambda() const;
+
+		bool IsParallelCullingEnabled() const;
+
+		void SetCascadeCount(unsigned int cascadeCount);
+		void SetResolution(unsigned int resolution);
+		void SetShadowDistance(float distance);
+		void SetSplitLambda(float lambda);
+
+	private:
+		struct Candidate
+		{
+			NzBoxf aabb;
+			const NzSceneNode* node;
+		};
+
+		struct Cascade
+		{
+			NzShadowCascade cascade;
+			std::unique_ptr<NzForwardRenderQueue> renderQueue;
+			std::vector<const NzSceneNode*> casters;
+			float casterDepth; // Profondeur minimale des projeteurs, relativement au centre
+		};
+
+		struct CullResult
+		{
+			std::vector<std::vector<const NzSceneNode*>> casters;
+			std::vector<float> casterDepths;
+		};
+
+		void CollectCandidates(const NzNode* node);
+		void CullRange(unsigned int first, unsigned int count, CullResult* result) const;
+		void UpdateMatrices(Cascade& cascade) const;
+
+		std::vector<Candidate> m_candidates;
+		std::vector<Cascade> m_cascades;
+		NzVector3f m_lightDirection;
+		NzVector3f m_lightRight;
+		NzVector3f m_lightUp;
+		bool m_parallelCulling;
+		float m_shadowDistance;
+		float m_splitLambda;
+		unsigned int m_resolution;
+};
+
+#endif // NAZARA_SHADOWCASCADES_HPP
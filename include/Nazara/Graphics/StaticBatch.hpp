@@ -0,0 +1,92 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_STATICBATCH_HPP
+#define NAZARA_STATICBATCH_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Graphics/SceneNode.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Renderer/Material.hpp>
+#include <Nazara/Utility/Enums.hpp>
+#include <Nazara/Utility/Mesh.hpp>
+#include <vector>
+
+class NzModel;
+class NzStaticMesh;
+
+struct NzStaticBatchStats
+{
+	unsigned int batchCount;         // Nombre de sous-meshs fusionnés (un appel de rendu chacun)
+	unsigned int chunkCount;
+	unsigned int modelCount;         // Nombre de modèles absorbés
+	unsigned int sourceSubMeshCount; // Nombre de sous-meshs d'origine (un appel de rendu chacun auparavant)
+	unsigned int triangleCount;
+	unsigned int vertexCount;
+	unsigned int visibleBatchCount;  // Au dernier test de visibilité
+};
+
+// Fusionne les modèles statiques d'une hiérarchie en un buffer de sommets et d'indices par matériau et par chunk,
+// les sommets étant transformés une fois pour toutes dans le repère global
+// Le découpage en chunks (grille régulière) permet de conserver un test de visibilité efficace
+class NAZARA_API NzStaticBatch : public NzSceneNode
+{
+	public:
+		NzStaticBatch(float chunkSize = 64.f);
+		~NzStaticBatch();
+
+		void AddToRenderQueue(NzAbstractRenderQueue* renderQueue) const override;
+
+		bool Build(NzNode* root, nzBufferStorage storage = nzBufferStorage_Hardware, bool disableSources = true);
+
+		void Clear();
+
+		const NzBoxf& GetBatchAABB(unsigned int batch) const;
+		unsigned int GetBatchChunk(unsigned int batch) const;
+		unsigned int GetBatchCount() const;
+		const NzMaterial* GetBatchMaterial(unsigned int batch) const;
+		NzStaticMesh* GetBatchMesh(unsigned int batch) const;
+		const NzBoundingVolumef& GetBoundingVolume() const override;
+		const NzBoxf& GetChunkAABB(unsigned int chunk) const;
+		unsigned int GetChunkCount() const;
+		float GetChunkSize() const;
+		nzSceneNodeType GetSceneNodeType() const override;
+		const std::vector<NzModel*>& GetSourceModels() const;
+		const NzStaticBatchStats& GetStats() const;
+
+		bool IsChunkVisible(unsigned int chunk) const;
+		bool IsDrawable() const override;
+
+		void SetChunkSize(float chunkSize);
+
+	private:
+		struct Batch
+		{
+			NzBoxf aabb;
+			NzMaterialConstRef material;
+			NzStaticMesh* subMesh; // Possédé par m_mesh
+			unsigned int chunk;
+		};
+
+		struct Chunk
+		{
+			NzBoxf aabb;
+			std::vector<unsigned int> batches;
+			bool visible;
+		};
+
+		bool FrustumCull(const NzFrustumf& frustum) override;
+
+		std::vector<Batch> m_batches;
+		std::vector<Chunk> m_chunks;
+		std::vector<NzModel*> m_sourceModels;
+		NzBoundingVolumef m_boundingVolume;
+		NzMesh m_mesh;
+		NzStaticBatchStats m_stats;
+		float m_chunkSize;
+};
+
+#endif // NAZARA_STATICBATCH_HPP
@@ -0,0 +1,109 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_TEXTURERESIDENCY_HPP
+#define NAZARA_TEXTURERESIDENCY_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <vector>
+
+// Ordonnancement (purement CPU) des niveaux de mipmap résidents d'un ensemble de textures :
+// - chaque frame, les niveaux requis sont signalés (RequestLevel) avec une priorité
+// - Schedule décide des chargements à lancer, des envois au GPU (dans la limite d'un budget par frame)
+//   et des évictions (dans la limite d'un budget mémoire, les textures inutilisées depuis le plus longtemps en premier)
+// Le niveau 0 est le plus détaillé, une texture évincée retombe sur son niveau de base, toujours disponible
+class NAZARA_API NzTextureResidency
+{
+	public:
+		struct Action
+		{
+			unsigned int texture;
+			nzUInt8 level;
+		};
+
+		NzTextureResidency(nzUInt64 memoryBudget = NAZARA_GRAPHICS_TEXTURESTREAMING_MEMORY_BUDGET, nzUInt64 uploadBudget = NAZARA_GRAPHICS_TEXTURESTREAMING_UPLOAD_BUDGET);
+		~NzTextureResidency();
+
+		unsigned int AddTexture(unsigned int width, unsigned int height, nzUInt8 bytesPerPixel, nzUInt8 levelCount, nzUInt8 baseLevel);
+
+		void BeginFrame();
+
+		void Clear();
+
+		nzUInt8 GetAvailableLevel(unsigned int texture) const;
+		nzUInt8 GetBaseLevel(unsigned int texture) const;
+		unsigned int GetEvictionCount() const;
+		unsigned int GetEvictionDelay() const;
+		unsigned int GetFrame() const;
+		nzUInt8 GetLevelCount(unsigned int texture) const;
+		unsigned int GetMaxPendingLoads() const;
+		nzUInt64 GetMemoryBudget() const;
+		unsigned int GetPendingLoadCount() const;
+		nzUInt8 GetRequestedLevel(unsigned int texture) const;
+		nzUInt8 GetResidentLevel(unsigned int texture) const;
+		nzUInt64 GetResidentMemory() const;
+		unsigned int GetStarvingCount() const;
+		unsigned int GetTextureCount() const;
+		nzUInt64 GetUploadBudget() const;
+		nzUInt64 GetUploadedBytes() const;
+
+		bool IsLoading(unsigned int texture) const;
+		bool IsRequested(unsigned int texture) const;
+		bool IsValid(unsigned int texture) const;
+
+		void RemoveTexture(unsigned int texture);
+		void RequestLevel(unsigned int texture, nzUInt8 level, float priority);
+
+		void Schedule(std::vector<Action>* loads, std::vector<Action>* uploads, std::vector<Action>* evictions);
+
+		void SetAvailableLevel(unsigned int texture, nzUInt8 level);
+		void SetEvictionDelay(unsigned int frameCount);
+		void SetLoadFailed(unsigned int texture);
+		void SetMaxPendingLoads(unsigned int loadCount);
+		void SetMemoryBudget(nzUInt64 budget);
+		void SetUploadBudget(nzUInt64 budget);
+
+		static nzUInt64 ComputeLevelSize(unsigned int width, unsigned int height, nzUInt8 bytesPerPixel, nzUInt8 level);
+		static nzUInt64 ComputeMemory(unsigned int width, unsigned int height, nzUInt8 bytesPerPixel, nzUInt8 firstLevel, nzUInt8 levelCount);
+
+	private:
+		struct Texture
+		{
+			unsigned int height;
+			unsigned int lastRequestFrame;
+			unsigned int width;
+			float priority;
+			bool failed;
+			bool loading;
+			bool valid;
+			nzUInt8 availableLevel; // Premier niveau dont les pixels sont disponibles côté CPU
+			nzUInt8 baseLevel;
+			nzUInt8 bytesPerPixel;
+			nzUInt8 levelCount;
+			nzUInt8 requestedLevel;
+			nzUInt8 residentLevel;
+		};
+
+		bool Evict(std::vector<unsigned int>& victims, unsigned int* victimIndex, std::vector<Action>* evictions);
+		nzUInt64 GetMemory(const Texture& texture, nzUInt8 level) const;
+		float GetWeight(const Texture& texture) const;
+
+		std::vector<Texture> m_textures;
+		std::vector<unsigned int> m_freeTextures;
+		nzUInt64 m_memoryBudget;
+		nzUInt64 m_residentMemory;
+		nzUInt64 m_uploadBudget;
+		nzUInt64 m_uploadedBytes;
+		unsigned int m_evictionCount;
+		unsigned int m_evictionDelay;
+		unsigned int m_frame;
+		unsigned int m_maxPendingLoads;
+		unsigned int m_pendingLoadCount;
+		unsigned int m_starvingCount;
+};
+
+#endif // NAZARA_TEXTURERESIDENCY_HPP
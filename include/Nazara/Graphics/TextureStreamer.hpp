@@ -0,0 +1,101 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_TEXTURESTREAMER_HPP
+#define NAZARA_TEXTURESTREAMER_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Core/String.hpp>
+#include <Nazara/Graphics/TextureResidency.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Matrix4.hpp>
+#include <Nazara/Renderer/Texture.hpp>
+#include <Nazara/Utility/Image.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class NzAbstractViewer;
+class NzMaterial;
+class NzNode;
+class NzStaticMesh;
+class NzSubMesh;
+
+struct NzTextureStreamerStats
+{
+	nzUInt64 residentMemory;       // Mémoire occupée par les niveaux résidents des textures diffusées
+	nzUInt64 uploadedBytes;        // Au cours de la dernière frame
+	unsigned int evictionCount;    // Depuis la création
+	unsigned int loadCount;        // Chargements terminés depuis la création
+	unsigned int pendingLoadCount;
+	unsigned int starvingCount;    // Textures affichées avec moins de détails que requis à la dernière frame
+	unsigned int textureCount;
+	unsigned int uploadCount;      // Au cours de la dernière frame
+};
+
+// Diffusion des textures : seuls les niveaux de mipmap peu détaillés sont gardés en permanence,
+// les niveaux plus détaillés sont chargés en arrière-plan (via le NzTaskScheduler) selon la taille à l'écran
+// des modèles visibles et la densité de leurs coordonnées de texture, puis envoyés au GPU dans la limite
+// d'un budget par frame et évincés lorsque le budget mémoire est atteint
+class NAZARA_API NzTextureStreamer : NzNonCopyable
+{
+	public:
+		NzTextureStreamer();
+		~NzTextureStreamer();
+
+		void Clear();
+
+		float GetLevelBias() const;
+		NzTextureResidency& GetResidency();
+		const NzTextureResidency& GetResidency() const;
+		const NzTextureStreamerStats& GetStats() const;
+
+		bool IsStreamed(const NzTexture* texture) const;
+
+		bool Register(NzTexture* texture, const NzString& filePath, const NzImageParams& params = NzImageParams());
+
+		void SetLevelBias(float bias);
+
+		void Unregister(NzTexture* texture);
+		void Update(const NzAbstractViewer* viewer, const NzNode& root);
+
+		static nzUInt8 ComputeRequiredLevel(unsigned int textureSize, float uvDensity, float worldPerPixel, float bias = 0.f);
+		static float ComputeUVDensity(const NzStaticMesh* subMesh);
+		static float ComputeWorldPerPixel(const NzMatrix4f& projectionMatrix, unsigned int viewportHeight, float distance);
+
+	private:
+		struct LoadQueue;
+
+		struct Texture
+		{
+			NzImage base;                  // Niveau de base, gardé en permanence
+			NzString filePath;
+			NzTextureRef texture;
+			NzImageParams params;
+			std::unique_ptr<NzImage> detail; // Chaîne de mipmaps complète, le temps de l'envoi
+			unsigned int serial;
+			unsigned int size;             // Plus grande dimension du niveau 0
+		};
+
+		void CollectRequests(const NzNode* node, const NzMatrix4f& projectionMatrix, const NzVector3f& eyePosition, unsigned int viewportHeight, float zNear);
+		void RequestSubMesh(const NzMaterial* material, const NzSubMesh* subMesh, const NzBoxf& aabb, float scale, const NzMatrix4f& projectionMatrix, const NzVector3f& eyePosition, unsigned int viewportHeight, float zNear);
+		bool UploadLevel(Texture& texture, nzUInt8 level);
+
+		std::shared_ptr<LoadQueue> m_loadQueue;
+		std::unordered_map<const NzTexture*, unsigned int> m_textureIndices;
+		std::unordered_map<const NzSubMesh*, float> m_uvDensities;
+		std::vector<NzTextureResidency::Action> m_evictions;
+		std::vector<NzTextureResidency::Action> m_loads;
+		std::vector<NzTextureResidency::Action> m_uploads;
+		std::vector<Texture> m_textures;
+		NzTextureResidency m_residency;
+		NzTextureStreamerStats m_stats;
+		float m_levelBias;
+		unsigned int m_serial;
+};
+
+#endif // NAZARA_TEXTURESTREAMER_HPP
@@ -0,0 +1,62 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_TRANSFORMBATCH_HPP
+#define NAZARA_TRANSFORMBATCH_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Graphics/Enums.hpp>
+#include <Nazara/Math/Matrix4.hpp>
+#include <Nazara/Math/Quaternion.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <vector>
+
+struct NzCompactTransform
+{
+	NzQuaternionf rotation;
+	NzVector3f scale;
+	NzVector3f translation;
+};
+
+// Calcule en une passe les matrices dérivées de tous les objets visibles, plutôt qu'objet par objet lors du rendu
+// Les matrices sont stockées de façon contiguë (16 flottants) pour permettre un traitement SIMD
+class NAZARA_API NzTransformBatch
+{
+	public:
+		NzTransformBatch(nzUInt32 flags = nzTransformBatch_Default);
+		~NzTransformBatch() = default;
+
+		unsigned int AddTransform(const NzMatrix4f& worldMatrix);
+
+		void Clear();
+
+		void Compute(const NzMatrix4f& viewMatrix, const NzMatrix4f& projectionMatrix);
+		void Compute(const NzMatrix4f& viewMatrix, const NzMatrix4f& projectionMatrix, unsigned int firstTransform, unsigned int transformCount);
+
+		const float* GetCompact3x4Matrix(unsigned int index) const;
+		const NzCompactTransform& GetCompactTransform(unsigned int index) const;
+		nzUInt32 GetFlags() const;
+		NzMatrix4f GetNormalMatrix(unsigned int index) const;
+		unsigned int GetTransformCount() const;
+		NzMatrix4f GetWorldMatrix(unsigned int index) const;
+		NzMatrix4f GetWorldViewMatrix(unsigned int index) const;
+		NzMatrix4f GetWorldViewProjMatrix(unsigned int index) const;
+
+		void Reserve(unsigned int transformCount);
+
+		void SetFlags(nzUInt32 flags);
+
+	private:
+		std::vector<NzCompactTransform> m_compactTransforms;
+		std::vector<float> m_compact3x4Matrices;
+		std::vector<float> m_normalMatrices;
+		std::vector<float> m_worldMatrices;
+		std::vector<float> m_worldViewMatrices;
+		std::vector<float> m_worldViewProjMatrices;
+		nzUInt32 m_flags;
+};
+
+#endif // NAZARA_TRANSFORMBATCH_HPP
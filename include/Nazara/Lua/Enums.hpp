@@ -16,6 +16,15 @@ enum nzLuaComparison
 	nzLuaComparison_Max = nzLuaComparison_LessOrEqual
 };
 
+enum nzLuaGCMode
+{
+	nzLuaGCMode_Generational,
+	nzLuaGCMode_Incremental,
+	nzLuaGCMode_Manual, // Le collecteur n'avance que lors des appels à StepGarbageCollector/CollectGarbage
+
+	nzLuaGCMode_Max = nzLuaGCMode_Manual
+};
+
 enum nzLuaOperation
 {
 	nzLuaOperation_Addition,
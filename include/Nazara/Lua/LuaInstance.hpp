@@ -23,12 +23,31 @@ class NzLuaInstance;
 using NzLuaCFunction = int (*)(lua_State* state);
 using NzLuaFunction = int (*)(NzLuaInstance& instance);
 
+struct NzLuaGCStats
+{
+	nzInt64 heapGrowth;         // Variation de la mémoire utilisée depuis la fin du dernier cycle
+	nzUInt64 allocatedBytes;
+	nzUInt64 collectedBytes;    // Octets libérés pendant les collectes explicites
+	nzUInt64 freedBytes;
+	nzUInt64 lastPauseTime;     // En microsecondes
+	nzUInt64 maxPauseTime;      // En microsecondes
+	nzUInt64 totalPauseTime;    // En microsecondes
+	nzUInt32 cycleCount;
+	nzUInt32 memoryUsageAfterCycle;
+	nzUInt32 peakMemoryUsage;
+	nzUInt32 stepCount;
+};
+
 class NAZARA_API NzLuaInstance : NzNonCopyable
 {
+	friend class NzLuaScheduler;
+
 	public:
 		NzLuaInstance();
 		~NzLuaInstance();
 
+		bool Call(unsigned int argCount, unsigned int resultCount = 0);
+
 		void CheckAny(int index) const;
 		int CheckInteger(int index) const;
 		int CheckInteger(int index, int defValue) const;
@@ -44,6 +63,8 @@ class NAZARA_API NzLuaInstance : NzNonCopyable
 		void* CheckUserdata(int index, const char* tname) const;
 		void* CheckUserdata(int index, const NzString& tname) const;
 
+		void CollectGarbage();
+
 		bool Compare(int index1, int index2, nzLuaComparison comparison) const;
 		void Compute(nzLuaOperation operation);
 
@@ -58,6 +79,8 @@ class NAZARA_API NzLuaInstance : NzNonCopyable
 		bool ExecuteFromStream(NzInputStream& stream);
 
 		int GetAbsIndex(int index) const;
+		nzLuaGCMode GetGCMode() const;
+		NzLuaGCStats GetGCStats() const;
 		void GetField(const char* fieldName, int index = -1) const;
 		void GetField(const NzString& fieldName, int index = -1) const;
 		void GetGlobal(const char* name) const;
@@ -110,9 +133,12 @@ class NAZARA_API NzLuaInstance : NzNonCopyable
 
 		void Remove(int index);
 		void Replace(int index);
+		void ResetGCStats();
 
 		void SetField(const char* name, int index = -2);
 		void SetField(const NzString& name, int index = -2);
+		void SetGCMode(nzLuaGCMode mode);
+		void SetGCParameters(int pause, int stepMultiplier);
 		void SetGlobal(const char* name);
 		void SetGlobal(const NzString& name);
 		void SetMetatable(const char* tname);
@@ -122,6 +148,8 @@ class NAZARA_API NzLuaInstance : NzNonCopyable
 		void SetTable(int index = -3);
 		void SetTimeLimit(nzUInt32 timeLimit);
 
+		bool StepGarbageCollector(nzUInt32 timeBudget, unsigned int maxSteps = 0);
+
 		bool ToBoolean(int index) const;
 		int ToInteger(int index, bool* succeeded = nullptr) const;
 		double ToNumber(int index, bool* succeeded = nullptr) const;
@@ -141,6 +169,8 @@ class NAZARA_API NzLuaInstance : NzNonCopyable
 		static int ProxyFunc(lua_State* state);
 		static void TimeLimiter(lua_State* state, lua_Debug* debug);
 
+		nzLuaGCMode m_gcMode;
+		NzLuaGCStats m_gcStats;
 		nzUInt32 m_memoryLimit;
 		nzUInt32 m_memoryUsage;
 		nzUInt32 m_timeLimit;
@@ -0,0 +1,119 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Lua scripting module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_LUASCHEDULER_HPP
+#define NAZARA_LUASCHEDULER_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Core/String.hpp>
+#include <functional>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+struct lua_Debug;
+struct lua_State;
+
+class NzLuaInstance;
+
+// Ordonnanceur de tâches scriptées basé sur les coroutines Lua
+// Une tâche s'endort en appelant une des fonctions de la table "Scheduler" (Wait, WaitFrames, WaitEvent, Yield),
+// elle n'est ensuite plus visitée avant que sa condition de réveil ne soit remplie.
+class NAZARA_API NzLuaScheduler : NzNonCopyable
+{
+	public:
+		NzLuaScheduler(NzLuaInstance& instance);
+		~NzLuaScheduler();
+
+		void Clear();
+
+		unsigned int GetFrameCount() const;
+		unsigned int GetInstructionBudget() const;
+		NzLuaInstance& GetInstance() const;
+		unsigned int GetJobCount() const;
+		NzString GetLastError() const;
+		unsigned int GetReadyJobCount() const;
+		double GetTime() const;
+
+		bool IsJobAlive(unsigned int jobId) const;
+
+		void Kill(unsigned int jobId);
+
+		void SetInstructionBudget(unsigned int budget);
+		void Signal(const NzString& event);
+
+		unsigned int Start(int argCount = 0);
+		unsigned int Start(const NzString& code);
+
+		unsigned int Update(float elapsedTime);
+
+	private:
+		enum WaitType
+		{
+			WaitType_Event,
+			WaitType_Frame,
+			WaitType_None,
+			WaitType_Time
+		};
+
+		struct Job
+		{
+			NzString event;
+			lua_State* thread;
+			WaitType waitType;
+			int argCount;
+			int reference;
+			unsigned int serial;
+			unsigned int instructionCount;
+			bool killed;
+		};
+
+		struct Wakeup
+		{
+			bool operator>(const Wakeup& wakeup) const;
+
+			nzUInt64 date;
+			nzUInt64 order;
+			unsigned int jobId;
+			unsigned int serial;
+		};
+
+		using WakeupQueue = std::priority_queue<Wakeup, std::vector<Wakeup>, std::greater<Wakeup>>;
+
+		void ApplyHook(lua_State* thread) const;
+		Job* GetRunningJob(lua_State* state, const char* function);
+		void MakeReady(unsigned int jobId, unsigned int serial);
+		void ReleaseJob(unsigned int jobId);
+		void Resume(unsigned int jobId);
+		void Suspend(Job& job, WaitType waitType);
+
+		static void InstructionLimiter(lua_State* state, lua_Debug* debug);
+		static NzLuaScheduler* GetScheduler(lua_State* state);
+		static int LuaSignal(lua_State* state);
+		static int LuaWait(lua_State* state);
+		static int LuaWaitEvent(lua_State* state);
+		static int LuaWaitFrames(lua_State* state);
+		static int LuaYield(lua_State* state);
+
+		std::map<NzString, std::vector<std::pair<unsigned int, unsigned int>>> m_eventWaiters;
+		std::unordered_map<unsigned int, Job> m_jobs;
+		std::vector<std::pair<unsigned int, unsigned int>> m_readyJobs;
+		std::vector<std::pair<unsigned int, unsigned int>> m_resumedJobs;
+		NzLuaInstance& m_instance;
+		NzString m_lastError;
+		WakeupQueue m_frameWakeups;
+		WakeupQueue m_timeWakeups;
+		nzUInt64 m_frameCount;
+		nzUInt64 m_time;
+		nzUInt64 m_wakeupOrder;
+		unsigned int m_instructionBudget;
+		unsigned int m_nextJobId;
+		unsigned int m_runningJob;
+};
+
+#endif // NAZARA_LUASCHEDULER_HPP
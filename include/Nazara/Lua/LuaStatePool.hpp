@@ -0,0 +1,97 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Lua scripting module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_LUASTATEPOOL_HPP
+#define NAZARA_LUASTATEPOOL_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/FunctionRef.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Core/String.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+
+struct lua_State;
+
+class NzLuaInstance;
+
+struct NzLuaMessage
+{
+	NzString data;
+	NzString name;
+	double value;
+	unsigned int source; // NzLuaStatePool::Engine si le message vient du moteur
+	unsigned int target; // NzLuaStatePool::Engine pour un effet à appliquer par le moteur
+};
+
+// Ensemble d'états Lua identiques se partageant la mise à jour des entités scriptées via le NzTaskScheduler
+// Chaque entité est rattachée à un état fixe, les scripts ne communiquent qu'au travers de messages (table "Pool")
+// et lisent les données du moteur via une copie en lecture seule (table "Shared").
+class NAZARA_API NzLuaStatePool : NzNonCopyable
+{
+	public:
+		NzLuaStatePool() = default;
+		~NzLuaStatePool();
+
+		bool Create(unsigned int stateCount = 0);
+		bool Create(unsigned int stateCount, NzFunctionRef<bool(NzLuaInstance& instance)> initializer);
+		void Destroy();
+
+		bool Execute(const NzString& code);
+		bool ExecuteFromFile(const NzString& filePath);
+
+		const std::vector<NzLuaMessage>& GetEffects() const;
+		NzString GetLastError() const;
+		NzLuaInstance& GetState(unsigned int index) const;
+		unsigned int GetStateCount() const;
+		unsigned int GetStateIndex(unsigned int entityId) const;
+
+		bool IsValid() const;
+
+		void Post(unsigned int target, const NzString& name, const NzString& data = NzString(), double value = 0.0);
+
+		void RemoveEntity(unsigned int entityId);
+
+		void SetShared(const NzString& name, double value);
+		void SetShared(const NzString& name, const NzString& value);
+
+		bool Update(const NzString& functionName, const unsigned int* entities, unsigned int entityCount, float elapsedTime);
+
+		static const unsigned int Engine = 0xFFFFFFFF;
+
+	private:
+		struct SharedValue
+		{
+			NzString string;
+			double number;
+			bool isString;
+		};
+
+		struct State;
+
+		void MergeMessages();
+		void UpdateShared(State& state);
+		void UpdateState(unsigned int index);
+
+		static State* GetPoolState(lua_State* state);
+		static int LuaEmit(lua_State* state);
+		static int LuaGetEntity(lua_State* state);
+		static int LuaReadOnly(lua_State* state);
+		static int LuaReceive(lua_State* state);
+		static int LuaSend(lua_State* state);
+
+		std::map<NzString, SharedValue> m_shared;
+		std::vector<std::unique_ptr<State>> m_states;
+		std::vector<NzLuaMessage> m_effects;
+		std::vector<NzLuaMessage> m_messages;
+		NzString m_functionName;
+		NzString m_lastError;
+		float m_elapsedTime = 0.f;
+		unsigned int m_sharedVersion = 0;
+};
+
+#endif // NAZARA_LUASTATEPOOL_HPP
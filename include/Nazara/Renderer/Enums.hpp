@@ -250,6 +250,21 @@ enum nzShaderUniform
 	nzShaderUniform_Max = nzShaderUniform_WorldViewProjMatrix
 };
 
+enum nzShaderUniformType
+{
+	nzShaderUniformType_Float,
+	nzShaderUniformType_Integer,
+	nzShaderUniformType_Matrix4f,
+	nzShaderUniformType_Vector2f,
+	nzShaderUniformType_Vector2i,
+	nzShaderUniformType_Vector3f,
+	nzShaderUniformType_Vector3i,
+	nzShaderUniformType_Vector4f,
+	nzShaderUniformType_Vector4i,
+
+	nzShaderUniformType_Max = nzShaderUniformType_Vector4i
+};
+
 enum nzShaderType
 {
 	nzShaderType_Fragment,
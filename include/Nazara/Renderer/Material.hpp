@@ -18,6 +18,7 @@
 #include <Nazara/Renderer/ShaderProgram.hpp>
 #include <Nazara/Renderer/Texture.hpp>
 #include <Nazara/Renderer/TextureSampler.hpp>
+#include <vector>
 
 struct NAZARA_API NzMaterialParams
 {
@@ -27,6 +28,7 @@ struct NAZARA_API NzMaterialParams
 	bool loadHeightMap = true;
 	bool loadNormalMap = true;
 	bool loadSpecularMap = true;
+	bool shareTextures = true; // Les textures chargées depuis un fichier sont partagées via NzMaterialRegistry
 
 	bool IsValid() const;
 };
@@ -50,6 +52,8 @@ class NAZARA_API NzMaterial : public NzResource
 
 		void Apply(const NzShaderProgram* program) const;
 
+		nzUInt64 ComputeHash() const;
+
 		void Enable(nzRendererParameter renderParameter, bool enable);
 		void EnableAlphaTest(bool alphaTest);
 		void EnableLighting(bool lighting);
@@ -87,6 +91,7 @@ class NAZARA_API NzMaterial : public NzResource
 
 		bool IsAlphaTestEnabled() const;
 		bool IsEnabled(nzRendererParameter renderParameter) const;
+		bool IsEquivalent(const NzMaterial& material) const;
 		bool IsLightingEnabled() const;
 
 		bool LoadFromFile(const NzString& filePath, const NzMaterialParams& params = NzMaterialParams());
@@ -134,6 +139,7 @@ class NAZARA_API NzMaterial : public NzResource
 			bool custom = false;
 		};
 
+		void BuildKey(std::vector<nzUInt32>* key) const;
 		void Copy(const NzMaterial& material);
 		void GenerateProgram(nzShaderTarget target, nzUInt32 flags) const;
 		void InvalidatePrograms(nzShaderTarget target);
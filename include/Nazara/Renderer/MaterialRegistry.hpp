@@ -0,0 +1,39 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_MATERIALREGISTRY_HPP
+#define NAZARA_MATERIALREGISTRY_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/String.hpp>
+#include <Nazara/Renderer/Material.hpp>
+#include <Nazara/Renderer/Texture.hpp>
+
+// Registre des matériaux et des textures partagés : les matériaux de contenu identique (voir NzMaterial::IsEquivalent)
+// sont fusionnés afin que les files de rendu, qui regroupent par matériau, puissent les regrouper
+class NAZARA_API NzMaterialRegistry
+{
+	public:
+		NzMaterialRegistry() = delete;
+		~NzMaterialRegistry() = delete;
+
+		static void Clear();
+
+		static NzMaterial* Find(const NzMaterial& material);
+
+		static unsigned int GetMaterialCount();
+		static unsigned int GetMergeCount();
+		// La texture retournée est partagée entre tous ses utilisateurs et ne doit donc pas être modifiée
+		static NzTexture* GetTexture(const NzString& filePath);
+		static unsigned int GetTextureCount();
+
+		static unsigned int Purge();
+
+		// Le matériau retourné est partagé entre tous ses utilisateurs et ne doit donc pas être modifié (voir NzModel::EditMaterial)
+		static NzMaterial* Register(NzMaterial* material);
+};
+
+#endif // NAZARA_MATERIALREGISTRY_HPP
@@ -44,8 +44,9 @@ enum nzOpenGLExtension
 	nzOpenGLExtension_TextureCompression_s3tc,
 	nzOpenGLExtension_TextureStorage,
 	nzOpenGLExtension_VertexArrayObjects,
+	nzOpenGLExtension_VertexAttribBinding,
 
-	nzOpenGLExtension_Max = nzOpenGLExtension_VertexArrayObjects
+	nzOpenGLExtension_Max = nzOpenGLExtension_VertexAttribBinding
 };
 
 class NzContext;
@@ -164,6 +165,7 @@ NAZARA_API extern PFNGLBINDRENDERBUFFERPROC         glBindRenderbuffer;
 NAZARA_API extern PFNGLBINDSAMPLERPROC              glBindSampler;
 NAZARA_API extern PFNGLBINDTEXTUREPROC              glBindTexture;
 NAZARA_API extern PFNGLBINDVERTEXARRAYPROC          glBindVertexArray;
+NAZARA_API extern PFNGLBINDVERTEXBUFFERPROC         glBindVertexBuffer;
 NAZARA_API extern PFNGLBLENDFUNCPROC                glBlendFunc;
 NAZARA_API extern PFNGLBLENDFUNCSEPARATEPROC        glBlendFuncSeparate;
 NAZARA_API extern PFNGLBUFFERDATAPROC               glBufferData;
@@ -313,8 +315,11 @@ NAZARA_API extern PFNGLUNIFORMMATRIX4FVPROC         glUniformMatrix4fv;
 NAZARA_API extern PFNGLUNMAPBUFFERPROC              glUnmapBuffer;
 NAZARA_API extern PFNGLUSEPROGRAMPROC               glUseProgram;
 NAZARA_API extern PFNGLVERTEXATTRIB4FPROC           glVertexAttrib4f;
+NAZARA_API extern PFNGLVERTEXATTRIBBINDINGPROC      glVertexAttribBinding;
 NAZARA_API extern PFNGLVERTEXATTRIBDIVISORPROC      glVertexAttribDivisor;
+NAZARA_API extern PFNGLVERTEXATTRIBFORMATPROC       glVertexAttribFormat;
 NAZARA_API extern PFNGLVERTEXATTRIBPOINTERPROC      glVertexAttribPointer;
+NAZARA_API extern PFNGLVERTEXBINDINGDIVISORPROC     glVertexBindingDivisor;
 NAZARA_API extern PFNGLVIEWPORTPROC                 glViewport;
 #if defined(NAZARA_PLATFORM_WINDOWS)
 NAZARA_API extern PFNWGLCHOOSEPIXELFORMATARBPROC    wglChoosePixelFormat;
@@ -0,0 +1,139 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_RENDERCOMMANDLIST_HPP
+#define NAZARA_RENDERCOMMANDLIST_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/FunctionRef.hpp>
+#include <Nazara/Math/Matrix4.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <Nazara/Math/Vector4.hpp>
+#include <Nazara/Renderer/Enums.hpp>
+#include <Nazara/Renderer/RenderStates.hpp>
+#include <Nazara/Renderer/TextureSampler.hpp>
+#include <Nazara/Utility/Enums.hpp>
+#include <vector>
+
+class NzIndexBuffer;
+class NzRenderDevice;
+class NzShaderProgram;
+class NzTexture;
+class NzVertexBuffer;
+
+struct NzRenderCommandStats
+{
+	unsigned int drawCount = 0;
+	unsigned int indexBufferChanges = 0;
+	unsigned int matrixChanges = 0;
+	unsigned int programChanges = 0;
+	unsigned int renderStatesChanges = 0;
+	unsigned int skippedChanges = 0; // Changements redondants éliminés lors du rejeu
+	unsigned int textureChanges = 0;
+	unsigned int uniformChanges = 0;
+	unsigned int vertexBufferChanges = 0;
+};
+
+// Enregistre des appels de rendu sans toucher au contexte, une liste peut donc être remplie depuis n'importe quel thread
+// Chaque commande de dessin capture l'état courant de la liste (buffers, états, matrices, textures, uniformes)
+// Les ressources référencées doivent rester valides jusqu'au rejeu (Submit), qui doit se faire depuis le thread de rendu
+class NAZARA_API NzRenderCommandList
+{
+	public:
+		NzRenderCommandList();
+		~NzRenderCommandList() = default;
+
+		void Clear();
+
+		void DrawIndexedPrimitives(nzPrimitiveMode mode, unsigned int firstIndex, unsigned int indexCount);
+		void DrawPrimitives(nzPrimitiveMode mode, unsigned int firstVertex, unsigned int vertexCount);
+
+		unsigned int GetCommandCount() const;
+		unsigned int GetMemoryUsage() const;
+
+		bool IsEmpty() const;
+
+		void Reserve(unsigned int commandCount);
+
+		void SetIndexBuffer(const NzIndexBuffer* indexBuffer);
+		void SetMatrix(nzMatrixType type, const NzMatrix4f& matrix);
+		void SetRenderStates(const NzRenderStates& states);
+		void SetShaderProgram(const NzShaderProgram* program);
+		void SetTexture(nzUInt8 unit, const NzTexture* texture, const NzTextureSampler& sampler = NzTextureSampler());
+		void SetUniform(int location, float value);
+		void SetUniform(int location, int value);
+		void SetUniform(int location, const NzMatrix4f& matrix);
+		void SetUniform(int location, const NzVector2f& vector);
+		void SetUniform(int location, const NzVector2i& vector);
+		void SetUniform(int location, const NzVector3f& vector);
+		void SetUniform(int location, const NzVector3i& vector);
+		void SetUniform(int location, const NzVector4f& vector);
+		void SetUniform(int location, const NzVector4i& vector);
+		void SetVertexBuffer(const NzVertexBuffer* vertexBuffer);
+
+		NzRenderCommandStats Submit(NzRenderDevice* device = nullptr) const;
+
+		static void Record(NzRenderCommandList* lists, unsigned int count, NzFunctionRef<void(NzRenderCommandList&, unsigned int)> recorder);
+		static NzRenderCommandStats Submit(const NzRenderCommandList* lists, unsigned int count, NzRenderDevice* device = nullptr);
+
+	private:
+		struct Command
+		{
+			const NzIndexBuffer* indexBuffer;
+			const NzShaderProgram* program;
+			const NzVertexBuffer* vertexBuffer;
+			nzPrimitiveMode primitiveMode;
+			unsigned int first;
+			unsigned int count;
+			unsigned int matrices[nzMatrixType_World+1]; // Index dans m_matrices
+			unsigned int states; // Index dans m_states
+			unsigned int textureCount;
+			unsigned int textureFirst;
+			unsigned int uniformCount;
+			unsigned int uniformFirst;
+			bool indexed;
+		};
+
+		struct TextureBinding
+		{
+			NzTextureSampler sampler;
+			const NzTexture* texture;
+			nzUInt8 unit;
+		};
+
+		struct UniformBinding
+		{
+			int location;
+			nzShaderUniformType type;
+			unsigned int offset; // Dans m_uniformData
+		};
+
+		void PushDraw(bool indexed, nzPrimitiveMode mode, unsigned int first, unsigned int count);
+		void PushUniform(int location, nzShaderUniformType type, const void* value, unsigned int size);
+
+		std::vector<Command> m_commands;
+		std::vector<NzMatrix4f> m_matrices;
+		std::vector<NzRenderStates> m_states;
+		std::vector<TextureBinding> m_currentTextures;
+		std::vector<TextureBinding> m_textures;
+		std::vector<UniformBinding> m_currentUniforms;
+		std::vector<UniformBinding> m_uniforms;
+		std::vector<nzUInt8> m_uniformData;
+		const NzIndexBuffer* m_indexBuffer;
+		const NzShaderProgram* m_program;
+		const NzVertexBuffer* m_vertexBuffer;
+		unsigned int m_matrixIndices[nzMatrixType_World+1];
+		unsigned int m_statesIndex;
+		unsigned int m_textureCount;
+		unsigned int m_textureFirst;
+		unsigned int m_uniformCount;
+		unsigned int m_uniformFirst;
+		bool m_texturesUpdated;
+		bool m_uniformsUpdated;
+};
+
+#endif // NAZARA_RENDERCOMMANDLIST_HPP
@@ -0,0 +1,42 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_RENDERDEVICE_HPP
+#define NAZARA_RENDERDEVICE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Math/Matrix4.hpp>
+#include <Nazara/Renderer/Enums.hpp>
+#include <Nazara/Renderer/RenderStates.hpp>
+#include <Nazara/Renderer/TextureSampler.hpp>
+#include <Nazara/Utility/Enums.hpp>
+
+class NzIndexBuffer;
+class NzShaderProgram;
+class NzTexture;
+class NzVertexBuffer;
+
+// Interface entre les listes de commandes et le renderer (NzRenderer en temps normal)
+// Une implémentation factice permet de vérifier le rejeu des commandes sans contexte OpenGL
+class NAZARA_API NzRenderDevice
+{
+	public:
+		NzRenderDevice() = default;
+		virtual ~NzRenderDevice();
+
+		virtual void DrawIndexedPrimitives(nzPrimitiveMode mode, unsigned int firstIndex, unsigned int indexCount) = 0;
+		virtual void DrawPrimitives(nzPrimitiveMode mode, unsigned int firstVertex, unsigned int vertexCount) = 0;
+
+		virtual void SetIndexBuffer(const NzIndexBuffer* indexBuffer) = 0;
+		virtual void SetMatrix(nzMatrixType type, const NzMatrix4f& matrix) = 0;
+		virtual void SetRenderStates(const NzRenderStates& states) = 0;
+		virtual void SetShaderProgram(const NzShaderProgram* program) = 0;
+		virtual void SetTexture(nzUInt8 unit, const NzTexture* texture, const NzTextureSampler& sampler) = 0;
+		virtual void SetUniform(const NzShaderProgram* program, int location, nzShaderUniformType type, const void* value) = 0;
+		virtual void SetVertexBuffer(const NzVertexBuffer* vertexBuffer) = 0;
+};
+
+#endif // NAZARA_RENDERDEVICE_HPP
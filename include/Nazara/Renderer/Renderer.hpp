@@ -100,6 +100,7 @@ class NAZARA_API NzRenderer
 		static void SetTextureSampler(nzUInt8 textureUnit, const NzTextureSampler& sampler);
 		static void SetVertexBuffer(const NzVertexBuffer* vertexBuffer);
 		static void SetViewport(const NzRecti& viewport);
+		static void SetWorldMatrices(const NzMatrix4f& world, const NzMatrix4f& worldView, const NzMatrix4f& worldViewProj);
 
 		static void Uninitialize();
 
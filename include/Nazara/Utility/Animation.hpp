@@ -44,6 +44,7 @@ class NAZARA_API NzAnimation : public NzResource
 
 		bool AddSequence(const NzSequence& sequence);
 		void AnimateSkeleton(NzSkeleton* targetSkeleton, unsigned int frameA, unsigned int frameB, float interpolation) const;
+		void AnimateSkeleton(NzSkeleton* targetSkeleton, unsigned int frameA, unsigned int frameB, float interpolation, const unsigned int* indices, unsigned int indiceCount) const;
 
 		bool CreateSkeletal(unsigned int frameCount, unsigned int jointCount);
 		void Destroy();
@@ -35,6 +35,9 @@
 // Utilise un tracker pour repérer les éventuels leaks (Ralentit l'exécution)
 #define NAZARA_UTILITY_MEMORYLEAKTRACKER 0
 
+// La construction des BVH doit-elle être répartie entre plusieurs threads ? (Accélère la construction sur les gros meshs)
+#define NAZARA_UTILITY_MULTITHREADED_BVH 0 ///FIXME: Bug du TaskScheduler
+
 // Le skinning doit-il prendre avantage du multi-threading ? (Boost de performances sur les processeurs multi-coeurs)
 #define NAZARA_UTILITY_MULTITHREADED_SKINNING 0 ///FIXME: Bug du TaskScheduler
 
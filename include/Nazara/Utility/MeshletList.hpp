@@ -0,0 +1,62 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Utility module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_MESHLETLIST_HPP
+#define NAZARA_MESHLETLIST_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Math/Frustum.hpp>
+#include <Nazara/Math/Sphere.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <vector>
+
+class NzStaticMesh;
+
+struct NzMeshlet
+{
+	NzSpheref boundingSphere;
+	NzVector3f coneAxis;
+	float coneCutoff; // Sinus de l'ouverture du cône de normales, 1 si le cluster ne peut pas être éliminé par son orientation
+	unsigned int firstIndex;
+	unsigned int triangleCount;
+	unsigned int vertexCount;
+};
+
+struct NzMeshletDrawRange
+{
+	unsigned int firstIndex;
+	unsigned int indexCount;
+};
+
+class NAZARA_API NzMeshletList
+{
+	public:
+		NzMeshletList() = default;
+		~NzMeshletList() = default;
+
+		bool Build(const NzStaticMesh* staticMesh, unsigned int maxVertices = 64, unsigned int maxTriangles = 124);
+		bool Build(const NzVector3f* positions, unsigned int vertexCount, const nzUInt32* indices, unsigned int indexCount, unsigned int maxVertices = 64, unsigned int maxTriangles = 124);
+
+		void Clear();
+
+		unsigned int Cull(const NzFrustumf& frustum, const NzVector3f& eyePosition, unsigned int* visibleMeshlets) const;
+
+		unsigned int GenerateDrawRanges(const unsigned int* meshlets, unsigned int meshletCount, NzMeshletDrawRange* ranges) const;
+		unsigned int GenerateIndices(const unsigned int* meshlets, unsigned int meshletCount, nzUInt32* indices) const;
+
+		const nzUInt32* GetIndices() const;
+		unsigned int GetIndexCount() const;
+		const NzMeshlet& GetMeshlet(unsigned int i) const;
+		unsigned int GetMeshletCount() const;
+
+		bool IsEmpty() const;
+
+	private:
+		std::vector<NzMeshlet> m_meshlets;
+		std::vector<nzUInt32> m_indices;
+};
+
+#endif // NAZARA_MESHLETLIST_HPP
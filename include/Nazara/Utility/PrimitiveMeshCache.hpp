@@ -0,0 +1,35 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Utility module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_PRIMITIVEMESHCACHE_HPP
+#define NAZARA_PRIMITIVEMESHCACHE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Primitive.hpp>
+#include <Nazara/Utility/Mesh.hpp>
+
+class NAZARA_API NzPrimitiveMeshCache
+{
+	friend class NzUtility;
+
+	public:
+		NzPrimitiveMeshCache() = delete;
+		~NzPrimitiveMeshCache() = delete;
+
+		static void Clear();
+
+		// Le mesh retourné est partagé entre tous ses utilisateurs et ne doit donc pas être modifié
+		static NzMesh* Get(const NzPrimitive& primitive, const NzMeshParams& params = NzMeshParams());
+		static unsigned int GetMeshCount();
+
+		static unsigned int Purge();
+
+	private:
+		static bool Initialize();
+		static void Uninitialize();
+};
+
+#endif // NAZARA_PRIMITIVEMESHCACHE_HPP
@@ -10,6 +10,7 @@
 #include <Nazara/Prerequesites.hpp>
 #include <Nazara/Core/ResourceListener.hpp>
 #include <Nazara/Utility/SubMesh.hpp>
+#include <Nazara/Utility/TriangleBVH.hpp>
 
 class NzStaticMesh;
 
@@ -26,9 +27,11 @@ class NAZARA_API NzStaticMesh final : public NzSubMesh, NzResourceListener
 		void Destroy();
 
 		bool GenerateAABB();
+		bool GenerateBVH();
 
 		const NzBoxf& GetAABB() const override;
 		nzAnimationType GetAnimationType() const final;
+		const NzTriangleBVH* GetBVH() const;
 		const NzIndexBuffer* GetIndexBuffer() const override;
 		NzVertexBuffer* GetVertexBuffer();
 		const NzVertexBuffer* GetVertexBuffer() const;
@@ -37,6 +40,8 @@ class NAZARA_API NzStaticMesh final : public NzSubMesh, NzResourceListener
 		bool IsAnimated() const final;
 		bool IsValid() const;
 
+		void InvalidateBVH();
+
 		void SetAABB(const NzBoxf& aabb);
 		void SetIndexBuffer(const NzIndexBuffer* indexBuffer);
 
@@ -44,6 +49,7 @@ class NAZARA_API NzStaticMesh final : public NzSubMesh, NzResourceListener
 		void OnResourceReleased(const NzResource* resource, int index) override;
 
 		NzBoxf m_aabb;
+		NzTriangleBVH* m_bvh = nullptr;
 		NzIndexBufferConstRef m_indexBuffer = nullptr;
 		NzVertexBufferRef m_vertexBuffer = nullptr;
 };
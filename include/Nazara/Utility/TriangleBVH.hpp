@@ -0,0 +1,79 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Utility module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_TRIANGLEBVH_HPP
+#define NAZARA_TRIANGLEBVH_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <vector>
+
+class NzSubMesh;
+
+struct NzTriangleBVHHit
+{
+	float distance;
+	float u; // Coordonnées barycentriques du point d'impact
+	float v;
+	unsigned int triangleIndex; // NzTriangleBVH::InvalidTriangle si le rayon n'a rien touché
+};
+
+class NAZARA_API NzTriangleBVH
+{
+	public:
+		NzTriangleBVH() = default;
+		NzTriangleBVH(const NzTriangleBVH& bvh) = default;
+		NzTriangleBVH(NzTriangleBVH&& bvh) = default;
+		~NzTriangleBVH() = default;
+
+		bool Build(NzSubMesh* subMesh);
+		bool Build(const NzVector3f* positions, unsigned int vertexCount, const nzUInt32* indices, unsigned int triangleCount);
+		void Destroy();
+
+		bool GetClosestPoint(const NzVector3f& point, float maxDistance, NzVector3f* closestPoint, unsigned int* triangleIndex = nullptr) const;
+		NzBoxf GetAABB() const;
+		unsigned int GetDepth() const;
+		unsigned int GetNodeCount() const;
+		unsigned int GetTriangleCount() const;
+
+		bool IsValid() const;
+
+		bool Raycast(const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzTriangleBVHHit* hit) const;
+		bool RaycastAny(const NzVector3f& origin, const NzVector3f& direction, float maxDistance) const;
+		unsigned int RaycastPacket(const NzVector3f* origins, const NzVector3f* directions, unsigned int rayCount, float maxDistance, NzTriangleBVHHit* hits) const;
+
+		NzTriangleBVH& operator=(const NzTriangleBVH& bvh) = default;
+		NzTriangleBVH& operator=(NzTriangleBVH&& bvh) = default;
+
+		static const unsigned int InvalidTriangle = 0xFFFFFFFF;
+
+		struct Node
+		{
+			float min[3];
+			nzUInt32 offset; // Feuille: premier triangle, noeud interne: index du fils gauche (le droit le suit)
+			float max[3];
+			nzUInt32 triangleCount; // Zéro pour un noeud interne
+		};
+
+		struct Triangle
+		{
+			NzVector3f vertex;
+			NzVector3f edge1;
+			NzVector3f edge2;
+			unsigned int index;
+		};
+
+	private:
+		void BuildHierarchy();
+		template<bool AnyHit> bool Traverse(const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzTriangleBVHHit* hit) const;
+
+		std::vector<Node> m_nodes;
+		std::vector<Triangle> m_triangles;
+		unsigned int m_depth = 0;
+};
+
+#endif // NAZARA_TRIANGLEBVH_HPP
@@ -8,6 +8,8 @@
 #include <Nazara/Core/Log.hpp>
 #include <Nazara/Audio/Config.hpp>
 #include <Nazara/Audio/Enums.hpp>
+#include <Nazara/Audio/OpenALDevice.hpp>
+#include <Nazara/Audio/VoiceManager.hpp>
 #include <Nazara/Audio/Loaders/sndfile.hpp>
 #include <AL/al.h>
 #include <AL/alc.h>
@@ -18,6 +20,7 @@ namespace
 	ALenum formats[nzAudioFormat_Max+1] = {0};
 	ALCdevice* device = nullptr;
 	ALCcontext* context = nullptr;
+	NzOpenALDevice openALDevice;
 }
 
 nzAudioFormat NzAudio::GetAudioFormat(unsigned int channelCount)
@@ -162,6 +165,15 @@ bool NzAudio::Initialize()
 	formats[nzAudioFormat_6_1]    = alGetEnumValue("AL_FORMAT_61CHN16");
 	formats[nzAudioFormat_7_1]    = alGetEnumValue("AL_FORMAT_71CHN16");
 
+	// Le gestionnaire de voix se réserve les sources réelles
+	if (!NzVoiceManager::Initialize(&openALDevice))
+	{
+		NazaraError("Failed to initialize voice manager");
+		Uninitialize();
+
+		return false;
+	}
+
 	// Loaders
 	NzLoaders_sndfile_Register();
 
@@ -271,6 +283,8 @@ void NzAudio::Uninitialize()
 	// Loaders
 	NzLoaders_sndfile_Unregister();
 
+	NzVoiceManager::Uninitialize();
+
 	// Libération d'OpenAL
 	if (device)
 	{
@@ -291,6 +305,14 @@ void NzAudio::Uninitialize()
 	NzCore::Uninitialize();
 }
 
+void NzAudio::Update()
+{
+	///DOC: À appeler une fois par frame, après avoir déplacé l'écouteur et les émetteurs :
+	///     les voix terminées y rendent leur source et les voix virtuelles les plus audibles en reçoivent une.
+	///     Sans cela, le gestionnaire de voix n'est mis à jour qu'à la lecture d'un son (au plus toutes les NAZARA_AUDIO_VOICE_UPDATE_INTERVAL ms)
+	NzVoiceManager::Update();
+}
+
 unsigned int NzAudio::GetOpenALFormat(nzAudioFormat format)
 {
 	#ifdef NAZARA_DEBUG
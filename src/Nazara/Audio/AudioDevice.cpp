@@ -0,0 +1,8 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Audio module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Audio/AudioDevice.hpp>
+#include <Nazara/Audio/Debug.hpp>
+
+NzAudioDevice::~NzAudioDevice() = default;
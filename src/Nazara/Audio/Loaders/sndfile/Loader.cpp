@@ -88,8 +88,6 @@ namespace
 
 	bool Load(NzSoundBuffer* soundBuffer, NzInputStream& stream, const NzSoundBufferParams& parameters)
 	{
-		NazaraUnused(parameters);
-
 		SF_INFO infos;
 		SNDFILE* file = sf_open_virtual(&callbacks, SFM_READ, &infos, &stream);
 		if (!file)
@@ -124,7 +122,7 @@ namespace
 			return false;
 		}
 
-		if (!soundBuffer->Create(format, static_cast<unsigned int>(sampleCount), infos.samplerate, samples.get()))
+		if (!soundBuffer->Create(format, static_cast<unsigned int>(sampleCount), infos.samplerate, samples.get(), parameters.storage))
 		{
 			sf_close(file);
 			NazaraError("Failed to create sound buffer");
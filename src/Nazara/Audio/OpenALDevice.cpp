@@ -0,0 +1,141 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Audio module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+// http://connect.creativelabs.com/openal/Documentation/OpenAL_Programmers_Guide.pdf
+
+#include <Nazara/Audio/OpenALDevice.hpp>
+#include <Nazara/Audio/Audio.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <AL/al.h>
+#include <Nazara/Audio/Debug.hpp>
+
+unsigned int NzOpenALDevice::CreateBuffer(nzAudioFormat format, const nzInt16* samples, unsigned int sampleCount, unsigned int sampleRate)
+{
+	// On vide le stack d'erreurs
+	while (alGetError() != AL_NO_ERROR);
+
+	ALuint buffer;
+	alGenBuffers(1, &buffer);
+
+	if (alGetError() != AL_NO_ERROR)
+	{
+		NazaraError("Failed to create OpenAL buffer");
+		return 0;
+	}
+
+	alBufferData(buffer, NzAudio::GetOpenALFormat(format), samples, sampleCount*sizeof(nzInt16), sampleRate);
+
+	if (alGetError() != AL_NO_ERROR)
+	{
+		NazaraError("Failed to set OpenAL buffer");
+		alDeleteBuffers(1, &buffer);
+
+		return 0;
+	}
+
+	return buffer;
+}
+
+unsigned int NzOpenALDevice::CreateSource()
+{
+	alGetError(); // On ignore les erreurs précédentes
+
+	ALuint source;
+	alGenSources(1, &source);
+
+	// La limite de sources du périphérique est atteinte
+	if (alGetError() != AL_NO_ERROR)
+		return 0;
+
+	return source;
+}
+
+void NzOpenALDevice::DestroyBuffer(unsigned int buffer)
+{
+	ALuint handle = buffer;
+	alDeleteBuffers(1, &handle);
+}
+
+void NzOpenALDevice::DestroySource(unsigned int source)
+{
+	ALuint handle = source;
+	alDeleteSources(1, &handle);
+}
+
+NzVector3f NzOpenALDevice::GetListenerPosition() const
+{
+	NzVector3f position;
+	alGetListenerfv(AL_POSITION, position);
+
+	return position;
+}
+
+nzUInt32 NzOpenALDevice::GetSourceOffset(unsigned int source) const
+{
+	ALfloat seconds = 0.f;
+	alGetSourcef(source, AL_SEC_OFFSET, &seconds);
+
+	return static_cast<nzUInt32>(seconds*1000);
+}
+
+nzSoundStatus NzOpenALDevice::GetSourceStatus(unsigned int source) const
+{
+	ALint state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	switch (state)
+	{
+		case AL_INITIAL:
+		case AL_STOPPED:
+			return nzSoundStatus_Stopped;
+
+		case AL_PAUSED:
+			return nzSoundStatus_Paused;
+
+		case AL_PLAYING:
+			return nzSoundStatus_Playing;
+
+		default:
+			NazaraInternalError("Source state unrecognized");
+	}
+
+	return nzSoundStatus_Stopped;
+}
+
+void NzOpenALDevice::PauseSource(unsigned int source)
+{
+	alSourcePause(source);
+}
+
+void NzOpenALDevice::PlaySource(unsigned int source)
+{
+	alSourcePlay(source);
+}
+
+void NzOpenALDevice::SetSourceBuffer(unsigned int source, unsigned int buffer)
+{
+	alSourcei(source, AL_BUFFER, (buffer != 0) ? buffer : AL_NONE);
+}
+
+void NzOpenALDevice::SetSourceOffset(unsigned int source, nzUInt32 offset)
+{
+	alSourcef(source, AL_SEC_OFFSET, offset/1000.f);
+}
+
+void NzOpenALDevice::SetSourceParameters(unsigned int source, const NzAudioSourceParameters& parameters)
+{
+	alSourcef(source, AL_GAIN, parameters.volume*0.01f);
+	alSourcef(source, AL_PITCH, parameters.pitch);
+	alSourcef(source, AL_REFERENCE_DISTANCE, parameters.minDistance);
+	alSourcef(source, AL_ROLLOFF_FACTOR, parameters.attenuation);
+	alSourcefv(source, AL_POSITION, parameters.position);
+	alSourcefv(source, AL_VELOCITY, parameters.velocity);
+	alSourcei(source, AL_LOOPING, parameters.looping);
+	alSourcei(source, AL_SOURCE_RELATIVE, parameters.spatialized);
+}
+
+void NzOpenALDevice::StopSource(unsigned int source)
+{
+	alSourceStop(source);
+}
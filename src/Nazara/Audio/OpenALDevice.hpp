@@ -0,0 +1,38 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Audio module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_OPENALDEVICE_HPP
+#define NAZARA_OPENALDEVICE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Audio/AudioDevice.hpp>
+
+class NzOpenALDevice : public NzAudioDevice
+{
+	public:
+		NzOpenALDevice() = default;
+		~NzOpenALDevice() = default;
+
+		unsigned int CreateBuffer(nzAudioFormat format, const nzInt16* samples, unsigned int sampleCount, unsigned int sampleRate);
+		unsigned int CreateSource();
+		void DestroyBuffer(unsigned int buffer);
+		void DestroySource(unsigned int source);
+
+		NzVector3f GetListenerPosition() const;
+		nzUInt32 GetSourceOffset(unsigned int source) const;
+		nzSoundStatus GetSourceStatus(unsigned int source) const;
+
+		void PauseSource(unsigned int source);
+		void PlaySource(unsigned int source);
+
+		void SetSourceBuffer(unsigned int source, unsigned int buffer);
+		void SetSourceOffset(unsigned int source, nzUInt32 offset);
+		void SetSourceParameters(unsigned int source, const NzAudioSourceParameters& parameters);
+
+		void StopSource(unsigned int source);
+};
+
+#endif // NAZARA_OPENALDEVICE_HPP
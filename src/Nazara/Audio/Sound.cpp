@@ -8,7 +8,6 @@
 #include <Nazara/Core/Error.hpp>
 #include <cstring>
 #include <stdexcept>
-#include <AL/al.h>
 #include <Nazara/Audio/Debug.hpp>
 
 NzSound::NzSound(const NzSoundBuffer* soundBuffer)
@@ -25,11 +24,14 @@ NzSoundEmitter(sound)
 NzSound::~NzSound()
 {
 	Stop();
+
+	if (m_buffer)
+		m_buffer->ReleaseBuffer(this);
 }
 
 void NzSound::EnableLooping(bool loop)
 {
-	alSourcei(m_source, AL_LOOPING, loop);
+	SetInternalLooping(loop);
 }
 
 const NzSoundBuffer* NzSound::GetBuffer() const
@@ -52,10 +54,7 @@ nzUInt32 NzSound::GetDuration() const
 
 nzUInt32 NzSound::GetPlayingOffset() const
 {
-	ALfloat seconds = -1.f;
-	alGetSourcef(m_source, AL_SEC_OFFSET, &seconds);
-
-	return static_cast<nzUInt32>(seconds*1000);
+	return GetInternalOffset();
 }
 
 nzSoundStatus NzSound::GetStatus() const
@@ -65,10 +64,7 @@ nzSoundStatus NzSound::GetStatus() const
 
 bool NzSound::IsLooping() const
 {
-	ALint loop;
-	alGetSourcei(m_source, AL_LOOPING, &loop);
-
-	return loop != AL_FALSE;
+	return m_parameters.looping;
 }
 
 bool NzSound::LoadFromFile(const NzString& filePath, const NzSoundBufferParams& params)
@@ -127,7 +123,7 @@ bool NzSound::LoadFromStream(NzInputStream& stream, const NzSoundBufferParams& p
 
 void NzSound::Pause()
 {
-	alSourcePause(m_source);
+	InternalPause();
 }
 
 bool NzSound::Play()
@@ -140,7 +136,21 @@ bool NzSound::Play()
 	}
 	#endif
 
-	alSourcePlay(m_source);
+	// Les buffers compressés ne sont décodés qu'au moment de la lecture, et peuvent avoir été évincés du cache depuis
+	if (m_buffer->GetStorage() != nzSoundBufferStorage_PCM)
+	{
+		unsigned int buffer = m_buffer->AcquireBuffer(this);
+		if (buffer == 0)
+		{
+			NazaraError("Failed to acquire sound buffer");
+			return false;
+		}
+
+		if (buffer != GetInternalBuffer())
+			SetInternalBuffer(buffer);
+	}
+
+	InternalPlay();
 
 	return true;
 }
@@ -152,20 +162,24 @@ void NzSound::SetBuffer(const NzSoundBuffer* buffer)
 
 	Stop();
 
+	if (m_buffer)
+		m_buffer->ReleaseBuffer(this);
+
 	m_buffer = buffer;
 
-	if (m_buffer)
-		alSourcei(m_source, AL_BUFFER, m_buffer->GetOpenALBuffer());
+	// Un buffer compressé n'est acquis qu'au Play
+	if (m_buffer && m_buffer->GetStorage() == nzSoundBufferStorage_PCM)
+		SetInternalBuffer(m_buffer->AcquireBuffer(this));
 	else
-		alSourcei(m_source, AL_BUFFER, AL_NONE);
+		SetInternalBuffer(0);
 }
 
 void NzSound::SetPlayingOffset(nzUInt32 offset)
 {
-	alSourcef(m_source, AL_SEC_OFFSET, offset/1000.f);
+	SetInternalOffset(offset);
 }
 
 void NzSound::Stop()
 {
-	alSourceStop(m_source);
+	InternalStop();
 }
@@ -5,29 +5,262 @@
 #include <Nazara/Audio/SoundBuffer.hpp>
 #include <Nazara/Audio/Audio.hpp>
 #include <Nazara/Audio/Config.hpp>
+#include <Nazara/Audio/Sound.hpp>
+#include <Nazara/Audio/VoiceManager.hpp>
+#include <Nazara/Core/Clock.hpp>
 #include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/File.hpp>
+#include <algorithm>
 #include <cstring>
+#include <memory>
 #include <stdexcept>
-#include <AL/al.h>
 #include <Nazara/Audio/Debug.hpp>
 
 ///FIXME: Adapter la création
 
 bool NzSoundBufferParams::IsValid() const
 {
+	#ifdef NAZARA_DEBUG
+	if (storage > nzSoundBufferStorage_Max)
+	{
+		NazaraError("Storage mode out of enum");
+		return false;
+	}
+	#endif
+
 	return true;
 }
 
 struct NzSoundBufferImpl
 {
-	ALuint buffer;
+	std::vector<nzUInt8> data; // Blocs ADPCM ou fichier encodé selon le mode de conservation
+	std::vector<NzSound*> users;
+	NzSoundBufferImpl* next = nullptr; // Liste LRU du cache (les plus récents en tête)
+	NzSoundBufferImpl* previous = nullptr;
 	nzAudioFormat format;
+	nzSoundBufferStorage storage;
 	nzUInt32 duration;
-	nzInt16* samples;
+	nzInt16* samples = nullptr;
+	unsigned int buffer = 0;
 	unsigned int sampleCount;
 	unsigned int sampleRate;
+	bool cached = false;
+	bool metadataKnown;
 };
 
+namespace
+{
+	// IMA ADPCM par blocs : chaque bloc repart d'un échantillon exact, ce qui borne l'accumulation d'erreurs
+	// En-tête de bloc par canal : prédicteur (16 bits), index du pas (8 bits) et un octet de remplissage
+	// Suivent les codes de quatre bits, entrelacés comme les échantillons (poids faible en premier)
+	const unsigned int adpcmBlockFrames = 2048;
+	const unsigned int adpcmHeaderSize = 4;
+
+	const int adpcmIndexTable[16] =
+	{
+		-1, -1, -1, -1, 2, 4, 6, 8,
+		-1, -1, -1, -1, 2, 4, 6, 8
+	};
+
+	const int adpcmStepTable[89] =
+	{
+		7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+		50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+		253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+		1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+		3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+		11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+	};
+
+	struct AdpcmState
+	{
+		int index = 0;
+		int predictor = 0;
+	};
+
+	// Commune à l'encodeur et au décodeur, qui restent ainsi parfaitement synchronisés
+	nzInt16 AdpcmApply(AdpcmState& state, unsigned int code)
+	{
+		int step = adpcmStepTable[state.index];
+		int delta = step >> 3;
+		if (code & 4)
+			delta += step;
+
+		if (code & 2)
+			delta += step >> 1;
+
+		if (code & 1)
+			delta += step >> 2;
+
+		state.predictor = (code & 8) ? state.predictor - delta : state.predictor + delta;
+		state.predictor = std::max(-32768, std::min(state.predictor, 32767));
+		state.index = std::max(0, std::min(state.index + adpcmIndexTable[code], 88));
+
+		return static_cast<nzInt16>(state.predictor);
+	}
+
+	unsigned int AdpcmEncodeSample(AdpcmState& state, nzInt16 sample)
+	{
+		int diff = sample - state.predictor;
+		int step = adpcmStepTable[state.index];
+
+		unsigned int code = 0;
+		if (diff < 0)
+		{
+			code = 8;
+			diff = -diff;
+		}
+
+		if (diff >= step)
+		{
+			code |= 4;
+			diff -= step;
+		}
+
+		step >>= 1;
+		if (diff >= step)
+		{
+			code |= 2;
+			diff -= step;
+		}
+
+		step >>= 1;
+		if (diff >= step)
+			code |= 1;
+
+		AdpcmApply(state, code);
+
+		return code;
+	}
+
+	unsigned int AdpcmGetBlockSize(unsigned int channelCount, unsigned int frameCount)
+	{
+		return channelCount*adpcmHeaderSize + (frameCount*channelCount + 1)/2;
+	}
+
+	void AdpcmEncode(const nzInt16* samples, unsigned int sampleCount, unsigned int channelCount, std::vector<nzUInt8>& data)
+	{
+		unsigned int frameCount = sampleCount/channelCount;
+		unsigned int fullBlocks = frameCount/adpcmBlockFrames;
+		unsigned int lastFrames = frameCount%adpcmBlockFrames;
+
+		data.clear();
+		data.resize(fullBlocks*AdpcmGetBlockSize(channelCount, adpcmBlockFrames) + ((lastFrames > 0) ? AdpcmGetBlockSize(channelCount, lastFrames) : 0), 0);
+
+		std::unique_ptr<AdpcmState[]> states(new AdpcmState[channelCount]);
+
+		nzUInt8* ptr = data.data();
+		for (unsigned int firstFrame = 0; firstFrame < frameCount; firstFrame += adpcmBlockFrames)
+		{
+			unsigned int blockFrames = std::min(adpcmBlockFrames, frameCount - firstFrame);
+			const nzInt16* blockSamples = &samples[firstFrame*channelCount];
+
+			for (unsigned int c = 0; c < channelCount; ++c)
+			{
+				// Le bloc repart de la valeur exacte de son premier échantillon
+				states[c].predictor = blockSamples[c];
+
+				nzUInt16 predictor = static_cast<nzUInt16>(states[c].predictor);
+				*ptr++ = static_cast<nzUInt8>(predictor & 0xFF);
+				*ptr++ = static_cast<nzUInt8>(predictor >> 8);
+				*ptr++ = static_cast<nzUInt8>(states[c].index);
+				*ptr++ = 0;
+			}
+
+			unsigned int codeCount = blockFrames*channelCount;
+			for (unsigned int i = 0; i < codeCount; ++i)
+			{
+				unsigned int code = AdpcmEncodeSample(states[i%channelCount], blockSamples[i]);
+				ptr[i/2] |= (i & 1) ? (code << 4) : code;
+			}
+
+			ptr += (codeCount + 1)/2;
+		}
+	}
+
+	void AdpcmDecode(const nzUInt8* data, unsigned int sampleCount, unsigned int channelCount, nzInt16* samples)
+	{
+		unsigned int frameCount = sampleCount/channelCount;
+
+		std::unique_ptr<AdpcmState[]> states(new AdpcmState[channelCount]);
+
+		for (unsigned int firstFrame = 0; firstFrame < frameCount; firstFrame += adpcmBlockFrames)
+		{
+			unsigned int blockFrames = std::min(adpcmBlockFrames, frameCount - firstFrame);
+			nzInt16* blockSamples = &samples[firstFrame*channelCount];
+
+			for (unsigned int c = 0; c < channelCount; ++c)
+			{
+				states[c].predictor = static_cast<nzInt16>(data[0] | (data[1] << 8));
+				states[c].index = std::min<int>(data[2], 88);
+				data += adpcmHeaderSize;
+			}
+
+			unsigned int codeCount = blockFrames*channelCount;
+			for (unsigned int i = 0; i < codeCount; ++i)
+			{
+				unsigned int code = (i & 1) ? (data[i/2] >> 4) : (data[i/2] & 0x0F);
+				blockSamples[i] = AdpcmApply(states[i%channelCount], code);
+			}
+
+			data += (codeCount + 1)/2;
+		}
+	}
+
+	// Cache des échantillons décodés des buffers compressés
+	NzSoundBufferImpl* s_cacheHead = nullptr;
+	NzSoundBufferImpl* s_cacheTail = nullptr;
+	NzSoundCacheStats s_cacheStats;
+	nzUInt64 s_cacheBudget = NAZARA_AUDIO_PCMCACHE_BUDGET;
+	nzUInt64 s_cacheUsage = 0;
+
+	nzUInt64 GetDecodedSize(const NzSoundBufferImpl* impl)
+	{
+		return impl->sampleCount*sizeof(nzInt16);
+	}
+
+	bool IsInUse(const NzSoundBufferImpl* impl)
+	{
+		// Un son en pause ou joué virtuellement reprendra sa lecture, son buffer doit rester disponible
+		for (const NzSound* user : impl->users)
+		{
+			if (user->GetStatus() != nzSoundStatus_Stopped)
+				return true;
+		}
+
+		return false;
+	}
+
+	void LinkFront(NzSoundBufferImpl* impl)
+	{
+		impl->previous = nullptr;
+		impl->next = s_cacheHead;
+
+		if (s_cacheHead)
+			s_cacheHead->previous = impl;
+		else
+			s_cacheTail = impl;
+
+		s_cacheHead = impl;
+	}
+
+	void Unlink(NzSoundBufferImpl* impl)
+	{
+		if (impl->previous)
+			impl->previous->next = impl->next;
+		else
+			s_cacheHead = impl->next;
+
+		if (impl->next)
+			impl->next->previous = impl->previous;
+		else
+			s_cacheTail = impl->previous;
+
+		impl->next = nullptr;
+		impl->previous = nullptr;
+	}
+}
+
 NzSoundBuffer::NzSoundBuffer(nzAudioFormat format, unsigned int sampleCount, unsigned int sampleRate, const nzInt16* samples)
 {
 	Create(format, sampleCount, sampleRate, samples);
@@ -46,7 +279,7 @@ NzSoundBuffer::~NzSoundBuffer()
 	Destroy();
 }
 
-bool NzSoundBuffer::Create(nzAudioFormat format, unsigned int sampleCount, unsigned int sampleRate, const nzInt16* samples)
+bool NzSoundBuffer::Create(nzAudioFormat format, unsigned int sampleCount, unsigned int sampleRate, const nzInt16* samples, nzSoundBufferStorage storage)
 {
 	Destroy();
 
@@ -74,38 +307,52 @@ bool NzSoundBuffer::Create(nzAudioFormat format, unsigned int sampleCount, unsig
 		NazaraError("Invalid sample source");
 		return false;
 	}
-	#endif
 
-	// On vide le stack d'erreurs
-	while (alGetError() != AL_NO_ERROR);
+	if (!NzVoiceManager::IsInitialized())
+	{
+		NazaraError("Audio module is not initialized");
+		return false;
+	}
+	#endif
 
-	ALuint buffer;
-	alGenBuffers(1, &buffer);
+	#ifdef NAZARA_DEBUG
+	if (storage > nzSoundBufferStorage_Max)
+	{
+		NazaraError("Storage mode out of enum");
+		return false;
+	}
+	#endif
 
-	if (alGetError() != AL_NO_ERROR)
+	if (storage == nzSoundBufferStorage_Encoded)
 	{
-		NazaraError("Failed to create OpenAL buffer");
+		NazaraError("Encoded storage requires the original file (use LoadFrom* functions)");
 		return false;
 	}
 
-	alBufferData(buffer, NzAudio::GetOpenALFormat(format), samples, sampleCount*sizeof(nzInt16), sampleRate);
+	std::unique_ptr<NzSoundBufferImpl> impl(new NzSoundBufferImpl);
+	impl->duration = static_cast<nzUInt32>(1000ULL * sampleCount / (format * sampleRate));
+	impl->format = format;
+	impl->metadataKnown = true;
+	impl->sampleCount = sampleCount;
+	impl->sampleRate = sampleRate;
+	impl->storage = storage;
 
-	if (alGetError() != AL_NO_ERROR)
+	if (storage == nzSoundBufferStorage_PCM)
 	{
-		NazaraError("Failed to set OpenAL buffer");
-		alDeleteBuffers(1, &buffer);
-
-		return false;
+		impl->buffer = NzVoiceManager::GetDevice()->CreateBuffer(format, samples, sampleCount, sampleRate);
+		if (impl->buffer == 0)
+		{
+			NazaraError("Failed to create audio buffer");
+			return false;
+		}
+
+		impl->samples = new nzInt16[sampleCount];
+		std::memcpy(&impl->samples[0], samples, sampleCount*sizeof(nzInt16));
 	}
+	else
+		AdpcmEncode(samples, sampleCount, format, impl->data); // Le buffer audio ne sera créé qu'à la première lecture
 
-	m_impl = new NzSoundBufferImpl;
-	m_impl->buffer = buffer;
-	m_impl->duration = 1000 * (sampleCount / (format * sampleRate));
-	m_impl->format = format;
-	m_impl->sampleCount = sampleCount;
-	m_impl->sampleRate = sampleRate;
-	m_impl->samples = new nzInt16[sampleCount];
-	std::memcpy(&m_impl->samples[0], samples, sampleCount*sizeof(nzInt16));
+	m_impl = impl.release();
 
 	NotifyCreated();
 	return true;
@@ -117,6 +364,16 @@ void NzSoundBuffer::Destroy()
 	{
 		NotifyDestroy();
 
+		if (m_impl->cached)
+			Evict(m_impl);
+		else if (m_impl->buffer != 0)
+		{
+			for (NzSound* user : m_impl->users)
+				user->SetInternalBuffer(0);
+
+			NzVoiceManager::GetDevice()->DestroyBuffer(m_impl->buffer);
+		}
+
 		delete[] m_impl->samples;
 		delete m_impl;
 		m_impl = nullptr;
@@ -133,6 +390,9 @@ nzUInt32 NzSoundBuffer::GetDuration() const
 	}
 	#endif
 
+	if (!EnsureMetadata())
+		return 0;
+
 	return m_impl->duration;
 }
 
@@ -146,9 +406,29 @@ nzAudioFormat NzSoundBuffer::GetFormat() const
 	}
 	#endif
 
+	if (!EnsureMetadata())
+		return nzAudioFormat_Unknown;
+
 	return m_impl->format;
 }
 
+unsigned int NzSoundBuffer::GetMemoryUsage() const
+{
+	#if NAZARA_AUDIO_SAFE
+	if (!m_impl)
+	{
+		NazaraError("Sound buffer not created");
+		return 0;
+	}
+	#endif
+
+	// Mémoire conservée en permanence, sans compter les échantillons décodés du cache
+	if (m_impl->storage == nzSoundBufferStorage_PCM)
+		return m_impl->sampleCount*sizeof(nzInt16);
+	else
+		return m_impl->data.size();
+}
+
 const nzInt16* NzSoundBuffer::GetSamples() const
 {
 	#if NAZARA_AUDIO_SAFE
@@ -157,6 +437,12 @@ const nzInt16* NzSoundBuffer::GetSamples() const
 		NazaraError("Sound buffer not created");
 		return nullptr;
 	}
+
+	if (m_impl->storage != nzSoundBufferStorage_PCM)
+	{
+		NazaraError("Samples are only kept with PCM storage");
+		return nullptr;
+	}
 	#endif
 
 	return m_impl->samples;
@@ -172,6 +458,9 @@ unsigned int NzSoundBuffer::GetSampleCount() const
 	}
 	#endif
 
+	if (!EnsureMetadata())
+		return 0;
+
 	return m_impl->sampleCount;
 }
 
@@ -185,9 +474,30 @@ unsigned int NzSoundBuffer::GetSampleRate() const
 	}
 	#endif
 
+	if (!EnsureMetadata())
+		return 0;
+
 	return m_impl->sampleRate;
 }
 
+nzSoundBufferStorage NzSoundBuffer::GetStorage() const
+{
+	#if NAZARA_AUDIO_SAFE
+	if (!m_impl)
+	{
+		NazaraError("Sound buffer not created");
+		return nzSoundBufferStorage_PCM;
+	}
+	#endif
+
+	return m_impl->storage;
+}
+
+bool NzSoundBuffer::IsResident() const
+{
+	return m_impl && m_impl->buffer != 0;
+}
+
 bool NzSoundBuffer::IsValid() const
 {
 	return m_impl != nullptr;
@@ -195,17 +505,82 @@ bool NzSoundBuffer::IsValid() const
 
 bool NzSoundBuffer::LoadFromFile(const NzString& filePath, const NzSoundBufferParams& params)
 {
-	return NzSoundBufferLoader::LoadFromFile(this, filePath, params);
+	if (params.storage != nzSoundBufferStorage_Encoded)
+		return NzSoundBufferLoader::LoadFromFile(this, filePath, params);
+
+	NzFile file(filePath);
+	if (!file.Open(NzFile::ReadOnly))
+	{
+		NazaraError("Failed to open \"" + filePath + '"');
+		return false;
+	}
+
+	std::vector<nzUInt8> data(static_cast<std::size_t>(file.GetSize()));
+	if (!data.empty() && file.Read(data.data(), data.size()) != data.size())
+	{
+		NazaraError("Failed to read \"" + filePath + '"');
+		return false;
+	}
+
+	return CreateEncoded(std::move(data));
 }
 
 bool NzSoundBuffer::LoadFromMemory(const void* data, std::size_t size, const NzSoundBufferParams& params)
 {
-	return NzSoundBufferLoader::LoadFromMemory(this, data, size, params);
+	if (params.storage != nzSoundBufferStorage_Encoded)
+		return NzSoundBufferLoader::LoadFromMemory(this, data, size, params);
+
+	const nzUInt8* ptr = static_cast<const nzUInt8*>(data);
+
+	return CreateEncoded(std::vector<nzUInt8>(ptr, ptr + size));
 }
 
 bool NzSoundBuffer::LoadFromStream(NzInputStream& stream, const NzSoundBufferParams& params)
 {
-	return NzSoundBufferLoader::LoadFromStream(this, stream, params);
+	if (params.storage != nzSoundBufferStorage_Encoded)
+		return NzSoundBufferLoader::LoadFromStream(this, stream, params);
+
+	// La position actuelle du flux n'est pas connue, on lit jusqu'à la fin
+	std::vector<nzUInt8> data;
+	nzUInt8 chunk[4096];
+	while (!stream.EndOfStream())
+	{
+		std::size_t readSize = stream.Read(chunk, sizeof(chunk));
+		if (readSize == 0)
+			break;
+
+		data.insert(data.end(), chunk, chunk + readSize);
+	}
+
+	return CreateEncoded(std::move(data));
+}
+
+void NzSoundBuffer::ClearCache()
+{
+	NzSoundBufferImpl* impl = s_cacheHead;
+	while (impl)
+	{
+		NzSoundBufferImpl* next = impl->next;
+		if (!IsInUse(impl))
+			Evict(impl);
+
+		impl = next;
+	}
+}
+
+nzUInt64 NzSoundBuffer::GetCacheBudget()
+{
+	return s_cacheBudget;
+}
+
+NzSoundCacheStats NzSoundBuffer::GetCacheStats()
+{
+	return s_cacheStats;
+}
+
+nzUInt64 NzSoundBuffer::GetCacheUsage()
+{
+	return s_cacheUsage;
 }
 
 bool NzSoundBuffer::IsFormatSupported(nzAudioFormat format)
@@ -213,17 +588,188 @@ bool NzSoundBuffer::IsFormatSupported(nzAudioFormat format)
 	return NzAudio::IsFormatSupported(format);
 }
 
-unsigned int NzSoundBuffer::GetOpenALBuffer() const
+void NzSoundBuffer::ResetCacheStats()
+{
+	s_cacheStats = NzSoundCacheStats();
+}
+
+void NzSoundBuffer::SetCacheBudget(nzUInt64 budget)
+{
+	s_cacheBudget = budget;
+
+	TrimCache(nullptr);
+}
+
+unsigned int NzSoundBuffer::AcquireBuffer(NzSound* user) const
 {
 	#ifdef NAZARA_DEBUG
 	if (!m_impl)
 	{
 		NazaraInternalError("Sound buffer not created");
-		return AL_NONE;
+		return 0;
 	}
 	#endif
 
+	if (m_impl->storage != nzSoundBufferStorage_PCM)
+	{
+		if (m_impl->cached)
+		{
+			s_cacheStats.hitCount++;
+
+			Unlink(m_impl);
+			LinkFront(m_impl);
+		}
+		else
+		{
+			s_cacheStats.missCount++;
+
+			if (!Decode())
+				return 0;
+		}
+	}
+
+	if (user && std::find(m_impl->users.begin(), m_impl->users.end(), user) == m_impl->users.end())
+		m_impl->users.push_back(user);
+
 	return m_impl->buffer;
 }
 
+bool NzSoundBuffer::CreateEncoded(std::vector<nzUInt8>&& data)
+{
+	Destroy();
+
+	#if NAZARA_AUDIO_SAFE
+	if (data.empty())
+	{
+		NazaraError("Encoded data is empty");
+		return false;
+	}
+
+	if (!NzVoiceManager::IsInitialized())
+	{
+		NazaraError("Audio module is not initialized");
+		return false;
+	}
+	#endif
+
+	// Les propriétés ne seront connues qu'au premier décodage, les erreurs de format aussi
+	m_impl = new NzSoundBufferImpl;
+	m_impl->data = std::move(data);
+	m_impl->duration = 0;
+	m_impl->format = nzAudioFormat_Unknown;
+	m_impl->metadataKnown = false;
+	m_impl->sampleCount = 0;
+	m_impl->sampleRate = 0;
+	m_impl->storage = nzSoundBufferStorage_Encoded;
+
+	NotifyCreated();
+	return true;
+}
+
+bool NzSoundBuffer::Decode() const
+{
+	nzUInt64 start = NzGetMicroseconds();
+
+	if (m_impl->storage == nzSoundBufferStorage_ADPCM)
+	{
+		std::unique_ptr<nzInt16[]> samples(new nzInt16[m_impl->sampleCount]);
+		AdpcmDecode(m_impl->data.data(), m_impl->sampleCount, m_impl->format, samples.get());
+
+		m_impl->buffer = NzVoiceManager::GetDevice()->CreateBuffer(m_impl->format, samples.get(), m_impl->sampleCount, m_impl->sampleRate);
+		if (m_impl->buffer == 0)
+		{
+			NazaraError("Failed to create audio buffer");
+			return false;
+		}
+	}
+	else
+	{
+		// On passe par les loaders habituels, puis on récupère le buffer audio du résultat
+		NzSoundBuffer decoded;
+		if (!NzSoundBufferLoader::LoadFromMemory(&decoded, m_impl->data.data(), m_impl->data.size()))
+		{
+			NazaraError("Failed to decode sound buffer");
+			return false;
+		}
+
+		m_impl->buffer = decoded.m_impl->buffer;
+		m_impl->duration = decoded.m_impl->duration;
+		m_impl->format = decoded.m_impl->format;
+		m_impl->metadataKnown = true;
+		m_impl->sampleCount = decoded.m_impl->sampleCount;
+		m_impl->sampleRate = decoded.m_impl->sampleRate;
+
+		decoded.m_impl->buffer = 0;
+	}
+
+	m_impl->cached = true;
+	LinkFront(m_impl);
+
+	nzUInt64 decodedSize = GetDecodedSize(m_impl);
+	s_cacheUsage += decodedSize;
+	s_cacheStats.decodedBytes += decodedSize;
+	s_cacheStats.decodeTime += NzGetMicroseconds() - start;
+
+	TrimCache(m_impl);
+
+	return true;
+}
+
+bool NzSoundBuffer::EnsureMetadata() const
+{
+	if (m_impl->metadataKnown)
+		return true;
+
+	// Les propriétés d'un fichier encodé ne sont connues qu'une fois celui-ci décodé
+	if (AcquireBuffer(nullptr) == 0)
+	{
+		NazaraError("Failed to decode sound buffer");
+		return false;
+	}
+
+	return true;
+}
+
+void NzSoundBuffer::ReleaseBuffer(NzSound* user) const
+{
+	if (!m_impl)
+		return; // Le buffer a été détruit, ses utilisateurs ont déjà été détachés
+
+	auto it = std::find(m_impl->users.begin(), m_impl->users.end(), user);
+	if (it != m_impl->users.end())
+		m_impl->users.erase(it);
+}
+
+void NzSoundBuffer::Evict(NzSoundBufferImpl* impl)
+{
+	// Les sons utilisant ce buffer sont arrêtés, ils le redemanderont au prochain Play
+	for (NzSound* user : impl->users)
+		user->SetInternalBuffer(0);
+
+	impl->users.clear();
+
+	NzVoiceManager::GetDevice()->DestroyBuffer(impl->buffer);
+	impl->buffer = 0;
+	impl->cached = false;
+
+	Unlink(impl);
+
+	s_cacheUsage -= GetDecodedSize(impl);
+	s_cacheStats.evictionCount++;
+}
+
+void NzSoundBuffer::TrimCache(const NzSoundBufferImpl* keep)
+{
+	// On remonte depuis le moins récemment utilisé, en épargnant les buffers en cours de lecture
+	NzSoundBufferImpl* impl = s_cacheTail;
+	while (impl && s_cacheUsage > s_cacheBudget)
+	{
+		NzSoundBufferImpl* previous = impl->previous;
+		if (impl != keep && !IsInUse(impl))
+			Evict(impl);
+
+		impl = previous;
+	}
+}
+
 NzSoundBufferLoader::LoaderList NzSoundBuffer::s_loaders;
@@ -2,155 +2,349 @@
 // This file is part of the "Nazara Engine - Audio module"
 // For conditions of distribution and use, see copyright notice in Config.hpp
 
-// http://connect.creativelabs.com/openal/Documentation/OpenAL_Programmers_Guide.pdf
-
 #include <Nazara/Audio/SoundEmitter.hpp>
+#include <Nazara/Audio/VoiceManager.hpp>
 #include <Nazara/Core/Error.hpp>
-#include <AL/al.h>
+#include <algorithm>
 #include <Nazara/Audio/Debug.hpp>
 
-NzSoundEmitter::NzSoundEmitter()
+NzSoundEmitter::NzSoundEmitter() :
+m_source(0),
+m_status(nzSoundStatus_Stopped),
+m_playStart(0),
+m_playOffset(0),
+m_buffer(0),
+m_priority(0)
 {
-	alGenSources(1, &m_source);
+	NzVoiceManager::RegisterEmitter(this);
 }
 
-NzSoundEmitter::NzSoundEmitter(const NzSoundEmitter& emitter)
+NzSoundEmitter::NzSoundEmitter(const NzSoundEmitter& emitter) :
+m_parameters(emitter.m_parameters),
+m_source(0),
+m_status(nzSoundStatus_Stopped),
+m_playStart(0),
+m_playOffset(0),
+m_buffer(0),
+m_priority(emitter.m_priority)
 {
-	alGenSources(1, &m_source);
-
-	SetAttenuation(emitter.GetAttenuation());
-	SetMinDistance(emitter.GetMinDistance());
-	SetPitch(emitter.GetPitch());
 	// Pas de copie de position ou de vitesse
-	SetVolume(emitter.GetVolume());
+	m_parameters.position = NzVector3f::Zero();
+	m_parameters.velocity = NzVector3f::Zero();
+
+	NzVoiceManager::RegisterEmitter(this);
 }
 
 NzSoundEmitter::~NzSoundEmitter()
 {
-	alDeleteSources(1, &m_source);
+	NzVoiceManager::UnregisterEmitter(this);
 }
 
 void NzSoundEmitter::EnableSpatialization(bool spatialization)
 {
-	alSourcei(m_source, AL_SOURCE_RELATIVE, spatialization);
+	m_parameters.spatialized = spatialization;
+
+	UpdateParameters();
 }
 
 float NzSoundEmitter::GetAttenuation() const
 {
-	ALfloat attenuation;
-	alGetSourcef(m_source, AL_ROLLOFF_FACTOR, &attenuation);
+	return m_parameters.attenuation;
+}
+
+float NzSoundEmitter::GetAudibility() const
+{
+	NzAudioDevice* device = NzVoiceManager::GetDevice();
 
-	return attenuation;
+	return GetAudibility((device) ? device->GetListenerPosition() : NzVector3f::Zero());
 }
 
 float NzSoundEmitter::GetMinDistance() const
 {
-	ALfloat distance;
-	alGetSourcef(m_source, AL_REFERENCE_DISTANCE, &distance);
-
-	return distance;
+	return m_parameters.minDistance;
 }
 
 float NzSoundEmitter::GetPitch() const
 {
-	ALfloat pitch;
-	alGetSourcef(m_source, AL_PITCH, &pitch);
-
-	return pitch;
+	return m_parameters.pitch;
 }
 
 NzVector3f NzSoundEmitter::GetPosition() const
 {
-	NzVector3f position;
-	alGetSourcefv(m_source, AL_POSITION, position);
+	return m_parameters.position;
+}
 
-	return position;
+int NzSoundEmitter::GetPriority() const
+{
+	return m_priority;
 }
 
 NzVector3f NzSoundEmitter::GetVelocity() const
 {
-	NzVector3f velocity;
-	alGetSourcefv(m_source, AL_VELOCITY, velocity);
-
-	return velocity;
+	return m_parameters.velocity;
 }
 
 float NzSoundEmitter::GetVolume() const
 {
-	ALfloat gain;
-	alGetSourcef(m_source, AL_GAIN, &gain);
-
-	return gain * 100.f;
+	return m_parameters.volume;
 }
 
 bool NzSoundEmitter::IsSpatialized() const
 {
-	ALint relative;
-	alGetSourcei(m_source, AL_SOURCE_RELATIVE, &relative);
+	return m_parameters.spatialized;
+}
 
-	return relative != AL_FALSE;
+bool NzSoundEmitter::IsVirtual() const
+{
+	return m_source == 0;
 }
 
 void NzSoundEmitter::SetAttenuation(float attenuation)
 {
-	alSourcef(m_source, AL_ROLLOFF_FACTOR, attenuation);
+	m_parameters.attenuation = attenuation;
+
+	UpdateParameters();
 }
 
 void NzSoundEmitter::SetMinDistance(float minDistance)
 {
-	alSourcef(m_source, AL_REFERENCE_DISTANCE, minDistance);
+	m_parameters.minDistance = minDistance;
+
+	UpdateParameters();
 }
 
 void NzSoundEmitter::SetPitch(float pitch)
 {
-	alSourcef(m_source, AL_PITCH, pitch);
+	// La progression virtuelle dépend de la hauteur, on repart de la position actuelle
+	RebaseVirtualOffset();
+
+	m_parameters.pitch = pitch;
+
+	UpdateParameters();
 }
 
 void NzSoundEmitter::SetPosition(const NzVector3f& position)
 {
-	alSourcefv(m_source, AL_POSITION, position);
+	m_parameters.position = position;
+
+	UpdateParameters();
 }
 
 void NzSoundEmitter::SetPosition(float x, float y, float z)
 {
-	alSource3f(m_source, AL_POSITION, x, y, z);
+	m_parameters.position.Set(x, y, z);
+
+	UpdateParameters();
+}
+
+void NzSoundEmitter::SetPriority(int priority)
+{
+	///DOC: Une voix de priorité supérieure obtient toujours une source avant une voix plus audible de priorité inférieure
+	m_priority = priority;
 }
 
 void NzSoundEmitter::SetVelocity(const NzVector3f& velocity)
 {
-	alSourcefv(m_source, AL_VELOCITY, velocity);
+	m_parameters.velocity = velocity;
+
+	UpdateParameters();
 }
 
 void NzSoundEmitter::SetVelocity(float velX, float velY, float velZ)
 {
-	alSource3f(m_source, AL_VELOCITY, velX, velY, velZ);
+	m_parameters.velocity.Set(velX, velY, velZ);
+
+	UpdateParameters();
 }
 
 void NzSoundEmitter::SetVolume(float volume)
 {
-	alSourcef(m_source, AL_GAIN, volume*0.01f);
+	m_parameters.volume = volume;
+
+	UpdateParameters();
+}
+
+unsigned int NzSoundEmitter::GetInternalBuffer() const
+{
+	return m_buffer;
 }
 
 nzSoundStatus NzSoundEmitter::GetInternalStatus() const
 {
-	ALint state;
-	alGetSourcei(m_source, AL_SOURCE_STATE, &state);
+	if (m_source)
+		return NzVoiceManager::GetDevice()->GetSourceStatus(m_source);
 
-	switch (state)
+	// Une voix virtuelle sans boucle s'arrête d'elle-même une fois sa durée écoulée
+	if (m_status == nzSoundStatus_Playing && !m_parameters.looping)
 	{
-		case AL_INITIAL:
-		case AL_STOPPED:
+		nzUInt32 duration = GetDuration();
+		if (duration > 0 && GetVirtualOffset(NzVoiceManager::GetTime()) >= duration)
 			return nzSoundStatus_Stopped;
+	}
+
+	return m_status;
+}
+
+nzUInt32 NzSoundEmitter::GetInternalOffset() const
+{
+	if (m_source)
+		return NzVoiceManager::GetDevice()->GetSourceOffset(m_source);
+
+	if (m_status == nzSoundStatus_Playing)
+		return GetVirtualOffset(NzVoiceManager::GetTime());
+	else
+		return m_playOffset;
+}
+
+void NzSoundEmitter::InternalPause()
+{
+	if (m_status != nzSoundStatus_Playing)
+		return;
+
+	m_playOffset = GetInternalOffset();
+	m_status = nzSoundStatus_Paused;
+
+	if (m_source)
+		NzVoiceManager::GetDevice()->PauseSource(m_source);
+}
+
+void NzSoundEmitter::InternalPlay()
+{
+	// Comme OpenAL, rejouer un son en cours de lecture le fait recommencer
+	if (GetInternalStatus() == nzSoundStatus_Playing)
+		SetInternalOffset(0);
+	else if (m_status == nzSoundStatus_Playing) // Lecture terminée
+		m_playOffset = 0;
+
+	m_playStart = NzVoiceManager::GetTime();
+	m_status = nzSoundStatus_Playing;
+
+	if (m_source)
+		NzVoiceManager::GetDevice()->PlaySource(m_source);
+	else
+		NzVoiceManager::RequestSource(this);
+
+	// Si l'application n'appelle pas NzAudio::Update, les voix virtuelles sont tout de même réévaluées de temps à autre
+	NzVoiceManager::UpdateIfNeeded();
+}
+
+void NzSoundEmitter::InternalStop()
+{
+	m_playOffset = 0;
+	m_status = nzSoundStatus_Stopped;
+
+	// Un émetteur arrêté n'a plus besoin de sa source
+	if (m_source)
+		NzVoiceManager::ReleaseSource(this);
+}
+
+void NzSoundEmitter::SetInternalBuffer(unsigned int buffer)
+{
+	m_buffer = buffer;
+
+	if (m_source)
+		NzVoiceManager::GetDevice()->SetSourceBuffer(m_source, buffer);
+}
+
+void NzSoundEmitter::SetInternalLooping(bool loop)
+{
+	RebaseVirtualOffset();
+
+	m_parameters.looping = loop;
+
+	UpdateParameters();
+}
+
+void NzSoundEmitter::SetInternalOffset(nzUInt32 offset)
+{
+	m_playOffset = offset;
+	m_playStart = NzVoiceManager::GetTime();
+
+	if (m_source)
+		NzVoiceManager::GetDevice()->SetSourceOffset(m_source, offset);
+}
+
+void NzSoundEmitter::AcquireSource(unsigned int source)
+{
+	NzAudioDevice* device = NzVoiceManager::GetDevice();
+
+	// La voix reprend là où sa lecture virtuelle est arrivée
+	RebaseVirtualOffset();
+
+	m_source = source;
+
+	device->SetSourceParameters(m_source, m_parameters);
+	device->SetSourceBuffer(m_source, m_buffer);
+	device->SetSourceOffset(m_source, m_playOffset);
+
+	if (m_status == nzSoundStatus_Playing)
+		device->PlaySource(m_source);
+}
 
-		case AL_PAUSED:
-			return nzSoundStatus_Paused;
+float NzSoundEmitter::GetAudibility(const NzVector3f& listenerPosition) const
+{
+	// Gain perçu selon le modèle d'atténuation par défaut d'OpenAL (AL_INVERSE_DISTANCE_CLAMPED)
+	float gain = std::max(m_parameters.volume, 0.f)*0.01f;
+	if (gain <= 0.f)
+		return 0.f;
+
+	float distance = (m_parameters.spatialized) ? m_parameters.position.GetLength() : m_parameters.position.Distance(listenerPosition);
+	float minDistance = m_parameters.minDistance;
+	if (minDistance <= 0.f || m_parameters.attenuation <= 0.f)
+		return gain;
+
+	distance = std::max(distance, minDistance);
 
-		case AL_PLAYING:
-			return nzSoundStatus_Playing;
+	return gain * minDistance / (minDistance + m_parameters.attenuation*(distance - minDistance));
+}
+
+nzUInt32 NzSoundEmitter::GetVirtualOffset(nzUInt64 now) const
+{
+	nzUInt64 elapsed = (now > m_playStart) ? now - m_playStart : 0;
+	nzUInt64 offset = m_playOffset + static_cast<nzUInt64>(elapsed*std::max(m_parameters.pitch, 0.f));
 
-		default:
-			NazaraInternalError("Source state unrecognized");
+	nzUInt32 duration = GetDuration();
+	if (duration > 0)
+	{
+		if (m_parameters.looping)
+			offset %= duration;
+		else
+			offset = std::min(offset, static_cast<nzUInt64>(duration));
 	}
 
-	return nzSoundStatus_Stopped;
+	return static_cast<nzUInt32>(offset);
+}
+
+void NzSoundEmitter::RebaseVirtualOffset()
+{
+	if (m_source || m_status != nzSoundStatus_Playing)
+		return;
+
+	nzUInt64 now = NzVoiceManager::GetTime();
+
+	m_playOffset = GetVirtualOffset(now);
+	m_playStart = now;
+}
+
+void NzSoundEmitter::ReleaseSource()
+{
+	NzAudioDevice* device = NzVoiceManager::GetDevice();
+
+	// On mémorise la position de lecture pour poursuivre virtuellement
+	if (m_status == nzSoundStatus_Playing)
+	{
+		m_playOffset = device->GetSourceOffset(m_source);
+		m_playStart = NzVoiceManager::GetTime();
+	}
+
+	device->StopSource(m_source);
+	device->SetSourceBuffer(m_source, 0);
+
+	m_source = 0;
+}
+
+void NzSoundEmitter::UpdateParameters()
+{
+	if (m_source)
+		NzVoiceManager::GetDevice()->SetSourceParameters(m_source, m_parameters);
 }
@@ -0,0 +1,312 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Audio module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Audio/VoiceManager.hpp>
+#include <Nazara/Audio/AudioDevice.hpp>
+#include <Nazara/Audio/SoundEmitter.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <algorithm>
+#include <vector>
+#include <Nazara/Audio/Debug.hpp>
+
+namespace
+{
+	// Bonus accordé aux voix possédant déjà une source, évite qu'elles ne s'échangent à chaque mise à jour
+	const float sourceHysteresis = 1.25f;
+
+	struct VoiceScore
+	{
+		NzSoundEmitter* emitter;
+		float audibility;
+		int priority;
+	};
+
+	bool CompareScores(const VoiceScore& lhs, const VoiceScore& rhs)
+	{
+		if (lhs.priority != rhs.priority)
+			return lhs.priority > rhs.priority;
+
+		return lhs.audibility > rhs.audibility;
+	}
+
+	std::vector<NzSoundEmitter*> s_emitters;
+	std::vector<unsigned int> s_freeSources;
+	std::vector<unsigned int> s_sources;
+	std::vector<VoiceScore> s_scores;
+	NzAudioDevice* s_device = nullptr;
+	NzClockFunction s_clock = NzGetMilliseconds;
+	nzUInt64 s_lastUpdate = 0;
+}
+
+NzAudioDevice* NzVoiceManager::GetDevice()
+{
+	return s_device;
+}
+
+unsigned int NzVoiceManager::GetFreeSourceCount()
+{
+	return s_freeSources.size();
+}
+
+unsigned int NzVoiceManager::GetSourceCount()
+{
+	return s_sources.size();
+}
+
+nzUInt64 NzVoiceManager::GetTime()
+{
+	return s_clock();
+}
+
+unsigned int NzVoiceManager::GetVirtualVoiceCount()
+{
+	unsigned int count = 0;
+	for (NzSoundEmitter* emitter : s_emitters)
+	{
+		if (!emitter->m_source && emitter->m_status == nzSoundStatus_Playing)
+			count++;
+	}
+
+	return count;
+}
+
+unsigned int NzVoiceManager::GetVoiceCount()
+{
+	return s_emitters.size();
+}
+
+bool NzVoiceManager::Initialize(NzAudioDevice* device, unsigned int maxSourceCount)
+{
+	#if NAZARA_AUDIO_SAFE
+	if (!device)
+	{
+		NazaraError("Invalid device");
+		return false;
+	}
+	#endif
+
+	if (s_device)
+		Uninitialize();
+
+	s_device = device;
+
+	// On prend autant de sources que le périphérique nous en accorde, dans la limite demandée
+	s_sources.reserve(maxSourceCount);
+	for (unsigned int i = 0; i < maxSourceCount; ++i)
+	{
+		unsigned int source = s_device->CreateSource();
+		if (source == 0)
+			break;
+
+		s_sources.push_back(source);
+	}
+
+	if (s_sources.empty())
+	{
+		NazaraError("Failed to create any source");
+		s_device = nullptr;
+
+		return false;
+	}
+
+	s_freeSources = s_sources;
+
+	return true;
+}
+
+bool NzVoiceManager::IsInitialized()
+{
+	return s_device != nullptr;
+}
+
+void NzVoiceManager::SetClockFunction(NzClockFunction clockFunction)
+{
+	s_clock = (clockFunction) ? clockFunction : NzGetMilliseconds;
+}
+
+void NzVoiceManager::Uninitialize()
+{
+	if (!s_device)
+		return;
+
+	// Les émetteurs encore en vie deviennent virtuels
+	for (NzSoundEmitter* emitter : s_emitters)
+	{
+		if (emitter->m_source)
+			emitter->ReleaseSource();
+	}
+
+	for (unsigned int source : s_sources)
+		s_device->DestroySource(source);
+
+	s_freeSources.clear();
+	s_sources.clear();
+	s_scores.clear();
+	s_device = nullptr;
+}
+
+void NzVoiceManager::Update()
+{
+	///DOC: Appelée par NzAudio::Update, et automatiquement lors de la lecture d'un son si la dernière mise à jour est trop ancienne
+	if (!s_device)
+		return;
+
+	nzUInt64 now = s_clock();
+	s_lastUpdate = now;
+	NzVector3f listenerPosition = s_device->GetListenerPosition();
+
+	s_scores.clear();
+	for (NzSoundEmitter* emitter : s_emitters)
+	{
+		if (emitter->m_status != nzSoundStatus_Playing)
+			continue;
+
+		// Les voix terminées libèrent leur source
+		if (emitter->m_source)
+		{
+			if (s_device->GetSourceStatus(emitter->m_source) == nzSoundStatus_Stopped)
+			{
+				emitter->InternalStop();
+				continue;
+			}
+		}
+		else if (!emitter->m_parameters.looping)
+		{
+			nzUInt32 duration = emitter->GetDuration();
+			if (duration > 0 && emitter->GetVirtualOffset(now) >= duration)
+			{
+				emitter->InternalStop();
+				continue;
+			}
+		}
+
+		// Une voix inaudible n'a pas besoin de source réelle
+		float audibility = emitter->GetAudibility(listenerPosition);
+		if (audibility <= 0.f)
+			continue;
+
+		if (emitter->m_source)
+			audibility *= sourceHysteresis;
+
+		s_scores.push_back(VoiceScore{emitter, audibility, emitter->m_priority});
+	}
+
+	unsigned int selectedCount = std::min(s_scores.size(), s_sources.size());
+	std::partial_sort(s_scores.begin(), s_scores.begin() + selectedCount, s_scores.end(), CompareScores);
+
+	// On retire d'abord leur source aux voix non-retenues (dont les voix en pause ou inaudibles)...
+	for (NzSoundEmitter* emitter : s_emitters)
+	{
+		if (!emitter->m_source)
+			continue;
+
+		auto end = s_scores.begin() + selectedCount;
+		if (std::find_if(s_scores.begin(), end, [emitter](const VoiceScore& score) { return score.emitter == emitter; }) == end)
+			ReleaseSource(emitter);
+	}
+
+	// ...avant de les donner aux voix retenues n'en ayant pas encore
+	for (unsigned int i = 0; i < selectedCount; ++i)
+	{
+		NzSoundEmitter* emitter = s_scores[i].emitter;
+		if (!emitter->m_source)
+		{
+			unsigned int source = s_freeSources.back();
+			s_freeSources.pop_back();
+
+			emitter->AcquireSource(source);
+		}
+	}
+}
+
+void NzVoiceManager::ReclaimSources()
+{
+	// Les voix dont la lecture s'est terminée sur leur source n'en ont plus besoin
+	for (NzSoundEmitter* emitter : s_emitters)
+	{
+		if (emitter->m_source && emitter->m_status == nzSoundStatus_Playing && s_device->GetSourceStatus(emitter->m_source) == nzSoundStatus_Stopped)
+			emitter->InternalStop();
+	}
+}
+
+void NzVoiceManager::RegisterEmitter(NzSoundEmitter* emitter)
+{
+	s_emitters.push_back(emitter);
+}
+
+void NzVoiceManager::ReleaseSource(NzSoundEmitter* emitter)
+{
+	unsigned int source = emitter->m_source;
+	emitter->ReleaseSource();
+
+	s_freeSources.push_back(source);
+}
+
+bool NzVoiceManager::RequestSource(NzSoundEmitter* emitter)
+{
+	if (!s_device)
+		return false;
+
+	// Les sources des voix terminées sont récupérées avant d'en voler une
+	if (s_freeSources.empty())
+		ReclaimSources();
+
+	if (s_freeSources.empty())
+	{
+		// Toutes les sources sont occupées, on prend celle de la voix la moins importante si elle l'est moins que nous
+		NzVector3f listenerPosition = s_device->GetListenerPosition();
+		VoiceScore candidate = {emitter, emitter->GetAudibility(listenerPosition), emitter->m_priority};
+		if (candidate.audibility <= 0.f)
+			return false;
+
+		NzSoundEmitter* weakest = nullptr;
+		VoiceScore weakestScore;
+		for (NzSoundEmitter* other : s_emitters)
+		{
+			if (!other->m_source)
+				continue;
+
+			// Une voix en pause ou arrêtée est la candidate idéale
+			float audibility = (other->m_status == nzSoundStatus_Playing) ? other->GetAudibility(listenerPosition)*sourceHysteresis : 0.f;
+			VoiceScore score = {other, audibility, other->m_priority};
+			if (!weakest || CompareScores(weakestScore, score))
+			{
+				weakest = other;
+				weakestScore = score;
+			}
+		}
+
+		if (!weakest || !CompareScores(candidate, weakestScore))
+			return false; // La voix reste virtuelle
+
+		ReleaseSource(weakest);
+	}
+
+	unsigned int source = s_freeSources.back();
+	s_freeSources.pop_back();
+
+	emitter->AcquireSource(source);
+
+	return true;
+}
+
+void NzVoiceManager::UnregisterEmitter(NzSoundEmitter* emitter)
+{
+	if (emitter->m_source)
+		ReleaseSource(emitter);
+
+	auto it = std::find(s_emitters.begin(), s_emitters.end(), emitter);
+	if (it != s_emitters.end())
+	{
+		// L'ordre des émetteurs n'a pas d'importance
+		*it = s_emitters.back();
+		s_emitters.pop_back();
+	}
+}
+
+void NzVoiceManager::UpdateIfNeeded()
+{
+	if (s_device && s_clock() - s_lastUpdate >= NAZARA_AUDIO_VOICE_UPDATE_INTERVAL)
+		Update();
+}
@@ -7,6 +7,7 @@
 #include <Nazara/Core/Error.hpp>
 #include <Nazara/Core/HardwareInfo.hpp>
 #include <Nazara/Core/Log.hpp>
+#include <Nazara/Core/SimdDispatch.hpp>
 #include <Nazara/Core/TaskScheduler.hpp>
 #include <Nazara/Core/Debug.hpp>
 
@@ -15,6 +16,9 @@ bool NzCore::Initialize()
 	if (s_moduleReferenceCounter++ != 0)
 		return true; // Déjà initialisé
 
+	// Résolution des noyaux SIMD vers la meilleure implémentation disponible
+	NzSimdDispatch::Initialize();
+
 	NazaraNotice("Initialized: Core");
 
 	return true;
@@ -40,6 +44,7 @@ void NzCore::Uninitialize()
 	s_moduleReferenceCounter = 0;
 
 	NzHardwareInfo::Uninitialize();
+	NzSimdDispatch::Uninitialize();
 	NzTaskScheduler::Uninitialize();
 
 	NazaraNotice("Uninitialized: Core");
@@ -15,42 +15,64 @@
 
 #include <Nazara/Core/Debug.hpp>
 
-void NzError::Error(nzErrorType type, const NzString& error)
+namespace
 {
-	if ((s_flags & nzErrorFlag_Silent) == 0 || (s_flags & nzErrorFlag_SilentDisabled) != 0)
-		NazaraLog->WriteError(type, error);
+	// Chaque thread possède sa propre dernière erreur (ainsi que ses flags, modifiés localement par NzErrorFlags)
+	thread_local NzString s_lastError;
+	thread_local const char* s_lastErrorFunction = "";
+	thread_local const char* s_lastErrorFile = "";
+	thread_local nzUInt32 s_flags = nzErrorFlag_None;
+	thread_local unsigned int s_lastErrorCode = 0;
+	thread_local unsigned int s_lastErrorLine = 0;
+}
 
+void NzError::Error(nzErrorType type, const char* error)
+{
+	// L'affectation réutilise la mémoire de la dernière erreur, aucune allocation dans la plupart des cas
 	s_lastError = error;
-	s_lastErrorFile = "";
-	s_lastErrorFunction = "";
-	s_lastErrorLine = 0;
+	s_lastErrorCode = 0;
 
-	#if NAZARA_CORE_EXIT_ON_ASSERT_FAILURE
-	if (type == nzErrorType_AssertFailed)
-		std::exit(EXIT_FAILURE);
-	#endif
+	Report(type, 0, "", "");
+}
 
-	if ((s_flags & nzErrorFlag_ThrowException) != 0 && (s_flags & nzErrorFlag_ThrowExceptionDisabled) == 0)
-		throw std::runtime_error(error);
+void NzError::Error(nzErrorType type, const NzString& error)
+{
+	s_lastError = error;
+	s_lastErrorCode = 0;
+
+	Report(type, 0, "", "");
+}
+
+void NzError::Error(nzErrorType type, const char* error, unsigned int line, const char* file, const char* function)
+{
+	s_lastError = error;
+	s_lastErrorCode = 0;
+
+	Report(type, line, file, function);
 }
 
 void NzError::Error(nzErrorType type, const NzString& error, unsigned int line, const char* file, const char* function)
 {
-	if ((s_flags & nzErrorFlag_Silent) == 0 || (s_flags & nzErrorFlag_SilentDisabled) != 0)
-		NazaraLog->WriteError(type, error, line, file, function);
+	s_lastError = error;
+	s_lastErrorCode = 0;
+
+	Report(type, line, file, function);
+}
 
+void NzError::Error(nzErrorType type, unsigned int code, const char* error, unsigned int line, const char* file, const char* function)
+{
 	s_lastError = error;
-	s_lastErrorFile = file;
-	s_lastErrorFunction = function;
-	s_lastErrorLine = line;
+	s_lastErrorCode = code;
 
-	#if NAZARA_CORE_EXIT_ON_ASSERT_FAILURE
-	if (type == nzErrorType_AssertFailed)
-		std::exit(EXIT_FAILURE);
-	#endif
+	Report(type, line, file, function);
+}
 
-	if ((s_flags & nzErrorFlag_ThrowException) != 0 && (s_flags & nzErrorFlag_ThrowExceptionDisabled) == 0)
-		throw std::runtime_error(error);
+void NzError::Error(nzErrorType type, unsigned int code, const NzString& error, unsigned int line, const char* file, const char* function)
+{
+	s_lastError = error;
+	s_lastErrorCode = code;
+
+	Report(type, line, file, function);
 }
 
 nzUInt32 NzError::GetFlags()
@@ -72,6 +94,11 @@ NzString NzError::GetLastError(const char** file, unsigned int* line, const char
 	return s_lastError;
 }
 
+unsigned int NzError::GetLastErrorCode()
+{
+	return s_lastErrorCode;
+}
+
 unsigned int NzError::GetLastSystemErrorCode()
 {
 	#if defined(NAZARA_PLATFORM_WINDOWS)
@@ -112,13 +139,58 @@ NzString NzError::GetLastSystemError(unsigned int code)
 	#endif
 }
 
+bool NzError::IsSilent()
+{
+	// Vrai si une erreur ne serait ni écrite dans le log, ni levée sous forme d'exception
+	bool logged = (s_flags & nzErrorFlag_Silent) == 0 || (s_flags & nzErrorFlag_SilentDisabled) != 0;
+	bool thrown = (s_flags & nzErrorFlag_ThrowException) != 0 && (s_flags & nzErrorFlag_ThrowExceptionDisabled) == 0;
+
+	return !logged && !thrown;
+}
+
 void NzError::SetFlags(nzUInt32 flags)
 {
 	s_flags = flags;
 }
 
-nzUInt32 NzError::s_flags = nzErrorFlag_None;
-NzString NzError::s_lastError;
-const char* NzError::s_lastErrorFunction = "";
-const char* NzError::s_lastErrorFile = "";
-unsigned int NzError::s_lastErrorLine = 0;
+void NzError::SetLastError(const char* error, unsigned int code, unsigned int line, const char* file, const char* function)
+{
+	// Comme Error, mais sans écriture dans le log ni exception
+	s_lastError = error;
+	s_lastErrorCode = code;
+	s_lastErrorFile = file;
+	s_lastErrorFunction = function;
+	s_lastErrorLine = line;
+}
+
+void NzError::SetLastError(const NzString& error, unsigned int code, unsigned int line, const char* file, const char* function)
+{
+	s_lastError = error;
+	s_lastErrorCode = code;
+	s_lastErrorFile = file;
+	s_lastErrorFunction = function;
+	s_lastErrorLine = line;
+}
+
+void NzError::Report(nzErrorType type, unsigned int line, const char* file, const char* function)
+{
+	s_lastErrorFile = file;
+	s_lastErrorFunction = function;
+	s_lastErrorLine = line;
+
+	if ((s_flags & nzErrorFlag_Silent) == 0 || (s_flags & nzErrorFlag_SilentDisabled) != 0)
+	{
+		if (line != 0)
+			NazaraLog->WriteError(type, s_lastError, line, file, function);
+		else
+			NazaraLog->WriteError(type, s_lastError);
+	}
+
+	#if NAZARA_CORE_EXIT_ON_ASSERT_FAILURE
+	if (type == nzErrorType_AssertFailed)
+		std::exit(EXIT_FAILURE);
+	#endif
+
+	if ((s_flags & nzErrorFlag_ThrowException) != 0 && (s_flags & nzErrorFlag_ThrowExceptionDisabled) == 0)
+		throw std::runtime_error(s_lastError);
+}
@@ -0,0 +1,78 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Event.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <Nazara/Core/LockGuard.hpp>
+#include <Nazara/Core/Debug.hpp>
+
+NzEvent::NzEvent(bool autoReset, bool signaled) :
+m_autoReset(autoReset),
+m_signaled(signaled)
+{
+}
+
+bool NzEvent::IsAutoReset() const
+{
+	return m_autoReset;
+}
+
+bool NzEvent::IsSignaled() const
+{
+	NzLockGuard lock(m_mutex);
+
+	return m_signaled;
+}
+
+void NzEvent::Reset()
+{
+	NzLockGuard lock(m_mutex);
+
+	m_signaled = false;
+}
+
+void NzEvent::Signal()
+{
+	NzLockGuard lock(m_mutex);
+
+	m_signaled = true;
+
+	// Un évènement à réinitialisation automatique ne libère qu'un seul thread
+	if (m_autoReset)
+		m_condition.Signal();
+	else
+		m_condition.SignalAll();
+}
+
+void NzEvent::Wait()
+{
+	NzLockGuard lock(m_mutex);
+
+	while (!m_signaled)
+		m_condition.Wait(&m_mutex);
+
+	if (m_autoReset)
+		m_signaled = false;
+}
+
+bool NzEvent::Wait(nzUInt32 timeout)
+{
+	NzLockGuard lock(m_mutex);
+
+	// Les réveils intempestifs ne doivent pas prolonger l'attente au-delà du délai demandé
+	nzUInt64 deadline = NzGetMilliseconds() + timeout;
+	while (!m_signaled)
+	{
+		nzUInt64 now = NzGetMilliseconds();
+		if (now >= deadline)
+			return false;
+
+		m_condition.Wait(&m_mutex, static_cast<nzUInt32>(deadline - now));
+	}
+
+	if (m_autoReset)
+		m_signaled = false;
+
+	return true;
+}
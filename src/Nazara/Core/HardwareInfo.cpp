@@ -3,9 +3,15 @@
 // For conditions of distribution and use, see copyright notice in Config.hpp
 
 #include <Nazara/Core/HardwareInfo.hpp>
+#include <Nazara/Core/Config.hpp>
 #include <Nazara/Core/Error.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
 
 #if defined(NAZARA_PLATFORM_WINDOWS)
 	#include <Nazara/Core/Win32/HardwareInfoImpl.hpp>
@@ -66,6 +72,170 @@ namespace
 
 	char s_brandString[48] = "Not initialized";
 	char s_vendor[12] = {'C', 'P', 'U', 'i', 's', 'U', 'n', 'k', 'n', 'o', 'w', 'n'};
+
+	struct Topology
+	{
+		std::vector<unsigned int> cores;
+		std::vector<unsigned int> nodes;
+		std::vector<unsigned int> packages;
+		unsigned int cacheLineSize = 0;
+		unsigned int cacheSizes[3] = {0, 0, 0};
+		unsigned int coreCount;
+		unsigned int nodeCount;
+		unsigned int packageCount;
+	};
+
+	void QueryCpuidCaches(Topology& topology)
+	{
+		nzUInt32 result[4];
+		NzHardwareInfoImpl::Cpuid(0, result);
+		unsigned int ids = result[0];
+
+		char vendor[12];
+		std::memcpy(&vendor[0], &result[1], 4);
+		std::memcpy(&vendor[4], &result[3], 4);
+		std::memcpy(&vendor[8], &result[2], 4);
+
+		if (std::memcmp(vendor, "GenuineIntel", 12) == 0 && ids >= 4)
+		{
+			// Paramètres déterministes des caches (feuille 4)
+			for (nzUInt32 index = 0; ; ++index)
+			{
+				nzUInt32 regs[4];
+				NzHardwareInfoImpl::Cpuid(4, regs, index);
+
+				unsigned int type = regs[0] & 0x1F;
+				if (type == 0)
+					break; // Plus de cache
+
+				unsigned int level = (regs[0] >> 5) & 0x7;
+				if (type == 2 || level < 1 || level > 3) // Cache d'instructions
+					continue;
+
+				unsigned int ways = ((regs[1] >> 22) & 0x3FF) + 1;
+				unsigned int partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+				unsigned int lineSize = (regs[1] & 0xFFF) + 1;
+				unsigned int sets = regs[2] + 1;
+
+				if (topology.cacheSizes[level-1] == 0)
+					topology.cacheSizes[level-1] = ways*partitions*lineSize*sets;
+
+				if (level == 1 && topology.cacheLineSize == 0)
+					topology.cacheLineSize = lineSize;
+			}
+		}
+		else
+		{
+			// Fonctions étendues, utilisées par AMD
+			NzHardwareInfoImpl::Cpuid(0x80000000, result);
+			unsigned int exIds = result[0];
+
+			if (exIds >= 0x80000005)
+			{
+				NzHardwareInfoImpl::Cpuid(0x80000005, result);
+				if (topology.cacheSizes[0] == 0)
+					topology.cacheSizes[0] = (result[2] >> 24)*1024;
+
+				if (topology.cacheLineSize == 0)
+					topology.cacheLineSize = result[2] & 0xFF;
+			}
+
+			if (exIds >= 0x80000006)
+			{
+				NzHardwareInfoImpl::Cpuid(0x80000006, result);
+				if (topology.cacheSizes[1] == 0)
+					topology.cacheSizes[1] = (result[2] >> 16)*1024;
+
+				if (topology.cacheSizes[2] == 0)
+					topology.cacheSizes[2] = (result[3] >> 18)*512*1024;
+			}
+		}
+	}
+
+	const Topology& GetTopology()
+	{
+		///DOC: Ne nécessite pas l'initialisation de HardwareInfo pour fonctionner
+		static Topology topology = []() -> Topology
+		{
+			Topology t;
+
+			unsigned int processorCount = NzHardwareInfo::GetProcessorCount();
+			t.cores.resize(processorCount);
+			t.nodes.resize(processorCount);
+			t.packages.resize(processorCount);
+
+			if (!NzHardwareInfoImpl::GetTopology(processorCount, &t.cores[0], &t.packages[0], &t.nodes[0], t.cacheSizes, &t.cacheLineSize))
+			{
+				// Topologie inconnue, chaque processeur logique est considéré comme un coeur physique
+				for (unsigned int i = 0; i < processorCount; ++i)
+				{
+					t.cores[i] = i;
+					t.nodes[i] = 0;
+					t.packages[i] = 0;
+				}
+			}
+
+			if (NzHardwareInfoImpl::IsCpuidSupported() && (t.cacheSizes[0] == 0 || t.cacheLineSize == 0))
+				QueryCpuidCaches(t);
+
+			if (t.cacheLineSize == 0)
+				t.cacheLineSize = NAZARA_CORE_CACHE_LINE_SIZE;
+
+			// Les identifiants de coeurs ne sont uniques qu'au sein d'un même processeur physique, on les renumérote
+			std::map<std::pair<unsigned int, unsigned int>, unsigned int> coreIds;
+			std::set<unsigned int> nodes;
+			std::set<unsigned int> packages;
+			for (unsigned int i = 0; i < processorCount; ++i)
+			{
+				auto it = coreIds.insert(std::make_pair(std::make_pair(t.packages[i], t.cores[i]), coreIds.size())).first;
+				t.cores[i] = it->second;
+
+				nodes.insert(t.nodes[i]);
+				packages.insert(t.packages[i]);
+			}
+
+			t.coreCount = coreIds.size();
+			t.nodeCount = nodes.size();
+			t.packageCount = packages.size();
+
+			return t;
+		}();
+
+		return topology;
+	}
+}
+
+unsigned int NzHardwareInfo::GetCacheLineSize()
+{
+	return GetTopology().cacheLineSize;
+}
+
+unsigned int NzHardwareInfo::GetCacheSize(unsigned int level)
+{
+	#if NAZARA_CORE_SAFE
+	if (level < 1 || level > 3)
+	{
+		NazaraError("Cache level out of range (" + NzString::Number(level) + " not in [1, 3])");
+		return 0;
+	}
+	#endif
+
+	return GetTopology().cacheSizes[level-1];
+}
+
+unsigned int NzHardwareInfo::GetNumaNodeCount()
+{
+	return GetTopology().nodeCount;
+}
+
+unsigned int NzHardwareInfo::GetPackageCount()
+{
+	return GetTopology().packageCount;
+}
+
+unsigned int NzHardwareInfo::GetPhysicalCoreCount()
+{
+	return GetTopology().coreCount;
 }
 
 NzString NzHardwareInfo::GetProcessorBrandString()
@@ -73,6 +243,19 @@ NzString NzHardwareInfo::GetProcessorBrandString()
 	return s_brandString;
 }
 
+unsigned int NzHardwareInfo::GetProcessorCore(unsigned int processor)
+{
+	#if NAZARA_CORE_SAFE
+	if (processor >= GetProcessorCount())
+	{
+		NazaraError("Processor index out of range (" + NzString::Number(processor) + " >= " + NzString::Number(GetProcessorCount()) + ')');
+		return 0;
+	}
+	#endif
+
+	return GetTopology().cores[processor];
+}
+
 unsigned int NzHardwareInfo::GetProcessorCount()
 {
 	///DOC: Ne nécessite pas l'initialisation de HardwareInfo pour fonctionner
@@ -80,6 +263,32 @@ unsigned int NzHardwareInfo::GetProcessorCount()
 	return processorCount;
 }
 
+unsigned int NzHardwareInfo::GetProcessorNumaNode(unsigned int processor)
+{
+	#if NAZARA_CORE_SAFE
+	if (processor >= GetProcessorCount())
+	{
+		NazaraError("Processor index out of range (" + NzString::Number(processor) + " >= " + NzString::Number(GetProcessorCount()) + ')');
+		return 0;
+	}
+	#endif
+
+	return GetTopology().nodes[processor];
+}
+
+unsigned int NzHardwareInfo::GetProcessorPackage(unsigned int processor)
+{
+	#if NAZARA_CORE_SAFE
+	if (processor >= GetProcessorCount())
+	{
+		NazaraError("Processor index out of range (" + NzString::Number(processor) + " >= " + NzString::Number(GetProcessorCount()) + ')');
+		return 0;
+	}
+	#endif
+
+	return GetTopology().packages[processor];
+}
+
 nzProcessorVendor NzHardwareInfo::GetProcessorVendor()
 {
 	return s_vendorEnum;
@@ -136,8 +345,15 @@ bool NzHardwareInfo::Initialize()
 	if (ids >= 1)
 	{
 		NzHardwareInfoImpl::Cpuid(1, result);
-		s_capabilities[nzProcessorCap_AVX]   = (result[2] & (1U << 28)) != 0;
-		s_capabilities[nzProcessorCap_FMA3]  = (result[2] & (1U << 12)) != 0;
+
+		// Les registres YMM/ZMM doivent aussi être sauvegardés par l'OS lors des changements de contexte (XCR0)
+		bool osxsave = (result[2] & (1U << 27)) != 0;
+		nzUInt64 xcr0 = (osxsave) ? NzHardwareInfoImpl::Xgetbv(0) : 0;
+		bool avxState = (xcr0 & 0x06) == 0x06;                   // XMM et YMM
+		bool avx512State = avxState && (xcr0 & 0xE0) == 0xE0;    // Opmask, ZMM_Hi256 et Hi16_ZMM
+
+		s_capabilities[nzProcessorCap_AVX]   = avxState && (result[2] & (1U << 28)) != 0;
+		s_capabilities[nzProcessorCap_FMA3]  = avxState && (result[2] & (1U << 12)) != 0;
 		s_capabilities[nzProcessorCap_MMX]   = (result[3] & (1U << 23)) != 0;
 		s_capabilities[nzProcessorCap_SSE]   = (result[3] & (1U << 25)) != 0;
 		s_capabilities[nzProcessorCap_SSE2]  = (result[3] & (1U << 26)) != 0;
@@ -146,6 +362,13 @@ bool NzHardwareInfo::Initialize()
 		s_capabilities[nzProcessorCap_SSE41] = (result[2] & (1U << 19)) != 0;
 		s_capabilities[nzProcessorCap_SSE42] = (result[2] & (1U << 20)) != 0;
 
+		if (ids >= 7)
+		{
+			NzHardwareInfoImpl::Cpuid(7, result, 0);
+			s_capabilities[nzProcessorCap_AVX2]    = avxState && (result[1] & (1U <<  5)) != 0;
+			s_capabilities[nzProcessorCap_AVX512F] = avx512State && (result[1] & (1U << 16)) != 0;
+		}
+
 		NzHardwareInfoImpl::Cpuid(0x80000000, result);
 		unsigned int exIds = result[0];
 
@@ -4,15 +4,45 @@
 
 #include <Nazara/Core/Posix/HardwareInfoImpl.hpp>
 #include <Nazara/Core/Error.hpp>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
 #include <Nazara/Core/Debug.hpp>
 
-void NzHardwareInfoImpl::Cpuid(nzUInt32 code, nzUInt32 result[4])
+namespace
+{
+	bool ReadSysValue(const char* path, unsigned int* value)
+	{
+		std::FILE* file = std::fopen(path, "r");
+		if (!file)
+			return false;
+
+		bool success = (std::fscanf(file, "%u", value) == 1);
+		std::fclose(file);
+
+		return success;
+	}
+
+	bool ReadSysString(const char* path, char* buffer, unsigned int size)
+	{
+		std::FILE* file = std::fopen(path, "r");
+		if (!file)
+			return false;
+
+		bool success = (std::fgets(buffer, size, file) != nullptr);
+		std::fclose(file);
+
+		return success;
+	}
+}
+
+void NzHardwareInfoImpl::Cpuid(nzUInt32 code, nzUInt32 result[4], nzUInt32 subCode)
 {
 	#if defined(NAZARA_COMPILER_CLANG) || defined(NAZARA_COMPILER_GCC) || defined(NAZARA_COMPILER_INTEL)
 	// Source: http://stackoverflow.com/questions/1666093/cpuid-implementations-in-c
 	asm volatile ("cpuid" // Besoin d'être volatile ?
 				  : "=a" (result[0]), "=b" (result[1]), "=c" (result[2]), "=d" (result[3]) // output
-                  : "a" (code), "c" (0));                                                  // input
+                  : "a" (code), "c" (subCode));                                            // input
 	#else
 	NazaraInternalError("Cpuid has been called although it is not supported");
 	#endif
@@ -24,6 +54,71 @@ unsigned int NzHardwareInfoImpl::GetProcessorCount()
 	return sysconf(_SC_NPROCESSORS_CONF);
 }
 
+bool NzHardwareInfoImpl::GetTopology(unsigned int processorCount, unsigned int* cores, unsigned int* packages, unsigned int* nodes, unsigned int cacheSizes[3], unsigned int* cacheLineSize)
+{
+	// La topologie est exposée par le sysfs sous Linux, les autres systèmes se rabattent sur le CPUID
+	char path[128];
+	for (unsigned int i = 0; i < processorCount; ++i)
+	{
+		std::sprintf(path, "/sys/devices/system/cpu/cpu%u/topology/core_id", i);
+		if (!ReadSysValue(path, &cores[i]))
+			return false;
+
+		std::sprintf(path, "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", i);
+		if (!ReadSysValue(path, &packages[i]))
+			packages[i] = 0;
+
+		// Le noeud NUMA apparaît sous la forme d'un lien "nodeX" dans le dossier du processeur
+		nodes[i] = 0;
+
+		std::sprintf(path, "/sys/devices/system/cpu/cpu%u", i);
+		DIR* dir = opendir(path);
+		if (dir)
+		{
+			while (dirent* entry = readdir(dir))
+			{
+				unsigned int node;
+				if (std::sscanf(entry->d_name, "node%u", &node) == 1)
+				{
+					nodes[i] = node;
+					break;
+				}
+			}
+
+			closedir(dir);
+		}
+	}
+
+	for (unsigned int index = 0; ; ++index)
+	{
+		unsigned int level;
+		std::sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%u/level", index);
+		if (!ReadSysValue(path, &level))
+			break;
+
+		char type[32];
+		std::sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%u/type", index);
+		if (!ReadSysString(path, type, sizeof(type)) || std::strncmp(type, "Instruction", 11) == 0)
+			continue;
+
+		if (level < 1 || level > 3)
+			continue;
+
+		// La taille est exprimée en kibioctets ("32K")
+		unsigned int size;
+		std::sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%u/size", index);
+		if (ReadSysValue(path, &size))
+			cacheSizes[level-1] = size*1024;
+
+		unsigned int lineSize;
+		std::sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%u/coherency_line_size", index);
+		if (level == 1 && ReadSysValue(path, &lineSize))
+			*cacheLineSize = lineSize;
+	}
+
+	return true;
+}
+
 bool NzHardwareInfoImpl::IsCpuidSupported()
 {
 	#ifdef NAZARA_PLATFORM_x64
@@ -53,3 +148,18 @@ bool NzHardwareInfoImpl::IsCpuidSupported()
 		#endif
 	#endif
 }
+
+nzUInt64 NzHardwareInfoImpl::Xgetbv(nzUInt32 index)
+{
+	#if defined(NAZARA_COMPILER_CLANG) || defined(NAZARA_COMPILER_GCC) || defined(NAZARA_COMPILER_INTEL)
+	nzUInt32 eax, edx;
+	asm volatile (".byte 0x0f, 0x01, 0xd0" // xgetbv, encodé à la main pour les assembleurs ne le connaissant pas
+				  : "=a" (eax), "=d" (edx) // output
+				  : "c" (index));          // input
+
+	return (static_cast<nzUInt64>(edx) << 32) | eax;
+	#else
+	NazaraInternalError("Xgetbv has been called although it is not supported");
+	return 0;
+	#endif
+}
@@ -0,0 +1,46 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Posix/RWLockImpl.hpp>
+#include <Nazara/Core/Debug.hpp>
+
+NzRWLockImpl::NzRWLockImpl()
+{
+	pthread_rwlock_init(&m_handle, NULL);
+}
+
+NzRWLockImpl::~NzRWLockImpl()
+{
+	pthread_rwlock_destroy(&m_handle);
+}
+
+void NzRWLockImpl::LockRead()
+{
+	pthread_rwlock_rdlock(&m_handle);
+}
+
+void NzRWLockImpl::LockWrite()
+{
+	pthread_rwlock_wrlock(&m_handle);
+}
+
+bool NzRWLockImpl::TryLockRead()
+{
+	return pthread_rwlock_tryrdlock(&m_handle) == 0;
+}
+
+bool NzRWLockImpl::TryLockWrite()
+{
+	return pthread_rwlock_trywrlock(&m_handle) == 0;
+}
+
+void NzRWLockImpl::UnlockRead()
+{
+	pthread_rwlock_unlock(&m_handle);
+}
+
+void NzRWLockImpl::UnlockWrite()
+{
+	pthread_rwlock_unlock(&m_handle);
+}
@@ -0,0 +1,29 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_RWLOCKIMPL_HPP
+#define NAZARA_RWLOCKIMPL_HPP
+
+#include <pthread.h>
+
+class NzRWLockImpl
+{
+	public:
+		NzRWLockImpl();
+		~NzRWLockImpl();
+
+		void LockRead();
+		void LockWrite();
+		bool TryLockRead();
+		bool TryLockWrite();
+		void UnlockRead();
+		void UnlockWrite();
+
+	private:
+		pthread_rwlock_t m_handle;
+};
+
+#endif // NAZARA_RWLOCKIMPL_HPP
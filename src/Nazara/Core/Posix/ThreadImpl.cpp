@@ -4,14 +4,128 @@
 
 #include <Nazara/Core/Posix/ThreadImpl.hpp>
 #include <Nazara/Core/Error.hpp>
-#include <Nazara/Core/Functor.hpp>
+#include <Nazara/Core/String.hpp>
+#include <sched.h>
 #include <unistd.h>
 #include <sys/time.h>
+
+#if defined(NAZARA_PLATFORM_LINUX)
+	#include <sys/resource.h>
+	#include <sys/syscall.h>
+#endif
+
 #include <Nazara/Core/Debug.hpp>
 
-NzThreadImpl::NzThreadImpl(NzFunctor* functor)
+namespace
+{
+	bool SetThreadAffinity(pthread_t handle, nzUInt64 processorMask)
+	{
+		#if defined(NAZARA_PLATFORM_LINUX)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (unsigned int i = 0; i < 64; ++i)
+		{
+			if (processorMask & (static_cast<nzUInt64>(1) << i))
+				CPU_SET(i, &set);
+		}
+
+		int error = pthread_setaffinity_np(handle, sizeof(cpu_set_t), &set);
+		if (error != 0)
+		{
+			NazaraError("Failed to set thread affinity: " + NzError::GetLastSystemError(error));
+			return false;
+		}
+
+		return true;
+		#else
+		NazaraUnused(handle);
+		NazaraUnused(processorMask);
+
+		NazaraError("Thread affinity is not supported on this platform");
+		return false;
+		#endif
+	}
+
+	bool SetThreadName(pthread_t handle, const NzString& name)
+	{
+		#if defined(NAZARA_PLATFORM_LINUX)
+		// Le noyau limite le nom à 16 caractères, zéro terminal compris
+		int error = pthread_setname_np(handle, name.SubString(0, 14).GetConstBuffer());
+		if (error != 0)
+		{
+			NazaraError("Failed to set thread name: " + NzError::GetLastSystemError(error));
+			return false;
+		}
+
+		return true;
+		#else
+		NazaraUnused(handle);
+		NazaraUnused(name);
+
+		NazaraError("Thread naming is not supported on this platform");
+		return false;
+		#endif
+	}
+
+	bool SetThreadPriority(pthread_t handle, nzThreadPriority priority)
+	{
+		int policy;
+		sched_param param;
+		if (pthread_getschedparam(handle, &policy, &param) != 0)
+		{
+			NazaraError("Failed to get thread scheduling parameters: " + NzError::GetLastSystemError());
+			return false;
+		}
+
+		int minPriority = sched_get_priority_min(policy);
+		int maxPriority = sched_get_priority_max(policy);
+		if (minPriority < maxPriority)
+		{
+			param.sched_priority = minPriority + ((maxPriority - minPriority)*priority)/nzThreadPriority_Max;
+
+			int error = pthread_setschedparam(handle, policy, &param);
+			if (error != 0)
+			{
+				NazaraError("Failed to set thread priority: " + NzError::GetLastSystemError(error));
+				return false;
+			}
+
+			return true;
+		}
+
+		#if defined(NAZARA_PLATFORM_LINUX)
+		// La politique par défaut (SCHED_OTHER) n'a qu'un niveau de priorité, Linux permet cependant
+		// d'affecter une valeur de politesse à chaque thread, mais uniquement depuis le thread concerné
+		if (pthread_equal(handle, pthread_self()))
+		{
+			static const int niceValues[nzThreadPriority_Max+1] =
+			{
+				10, // nzThreadPriority_Lowest
+				5,  // nzThreadPriority_Low
+				0,  // nzThreadPriority_Normal
+				-5, // nzThreadPriority_High
+				-10 // nzThreadPriority_Highest
+			};
+
+			// Une valeur négative nécessite des privilèges
+			if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), niceValues[priority]) != 0)
+			{
+				NazaraError("Failed to set thread priority: " + NzError::GetLastSystemError());
+				return false;
+			}
+
+			return true;
+		}
+		#endif
+
+		NazaraError("Thread priority is not supported by the scheduling policy");
+		return false;
+	}
+}
+
+NzThreadImpl::NzThreadImpl(NzCallable<void()>* function)
 {
-    int error = pthread_create(&m_handle, nullptr, &NzThreadImpl::ThreadProc, functor);
+    int error = pthread_create(&m_handle, nullptr, &NzThreadImpl::ThreadProc, function);
 	if (error != 0)
 		NazaraInternalError("Failed to create thread: " + NzError::GetLastSystemError());
 }
@@ -26,11 +140,41 @@ void NzThreadImpl::Join()
 	pthread_join(m_handle, nullptr);
 }
 
+bool NzThreadImpl::SetAffinity(nzUInt64 processorMask)
+{
+	return SetThreadAffinity(m_handle, processorMask);
+}
+
+bool NzThreadImpl::SetName(const NzString& name)
+{
+	return SetThreadName(m_handle, name);
+}
+
+bool NzThreadImpl::SetPriority(nzThreadPriority priority)
+{
+	return SetThreadPriority(m_handle, priority);
+}
+
+bool NzThreadImpl::SetCurrentThreadAffinity(nzUInt64 processorMask)
+{
+	return SetThreadAffinity(pthread_self(), processorMask);
+}
+
+bool NzThreadImpl::SetCurrentThreadName(const NzString& name)
+{
+	return SetThreadName(pthread_self(), name);
+}
+
+bool NzThreadImpl::SetCurrentThreadPriority(nzThreadPriority priority)
+{
+	return SetThreadPriority(pthread_self(), priority);
+}
+
 void* NzThreadImpl::ThreadProc(void* userdata)
 {
-	NzFunctor* func = static_cast<NzFunctor*>(userdata);
-	func->Run();
-	delete func;
+	NzCallable<void()>* function = static_cast<NzCallable<void()>*>(userdata);
+	(*function)();
+	delete function;
 
 	return nullptr;
 }
@@ -51,7 +195,7 @@ void NzThreadImpl::Sleep(nzUInt32 time)
 
     // construct the time limit (current time + time to wait)
     timespec ti;
-    ti.tv_nsec = (tv.tv_usec + (time % 1000)) * 1000;
+    ti.tv_nsec = (tv.tv_usec + (time % 1000) * 1000) * 1000;
     ti.tv_sec = tv.tv_sec + (time / 1000) + (ti.tv_nsec / 1000000000);
     ti.tv_nsec %= 1000000000;
 
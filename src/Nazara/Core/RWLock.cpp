@@ -0,0 +1,77 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/RWLock.hpp>
+
+#if defined(NAZARA_PLATFORM_WINDOWS)
+	#include <Nazara/Core/Win32/RWLockImpl.hpp>
+#elif defined(NAZARA_PLATFORM_POSIX)
+	#include <Nazara/Core/Posix/RWLockImpl.hpp>
+#else
+	#error Lack of implementation: RWLock
+#endif
+
+#include <Nazara/Core/Debug.hpp>
+
+NzRWLock::NzRWLock()
+{
+	m_impl = new NzRWLockImpl;
+}
+
+NzRWLock::~NzRWLock()
+{
+	delete m_impl;
+}
+
+void NzRWLock::LockRead()
+{
+	m_impl->LockRead();
+}
+
+void NzRWLock::LockWrite()
+{
+	m_impl->LockWrite();
+}
+
+bool NzRWLock::TryLockRead()
+{
+	return m_impl->TryLockRead();
+}
+
+bool NzRWLock::TryLockWrite()
+{
+	return m_impl->TryLockWrite();
+}
+
+void NzRWLock::UnlockRead()
+{
+	m_impl->UnlockRead();
+}
+
+void NzRWLock::UnlockWrite()
+{
+	m_impl->UnlockWrite();
+}
+
+NzReadLockGuard::NzReadLockGuard(NzRWLock& lock) :
+m_lock(lock)
+{
+	m_lock.LockRead();
+}
+
+NzReadLockGuard::~NzReadLockGuard()
+{
+	m_lock.UnlockRead();
+}
+
+NzWriteLockGuard::NzWriteLockGuard(NzRWLock& lock) :
+m_lock(lock)
+{
+	m_lock.LockWrite();
+}
+
+NzWriteLockGuard::~NzWriteLockGuard()
+{
+	m_lock.UnlockWrite();
+}
@@ -0,0 +1,180 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/SimdDispatch.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/HardwareInfo.hpp>
+#include <Nazara/Core/String.hpp>
+#include <cstdlib>
+#include <Nazara/Core/Debug.hpp>
+
+///DOC: La variable d'environnement NAZARA_SIMD_LEVEL (scalar, sse2, sse41, avx2 ou avx512) permet de forcer un niveau
+///     inférieur à celui supporté par le processeur, afin de tester chaque implémentation sur une même machine
+
+namespace
+{
+	const char* levelNames[nzSimdLevel_Max+1] =
+	{
+		"scalar", // nzSimdLevel_Scalar
+		"sse2",   // nzSimdLevel_SSE2
+		"sse41",  // nzSimdLevel_SSE41
+		"avx2",   // nzSimdLevel_AVX2
+		"avx512"  // nzSimdLevel_AVX512
+	};
+
+	// Initialisé à zéro avant toute construction dynamique, les noyaux peuvent donc s'enregistrer depuis n'importe quelle unité de compilation
+	NzSimdFunctionBase* s_functions = nullptr;
+	nzSimdLevel s_level = nzSimdLevel_Scalar;
+	nzSimdLevel s_supportedLevel = nzSimdLevel_Scalar;
+	bool s_initialized = false;
+
+	nzSimdLevel ComputeSupportedLevel()
+	{
+		if (!NzHardwareInfo::Initialize())
+			return nzSimdLevel_Scalar;
+
+		if (NzHardwareInfo::HasCapability(nzProcessorCap_AVX512F) && NzHardwareInfo::HasCapability(nzProcessorCap_AVX2))
+			return nzSimdLevel_AVX512;
+		else if (NzHardwareInfo::HasCapability(nzProcessorCap_AVX2) && NzHardwareInfo::HasCapability(nzProcessorCap_FMA3))
+			return nzSimdLevel_AVX2;
+		else if (NzHardwareInfo::HasCapability(nzProcessorCap_SSE41))
+			return nzSimdLevel_SSE41;
+		else if (NzHardwareInfo::HasCapability(nzProcessorCap_SSE2))
+			return nzSimdLevel_SSE2;
+		else
+			return nzSimdLevel_Scalar;
+	}
+}
+
+nzSimdLevel NzSimdDispatch::GetLevel()
+{
+	return s_level;
+}
+
+nzSimdLevel NzSimdDispatch::GetSupportedLevel()
+{
+	return s_supportedLevel;
+}
+
+bool NzSimdDispatch::Initialize()
+{
+	if (s_initialized)
+		return true; // Déjà initialisé
+
+	s_supportedLevel = ComputeSupportedLevel();
+	s_initialized = true;
+
+	nzSimdLevel level = s_supportedLevel;
+
+	const char* forcedLevel = std::getenv("NAZARA_SIMD_LEVEL");
+	if (forcedLevel)
+	{
+		NzString levelName = NzString(forcedLevel).ToLower();
+
+		bool found = false;
+		for (unsigned int i = 0; i <= nzSimdLevel_Max; ++i)
+		{
+			if (levelName == levelNames[i])
+			{
+				level = static_cast<nzSimdLevel>(i);
+				found = true;
+				break;
+			}
+		}
+
+		if (!found)
+			NazaraWarning("Unknown SIMD level \"" + levelName + "\" in NAZARA_SIMD_LEVEL, ignoring");
+	}
+
+	if (!SetLevel(level))
+		SetLevel(s_supportedLevel);
+
+	return true;
+}
+
+bool NzSimdDispatch::IsInitialized()
+{
+	return s_initialized;
+}
+
+bool NzSimdDispatch::IsLevelSupported(nzSimdLevel level)
+{
+	return level <= s_supportedLevel;
+}
+
+bool NzSimdDispatch::SetLevel(nzSimdLevel level)
+{
+	#ifdef NAZARA_DEBUG
+	if (level > nzSimdLevel_Max)
+	{
+		NazaraError("SIMD level out of enum");
+		return false;
+	}
+	#endif
+
+	#if NAZARA_CORE_SAFE
+	if (!s_initialized)
+	{
+		NazaraError("SIMD dispatch is not initialized");
+		return false;
+	}
+	#endif
+
+	// Exécuter une instruction non-supportée terminerait le programme
+	if (!IsLevelSupported(level))
+	{
+		NazaraError("SIMD level " + NzString(levelNames[level]) + " is not supported by this processor (max: " + levelNames[s_supportedLevel] + ')');
+		return false;
+	}
+
+	///FIXME: Les noyaux ne doivent pas être appelés par un autre thread pendant la résolution
+	s_level = level;
+	for (NzSimdFunctionBase* function = s_functions; function; function = function->m_next)
+		function->Resolve(level);
+
+	return true;
+}
+
+void NzSimdDispatch::Uninitialize()
+{
+	// On revient aux implémentations scalaires, toujours valides
+	for (NzSimdFunctionBase* function = s_functions; function; function = function->m_next)
+		function->Resolve(nzSimdLevel_Scalar);
+
+	s_initialized = false;
+	s_level = nzSimdLevel_Scalar;
+	s_supportedLevel = nzSimdLevel_Scalar;
+}
+
+void NzSimdDispatch::Register(NzSimdFunctionBase* function)
+{
+	function->m_next = s_functions;
+	function->m_previous = nullptr;
+
+	if (s_functions)
+		s_functions->m_previous = function;
+
+	s_functions = function;
+}
+
+void NzSimdDispatch::Unregister(NzSimdFunctionBase* function)
+{
+	if (function->m_previous)
+		function->m_previous->m_next = function->m_next;
+	else
+		s_functions = function->m_next;
+
+	if (function->m_next)
+		function->m_next->m_previous = function->m_previous;
+}
+
+NzSimdFunctionBase::NzSimdFunctionBase()
+{
+	NzSimdDispatch::Register(this);
+}
+
+NzSimdFunctionBase::~NzSimdFunctionBase()
+{
+	NzSimdDispatch::Unregister(this);
+}
@@ -0,0 +1,59 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/SpinMutex.hpp>
+#include <algorithm>
+
+#if defined(NAZARA_COMPILER_MSVC)
+	#include <intrin.h>
+#endif
+
+#include <Nazara/Core/Debug.hpp>
+
+namespace
+{
+	const int maxSpinCount = 1024;
+	const int minSpinCount = 16;
+
+	inline void CpuRelax()
+	{
+		// Indique au processeur que nous sommes dans une boucle d'attente active (libère le second thread matériel)
+		#if defined(NAZARA_COMPILER_MSVC) && (defined(_M_IX86) || defined(_M_X64))
+		_mm_pause();
+		#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+		__asm__ __volatile__("pause");
+		#endif
+	}
+}
+
+NzSpinMutex::NzSpinMutex() :
+m_semaphore(0),
+m_count(0),
+m_spinCount(128)
+{
+}
+
+void NzSpinMutex::LockContended()
+{
+	// Le nombre d'essais s'adapte au temps de détention habituel du verrou:
+	// il augmente si l'attente active a suffi, diminue sinon
+	int spinCount = m_spinCount.load(std::memory_order_relaxed);
+	for (int i = 0; i < spinCount; ++i)
+	{
+		CpuRelax();
+
+		int expected = 0;
+		if (m_count.load(std::memory_order_relaxed) == 0 && m_count.compare_exchange_weak(expected, 1, std::memory_order_acquire))
+		{
+			m_spinCount.store(std::min(spinCount*2, maxSpinCount), std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	m_spinCount.store(std::max(spinCount/2, minSpinCount), std::memory_order_relaxed);
+
+	// On s'enregistre comme attendant, si personne ne possédait le verrou entre-temps il nous revient directement
+	if (m_count.fetch_add(1, std::memory_order_acquire) > 0)
+		m_semaphore.Wait();
+}
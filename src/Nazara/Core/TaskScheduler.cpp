@@ -5,12 +5,16 @@
 #include <Nazara/Core/TaskScheduler.hpp>
 #include <Nazara/Core/ConditionVariable.hpp>
 #include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/ErrorFlags.hpp>
 #include <Nazara/Core/HardwareInfo.hpp>
 #include <Nazara/Core/LockGuard.hpp>
 #include <Nazara/Core/Mutex.hpp>
 #include <Nazara/Core/Thread.hpp>
+#include <algorithm>
 #include <atomic>
-#include <queue>
+#include <map>
+#include <tuple>
+#include <utility>
 #include <vector>
 #include <Nazara/Core/Debug.hpp>
 
@@ -20,7 +24,7 @@ namespace
 {
 	struct TaskSchedulerImpl
 	{
-		std::queue<NzFunctor*> tasks;
+		std::vector<NzCallable<void()>> tasks; // Réutilisé d'un lot à l'autre, sans allocation une fois la capacité atteinte
 		std::vector<NzThread> workers;
 		NzConditionVariable waiterConditionVariable;
 		NzConditionVariable workerConditionVariable;
@@ -30,33 +34,92 @@ namespace
 		NzMutex workerConditionVariableMutex;
 		volatile bool running = true;
 		std::atomic<unsigned int> taskCount;
+		unsigned int nextTask = 0;
 	};
 
 	TaskSchedulerImpl* s_impl = nullptr;
+	nzThreadPriority s_workerPriority = nzThreadPriority_Normal;
 	unsigned int s_workerCount = 0;
+	bool s_workerPinning = false;
 
-	void WorkerFunc()
+	unsigned int GetWorkerProcessor(unsigned int workerIndex)
 	{
+		// Les workers sont d'abord répartis sur des coeurs physiques distincts, en alternant les noeuds NUMA,
+		// avant d'utiliser les processeurs logiques supplémentaires (Hyper-Threading)
+		static std::vector<unsigned int> processors = []() -> std::vector<unsigned int>
+		{
+			unsigned int processorCount = std::min(NzHardwareInfo::GetProcessorCount(), 64U); // Limite du masque d'affinité
+
+			std::map<unsigned int, unsigned int> coreSmtRanks; // Coeur => nombre de processeurs logiques déjà vus
+			std::map<unsigned int, unsigned int> nodeCoreRanks; // Noeud => nombre de coeurs déjà vus
+			std::map<unsigned int, unsigned int> coreNodeRanks; // Coeur => rang au sein de son noeud
+
+			std::vector<std::tuple<unsigned int, unsigned int, unsigned int, unsigned int>> keys;
+			keys.reserve(processorCount);
+			for (unsigned int i = 0; i < processorCount; ++i)
+			{
+				unsigned int core = NzHardwareInfo::GetProcessorCore(i);
+				unsigned int node = NzHardwareInfo::GetProcessorNumaNode(i);
+
+				auto it = coreNodeRanks.find(core);
+				if (it == coreNodeRanks.end())
+					it = coreNodeRanks.insert(std::make_pair(core, nodeCoreRanks[node]++)).first;
+
+				keys.push_back(std::make_tuple(coreSmtRanks[core]++, it->second, node, i));
+			}
+
+			std::sort(keys.begin(), keys.end());
+
+			std::vector<unsigned int> order;
+			order.reserve(processorCount);
+			for (auto& key : keys)
+				order.push_back(std::get<3>(key));
+
+			return order;
+		}();
+
+		return processors[workerIndex % processors.size()];
+	}
+
+	void WorkerFunc(unsigned int workerIndex)
+	{
+		{
+			// Réglages facultatifs : un worker doit démarrer même si la plateforme ne les supporte pas
+			NzErrorFlags errFlags(nzErrorFlag_Silent, true);
+
+			NzThread::SetCurrentThreadName("NzWorker #" + NzString::Number(workerIndex)); // Court: Linux tronque à 15 caractères
+
+			if (s_workerPinning)
+				NzThread::SetCurrentThreadAffinity(static_cast<nzUInt64>(1) << GetWorkerProcessor(workerIndex));
+
+			if (s_workerPriority != nzThreadPriority_Normal)
+				NzThread::SetCurrentThreadPriority(s_workerPriority);
+		}
+
 		do
 		{
-			NzFunctor* task;
+			NzCallable<void()> task;
 			{
 				NzLockGuard lock(s_impl->taskMutex);
-				if (!s_impl->tasks.empty())
+				if (s_impl->nextTask < s_impl->tasks.size())
 				{
-					task = s_impl->tasks.front();
-					s_impl->tasks.pop();
+					task = std::move(s_impl->tasks[s_impl->nextTask++]);
+
+					// Lot terminé, on vide la liste en conservant sa mémoire
+					if (s_impl->nextTask == s_impl->tasks.size())
+					{
+						s_impl->tasks.clear();
+						s_impl->nextTask = 0;
+					}
 				}
-				else
-					task = nullptr;
 			}
 
 			// Avons-nous une tâche ?
 			if (task)
 			{
-				task->Run(); // Chouette ! Allons travailler gaiement
+				task(); // Chouette ! Allons travailler gaiement
 
-				delete task; // Sans oublier de supprimer la tâche
+				task.Reset(); // Sans oublier de libérer la tâche
 
 				s_impl->taskCountMutex.Lock();
 				#ifdef NAZARA_DEBUG
@@ -85,11 +148,22 @@ namespace
 	}
 }
 
+void NzTaskScheduler::EnableWorkerPinning(bool pinning)
+{
+	///DOC: Ne s'applique qu'aux workers créés après l'appel
+	s_workerPinning = pinning;
+}
+
 unsigned int NzTaskScheduler::GetWorkerCount()
 {
 	return (s_workerCount > 0) ? s_workerCount : NzHardwareInfo::GetProcessorCount();
 }
 
+nzThreadPriority NzTaskScheduler::GetWorkerPriority()
+{
+	return s_workerPriority;
+}
+
 bool NzTaskScheduler::Initialize()
 {
 	if (s_impl)
@@ -101,11 +175,16 @@ bool NzTaskScheduler::Initialize()
 
 	s_impl->workers.resize(workerCount);
 	for (unsigned int i = 0; i < workerCount; ++i)
-		s_impl->workers[i] = NzThread(WorkerFunc);
+		s_impl->workers[i] = NzThread(WorkerFunc, i);
 
 	return true;
 }
 
+bool NzTaskScheduler::IsWorkerPinningEnabled()
+{
+	return s_workerPinning;
+}
+
 void NzTaskScheduler::SetWorkerCount(unsigned int workerCount)
 {
 	s_workerCount = workerCount;
@@ -116,12 +195,26 @@ void NzTaskScheduler::SetWorkerCount(unsigned int workerCount)
 		s_impl->workers.resize(newWorkerCount);
 		if (newWorkerCount > oldWorkerCount)
 		{
-			for (unsigned int i = oldWorkerCount-1; i < newWorkerCount; ++i)
-				s_impl->workers[i] = NzThread(WorkerFunc);
+			for (unsigned int i = oldWorkerCount; i < newWorkerCount; ++i)
+				s_impl->workers[i] = NzThread(WorkerFunc, i);
 		}
 	}
 }
 
+void NzTaskScheduler::SetWorkerPriority(nzThreadPriority priority)
+{
+	#if NAZARA_CORE_SAFE
+	if (priority > nzThreadPriority_Max)
+	{
+		NazaraError("Thread priority out of enum");
+		return;
+	}
+	#endif
+
+	///DOC: Ne s'applique qu'aux workers créés après l'appel
+	s_workerPriority = priority;
+}
+
 void NzTaskScheduler::Uninitialize()
 {
 	if (s_impl)
@@ -131,11 +224,8 @@ void NzTaskScheduler::Uninitialize()
 		// S'il reste des tâches en cours, on les libère
 		{
 			NzLockGuard lock(s_impl->taskMutex);
-			while (!s_impl->tasks.empty())
-			{
-				delete s_impl->tasks.front();
-				s_impl->tasks.pop();
-			}
+			s_impl->tasks.clear();
+			s_impl->nextTask = 0;
 		}
 
 		// Ensuite on réveille les threads pour qu'ils s'arrêtent d'eux-même
@@ -162,10 +252,13 @@ void NzTaskScheduler::WaitForTasks()
 	#endif
 
 	// Tout d'abord, il y a-t-il des tâches en attente ?
-	if (s_impl->tasks.empty())
-		return;
+	{
+		NzLockGuard lock(s_impl->taskMutex);
+		if (s_impl->nextTask == s_impl->tasks.size())
+			return;
 
-	s_impl->taskCount = s_impl->tasks.size();
+		s_impl->taskCount = s_impl->tasks.size() - s_impl->nextTask;
+	}
 
 	// On verrouille d'abord la mutex entourant le signal (Pour ne pas perdre le signal en chemin)
 	s_impl->waiterConditionVariableMutex.Lock();
@@ -179,7 +272,7 @@ void NzTaskScheduler::WaitForTasks()
 	s_impl->waiterConditionVariableMutex.Unlock();
 }
 
-void NzTaskScheduler::AddTaskFunctor(NzFunctor* taskFunctor)
+void NzTaskScheduler::AddTaskCallable(NzCallable<void()>&& task)
 {
 	#ifdef NAZARA_CORE_SAFE
 	if (!s_impl)
@@ -189,5 +282,6 @@ void NzTaskScheduler::AddTaskFunctor(NzFunctor* taskFunctor)
 	}
 	#endif
 
-	s_impl->tasks.push(taskFunctor);
+	NzLockGuard lock(s_impl->taskMutex);
+	s_impl->tasks.push_back(std::move(task));
 }
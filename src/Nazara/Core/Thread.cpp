@@ -74,6 +74,57 @@ void NzThread::Join()
 	m_impl = nullptr;
 }
 
+bool NzThread::SetAffinity(nzUInt64 processorMask)
+{
+	#if NAZARA_CORE_SAFE
+	if (!m_impl)
+	{
+		NazaraError("Invalid thread");
+		return false;
+	}
+
+	if (processorMask == 0)
+	{
+		NazaraError("Processor mask must not be empty");
+		return false;
+	}
+	#endif
+
+	return m_impl->SetAffinity(processorMask);
+}
+
+bool NzThread::SetName(const NzString& name)
+{
+	#if NAZARA_CORE_SAFE
+	if (!m_impl)
+	{
+		NazaraError("Invalid thread");
+		return false;
+	}
+	#endif
+
+	return m_impl->SetName(name);
+}
+
+bool NzThread::SetPriority(nzThreadPriority priority)
+{
+	#if NAZARA_CORE_SAFE
+	if (!m_impl)
+	{
+		NazaraError("Invalid thread");
+		return false;
+	}
+
+	if (priority > nzThreadPriority_Max)
+	{
+		NazaraError("Thread priority out of enum");
+		return false;
+	}
+	#endif
+
+	return m_impl->SetPriority(priority);
+}
+
 NzThread& NzThread::operator=(NzThread&& thread)
 {
 	#if NAZARA_CORE_SAFE
@@ -93,14 +144,46 @@ unsigned int NzThread::HardwareConcurrency()
 	return NzHardwareInfo::GetProcessorCount();
 }
 
+bool NzThread::SetCurrentThreadAffinity(nzUInt64 processorMask)
+{
+	#if NAZARA_CORE_SAFE
+	if (processorMask == 0)
+	{
+		NazaraError("Processor mask must not be empty");
+		return false;
+	}
+	#endif
+
+	return NzThreadImpl::SetCurrentThreadAffinity(processorMask);
+}
+
+bool NzThread::SetCurrentThreadName(const NzString& name)
+{
+	return NzThreadImpl::SetCurrentThreadName(name);
+}
+
+bool NzThread::SetCurrentThreadPriority(nzThreadPriority priority)
+{
+	#if NAZARA_CORE_SAFE
+	if (priority > nzThreadPriority_Max)
+	{
+		NazaraError("Thread priority out of enum");
+		return false;
+	}
+	#endif
+
+	return NzThreadImpl::SetCurrentThreadPriority(priority);
+}
+
 void NzThread::Sleep(nzUInt32 milliseconds)
 {
 	NzThreadImpl::Sleep(milliseconds);
 }
 
-void NzThread::CreateImpl(NzFunctor* functor)
+void NzThread::CreateImpl(NzCallable<void()>&& function)
 {
-	m_impl = new NzThreadImpl(functor);
+	// L'appelable doit survivre au détachement du thread, il lui appartient désormais
+	m_impl = new NzThreadImpl(new NzCallable<void()>(std::move(function)));
 }
 
 /*********************************NzThread::Id********************************/
@@ -4,6 +4,7 @@
 
 #include <Nazara/Core/Win32/HardwareInfoImpl.hpp>
 #include <Nazara/Core/Error.hpp>
+#include <memory>
 #include <windows.h>
 
 #ifdef NAZARA_COMPILER_MSVC
@@ -12,15 +13,15 @@
 
 #include <Nazara/Core/Debug.hpp>
 
-void NzHardwareInfoImpl::Cpuid(nzUInt32 code, nzUInt32 result[4])
+void NzHardwareInfoImpl::Cpuid(nzUInt32 code, nzUInt32 result[4], nzUInt32 subCode)
 {
 	#if defined(NAZARA_COMPILER_MSVC)
-	__cpuid(reinterpret_cast<int*>(result), static_cast<int>(code)); // Visual propose une fonction intrinsèque pour le cpuid
+	__cpuidex(reinterpret_cast<int*>(result), static_cast<int>(code), static_cast<int>(subCode)); // Visual propose une fonction intrinsèque pour le cpuid
 	#elif defined(NAZARA_COMPILER_CLANG) || defined(NAZARA_COMPILER_GCC) || defined(NAZARA_COMPILER_INTEL)
 	// Source: http://stackoverflow.com/questions/1666093/cpuid-implementations-in-c
 	asm volatile ("cpuid" // Besoin d'être volatile ?
 				  : "=a" (result[0]), "=b" (result[1]), "=c" (result[2]), "=d" (result[3]) // output
-                  : "a" (code), "c" (0));                                                  // input
+                  : "a" (code), "c" (subCode));                                            // input
 	#else
 	NazaraInternalError("Cpuid has been called although it is not supported");
 	#endif
@@ -35,6 +36,76 @@ unsigned int NzHardwareInfoImpl::GetProcessorCount()
 	return infos.dwNumberOfProcessors;
 }
 
+bool NzHardwareInfoImpl::GetTopology(unsigned int processorCount, unsigned int* cores, unsigned int* packages, unsigned int* nodes, unsigned int cacheSizes[3], unsigned int* cacheLineSize)
+{
+	// Disponible depuis Windows XP SP3
+	DWORD length = 0;
+	GetLogicalProcessorInformation(nullptr, &length);
+	if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+		return false;
+
+	unsigned int entryCount = length/sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+	std::unique_ptr<SYSTEM_LOGICAL_PROCESSOR_INFORMATION[]> infos(new SYSTEM_LOGICAL_PROCESSOR_INFORMATION[entryCount]);
+	if (!GetLogicalProcessorInformation(infos.get(), &length))
+	{
+		NazaraError("Failed to get logical processor information: " + NzError::GetLastSystemError());
+		return false;
+	}
+
+	for (unsigned int i = 0; i < processorCount; ++i)
+	{
+		cores[i] = i;
+		packages[i] = 0;
+		nodes[i] = 0;
+	}
+
+	unsigned int coreIndex = 0;
+	unsigned int packageIndex = 0;
+	for (unsigned int i = 0; i < entryCount; ++i)
+	{
+		const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& info = infos[i];
+		switch (info.Relationship)
+		{
+			case RelationCache:
+				if (info.Cache.Type != CacheInstruction && info.Cache.Level >= 1 && info.Cache.Level <= 3)
+				{
+					cacheSizes[info.Cache.Level-1] = info.Cache.Size;
+					if (info.Cache.Level == 1)
+						*cacheLineSize = info.Cache.LineSize;
+				}
+				break;
+
+			case RelationNumaNode:
+			case RelationProcessorCore:
+			case RelationProcessorPackage:
+				for (unsigned int j = 0; j < processorCount && j < sizeof(ULONG_PTR)*8; ++j)
+				{
+					if (info.ProcessorMask & (static_cast<ULONG_PTR>(1) << j))
+					{
+						if (info.Relationship == RelationNumaNode)
+							nodes[j] = info.NumaNode.NodeNumber;
+						else if (info.Relationship == RelationProcessorCore)
+							cores[j] = coreIndex;
+						else
+							packages[j] = packageIndex;
+					}
+				}
+
+				if (info.Relationship == RelationProcessorCore)
+					coreIndex++;
+				else if (info.Relationship == RelationProcessorPackage)
+					packageIndex++;
+
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return true;
+}
+
 bool NzHardwareInfoImpl::IsCpuidSupported()
 {
 	#ifdef NAZARA_PLATFORM_x64
@@ -83,3 +154,20 @@ bool NzHardwareInfoImpl::IsCpuidSupported()
 		#endif
 	#endif
 }
+
+nzUInt64 NzHardwareInfoImpl::Xgetbv(nzUInt32 index)
+{
+	#if defined(NAZARA_COMPILER_MSVC)
+	return _xgetbv(index); // Disponible depuis Visual Studio 2010 SP1
+	#elif defined(NAZARA_COMPILER_CLANG) || defined(NAZARA_COMPILER_GCC) || defined(NAZARA_COMPILER_INTEL)
+	nzUInt32 eax, edx;
+	asm volatile (".byte 0x0f, 0x01, 0xd0" // xgetbv, encodé à la main pour les assembleurs ne le connaissant pas
+				  : "=a" (eax), "=d" (edx) // output
+				  : "c" (index));          // input
+
+	return (static_cast<nzUInt64>(edx) << 32) | eax;
+	#else
+	NazaraInternalError("Xgetbv has been called although it is not supported");
+	return 0;
+	#endif
+}
@@ -12,9 +12,11 @@
 class NzHardwareInfoImpl
 {
 	public:
-		static void Cpuid(nzUInt32 code, nzUInt32 result[4]);
+		static void Cpuid(nzUInt32 code, nzUInt32 result[4], nzUInt32 subCode = 0);
 		static unsigned int GetProcessorCount();
+		static bool GetTopology(unsigned int processorCount, unsigned int* cores, unsigned int* packages, unsigned int* nodes, unsigned int cacheSizes[3], unsigned int* cacheLineSize);
 		static bool IsCpuidSupported();
+		static nzUInt64 Xgetbv(nzUInt32 index);
 };
 
 #endif // NAZARA_HARDWAREINFOIMPL_WINDOWS_HPP
@@ -0,0 +1,121 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Core/Win32/RWLockImpl.hpp>
+#include <Nazara/Core/Debug.hpp>
+
+#if NAZARA_CORE_WINDOWS_SRWLOCK
+NzRWLockImpl::NzRWLockImpl()
+{
+	InitializeSRWLock(&m_lock);
+}
+
+NzRWLockImpl::~NzRWLockImpl() = default;
+
+void NzRWLockImpl::LockRead()
+{
+	AcquireSRWLockShared(&m_lock);
+}
+
+void NzRWLockImpl::LockWrite()
+{
+	AcquireSRWLockExclusive(&m_lock);
+}
+
+bool NzRWLockImpl::TryLockRead()
+{
+	return TryAcquireSRWLockShared(&m_lock) != 0;
+}
+
+bool NzRWLockImpl::TryLockWrite()
+{
+	return TryAcquireSRWLockExclusive(&m_lock) != 0;
+}
+
+void NzRWLockImpl::UnlockRead()
+{
+	ReleaseSRWLockShared(&m_lock);
+}
+
+void NzRWLockImpl::UnlockWrite()
+{
+	ReleaseSRWLockExclusive(&m_lock);
+}
+#else
+NzRWLockImpl::NzRWLockImpl() :
+m_readerCount(0)
+{
+	InitializeCriticalSection(&m_readerSection);
+	InitializeCriticalSection(&m_writerSection);
+	m_noReaderEvent = CreateEventW(nullptr, TRUE, TRUE, nullptr);
+}
+
+NzRWLockImpl::~NzRWLockImpl()
+{
+	CloseHandle(m_noReaderEvent);
+	DeleteCriticalSection(&m_writerSection);
+	DeleteCriticalSection(&m_readerSection);
+}
+
+void NzRWLockImpl::LockRead()
+{
+	// Un lecteur passe brièvement par la section de l'écrivain, afin de ne pas l'affamer
+	EnterCriticalSection(&m_writerSection);
+
+	EnterCriticalSection(&m_readerSection);
+	if (++m_readerCount == 1)
+		ResetEvent(m_noReaderEvent);
+	LeaveCriticalSection(&m_readerSection);
+
+	LeaveCriticalSection(&m_writerSection);
+}
+
+void NzRWLockImpl::LockWrite()
+{
+	EnterCriticalSection(&m_writerSection);
+	WaitForSingleObject(m_noReaderEvent, INFINITE);
+}
+
+bool NzRWLockImpl::TryLockRead()
+{
+	if (!TryEnterCriticalSection(&m_writerSection))
+		return false;
+
+	EnterCriticalSection(&m_readerSection);
+	if (++m_readerCount == 1)
+		ResetEvent(m_noReaderEvent);
+	LeaveCriticalSection(&m_readerSection);
+
+	LeaveCriticalSection(&m_writerSection);
+
+	return true;
+}
+
+bool NzRWLockImpl::TryLockWrite()
+{
+	if (!TryEnterCriticalSection(&m_writerSection))
+		return false;
+
+	if (WaitForSingleObject(m_noReaderEvent, 0) != WAIT_OBJECT_0)
+	{
+		LeaveCriticalSection(&m_writerSection);
+		return false;
+	}
+
+	return true;
+}
+
+void NzRWLockImpl::UnlockRead()
+{
+	EnterCriticalSection(&m_readerSection);
+	if (--m_readerCount == 0)
+		SetEvent(m_noReaderEvent);
+	LeaveCriticalSection(&m_readerSection);
+}
+
+void NzRWLockImpl::UnlockWrite()
+{
+	LeaveCriticalSection(&m_writerSection);
+}
+#endif
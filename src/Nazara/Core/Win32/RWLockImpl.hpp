@@ -0,0 +1,48 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Core module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_RWLOCKIMPL_HPP
+#define NAZARA_RWLOCKIMPL_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Config.hpp>
+#include <windows.h>
+
+// Les SRW locks ne peuvent être tentés sans bloquer (TryAcquireSRWLock*) qu'à partir de Windows 7,
+// en deçà l'implémentation de secours, qui le permet, est utilisée
+#if NAZARA_CORE_WINDOWS_VISTA && _WIN32_WINNT >= 0x0601
+	#define NAZARA_CORE_WINDOWS_SRWLOCK 1
+#else
+	#define NAZARA_CORE_WINDOWS_SRWLOCK 0
+#endif
+
+class NzRWLockImpl
+{
+	public:
+		NzRWLockImpl();
+		~NzRWLockImpl();
+
+		void LockRead();
+		void LockWrite();
+		bool TryLockRead();
+		bool TryLockWrite();
+		void UnlockRead();
+		void UnlockWrite();
+
+	private:
+		#if NAZARA_CORE_WINDOWS_SRWLOCK
+		SRWLOCK m_lock;
+		#else
+		// Implémentation de secours (XP, Vista): les lecteurs sont comptés sous une section critique,
+		// l'écrivain attend la fin des lectures en cours sur un évènement manuel
+		CRITICAL_SECTION m_readerSection;
+		CRITICAL_SECTION m_writerSection;
+		HANDLE m_noReaderEvent;
+		LONG m_readerCount;
+		#endif
+};
+
+#endif // NAZARA_RWLOCKIMPL_HPP
@@ -4,13 +4,89 @@
 
 #include <Nazara/Core/Win32/ThreadImpl.hpp>
 #include <Nazara/Core/Error.hpp>
-#include <Nazara/Core/Functor.hpp>
+#include <Nazara/Core/String.hpp>
 #include <process.h>
 #include <Nazara/Core/Debug.hpp>
 
-NzThreadImpl::NzThreadImpl(NzFunctor* functor)
+namespace
 {
-	m_handle = reinterpret_cast<HANDLE>(_beginthreadex(nullptr, 0, &NzThreadImpl::ThreadProc, functor, 0, nullptr));
+	bool SetThreadAffinity(HANDLE handle, nzUInt64 processorMask)
+	{
+		if (SetThreadAffinityMask(handle, static_cast<DWORD_PTR>(processorMask)) == 0)
+		{
+			NazaraError("Failed to set thread affinity: " + NzError::GetLastSystemError());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool SetThreadName(DWORD threadId, const NzString& name)
+	{
+		#ifdef NAZARA_COMPILER_MSVC
+		// Windows n'a pas d'API pour nommer un thread, la convention est de lever une exception
+		// interceptée par le débogueur (http://msdn.microsoft.com/en-us/library/xcb2z8hs.aspx)
+		#pragma pack(push, 8)
+		struct ThreadNameInfo
+		{
+			DWORD type;
+			LPCSTR name;
+			DWORD threadId;
+			DWORD flags;
+		};
+		#pragma pack(pop)
+
+		if (!IsDebuggerPresent())
+			return true;
+
+		ThreadNameInfo info;
+		info.type = 0x1000;
+		info.name = name.GetConstBuffer();
+		info.threadId = threadId;
+		info.flags = 0;
+
+		__try
+		{
+			RaiseException(0x406D1388, 0, sizeof(info)/sizeof(ULONG_PTR), reinterpret_cast<ULONG_PTR*>(&info));
+		}
+		__except (EXCEPTION_EXECUTE_HANDLER)
+		{
+		}
+
+		return true;
+		#else
+		NazaraUnused(threadId);
+		NazaraUnused(name);
+
+		NazaraError("Thread naming is only supported with Visual C++");
+		return false;
+		#endif
+	}
+
+	bool SetThreadPriority(HANDLE handle, nzThreadPriority priority)
+	{
+		static const int priorities[nzThreadPriority_Max+1] =
+		{
+			THREAD_PRIORITY_LOWEST,       // nzThreadPriority_Lowest
+			THREAD_PRIORITY_BELOW_NORMAL, // nzThreadPriority_Low
+			THREAD_PRIORITY_NORMAL,       // nzThreadPriority_Normal
+			THREAD_PRIORITY_ABOVE_NORMAL, // nzThreadPriority_High
+			THREAD_PRIORITY_HIGHEST       // nzThreadPriority_Highest
+		};
+
+		if (!::SetThreadPriority(handle, priorities[priority]))
+		{
+			NazaraError("Failed to set thread priority: " + NzError::GetLastSystemError());
+			return false;
+		}
+
+		return true;
+	}
+}
+
+NzThreadImpl::NzThreadImpl(NzCallable<void()>* function)
+{
+	m_handle = reinterpret_cast<HANDLE>(_beginthreadex(nullptr, 0, &NzThreadImpl::ThreadProc, function, 0, &m_threadId));
 	if (!m_handle)
 		NazaraInternalError("Failed to create thread: " + NzError::GetLastSystemError());
 }
@@ -27,11 +103,41 @@ void NzThreadImpl::Join()
 	CloseHandle(m_handle);
 }
 
+bool NzThreadImpl::SetAffinity(nzUInt64 processorMask)
+{
+	return SetThreadAffinity(m_handle, processorMask);
+}
+
+bool NzThreadImpl::SetName(const NzString& name)
+{
+	return SetThreadName(m_threadId, name);
+}
+
+bool NzThreadImpl::SetPriority(nzThreadPriority priority)
+{
+	return SetThreadPriority(m_handle, priority);
+}
+
+bool NzThreadImpl::SetCurrentThreadAffinity(nzUInt64 processorMask)
+{
+	return SetThreadAffinity(GetCurrentThread(), processorMask);
+}
+
+bool NzThreadImpl::SetCurrentThreadName(const NzString& name)
+{
+	return SetThreadName(GetCurrentThreadId(), name);
+}
+
+bool NzThreadImpl::SetCurrentThreadPriority(nzThreadPriority priority)
+{
+	return SetThreadPriority(GetCurrentThread(), priority);
+}
+
 unsigned int __stdcall NzThreadImpl::ThreadProc(void* userdata)
 {
-	NzFunctor* func = static_cast<NzFunctor*>(userdata);
-	func->Run();
-	delete func;
+	NzCallable<void()>* function = static_cast<NzCallable<void()>*>(userdata);
+	(*function)();
+	delete function;
 
 	/*
 	En C++, il vaut mieux retourner depuis la fonction que de quitter le thread explicitement
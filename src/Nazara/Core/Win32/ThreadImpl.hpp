@@ -10,24 +10,34 @@
 #define NAZARA_THREADIMPL_HPP
 
 #include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/Callable.hpp>
+#include <Nazara/Core/Enums.hpp>
 #include <windows.h>
 
-struct NzFunctor;
+class NzString;
 
 class NzThreadImpl
 {
 	public:
-		NzThreadImpl(NzFunctor* threadFunc);
+		NzThreadImpl(NzCallable<void()>* threadFunc);
 
 		void Detach();
 		void Join();
 
+		bool SetAffinity(nzUInt64 processorMask);
+		bool SetName(const NzString& name);
+		bool SetPriority(nzThreadPriority priority);
+
+		static bool SetCurrentThreadAffinity(nzUInt64 processorMask);
+		static bool SetCurrentThreadName(const NzString& name);
+		static bool SetCurrentThreadPriority(nzThreadPriority priority);
 		static void Sleep(nzUInt32 time);
 
 	private:
 		static unsigned int __stdcall ThreadProc(void* userdata);
 
 		HANDLE m_handle;
+		unsigned int m_threadId;
 };
 
 #endif // NAZARA_THREADIMPL_HPP
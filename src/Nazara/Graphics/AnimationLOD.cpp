@@ -0,0 +1,178 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/AnimationLOD.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Graphics/AbstractViewer.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <Nazara/Utility/Joint.hpp>
+#include <Nazara/Utility/Skeleton.hpp>
+#include <algorithm>
+#include <limits>
+#include <Nazara/Graphics/Debug.hpp>
+
+NzAnimationLOD::NzAnimationLOD(nzAnimationLODMetric metric) :
+m_metric(metric),
+m_offscreenFreeze(true)
+{
+	// Le niveau zéro correspond à l'animation complète, à chaque mise à jour
+	NzAnimationLODLevel level;
+	level.threshold = (metric == nzAnimationLODMetric_Distance) ? 0.f : std::numeric_limits<float>::infinity();
+	level.updateInterval = 1;
+
+	m_levels.push_back(level);
+}
+
+unsigned int NzAnimationLOD::AddLevel(float threshold, unsigned int updateInterval, std::vector<unsigned int> joints)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (updateInterval == 0)
+	{
+		NazaraError("Update interval must be over zero");
+		return 0;
+	}
+	#endif
+
+	NzAnimationLODLevel level;
+	level.joints = std::move(joints);
+	level.threshold = threshold;
+	level.updateInterval = updateInterval;
+
+	// Les niveaux sont triés du plus détaillé au moins détaillé
+	auto it = m_levels.begin() + 1;
+	if (m_metric == nzAnimationLODMetric_Distance)
+	{
+		while (it != m_levels.end() && it->threshold <= threshold)
+			++it;
+	}
+	else
+	{
+		while (it != m_levels.end() && it->threshold >= threshold)
+			++it;
+	}
+
+	return m_levels.insert(it, std::move(level)) - m_levels.begin();
+}
+
+float NzAnimationLOD::ComputeMetric(const NzAbstractViewer* viewer, const NzBoundingVolumef& boundingVolume) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!viewer)
+	{
+		NazaraError("Invalid viewer");
+		return 0.f;
+	}
+	#endif
+
+	if (boundingVolume.IsInfinite())
+		return (m_metric == nzAnimationLODMetric_Distance) ? 0.f : std::numeric_limits<float>::infinity();
+
+	float distance = viewer->GetEyePosition().Distance(boundingVolume.aabb.GetCenter());
+	if (m_metric == nzAnimationLODMetric_Distance)
+		return distance;
+
+	// Rapport entre la hauteur projetée de la sphère englobante et la hauteur de l'écran
+	float radius = boundingVolume.aabb.GetRadius();
+	if (distance <= radius)
+		return std::numeric_limits<float>::infinity();
+
+	return radius * viewer->GetProjectionMatrix()(1, 1) / distance;
+}
+
+void NzAnimationLOD::EnableOffscreenFreeze(bool freeze)
+{
+	m_offscreenFreeze = freeze;
+}
+
+const NzAnimationLODLevel& NzAnimationLOD::GetLevel(unsigned int level) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (level >= m_levels.size())
+	{
+		NazaraError("Level out of range (" + NzString::Number(level) + " >= " + NzString::Number(m_levels.size()) + ')');
+
+		static NzAnimationLODLevel dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_levels[level];
+}
+
+unsigned int NzAnimationLOD::GetLevelCount() const
+{
+	return m_levels.size();
+}
+
+nzAnimationLODMetric NzAnimationLOD::GetMetric() const
+{
+	return m_metric;
+}
+
+bool NzAnimationLOD::IsOffscreenFreezeEnabled() const
+{
+	return m_offscreenFreeze;
+}
+
+unsigned int NzAnimationLOD::SelectLevel(float metric) const
+{
+	unsigned int level = 0;
+	if (m_metric == nzAnimationLODMetric_Distance)
+	{
+		while (level+1 < m_levels.size() && m_levels[level+1].threshold <= metric)
+			level++;
+	}
+	else
+	{
+		while (level+1 < m_levels.size() && m_levels[level+1].threshold >= metric)
+			level++;
+	}
+
+	return level;
+}
+
+std::vector<unsigned int> NzAnimationLOD::BuildJointList(const NzSkeleton* skeleton, unsigned int leafDepth)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!skeleton || !skeleton->IsValid())
+	{
+		NazaraError("Invalid skeleton");
+		return std::vector<unsigned int>();
+	}
+	#endif
+
+	const NzJoint* joints = skeleton->GetJoints();
+	unsigned int jointCount = skeleton->GetJointCount();
+
+	// Hauteur de chaque joint dans la hiérarchie (zéro pour une feuille)
+	std::vector<unsigned int> heights(jointCount, 0);
+	for (unsigned int i = 0; i < jointCount; ++i)
+	{
+		unsigned int height = 1;
+		const NzNode* parent = joints[i].GetParent();
+		while (parent)
+		{
+			const NzJoint* parentJoint = static_cast<const NzJoint*>(parent);
+			if (parentJoint < joints || parentJoint >= joints + jointCount)
+				break; // Le parent ne fait pas partie du squelette
+
+			unsigned int& parentHeight = heights[parentJoint - joints];
+			if (parentHeight >= height)
+				break; // Le reste de la chaîne a déjà été mis à jour par un autre descendant
+
+			parentHeight = height++;
+			parent = parent->GetParent();
+		}
+	}
+
+	std::vector<unsigned int> jointList;
+	jointList.reserve(jointCount);
+	for (unsigned int i = 0; i < jointCount; ++i)
+	{
+		if (heights[i] >= leafDepth)
+			jointList.push_back(i);
+	}
+
+	return jointList;
+}
@@ -15,15 +15,26 @@
 #include <Nazara/Renderer/Renderer.hpp>
 #include <Nazara/Renderer/ShaderProgramManager.hpp>
 #include <Nazara/Utility/BufferMapper.hpp>
+#include <Nazara/Utility/PrimitiveMeshCache.hpp>
 #include <Nazara/Utility/StaticMesh.hpp>
 #include <Nazara/Utility/VertexStruct.hpp>
+#include <algorithm>
 #include <limits>
 #include <memory>
-#include <random>
 #include <Nazara/Graphics/Debug.hpp>
 
 namespace
 {
+	NzRenderGraphTextureInfo BuildTextureInfo(nzPixelFormat format, unsigned int width, unsigned int height)
+	{
+		NzRenderGraphTextureInfo info;
+		info.format = format;
+		info.height = height;
+		info.width = width;
+
+		return info;
+	}
+
 	NzShaderProgram* BuildClearProgram()
 	{
 		const char fragmentSource[] = {
@@ -378,172 +389,6 @@ namespace
 		return program.release();
 	}
 
-	NzShaderProgram* BuildSSAOProgram()
-	{
-		const char fragmentSource[] = {
-			#include <Nazara/Graphics/Resources/DeferredShading/Shaders/SSAO.frag.h>
-		};
-
-		const char* vertexSource =
-		"#version 140\n"
-
-		"in vec3 VertexPosition;\n"
-
-		"void main()\n"
-		"{\n"
-		"\t" "gl_Position = vec4(VertexPosition, 1.0);" "\n"
-		"}\n";
-
-		///TODO: Remplacer ça par des ShaderNode
-		std::unique_ptr<NzShaderProgram> program(new NzShaderProgram(nzShaderLanguage_GLSL));
-		program->SetPersistent(false);
-
-		if (!program->LoadShader(nzShaderType_Fragment, NzString(fragmentSource, sizeof(fragmentSource))))
-		{
-			NazaraError("Failed to load fragment shader");
-			return nullptr;
-		}
-
-		if (!program->LoadShader(nzShaderType_Vertex, vertexSource))
-		{
-			NazaraError("Failed to load vertex shader");
-			return nullptr;
-		}
-
-		if (!program->Compile())
-		{
-			NazaraError("Failed to compile program");
-			return nullptr;
-		}
-
-		program->SendInteger(program->GetUniformLocation("GBuffer1"), 0);
-		program->SendInteger(program->GetUniformLocation("NoiseTexture"), 1);
-
-		return program.release();
-	}
-
-	NzShaderProgram* BuildSSAOFinalProgram()
-	{
-		const char fragmentSource[] = {
-			#include <Nazara/Graphics/Resources/DeferredShading/Shaders/SSAOFinal.frag.h>
-		};
-
-		const char* vertexSource =
-		"#version 140\n"
-
-		"in vec3 VertexPosition;\n"
-
-		"void main()\n"
-		"{\n"
-		"\t" "gl_Position = vec4(VertexPosition, 1.0);" "\n"
-		"}\n";
-
-		///TODO: Remplacer ça par des ShaderNode
-		std::unique_ptr<NzShaderProgram> program(new NzShaderProgram(nzShaderLanguage_GLSL));
-		program->SetPersistent(false);
-
-		if (!program->LoadShader(nzShaderType_Fragment, NzString(fragmentSource, sizeof(fragmentSource))))
-		{
-			NazaraError("Failed to load fragment shader");
-			return nullptr;
-		}
-
-		if (!program->LoadShader(nzShaderType_Vertex, vertexSource))
-		{
-			NazaraError("Failed to load vertex shader");
-			return nullptr;
-		}
-
-		if (!program->Compile())
-		{
-			NazaraError("Failed to compile program");
-			return nullptr;
-		}
-
-		program->SendInteger(program->GetUniformLocation("ColorTexture"), 0);
-		program->SendInteger(program->GetUniformLocation("SSAOTexture"), 1);
-
-		return program.release();
-	}
-
-	// http://digitalerr0r.wordpress.com/2009/05/16/xna-shader-programming-tutorial-20-depth-of-field/
-	NzShaderProgram* BuildDepthOfFieldProgram()
-	{
-		const char* fragmentSource =
-		"#version 140\n"
-
-		"out vec4 RenderTarget0;\n"
-
-		"uniform sampler2D BlurTexture;\n"
-		"uniform sampler2D ColorTexture;\n"
-		"uniform sampler2D GBuffer1;\n"
-		"uniform vec2 InvTargetSize;" "\n"
-
-		"float Distance = 30.0;\n"
-		"float Range = 100.0;\n"
-		"float Near = 0.1;\n"
-		"float Far = (5000.0) / (5000.0 - 0.1);\n"
-		//"float Far = 50.0;\n"
-
-		"void main()\n"
-		"{\n"
-			"vec2 texCoord = gl_FragCoord.xy * InvTargetSize;\n"
-
-			"// Get our original pixel from ColorMap\n"
-			"vec3 color = textureLod(ColorTexture, texCoord, 0.0).rgb;\n"
-
-			"// Get our bloom pixel from bloom texture\n"
-			"vec3 blur = textureLod(BlurTexture, texCoord, 0.0).rgb;\n"
-
-			"float depth = textureLod(GBuffer1, texCoord, 0.0).w;\n"
-			"depth = (2.0 * 0.1) / (5000.0 + 0.1 - depth * (5000.0 - 0.1));"
-			"depth = 1.0 - depth;\n"
-
-			"float fSceneZ = ( -Near * Far ) / ( depth - Far);\n"
-			"float blurFactor = clamp(abs(fSceneZ - Distance)/Range, 0.0, 1.0);\n"
-
-			"RenderTarget0 = vec4(mix(color, blur, blurFactor), 1.0);\n"
-		"}\n";
-
-		const char* vertexSource =
-		"#version 140\n"
-
-		"in vec3 VertexPosition;\n"
-
-		"void main()\n"
-		"{\n"
-		"\t" "gl_Position = vec4(VertexPosition, 1.0);" "\n"
-		"}\n";
-
-		///TODO: Remplacer ça par des ShaderNode
-		std::unique_ptr<NzShaderProgram> program(new NzShaderProgram(nzShaderLanguage_GLSL));
-		program->SetPersistent(false);
-
-		if (!program->LoadShader(nzShaderType_Fragment, fragmentSource))
-		{
-			NazaraError("Failed to load fragment shader");
-			return nullptr;
-		}
-
-		if (!program->LoadShader(nzShaderType_Vertex, vertexSource))
-		{
-			NazaraError("Failed to load vertex shader");
-			return nullptr;
-		}
-
-		if (!program->Compile())
-		{
-			NazaraError("Failed to compile program");
-			return nullptr;
-		}
-
-		program->SendInteger(program->GetUniformLocation("ColorTexture"), 0);
-		program->SendInteger(program->GetUniformLocation("BlurTexture"), 1);
-		program->SendInteger(program->GetUniformLocation("GBuffer1"), 2);
-
-		return program.release();
-	}
-
 	NzShaderProgram* BuildBlitProgram()
 	{
 		const char fragmentSource[] = {
@@ -591,7 +436,7 @@ namespace
 NzDeferredRenderTechnique::NzDeferredRenderTechnique() :
 m_renderQueue(static_cast<NzForwardRenderQueue*>(m_forwardTechnique.GetRenderQueue())),
 m_GBufferSize(0, 0),
-m_texturesUpdated(false)
+m_renderGraphUpdated(false)
 {
 	m_aaProgram = BuildAAProgram();
 
@@ -616,8 +461,6 @@ m_texturesUpdated(false)
 	m_pointLightProgram = BuildPointLightProgram();
 	m_spotLightProgram = BuildSpotLightProgram();
 
-	m_depthOfFieldProgram = BuildDepthOfFieldProgram();
-
 	m_bilinearSampler.SetAnisotropyLevel(1);
 	m_bilinearSampler.SetFilterMode(nzSamplerFilter_Bilinear);
 	m_bilinearSampler.SetWrapMode(nzSamplerWrap_Clamp);
@@ -626,93 +469,8 @@ m_texturesUpdated(false)
 	m_pointSampler.SetFilterMode(nzSamplerFilter_Nearest);
 	m_pointSampler.SetWrapMode(nzSamplerWrap_Clamp);
 
-	m_ssaoSampler.SetAnisotropyLevel(1);
-	m_ssaoSampler.SetFilterMode(nzSamplerFilter_Nearest);
-	m_ssaoSampler.SetWrapMode(nzSamplerWrap_Repeat);
-
-	/*const unsigned int kernelSize = 16;
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dis(-1.f, 1.f);
-    std::uniform_real_distribution<float> dis2(0.f, 1.f);
-
-	std::vector<NzVector3f> kernel(kernelSize);
-	for (unsigned int i = 0; i < kernelSize; ++i)
-	{
-		kernel[i].Set(dis(gen), dis(gen), dis2(gen));
-		kernel[i].Normalize();
-
-		float scale = static_cast<float>(i) / kernelSize;
-		kernel[i] *= NzLerp(0.1f, 1.0f, scale * scale);
-	}
-
-	int noiseDataSize = 4 * 4;
-
-	std::vector<nzUInt8> noiseData(noiseDataSize*2);
-	for (int i = 0; i < noiseDataSize; ++i)
-	{
-		NzVector2f vec(dis(gen), dis(gen));
-		vec.Normalize();
-
-		noiseData[i*2 + 0] = static_cast<nzUInt8>((vec.x*0.5f + 0.5f) * 0xFF);
-		noiseData[i*2 + 1] = static_cast<nzUInt8>((vec.y*0.5f + 0.5f) * 0xFF);
-	}
-
-	m_ssaoNoiseTexture = new NzTexture;
-	m_ssaoNoiseTexture->SetPersistent(false);
-	m_ssaoNoiseTexture->Create(nzImageType_2D, nzPixelFormat_RG8, 4, 4);
-	m_ssaoNoiseTexture->Update(&noiseData[0]);*/
-
-	const char noiseTexture[] = {
-		#include <Nazara/Graphics/Resources/DeferredShading/Textures/ssaoNoise.jpg.h>
-	};
-
-	m_ssaoNoiseTexture = new NzTexture;
-	m_ssaoNoiseTexture->SetPersistent(false);
-	m_ssaoNoiseTexture->LoadFromMemory(noiseTexture, sizeof(noiseTexture));
-
-	m_ssaoProgram = BuildSSAOProgram();
-	m_ssaoProgram->SendInteger(m_ssaoProgram->GetUniformLocation("NoiseTextureSize"), m_ssaoNoiseTexture->GetWidth());
-	//m_ssaoProgram->SendInteger(m_ssaoProgram->GetUniformLocation("ssaoKernelSize"), kernelSize);
-	//m_ssaoProgram->SendVectorArray(m_ssaoProgram->GetUniformLocation("ssaoKernelOffsets"), &kernel[0], kernelSize);
-
-	m_ssaoFinalProgram = BuildSSAOFinalProgram();
-
-	m_sphere = new NzMesh;
-	m_sphere->SetPersistent(false);
-	m_sphere->CreateStatic();
-	m_sphereMesh = static_cast<NzStaticMesh*>(m_sphere->BuildSubMesh(NzPrimitive::IcoSphere(1.f, 1)));
-
-	m_bloomTextureA = new NzTexture;
-	m_bloomTextureA->SetPersistent(false);
-
-	m_bloomTextureB = new NzTexture;
-	m_bloomTextureB->SetPersistent(false);
-
-	m_dofTextureA = new NzTexture;
-	m_dofTextureA->SetPersistent(false);
-
-	m_dofTextureB = new NzTexture;
-	m_dofTextureB->SetPersistent(false);
-
-	m_ssaoTextureA = new NzTexture;
-	m_ssaoTextureA->SetPersistent(false);
-
-	m_ssaoTextureB = new NzTexture;
-	m_ssaoTextureB->SetPersistent(false);
-
-	m_workTextureA = new NzTexture;
-	m_workTextureA->SetPersistent(false);
-
-	m_workTextureB = new NzTexture;
-	m_workTextureB->SetPersistent(false);
-
-	for (unsigned int i = 0; i < 3; ++i)
-	{
-		m_GBuffer[i] = new NzTexture;
-		m_GBuffer[i]->SetPersistent(false);
-	}
+	m_sphere = NzPrimitiveMeshCache::Get(NzPrimitive::IcoSphere(1.f, 1));
+	m_sphereMesh = static_cast<NzStaticMesh*>(m_sphere->GetSubMesh(0));
 }
 
 NzDeferredRenderTechnique::~NzDeferredRenderTechnique()
@@ -726,301 +484,255 @@ void NzDeferredRenderTechnique::Clear(const NzScene* scene)
 
 bool NzDeferredRenderTechnique::Draw(const NzScene* scene)
 {
-	NzAbstractViewer* viewer = scene->GetViewer();
 	NzRecti viewerViewport = NzRenderer::GetViewport();
 
 	if (static_cast<unsigned int>(viewerViewport.width) != m_GBufferSize.x || static_cast<unsigned int>(viewerViewport.height) != m_GBufferSize.y)
 	{
 		m_GBufferSize.Set(viewerViewport.width, viewerViewport.height);
-		m_texturesUpdated = false;
+		m_renderGraphUpdated = false;
 	}
 
-	if (!m_texturesUpdated && !UpdateTextures())
+	if (!m_renderGraphUpdated)
+		BuildRenderGraph();
+
+	if (!m_renderGraph.Execute(scene))
 	{
-		NazaraError("Failed to update RTT");
+		NazaraError("Failed to execute render graph");
 		return false;
 	}
 
-	NzRenderer::SetTarget(&m_geometryRTT);
-	NzRenderer::SetViewport(NzRecti(0, 0, m_GBufferSize.x, m_GBufferSize.y));
-
-	/****************************Passe géométrique****************************/
-	m_geometryRTT.SetColorTargets({0, 1, 2}); // G-Buffer
-
-	NzRenderer::SetRenderStates(m_clearStates);
-	NzRenderer::SetShaderProgram(m_clearProgram);
-	NzRenderer::DrawFullscreenQuad();
-
-	NzRenderer::SetMatrix(nzMatrixType_Projection, viewer->GetProjectionMatrix());
-	NzRenderer::SetMatrix(nzMatrixType_View, viewer->GetViewMatrix());
-
-	GeomPass(scene);
-
-	/****************************Passe d'éclairage****************************/
-	m_geometryRTT.SetColorTarget(4); // workTextureA
-
-	NzRenderer::SetTexture(0, m_GBuffer[0]);
-	NzRenderer::SetTextureSampler(0, m_pointSampler);
+	return true;
+}
 
-	NzRenderer::SetTexture(1, m_GBuffer[1]);
-	NzRenderer::SetTextureSampler(1, m_pointSampler);
+NzTexture* NzDeferredRenderTechnique::GetGBuffer(unsigned int i) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (i >= 3)
+	{
+		NazaraError("GBuffer texture index out of range (" + NzString::Number(i) + " >= 3)");
+		return nullptr;
+	}
+	#endif
 
-	NzRenderer::SetTexture(2, m_GBuffer[2]);
-	NzRenderer::SetTextureSampler(2, m_pointSampler);
+	return m_renderGraph.GetTexture(m_GBuffer[i]);
+}
 
-	NzRenderer::SetClearColor(NzColor::Black);
-	NzRenderer::Clear(nzRendererClear_Color);
+NzAbstractRenderQueue* NzDeferredRenderTechnique::GetRenderQueue()
+{
+	return &m_renderQueue;
+}
 
-	NzRenderStates lightStates;
-	lightStates.dstBlend = nzBlendFunc_One;
-	lightStates.srcBlend = nzBlendFunc_One;
-	lightStates.parameters[nzRendererParameter_Blend] = true;
-	lightStates.parameters[nzRendererParameter_DepthBuffer] = true;
-	lightStates.parameters[nzRendererParameter_DepthWrite] = false;
+nzRenderTechniqueType NzDeferredRenderTechnique::GetType() const
+{
+	return nzRenderTechniqueType_DeferredShading;
+}
 
-	// Directional lights
-	if (!m_renderQueue.directionalLights.empty())
+NzTexture* NzDeferredRenderTechnique::GetWorkTexture(unsigned int i) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (i >= 2)
 	{
-		NzRenderer::SetRenderStates(lightStates);
-		DirectionalLightPass(scene);
+		NazaraError("GBuffer texture index out of range (" + NzString::Number(i) + " >= 3)");
+		return nullptr;
 	}
+	#endif
 
-	// Point lights/Spot lights
-	if (!m_renderQueue.pointLights.empty() || !m_renderQueue.spotLights.empty())
-	{
-		// http://www.altdevblogaday.com/2011/08/08/stencil-buffer-optimisation-for-deferred-lights/
-		lightStates.parameters[nzRendererParameter_StencilTest] = true;
-		lightStates.faceCulling = nzFaceSide_Front;
-		lightStates.backFace.stencilMask = 0xFF;
-		lightStates.backFace.stencilReference = 0;
-		lightStates.backFace.stencilFail = nzStencilOperation_Keep;
-		lightStates.backFace.stencilPass = nzStencilOperation_Keep;
-		lightStates.backFace.stencilZFail = nzStencilOperation_Invert;
-		lightStates.frontFace.stencilMask = 0xFF;
-		lightStates.frontFace.stencilReference = 0;
-		lightStates.frontFace.stencilFail = nzStencilOperation_Keep;
-		lightStates.frontFace.stencilPass = nzStencilOperation_Keep;
-		lightStates.frontFace.stencilZFail = nzStencilOperation_Invert;
-
-		NzRenderer::SetRenderStates(lightStates);
+	return m_renderGraph.GetTexture(m_workTextures[i]);
+}
 
-		if (!m_renderQueue.pointLights.empty())
-			PointLightPass(scene);
+bool NzDeferredRenderTechnique::IsSupported()
+{
+	// On ne va pas s'embêter à écrire un Deferred Renderer qui ne passe pas par le MRT, ce serait lent et inutile (OpenGL 2 garanti cette fonctionnalité en plus)
+	return NzRenderer::HasCapability(nzRendererCap_RenderTexture) &&
+	       NzRenderer::HasCapability(nzRendererCap_MultipleRenderTargets) &&
+	       NzRenderer::GetMaxColorAttachments() >= 4 &&
+	       NzRenderer::GetMaxRenderTargets() >= 4 &&
+	       NzTexture::IsFormatSupported(nzPixelFormat_Depth24Stencil8) &&
+	       NzTexture::IsFormatSupported(nzPixelFormat_RGBA32F);
+}
 
-		if (!m_renderQueue.spotLights.empty())
-			SpotLightPass(scene);
+void NzDeferredRenderTechnique::BuildRenderGraph()
+{
+	/*
+	G-Buffer:
+	Texture0: Diffuse Color + Flags
+	Texture1: Normal map + Depth
+	Texture2: Specular value + Shininess
+	*/
 
-		NzRenderer::Enable(nzRendererParameter_StencilTest, false);
-	}
+	unsigned int width = m_GBufferSize.x;
+	unsigned int height = m_GBufferSize.y;
+	unsigned int bloomWidth = std::max(width/8, 1U);
+	unsigned int bloomHeight = std::max(height/8, 1U);
 
-	/******************************Passe forward******************************/
-	NzAbstractBackground* background = scene->GetBackground();
-	if (background)
-		background->Draw(scene);
+	// Le pool de textures est conservé, seules les textures dont la taille a changé seront recréées
+	m_renderGraph.Clear();
 
-	NzRenderer::SetMatrix(nzMatrixType_Projection, viewer->GetProjectionMatrix());
-	NzRenderer::SetMatrix(nzMatrixType_View, viewer->GetViewMatrix());
+	m_GBuffer[0] = m_renderGraph.AddTexture("GBuffer0", BuildTextureInfo(nzPixelFormat_RGBA8, width, height));
+	m_GBuffer[1] = m_renderGraph.AddTexture("GBuffer1", BuildTextureInfo(nzPixelFormat_RGBA32F, width, height));
+	m_GBuffer[2] = m_renderGraph.AddTexture("GBuffer2", BuildTextureInfo(nzPixelFormat_RGBA8, width, height));
+	m_workTextures[0] = m_renderGraph.AddTexture("WorkTextureA", BuildTextureInfo(nzPixelFormat_RGBA8, width, height));
+	m_workTextures[1] = m_renderGraph.AddTexture("WorkTextureB", BuildTextureInfo(nzPixelFormat_RGBA8, width, height));
 
-	m_forwardTechnique.Draw(scene);
+	unsigned int bloomTextureA = m_renderGraph.AddTexture("BloomTextureA", BuildTextureInfo(nzPixelFormat_RGBA8, bloomWidth, bloomHeight));
+	unsigned int bloomTextureB = m_renderGraph.AddTexture("BloomTextureB", BuildTextureInfo(nzPixelFormat_RGBA8, bloomWidth, bloomHeight));
+	unsigned int depthStencil = m_renderGraph.AddTexture("DepthStencil", BuildTextureInfo(nzPixelFormat_Depth24Stencil8, width, height));
+	unsigned int workTextureA = m_workTextures[0];
+	unsigned int workTextureB = m_workTextures[1];
 
-	NzRenderStates states;
-	states.parameters[nzRendererParameter_DepthBuffer] = false;
+	unsigned int pass;
 
-	NzRenderer::SetRenderStates(states);
+	/****************************Passe géométrique****************************/
+	pass = m_renderGraph.AddPass("Geometry", [this](const NzScene* scene)
+	{
+		NzAbstractViewer* viewer = scene->GetViewer();
 
-	/****************************SSAO***************************/
-/*	NzRenderer::SetShaderProgram(m_ssaoProgram);
+		NzRenderer::SetRenderStates(m_clearStates);
+		NzRenderer::SetShaderProgram(m_clearProgram);
+		NzRenderer::DrawFullscreenQuad();
 
-	NzRenderer::SetTarget(&m_ssaoRTT);
-	NzRenderer::SetViewport(NzRecti(0, 0, m_GBufferSize.x/4, m_GBufferSize.y/4));
+		NzRenderer::SetMatrix(nzMatrixType_Projection, viewer->GetProjectionMatrix());
+		NzRenderer::SetMatrix(nzMatrixType_View, viewer->GetViewMatrix());
 
-	m_ssaoRTT.SetColorTarget(0); // ssaoTextureA
+		GeomPass(scene);
+	});
 
-	NzRenderer::SetTexture(0, m_GBuffer[1]);
-	NzRenderer::SetTexture(1, m_ssaoNoiseTexture);
-	NzRenderer::SetTextureSampler(0, m_pointSampler);
-	NzRenderer::SetTextureSampler(1, m_ssaoSampler);
-	NzRenderer::DrawFullscreenQuad();
+	for (unsigned int i = 0; i < 3; ++i)
+		m_renderGraph.AddPassOutput(pass, m_GBuffer[i], false);
 
-	NzRenderer::SetShaderProgram(m_gaussianBlurProgram);
+	m_renderGraph.AddPassOutput(pass, depthStencil, false);
 
-	const unsigned int ssaoBlurPass = 2;
-	for (unsigned int i = 0; i < ssaoBlurPass; ++i)
+	/****************************Passe d'éclairage****************************/
+	pass = m_renderGraph.AddPass("Lighting", [this](const NzScene* scene)
 	{
-		m_ssaoRTT.SetColorTarget(1); // ssaoTextureB
+		LightingPass(scene);
+	});
 
-		m_gaussianBlurProgram->SendVector(m_gaussianBlurProgramFilterLocation, NzVector2f(1.f, 0.f));
+	for (unsigned int i = 0; i < 3; ++i)
+		m_renderGraph.AddPassInput(pass, m_GBuffer[i]);
 
-		NzRenderer::SetTexture(0, m_ssaoTextureA);
-		NzRenderer::DrawFullscreenQuad();
+	m_renderGraph.AddPassOutput(pass, workTextureA, false);
+	m_renderGraph.AddPassOutput(pass, depthStencil); // Le stencil sert à délimiter les lumières
 
-		m_ssaoRTT.SetColorTarget(0); // ssaoTextureA
+	/******************************Passe forward******************************/
+	pass = m_renderGraph.AddPass("Forward", [this](const NzScene* scene)
+	{
+		NzAbstractBackground* background = scene->GetBackground();
+		if (background)
+			background->Draw(scene);
 
-		m_gaussianBlurProgram->SendVector(m_gaussianBlurProgramFilterLocation, NzVector2f(0.f, 1.f));
+		NzAbstractViewer* viewer = scene->GetViewer();
+		NzRenderer::SetMatrix(nzMatrixType_Projection, viewer->GetProjectionMatrix());
+		NzRenderer::SetMatrix(nzMatrixType_View, viewer->GetViewMatrix());
 
-		NzRenderer::SetTexture(0, m_ssaoTextureB);
-		NzRenderer::DrawFullscreenQuad();
-	}
+		m_forwardTechnique.Draw(scene);
+	});
 
-	NzRenderer::SetTarget(&m_geometryRTT);
-	NzRenderer::SetViewport(NzRecti(0, 0, m_GBufferSize.x, m_GBufferSize.y));
-	m_geometryRTT.SetColorTarget(5); // workTextureB
+	m_renderGraph.AddPassOutput(pass, workTextureA);
+	m_renderGraph.AddPassOutput(pass, depthStencil);
 
-	NzRenderer::SetShaderProgram(m_ssaoFinalProgram);
-	NzRenderer::SetTexture(0, m_workTextureA);
-	NzRenderer::SetTexture(1, m_ssaoTextureA);
-	NzRenderer::SetTextureSampler(0, m_pointSampler);
-	NzRenderer::SetTextureSampler(1, m_bilinearSampler);
-	NzRenderer::DrawFullscreenQuad();
-*/
 	/****************************AA***************************/
-	NzRenderer::SetShaderProgram(m_aaProgram);
-
-	m_geometryRTT.SetColorTarget(5); // workTextureB
+	pass = m_renderGraph.AddPass("AA", [this, workTextureA](const NzScene* scene)
+	{
+		NazaraUnused(scene);
 
-	NzRenderer::SetTexture(0, m_workTextureA);
-	NzRenderer::SetTextureSampler(0, m_pointSampler);
-	NzRenderer::DrawFullscreenQuad();
+		NzRenderStates states;
+		states.parameters[nzRendererParameter_DepthBuffer] = false;
 
-	/****************************Bloom***************************/
-	NzRenderer::SetTextureSampler(0, m_bilinearSampler);
-	NzRenderer::SetTextureSampler(1, m_bilinearSampler);
+		NzRenderer::SetRenderStates(states);
+		NzRenderer::SetShaderProgram(m_aaProgram);
+		NzRenderer::SetTexture(0, m_renderGraph.GetTexture(workTextureA));
+		NzRenderer::SetTextureSampler(0, m_pointSampler);
+		NzRenderer::DrawFullscreenQuad();
+	});
 
-	m_geometryRTT.SetColorTarget(4); // workTextureA
+	m_renderGraph.AddPassInput(pass, workTextureA);
+	m_renderGraph.AddPassOutput(pass, workTextureB, false);
 
-	NzRenderer::SetShaderProgram(m_bloomBrightProgram);
+	/****************************Bloom***************************/
+	pass = m_renderGraph.AddPass("BloomBright", [this, workTextureB](const NzScene* scene)
+	{
+		NazaraUnused(scene);
 
-	NzRenderer::SetTexture(0, m_workTextureA);
-	NzRenderer::DrawFullscreenQuad();
+		NzRenderer::SetTextureSampler(0, m_bilinearSampler);
+		NzRenderer::SetTextureSampler(1, m_bilinearSampler);
 
-	NzRenderer::SetTarget(&m_bloomRTT);
-	NzRenderer::SetViewport(NzRecti(0, 0, m_GBufferSize.x/8, m_GBufferSize.y/8));
+		NzRenderer::SetShaderProgram(m_bloomBrightProgram);
+		NzRenderer::SetTexture(0, m_renderGraph.GetTexture(workTextureB));
+		NzRenderer::DrawFullscreenQuad();
+	});
 
-	NzRenderer::SetShaderProgram(m_gaussianBlurProgram);
+	m_renderGraph.AddPassInput(pass, workTextureB);
+	m_renderGraph.AddPassOutput(pass, workTextureA, false);
 
 	const unsigned int bloomBlurPass = 5;
 	for (unsigned int i = 0; i < bloomBlurPass; ++i)
 	{
-		m_bloomRTT.SetColorTarget(0); // bloomTextureA
-
-		m_gaussianBlurProgram->SendVector(m_gaussianBlurProgramFilterLocation, NzVector2f(1.f, 0.f));
+		unsigned int source = (i == 0) ? workTextureA : bloomTextureB;
 
-		NzRenderer::SetTexture(0, (i == 0) ? m_workTextureB : m_bloomTextureB);
-		NzRenderer::DrawFullscreenQuad();
+		pass = m_renderGraph.AddPass("BloomBlurH", [this, source](const NzScene* scene)
+		{
+			NazaraUnused(scene);
 
-		m_bloomRTT.SetColorTarget(1); // bloomTextureB
+			NzRenderer::SetShaderProgram(m_gaussianBlurProgram);
+			m_gaussianBlurProgram->SendVector(m_gaussianBlurProgramFilterLocation, NzVector2f(1.f, 0.f));
 
-		m_gaussianBlurProgram->SendVector(m_gaussianBlurProgramFilterLocation, NzVector2f(0.f, 1.f));
+			NzRenderer::SetTexture(0, m_renderGraph.GetTexture(source));
+			NzRenderer::DrawFullscreenQuad();
+		});
 
-		NzRenderer::SetTexture(0, m_bloomTextureA);
-		NzRenderer::DrawFullscreenQuad();
-	}
+		m_renderGraph.AddPassInput(pass, source);
+		m_renderGraph.AddPassOutput(pass, bloomTextureA, false);
 
-	NzRenderer::SetTarget(&m_geometryRTT);
-	NzRenderer::SetViewport(NzRecti(0, 0, m_GBufferSize.x, m_GBufferSize.y));
-	m_geometryRTT.SetColorTarget(4); // workTextureA
-
-	NzRenderer::SetShaderProgram(m_bloomFinalProgram);
-	NzRenderer::SetTexture(0, m_workTextureB);
-	NzRenderer::SetTexture(1, m_bloomTextureB);
-	NzRenderer::DrawFullscreenQuad();
+		pass = m_renderGraph.AddPass("BloomBlurV", [this, bloomTextureA](const NzScene* scene)
+		{
+			NazaraUnused(scene);
 
-	/****************************Depth-of-Field***************************/
-/*	NzRenderer::SetTextureSampler(0, m_pointSampler);
-	NzRenderer::SetTextureSampler(1, m_bilinearSampler);
-	NzRenderer::SetTextureSampler(2, m_pointSampler);
+			NzRenderer::SetShaderProgram(m_gaussianBlurProgram);
+			m_gaussianBlurProgram->SendVector(m_gaussianBlurProgramFilterLocation, NzVector2f(0.f, 1.f));
 
-	NzRenderer::SetTarget(&m_dofRTT);
-	NzRenderer::SetViewport(NzRecti(0, 0, m_GBufferSize.x/4, m_GBufferSize.y/4));
+			NzRenderer::SetTexture(0, m_renderGraph.GetTexture(bloomTextureA));
+			NzRenderer::DrawFullscreenQuad();
+		});
 
-	NzRenderer::SetShaderProgram(m_gaussianBlurProgram);
+		m_renderGraph.AddPassInput(pass, bloomTextureA);
+		m_renderGraph.AddPassOutput(pass, bloomTextureB, false);
+	}
 
-	const unsigned int dofBlurPass = 2;
-	for (unsigned int i = 0; i < dofBlurPass; ++i)
+	pass = m_renderGraph.AddPass("BloomFinal", [this, workTextureB, bloomTextureB](const NzScene* scene)
 	{
-		m_dofRTT.SetColorTarget(0); // dofTextureA
-
-		m_gaussianBlurProgram->SendVector(m_gaussianBlurProgramFilterLocation, NzVector2f(1.f, 0.f));
+		NazaraUnused(scene);
 
-		NzRenderer::SetTexture(0, (i == 0) ? m_workTextureA : m_dofTextureB);
+		NzRenderer::SetShaderProgram(m_bloomFinalProgram);
+		NzRenderer::SetTexture(0, m_renderGraph.GetTexture(workTextureB));
+		NzRenderer::SetTexture(1, m_renderGraph.GetTexture(bloomTextureB));
 		NzRenderer::DrawFullscreenQuad();
+	});
 
-		m_dofRTT.SetColorTarget(1); // dofTextureB
-
-		m_gaussianBlurProgram->SendVector(m_gaussianBlurProgramFilterLocation, NzVector2f(0.f, 1.f));
-
-		NzRenderer::SetTexture(0, m_dofTextureA);
-		NzRenderer::DrawFullscreenQuad();
-	}
-
-	NzRenderer::SetTarget(&m_geometryRTT);
-	NzRenderer::SetViewport(NzRecti(0, 0, m_GBufferSize.x, m_GBufferSize.y));
-	m_geometryRTT.SetColorTarget(5); // workTextureB
-
-	NzRenderer::SetShaderProgram(m_depthOfFieldProgram);
-	NzRenderer::SetTexture(0, m_workTextureA);
-	NzRenderer::SetTexture(1, m_dofTextureB);
-	NzRenderer::SetTexture(2, m_GBuffer[1]);
-	NzRenderer::DrawFullscreenQuad();*/
+	m_renderGraph.AddPassInput(pass, workTextureB);
+	m_renderGraph.AddPassInput(pass, bloomTextureB);
+	m_renderGraph.AddPassOutput(pass, workTextureA, false);
 
 	/*******************************Passe finale******************************/
-	scene->GetViewer()->ApplyView();
-
-	NzRenderer::SetRenderStates(states);
-	NzRenderer::SetShaderProgram(m_blitProgram);
-	NzRenderer::SetTexture(0, m_workTextureA);
-	NzRenderer::SetTextureSampler(0, m_pointSampler);
-
-	NzRenderer::DrawFullscreenQuad();
-
-	return true;
-}
-
-NzTexture* NzDeferredRenderTechnique::GetGBuffer(unsigned int i) const
-{
-	#if NAZARA_GRAPHICS_SAFE
-	if (i >= 3)
+	pass = m_renderGraph.AddPass("Final", [this, workTextureA](const NzScene* scene)
 	{
-		NazaraError("GBuffer texture index out of range (" + NzString::Number(i) + " >= 3)");
-		return nullptr;
-	}
-	#endif
+		scene->GetViewer()->ApplyView();
 
-	return m_GBuffer[i];
-}
-
-NzAbstractRenderQueue* NzDeferredRenderTechnique::GetRenderQueue()
-{
-	return &m_renderQueue;
-}
-
-nzRenderTechniqueType NzDeferredRenderTechnique::GetType() const
-{
-	return nzRenderTechniqueType_DeferredShading;
-}
+		NzRenderStates states;
+		states.parameters[nzRendererParameter_DepthBuffer] = false;
 
-NzTexture* NzDeferredRenderTechnique::GetWorkTexture(unsigned int i) const
-{
-	#if NAZARA_GRAPHICS_SAFE
-	if (i >= 2)
-	{
-		NazaraError("GBuffer texture index out of range (" + NzString::Number(i) + " >= 3)");
-		return nullptr;
-	}
-	#endif
+		NzRenderer::SetRenderStates(states);
+		NzRenderer::SetShaderProgram(m_blitProgram);
+		NzRenderer::SetTexture(0, m_renderGraph.GetTexture(workTextureA));
+		NzRenderer::SetTextureSampler(0, m_pointSampler);
 
-	return (i == 0) ? m_workTextureA : m_workTextureB;
+		NzRenderer::DrawFullscreenQuad();
+	});
 
-}
+	m_renderGraph.AddPassInput(pass, workTextureA);
+	m_renderGraph.SetPassExternalOutput(pass, true); // Dessine vers la cible du viewer
 
-bool NzDeferredRenderTechnique::IsSupported()
-{
-	// On ne va pas s'embêter à écrire un Deferred Renderer qui ne passe pas par le MRT, ce serait lent et inutile (OpenGL 2 garanti cette fonctionnalité en plus)
-	return NzRenderer::HasCapability(nzRendererCap_RenderTexture) &&
-	       NzRenderer::HasCapability(nzRendererCap_MultipleRenderTargets) &&
-	       NzRenderer::GetMaxColorAttachments() >= 6 && //FIXME: Repasser à quatre
-	       NzRenderer::GetMaxRenderTargets() >= 4 &&
-	       NzTexture::IsFormatSupported(nzPixelFormat_RGBA32F);
+	m_renderGraphUpdated = true;
 }
 
 void NzDeferredRenderTechnique::GeomPass(const NzScene* scene)
@@ -1177,6 +889,63 @@ void NzDeferredRenderTechnique::DirectionalLightPass(const NzScene* scene)
 	}
 }
 
+void NzDeferredRenderTechnique::LightingPass(const NzScene* scene)
+{
+	NzRenderer::SetTexture(0, m_renderGraph.GetTexture(m_GBuffer[0]));
+	NzRenderer::SetTextureSampler(0, m_pointSampler);
+
+	NzRenderer::SetTexture(1, m_renderGraph.GetTexture(m_GBuffer[1]));
+	NzRenderer::SetTextureSampler(1, m_pointSampler);
+
+	NzRenderer::SetTexture(2, m_renderGraph.GetTexture(m_GBuffer[2]));
+	NzRenderer::SetTextureSampler(2, m_pointSampler);
+
+	NzRenderer::SetClearColor(NzColor::Black);
+	NzRenderer::Clear(nzRendererClear_Color);
+
+	NzRenderStates lightStates;
+	lightStates.dstBlend = nzBlendFunc_One;
+	lightStates.srcBlend = nzBlendFunc_One;
+	lightStates.parameters[nzRendererParameter_Blend] = true;
+	lightStates.parameters[nzRendererParameter_DepthBuffer] = true;
+	lightStates.parameters[nzRendererParameter_DepthWrite] = false;
+
+	// Directional lights
+	if (!m_renderQueue.directionalLights.empty())
+	{
+		NzRenderer::SetRenderStates(lightStates);
+		DirectionalLightPass(scene);
+	}
+
+	// Point lights/Spot lights
+	if (!m_renderQueue.pointLights.empty() || !m_renderQueue.spotLights.empty())
+	{
+		// http://www.altdevblogaday.com/2011/08/08/stencil-buffer-optimisation-for-deferred-lights/
+		lightStates.parameters[nzRendererParameter_StencilTest] = true;
+		lightStates.faceCulling = nzFaceSide_Front;
+		lightStates.backFace.stencilMask = 0xFF;
+		lightStates.backFace.stencilReference = 0;
+		lightStates.backFace.stencilFail = nzStencilOperation_Keep;
+		lightStates.backFace.stencilPass = nzStencilOperation_Keep;
+		lightStates.backFace.stencilZFail = nzStencilOperation_Invert;
+		lightStates.frontFace.stencilMask = 0xFF;
+		lightStates.frontFace.stencilReference = 0;
+		lightStates.frontFace.stencilFail = nzStencilOperation_Keep;
+		lightStates.frontFace.stencilPass = nzStencilOperation_Keep;
+		lightStates.frontFace.stencilZFail = nzStencilOperation_Invert;
+
+		NzRenderer::SetRenderStates(lightStates);
+
+		if (!m_renderQueue.pointLights.empty())
+			PointLightPass(scene);
+
+		if (!m_renderQueue.spotLights.empty())
+			SpotLightPass(scene);
+
+		NzRenderer::Enable(nzRendererParameter_StencilTest, false);
+	}
+}
+
 void NzDeferredRenderTechnique::PointLightPass(const NzScene* scene)
 {
 	NzRenderer::SetShaderProgram(m_pointLightProgram);
@@ -1256,88 +1025,3 @@ void NzDeferredRenderTechnique::SpotLightPass(const NzScene* scene)
 		NzRenderer::DrawIndexedPrimitives(nzPrimitiveMode_TriangleList, 0, indexBuffer->GetIndexCount());
 	}
 }
-
-bool NzDeferredRenderTechnique::UpdateTextures() const
-{
-	/*
-	G-Buffer:
-	Texture0: Diffuse Color + Flags
-	Texture1: Normal map + Depth
-	Texture2: Specular value + Shininess
-	Texture3: N/A
-	*/
-
-	try
-	{
-		NzErrorFlags errFlags(nzErrorFlag_ThrowException);
-
-		unsigned int width = m_GBufferSize.x;
-		unsigned int height = m_GBufferSize.y;
-
-		m_GBuffer[0]->Create(nzImageType_2D, nzPixelFormat_RGBA8, width, height);
-		m_GBuffer[1]->Create(nzImageType_2D, nzPixelFormat_RGBA32F, width, height);
-		m_GBuffer[2]->Create(nzImageType_2D, nzPixelFormat_RGBA8, width, height);
-		m_bloomTextureA->Create(nzImageType_2D, nzPixelFormat_RGBA8, width/8, height/8);
-		m_bloomTextureB->Create(nzImageType_2D, nzPixelFormat_RGBA8, width/8, height/8);
-		m_dofTextureA->Create(nzImageType_2D, nzPixelFormat_RGB8, width/4, height/4);
-		m_dofTextureB->Create(nzImageType_2D, nzPixelFormat_RGB8, width/4, height/4);
-		m_ssaoTextureA->Create(nzImageType_2D, nzPixelFormat_R8, width/4, height/4);
-		m_ssaoTextureB->Create(nzImageType_2D, nzPixelFormat_R8, width/4, height/4);
-		m_workTextureA->Create(nzImageType_2D, nzPixelFormat_RGBA8, width, height);
-		m_workTextureB->Create(nzImageType_2D, nzPixelFormat_RGBA8, width, height);
-
-		m_geometryRTT.Create(true);
-
-		// Texture 0 : Diffuse Color + Flags
-		m_geometryRTT.AttachTexture(nzAttachmentPoint_Color, 0, m_GBuffer[0]);
-
-		// Texture 1 : Normal map + Depth
-		m_geometryRTT.AttachTexture(nzAttachmentPoint_Color, 1, m_GBuffer[1]);
-
-		// Texture 2 : Specular value + Shininess
-		m_geometryRTT.AttachTexture(nzAttachmentPoint_Color, 2, m_GBuffer[2]);
-
-		// Texture 3 : Emission map ?
-
-		// Texture 4 : Target A
-		m_geometryRTT.AttachTexture(nzAttachmentPoint_Color, 4, m_workTextureA);
-
-		// Texture 5 : Target B
-		m_geometryRTT.AttachTexture(nzAttachmentPoint_Color, 5, m_workTextureB);
-
-		// Depth/stencil buffer
-		m_geometryRTT.AttachBuffer(nzAttachmentPoint_DepthStencil, 0, nzPixelFormat_Depth24Stencil8, width, height);
-
-		m_geometryRTT.Unlock();
-
-		m_bloomRTT.Create(true);
-		m_bloomRTT.AttachTexture(nzAttachmentPoint_Color, 0, m_bloomTextureA);
-		m_bloomRTT.AttachTexture(nzAttachmentPoint_Color, 1, m_bloomTextureB);
-		m_bloomRTT.Unlock();
-
-		m_dofRTT.Create(true);
-		m_dofRTT.AttachTexture(nzAttachmentPoint_Color, 0, m_dofTextureA);
-		m_dofRTT.AttachTexture(nzAttachmentPoint_Color, 1, m_dofTextureB);
-		m_dofRTT.Unlock();
-
-		m_ssaoRTT.Create(true);
-		m_ssaoRTT.AttachTexture(nzAttachmentPoint_Color, 0, m_ssaoTextureA);
-		m_ssaoRTT.AttachTexture(nzAttachmentPoint_Color, 1, m_ssaoTextureB);
-		m_ssaoRTT.Unlock();
-
-		if (!m_bloomRTT.IsComplete() || !m_dofRTT.IsComplete() || !m_geometryRTT.IsComplete() || !m_ssaoRTT.IsComplete())
-		{
-			NazaraError("Incomplete RTT");
-			return false;
-		}
-
-		m_texturesUpdated = true;
-
-		return true;
-	}
-	catch (const std::exception& e)
-	{
-		NazaraError("Failed to create work RTT/G-Buffer");
-		return false;
-	}
-}
@@ -92,7 +92,7 @@ void NzForwardRenderQueue::AddModel(const NzModel* model)
 	for (unsigned int i = 0; i < submeshCount; ++i)
 	{
 		NzSubMesh* subMesh = mesh->GetSubMesh(i);
-		NzMaterial* material = model->GetMaterial(subMesh->GetMaterialIndex());
+		const NzMaterial* material = model->GetMaterial(subMesh->GetMaterialIndex());
 
 		AddSubMesh(material, subMesh, transformMatrix);
 	}
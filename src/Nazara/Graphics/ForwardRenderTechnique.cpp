@@ -80,6 +80,8 @@ bool NzForwardRenderTechnique::Draw(const NzScene* scene)
 	m_lights.SetLights(&m_renderQueue.lights[0], m_renderQueue.lights.size());
 	m_renderQueue.Sort(scene->GetViewer());
 
+	UpdateTransforms(scene);
+
 	if (!m_renderQueue.opaqueModels.empty())
 		DrawOpaqueModels(scene);
 
@@ -312,7 +314,7 @@ void NzForwardRenderTechnique::DrawOpaqueModels(const NzScene* scene)
 								for (unsigned int i = lightCount; i < maxLightCount; ++i)
 									NzLight::Disable(program, i);
 
-								NzRenderer::SetMatrix(nzMatrixType_World, data.transformMatrix);
+								NzRenderer::SetWorldMatrices(data.transformMatrix, m_transforms.GetWorldViewMatrix(data.transformIndex), m_transforms.GetWorldViewProjMatrix(data.transformIndex));
 								DrawFunc(primitiveMode, 0, indexCount);
 
 								lightCount = originalLightCount;
@@ -488,7 +490,7 @@ void NzForwardRenderTechnique::DrawTransparentModels(const NzScene* scene)
 			for (unsigned int i = lightCount; i < maxLightCount; ++i)
 				NzLight::Disable(program, i);
 
-			NzRenderer::SetMatrix(nzMatrixType_World, matrix);
+			NzRenderer::SetWorldMatrices(matrix, m_transforms.GetWorldViewMatrix(staticModel.transformIndex), m_transforms.GetWorldViewProjMatrix(staticModel.transformIndex));
 			DrawFunc(mesh->GetPrimitiveMode(), 0, indexCount);
 		}
 		else
@@ -497,3 +499,32 @@ void NzForwardRenderTechnique::DrawTransparentModels(const NzScene* scene)
 		}
 	}
 }
+
+void NzForwardRenderTechnique::UpdateTransforms(const NzScene* scene)
+{
+	// Les matrices dérivées de tous les objets dessinés un par un sont calculées en une seule passe,
+	// la boucle de rendu n'a plus qu'à les envoyer
+	m_transforms.Clear();
+
+	for (auto& matIt : m_renderQueue.opaqueModels)
+	{
+		if (!std::get<0>(matIt.second))
+			continue;
+
+		// Les modèles instanciés envoient leur matrice monde via le buffer d'instancing (même condition que DrawOpaqueModels)
+		if (m_instancingEnabled && m_lights.IsEmpty() && std::get<1>(matIt.second))
+			continue;
+
+		for (auto& subMeshIt : std::get<3>(matIt.second))
+		{
+			for (NzForwardRenderQueue::StaticData& data : subMeshIt.second.second)
+				data.transformIndex = m_transforms.AddTransform(data.transformMatrix);
+		}
+	}
+
+	for (NzForwardRenderQueue::TransparentStaticModel& model : m_renderQueue.transparentStaticModels)
+		model.transformIndex = m_transforms.AddTransform(model.transformMatrix);
+
+	NzAbstractViewer* viewer = scene->GetViewer();
+	m_transforms.Compute(viewer->GetViewMatrix(), viewer->GetProjectionMatrix());
+}
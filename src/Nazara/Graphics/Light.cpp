@@ -19,6 +19,7 @@ NzLight::NzLight(nzLightType type) :
 m_type(type),
 m_color(NzColor::White),
 m_boundingVolumeUpdated(false),
+m_shadowCasting(false),
 m_ambientFactor((type == nzLightType_Directional) ? 0.2f : 0.f),
 m_attenuation(0.9f),
 m_diffuseFactor(1.f),
@@ -34,6 +35,7 @@ m_type(light.m_type),
 m_boundingVolume(light.m_boundingVolume),
 m_color(light.m_color),
 m_boundingVolumeUpdated(light.m_boundingVolumeUpdated),
+m_shadowCasting(light.m_shadowCasting),
 m_ambientFactor(light.m_ambientFactor),
 m_attenuation(light.m_attenuation),
 m_diffuseFactor(light.m_diffuseFactor),
@@ -123,6 +125,12 @@ void NzLight::Enable(const NzShaderProgram* program, unsigned int lightUnit) con
 	}
 }
 
+void NzLight::EnableShadowCasting(bool shadowCasting)
+{
+	///DOC: Seules les lumières directionnelles sont actuellement supportées (voir NzShadowCascades)
+	m_shadowCasting = shadowCasting;
+}
+
 float NzLight::GetAmbientFactor() const
 {
 	return m_ambientFactor;
@@ -181,6 +189,11 @@ bool NzLight::IsDrawable() const
 	return true;
 }
 
+bool NzLight::IsShadowCastingEnabled() const
+{
+	return m_shadowCasting;
+}
+
 void NzLight::SetAmbientFactor(float factor)
 {
 	m_ambientFactor = factor;
@@ -217,6 +230,7 @@ void NzLight::SetOuterAngle(float outerAngle)
 
 	m_boundingVolume.MakeNull();
 	m_boundingVolumeUpdated = false;
+	NotifyBoundingVolumeChange();
 }
 
 void NzLight::SetRadius(float radius)
@@ -225,6 +239,7 @@ void NzLight::SetRadius(float radius)
 
 	m_boundingVolume.MakeNull();
 	m_boundingVolumeUpdated = false;
+	NotifyBoundingVolumeChange();
 }
 
 NzLight& NzLight::operator=(const NzLight& light)
@@ -240,6 +255,7 @@ NzLight& NzLight::operator=(const NzLight& light)
 	m_innerAngle = light.m_innerAngle;
 	m_outerAngle = light.m_outerAngle;
 	m_radius = light.m_radius;
+	m_shadowCasting = light.m_shadowCasting;
 	m_type = light.m_type;
 
 	return *this;
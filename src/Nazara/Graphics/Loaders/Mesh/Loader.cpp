@@ -5,6 +5,7 @@
 #include <Nazara/Graphics/Loaders/Mesh.hpp>
 #include <Nazara/Graphics/Model.hpp>
 #include <Nazara/Renderer/Material.hpp>
+#include <Nazara/Renderer/MaterialRegistry.hpp>
 #include <Nazara/Utility/Mesh.hpp>
 #include <memory>
 #include <Nazara/Graphics/Debug.hpp>
@@ -65,8 +66,11 @@ namespace
 					material->SetPersistent(false);
 					if (material->LoadFromFile(mat, parameters.material))
 					{
-						model->SetMaterial(i, material.get());
-						material.release();
+						// Un matériau équivalent déjà enregistré remplace le nôtre, qui est alors libéré
+						NzMaterial* shared = (parameters.mergeMaterials) ? NzMaterialRegistry::Register(material.get()) : material.get();
+						model->SetMaterial(i, shared);
+						if (shared == material.get())
+							material.release();
 					}
 					else
 						NazaraWarning("Failed to load material #" + NzString::Number(i));
@@ -7,6 +7,7 @@
 #include <Nazara/Graphics/Loaders/OBJ/OBJParser.hpp>
 #include <Nazara/Graphics/Model.hpp>
 #include <Nazara/Renderer/Material.hpp>
+#include <Nazara/Renderer/MaterialRegistry.hpp>
 #include <Nazara/Utility/BufferMapper.hpp>
 #include <Nazara/Utility/IndexMapper.hpp>
 #include <Nazara/Utility/Mesh.hpp>
@@ -31,6 +32,21 @@ namespace
 		return nzTernary_Unknown;
 	}
 
+	NzTexture* LoadTexture(const NzString& filePath, bool shared)
+	{
+		// Une texture partagée permet de fusionner les matériaux qui l'utilisent
+		if (shared)
+			return NzMaterialRegistry::GetTexture(filePath);
+
+		std::unique_ptr<NzTexture> texture(new NzTexture);
+		texture->SetPersistent(false);
+
+		if (!texture->LoadFromFile(filePath))
+			return nullptr;
+
+		return texture.release();
+	}
+
 	bool Load(NzModel* model, NzInputStream& stream, const NzModelParameters& parameters)
 	{
 		NzOBJParser parser(stream);
@@ -228,15 +244,12 @@ namespace
 								bool hasAlphaMap = false;;
 								if (parameters.material.loadAlphaMap && !mtlMat->alphaMap.IsEmpty())
 								{
-									std::unique_ptr<NzTexture> alphaMap(new NzTexture);
-									alphaMap->SetPersistent(false);
-
-									if (alphaMap->LoadFromFile(baseDir + mtlMat->alphaMap))
+									NzTexture* alphaMap = LoadTexture(baseDir + mtlMat->alphaMap, parameters.material.shareTextures);
+									if (alphaMap)
 									{
 										hasAlphaMap = true;
 
-										material->SetAlphaMap(alphaMap.get());
-										alphaMap.release();
+										material->SetAlphaMap(alphaMap);
 									}
 									else
 										NazaraWarning("Failed to load alpha map (" + mtlMat->alphaMap + ')');
@@ -244,28 +257,18 @@ namespace
 
 								if (parameters.material.loadDiffuseMap && !mtlMat->diffuseMap.IsEmpty())
 								{
-									std::unique_ptr<NzTexture> diffuseMap(new NzTexture);
-									diffuseMap->SetPersistent(false);
-
-									if (diffuseMap->LoadFromFile(baseDir + mtlMat->diffuseMap))
-									{
-										material->SetDiffuseMap(diffuseMap.get());
-										diffuseMap.release();
-									}
+									NzTexture* diffuseMap = LoadTexture(baseDir + mtlMat->diffuseMap, parameters.material.shareTextures);
+									if (diffuseMap)
+										material->SetDiffuseMap(diffuseMap);
 									else
 										NazaraWarning("Failed to load diffuse map (" + mtlMat->diffuseMap + ')');
 								}
 
 								if (parameters.material.loadSpecularMap && !mtlMat->specularMap.IsEmpty())
 								{
-									std::unique_ptr<NzTexture> specularMap(new NzTexture);
-									specularMap->SetPersistent(false);
-
-									if (specularMap->LoadFromFile(baseDir + mtlMat->specularMap))
-									{
-										material->SetSpecularMap(specularMap.get());
-										specularMap.release();
-									}
+									NzTexture* specularMap = LoadTexture(baseDir + mtlMat->specularMap, parameters.material.shareTextures);
+									if (specularMap)
+										material->SetSpecularMap(specularMap);
 									else
 										NazaraWarning("Failed to load specular map (" + mtlMat->specularMap + ')');
 								}
@@ -281,10 +284,13 @@ namespace
 									material->SetSrcBlend(nzBlendFunc_SrcAlpha);
 								}
 
-								materialCache[matName] = material.get();
+								// Un matériau équivalent déjà enregistré (par ce modèle ou un autre) remplace le nôtre, qui est alors libéré
+								NzMaterial* shared = (parameters.mergeMaterials) ? NzMaterialRegistry::Register(material.get()) : material.get();
+								materialCache[matName] = shared;
 
-								model->SetMaterial(meshes[i].material, material.get());
-								material.release();
+								model->SetMaterial(meshes[i].material, shared);
+								if (shared == material.get())
+									material.release();
 							}
 						}
 						else
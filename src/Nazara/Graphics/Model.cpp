@@ -8,6 +8,7 @@
 #include <Nazara/Graphics/Config.hpp>
 #include <Nazara/Utility/SkeletalMesh.hpp>
 #include <Nazara/Utility/StaticMesh.hpp>
+#include <cmath>
 #include <memory>
 #include <Nazara/Graphics/Debug.hpp>
 
@@ -23,28 +24,42 @@ bool NzModelParameters::IsValid() const
 }
 
 NzModel::NzModel() :
+m_animationLOD(nullptr),
 m_currentSequence(nullptr),
 m_animationEnabled(true),
 m_boundingVolumeUpdated(true),
+m_static(false),
+m_pendingAnimationTime(0.f),
+m_animationLODLevel(0),
 m_matCount(0),
+m_sampledLODLevel(0),
 m_skin(0),
-m_skinCount(1)
+m_skinCount(1),
+m_updateCounter(0)
 {
 }
 
 NzModel::NzModel(const NzModel& model) :
 NzSceneNode(model),
 m_materials(model.m_materials),
+m_previousPose(model.m_previousPose),
+m_sampledPose(model.m_sampledPose),
+m_animationLOD(model.m_animationLOD),
 m_boundingVolume(model.m_boundingVolume),
 m_currentSequence(model.m_currentSequence),
 m_animationEnabled(model.m_animationEnabled),
 m_boundingVolumeUpdated(model.m_boundingVolumeUpdated),
+m_static(model.m_static),
 m_interpolation(model.m_interpolation),
+m_pendingAnimationTime(model.m_pendingAnimationTime),
+m_animationLODLevel(model.m_animationLODLevel),
 m_currentFrame(model.m_currentFrame),
 m_matCount(model.m_matCount),
 m_nextFrame(model.m_nextFrame),
+m_sampledLODLevel(model.m_sampledLODLevel),
 m_skin(model.m_skin),
-m_skinCount(model.m_skinCount)
+m_skinCount(model.m_skinCount),
+m_updateCounter(model.m_updateCounter)
 {
 	if (model.m_mesh)
 	{
@@ -78,35 +93,46 @@ void NzModel::AdvanceAnimation(float elapsedTime)
 	}
 	#endif
 
-	m_interpolation += m_currentSequence->frameRate * elapsedTime;
-	while (m_interpolation > 1.f)
+	AdvanceFrames(elapsedTime);
+	UpdateSkeleton(nullptr);
+}
+
+NzMaterial* NzModel::EditMaterial(unsigned int matIndex)
+{
+	return EditMaterial(m_skin, matIndex);
+}
+
+NzMaterial* NzModel::EditMaterial(unsigned int skinIndex, unsigned int matIndex)
+{
+	///DOC: Copie-sur-écriture : un matériau partagé (avec d'autres modèles, le registre des matériaux, ...)
+	///     ou le matériau par défaut est d'abord copié, la copie n'étant utilisée que par cet emplacement de ce modèle
+	#if NAZARA_GRAPHICS_SAFE
+	if (skinIndex >= m_skinCount)
 	{
-		m_interpolation -= 1.f;
+		NazaraError("Skin index out of range (" + NzString::Number(skinIndex) + " >= " + NzString::Number(m_skinCount) + ')');
+		return nullptr;
+	}
 
-		unsigned lastFrame = m_currentSequence->firstFrame + m_currentSequence->frameCount - 1;
-		if (m_nextFrame+1 > lastFrame)
-		{
-			if (m_animation->IsLoopPointInterpolationEnabled())
-			{
-				m_currentFrame = m_nextFrame;
-				m_nextFrame = m_currentSequence->firstFrame;
-			}
-			else
-			{
-				m_currentFrame = m_currentSequence->firstFrame;
-				m_nextFrame = m_currentFrame+1;
-			}
-		}
-		else
-		{
-			m_currentFrame = m_nextFrame;
-			m_nextFrame++;
-		}
+	if (matIndex >= m_matCount)
+	{
+		NazaraError("Material index out of range (" + NzString::Number(matIndex) + " >= " + NzString::Number(m_matCount) + ')');
+		return nullptr;
 	}
+	#endif
 
-	m_animation->AnimateSkeleton(&m_skeleton, m_currentFrame, m_nextFrame, m_interpolation);
-	m_boundingVolume.MakeNull();
-	m_boundingVolumeUpdated = false;
+	NzMaterialRef& slot = m_materials[skinIndex*m_matCount + matIndex];
+
+	NzMaterial* material = slot;
+	if (material == NzMaterial::GetDefault() || material->GetResourceReferenceCount() > 1)
+	{
+		std::unique_ptr<NzMaterial> instance(new NzMaterial(*material));
+		instance->SetPersistent(false);
+
+		material = instance.release();
+		slot = material;
+	}
+
+	return material;
 }
 
 void NzModel::EnableAnimation(bool animation)
@@ -119,6 +145,16 @@ NzAnimation* NzModel::GetAnimation() const
 	return m_animation;
 }
 
+const NzAnimationLOD* NzModel::GetAnimationLOD() const
+{
+	return m_animationLOD;
+}
+
+unsigned int NzModel::GetAnimationLODLevel() const
+{
+	return m_animationLODLevel;
+}
+
 const NzBoundingVolumef& NzModel::GetBoundingVolume() const
 {
 	#if NAZARA_GRAPHICS_SAFE
@@ -137,8 +173,9 @@ const NzBoundingVolumef& NzModel::GetBoundingVolume() const
 	return m_boundingVolume;
 }
 
-NzMaterial* NzModel::GetMaterial(const NzString& subMeshName) const
+const NzMaterial* NzModel::GetMaterial(const NzString& subMeshName) const
 {
+	///DOC: Le matériau peut être partagé (registre des matériaux, autres modèles), il n'est donc accessible qu'en lecture (voir EditMaterial)
 	#if NAZARA_GRAPHICS_SAFE
 	if (!m_mesh)
 	{
@@ -164,7 +201,7 @@ NzMaterial* NzModel::GetMaterial(const NzString& subMeshName) const
 	return m_materials[m_skin*m_matCount + matIndex];
 }
 
-NzMaterial* NzModel::GetMaterial(unsigned int matIndex) const
+const NzMaterial* NzModel::GetMaterial(unsigned int matIndex) const
 {
 	#if NAZARA_GRAPHICS_SAFE
 	if (matIndex >= m_matCount)
@@ -177,7 +214,7 @@ NzMaterial* NzModel::GetMaterial(unsigned int matIndex) const
 	return m_materials[m_skin*m_matCount + matIndex];
 }
 
-NzMaterial* NzModel::GetMaterial(unsigned int skinIndex, const NzString& subMeshName) const
+const NzMaterial* NzModel::GetMaterial(unsigned int skinIndex, const NzString& subMeshName) const
 {
 	#if NAZARA_GRAPHICS_SAFE
 	if (skinIndex >= m_skinCount)
@@ -204,7 +241,7 @@ NzMaterial* NzModel::GetMaterial(unsigned int skinIndex, const NzString& subMesh
 	return m_materials[skinIndex*m_matCount + matIndex];
 }
 
-NzMaterial* NzModel::GetMaterial(unsigned int skinIndex, unsigned int matIndex) const
+const NzMaterial* NzModel::GetMaterial(unsigned int skinIndex, unsigned int matIndex) const
 {
 	#if NAZARA_GRAPHICS_SAFE
 	if (skinIndex >= m_skinCount)
@@ -273,6 +310,11 @@ bool NzModel::IsDrawable() const
 	return m_mesh != nullptr && m_mesh->GetSubMeshCount() >= 1;
 }
 
+bool NzModel::IsStatic() const
+{
+	return m_static;
+}
+
 bool NzModel::LoadFromFile(const NzString& filePath, const NzModelParameters& params)
 {
 	return NzModelLoader::LoadFromFile(this, filePath, params);
@@ -342,6 +384,10 @@ bool NzModel::SetAnimation(NzAnimation* animation)
 	{
 		m_currentFrame = 0;
 		m_interpolation = 0.f;
+		m_pendingAnimationTime = 0.f;
+		m_previousPose.clear();
+		m_sampledPose.clear();
+		m_updateCounter = 0;
 
 		SetSequence(0);
 
@@ -354,6 +400,21 @@ bool NzModel::SetAnimation(NzAnimation* animation)
 	return true;
 }
 
+void NzModel::SetAnimationLOD(const NzAnimationLOD* animationLOD)
+{
+	if (m_animationLOD && m_animation && m_pendingAnimationTime > 0.f)
+	{
+		// On rattrape le temps accumulé par l'ancienne politique
+		AdvanceFrames(m_pendingAnimationTime);
+		UpdateSkeleton(nullptr);
+	}
+
+	m_animationLOD = animationLOD;
+	m_animationLODLevel = 0;
+	m_pendingAnimationTime = 0.f;
+	m_updateCounter = 0;
+}
+
 bool NzModel::SetMaterial(const NzString& subMeshName, NzMaterial* material)
 {
 	NzSubMesh* subMesh = m_mesh->GetSubMesh(subMeshName);
@@ -464,6 +525,7 @@ void NzModel::SetMesh(NzMesh* mesh)
 	{
 		m_boundingVolume.MakeNull();
 		m_boundingVolumeUpdated = false;
+		NotifyBoundingVolumeChange();
 
 		if (m_mesh->GetAnimationType() == nzAnimationType_Skeletal)
 			m_skeleton = *mesh->GetSkeleton(); // Copie du squelette template
@@ -486,6 +548,8 @@ void NzModel::SetMesh(NzMesh* mesh)
 	{
 		m_boundingVolume.MakeNull();
 		m_boundingVolumeUpdated = true;
+		NotifyBoundingVolumeChange();
+
 		m_matCount = 0;
 		m_materials.clear();
 		m_skinCount = 0;
@@ -568,12 +632,20 @@ void NzModel::SetSkinCount(unsigned int skinCount)
 	m_skinCount = skinCount;
 }
 
+void NzModel::SetStatic(bool isStatic)
+{
+	///DOC: Un modèle statique peut être fusionné avec ses voisins par NzStaticBatch
+	m_static = isStatic;
+}
+
 NzModel& NzModel::operator=(const NzModel& node)
 {
 	NzSceneNode::operator=(node);
 
 	m_animation = node.m_animation;
 	m_animationEnabled = node.m_animationEnabled;
+	m_animationLOD = node.m_animationLOD;
+	m_animationLODLevel = node.m_animationLODLevel;
 	m_boundingVolume = node.m_boundingVolume;
 	m_boundingVolumeUpdated = node.m_boundingVolumeUpdated;
 	m_currentFrame = node.m_currentFrame;
@@ -583,8 +655,14 @@ NzModel& NzModel::operator=(const NzModel& node)
 	m_materials = node.m_materials;
 	m_mesh = node.m_mesh;
 	m_nextFrame = node.m_nextFrame;
+	m_pendingAnimationTime = node.m_pendingAnimationTime;
+	m_previousPose = node.m_previousPose;
+	m_sampledLODLevel = node.m_sampledLODLevel;
+	m_sampledPose = node.m_sampledPose;
 	m_skin = node.m_skin;
 	m_skinCount = node.m_skinCount;
+	m_static = node.m_static;
+	m_updateCounter = node.m_updateCounter;
 
 	if (m_mesh->GetAnimationType() == nzAnimationType_Skeletal)
 		m_skeleton = node.m_skeleton;
@@ -606,6 +684,8 @@ NzModel& NzModel::operator=(NzModel&& node)
 
 	// Paramètres
 	m_animationEnabled = node.m_animationEnabled;
+	m_animationLOD = node.m_animationLOD;
+	m_animationLODLevel = node.m_animationLODLevel;
 	m_boundingVolume = node.m_boundingVolume;
 	m_boundingVolumeUpdated = node.m_boundingVolumeUpdated;
 	m_currentFrame = node.m_currentFrame;
@@ -613,12 +693,79 @@ NzModel& NzModel::operator=(NzModel&& node)
 	m_interpolation = node.m_interpolation;
 	m_matCount = node.m_matCount;
 	m_nextFrame = node.m_nextFrame;
+	m_pendingAnimationTime = node.m_pendingAnimationTime;
+	m_previousPose = std::move(node.m_previousPose);
+	m_sampledLODLevel = node.m_sampledLODLevel;
+	m_sampledPose = std::move(node.m_sampledPose);
 	m_skin = node.m_skin;
 	m_skinCount = node.m_skinCount;
+	m_static = node.m_static;
+	m_updateCounter = node.m_updateCounter;
 
 	return *this;
 }
 
+void NzModel::AdvanceFrames(float elapsedTime)
+{
+	m_interpolation += m_currentSequence->frameRate * elapsedTime;
+
+	// Après une longue pause (modèle figé hors-champ), on saute directement les boucles complètes de la séquence
+	unsigned int loopLength = (m_animation->IsLoopPointInterpolationEnabled()) ? m_currentSequence->frameCount : m_currentSequence->frameCount - 1;
+	if (loopLength > 0 && m_interpolation > loopLength + 1.f)
+		m_interpolation = 1.f + std::fmod(m_interpolation - 1.f, static_cast<float>(loopLength));
+
+	while (m_interpolation > 1.f)
+	{
+		m_interpolation -= 1.f;
+
+		unsigned lastFrame = m_currentSequence->firstFrame + m_currentSequence->frameCount - 1;
+		if (m_nextFrame+1 > lastFrame)
+		{
+			if (m_animation->IsLoopPointInterpolationEnabled())
+			{
+				m_currentFrame = m_nextFrame;
+				m_nextFrame = m_currentSequence->firstFrame;
+			}
+			else
+			{
+				m_currentFrame = m_currentSequence->firstFrame;
+				m_nextFrame = m_currentFrame+1;
+			}
+		}
+		else
+		{
+			m_currentFrame = m_nextFrame;
+			m_nextFrame++;
+		}
+	}
+}
+
+void NzModel::BlendPoses(const NzAnimationLODLevel& level, float interpolation)
+{
+	auto blendJoint = [this, interpolation](unsigned int index)
+	{
+		const JointPose& from = m_previousPose[index];
+		const JointPose& to = m_sampledPose[index];
+
+		NzJoint* joint = m_skeleton.GetJoint(index);
+		joint->SetPosition(NzVector3f::Lerp(from.position, to.position, interpolation));
+		joint->SetRotation(NzQuaternionf::Slerp(from.rotation, to.rotation, interpolation));
+		joint->SetScale(NzVector3f::Lerp(from.scale, to.scale, interpolation));
+	};
+
+	if (level.joints.empty())
+	{
+		unsigned int jointCount = m_skeleton.GetJointCount();
+		for (unsigned int i = 0; i < jointCount; ++i)
+			blendJoint(i);
+	}
+	else
+	{
+		for (unsigned int index : level.joints)
+			blendJoint(index);
+	}
+}
+
 bool NzModel::FrustumCull(const NzFrustumf& frustum)
 {
 	if (!m_boundingVolumeUpdated)
@@ -634,6 +781,21 @@ void NzModel::Invalidate()
 	m_boundingVolumeUpdated = false;
 }
 
+void NzModel::OnVisibilityChange(bool visibility)
+{
+	NzSceneNode::OnVisibilityChange(visibility);
+
+	// Un modèle figé hors-champ rattrape son animation au moment où il redevient visible
+	if (visibility && m_animationLOD && m_animationEnabled && m_animation && m_pendingAnimationTime > 0.f)
+	{
+		AdvanceFrames(m_pendingAnimationTime);
+		UpdateSkeleton(nullptr);
+
+		m_pendingAnimationTime = 0.f;
+		m_updateCounter = 0;
+	}
+}
+
 void NzModel::Register()
 {
 	if (m_animation)
@@ -645,10 +807,71 @@ void NzModel::Unregister()
 	m_scene->UnregisterForUpdate(this);
 }
 
+void NzModel::StorePose(const NzAnimationLODLevel& level)
+{
+	m_sampledPose.resize(m_skeleton.GetJointCount());
+
+	auto storeJoint = [this](unsigned int index)
+	{
+		const NzJoint* joint = m_skeleton.GetJoint(index);
+
+		JointPose& pose = m_sampledPose[index];
+		pose.position = joint->GetPosition(nzCoordSys_Local);
+		pose.rotation = joint->GetRotation(nzCoordSys_Local);
+		pose.scale = joint->GetScale(nzCoordSys_Local);
+	};
+
+	if (level.joints.empty())
+	{
+		for (unsigned int i = 0; i < m_sampledPose.size(); ++i)
+			storeJoint(i);
+	}
+	else
+	{
+		for (unsigned int index : level.joints)
+			storeJoint(index);
+	}
+}
+
 void NzModel::Update()
 {
-	if (m_animationEnabled && m_animation)
+	if (!m_animationEnabled || !m_animation)
+		return;
+
+	if (!m_animationLOD)
+	{
 		AdvanceAnimation(m_scene->GetUpdateTime());
+		return;
+	}
+
+	// Le temps écoulé est accumulé et consommé en une fois lors du prochain échantillonnage du squelette
+	m_pendingAnimationTime += m_scene->GetUpdateTime();
+
+	if (!m_visible && m_animationLOD->IsOffscreenFreezeEnabled())
+		return; // Pose figée, voir OnVisibilityChange
+
+	NzAbstractViewer* viewer = m_scene->GetViewer();
+	if (viewer)
+		m_animationLODLevel = m_animationLOD->SelectLevel(m_animationLOD->ComputeMetric(viewer, GetBoundingVolume()));
+	else
+		m_animationLODLevel = 0;
+
+	const NzAnimationLODLevel& level = m_animationLOD->GetLevel(m_animationLODLevel);
+	if (++m_updateCounter < level.updateInterval)
+	{
+		// Entre deux échantillonnages, la pose glisse de l'avant-dernière à la dernière pose échantillonnée :
+		// le mouvement reste fluide au prix d'un échantillonnage de retard, la boîte englobante n'étant recalculée qu'aux échantillonnages
+		if (!m_previousPose.empty() && m_sampledLODLevel == m_animationLODLevel)
+			BlendPoses(level, static_cast<float>(m_updateCounter+1)/level.updateInterval);
+
+		return;
+	}
+
+	AdvanceFrames(m_pendingAnimationTime);
+	UpdateSkeleton(&level);
+
+	m_pendingAnimationTime = 0.f;
+	m_updateCounter = 0;
 }
 
 void NzModel::UpdateBoundingVolume() const
@@ -668,4 +891,37 @@ void NzModel::UpdateBoundingVolume() const
 	m_boundingVolumeUpdated = true;
 }
 
+void NzModel::UpdateSkeleton(const NzAnimationLODLevel* level)
+{
+	if (level && !level->joints.empty())
+		m_animation->AnimateSkeleton(&m_skeleton, m_currentFrame, m_nextFrame, m_interpolation, &level->joints[0], level->joints.size());
+	else
+		m_animation->AnimateSkeleton(&m_skeleton, m_currentFrame, m_nextFrame, m_interpolation);
+
+	// À fréquence réduite, les deux dernières poses sont conservées pour être interpolées (voir Update)
+	if (level && level->updateInterval > 1)
+	{
+		// Un changement de niveau (et donc de joints animés) repart d'une pose sans interpolation
+		bool blend = (!m_sampledPose.empty() && m_sampledLODLevel == m_animationLODLevel);
+
+		std::swap(m_previousPose, m_sampledPose);
+		StorePose(*level);
+		m_sampledLODLevel = m_animationLODLevel;
+
+		if (blend)
+			BlendPoses(*level, 1.f/level->updateInterval);
+		else
+			m_previousPose.clear();
+	}
+	else
+	{
+		m_previousPose.clear();
+		m_sampledPose.clear();
+	}
+
+	m_boundingVolume.MakeNull();
+	m_boundingVolumeUpdated = false;
+	NotifyBoundingVolumeChange();
+}
+
 NzModelLoader::LoaderList NzModel::s_loaders;
@@ -0,0 +1,589 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/PortalSystem.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <Nazara/Graphics/SceneNode.hpp>
+#include <algorithm>
+#include <Nazara/Graphics/Debug.hpp>
+
+namespace
+{
+	const float epsilon = 0.0001f;
+
+	// Sutherland-Hodgman : ne garde que la partie du polygone du côté positif du plan
+	void ClipPolygon(const std::vector<NzVector3f>& input, const NzPlanef& plane, std::vector<NzVector3f>* output)
+	{
+		output->clear();
+
+		unsigned int vertexCount = input.size();
+		for (unsigned int i = 0; i < vertexCount; ++i)
+		{
+			const NzVector3f& a = input[i];
+			const NzVector3f& b = input[(i+1) % vertexCount];
+
+			float distA = plane.Distance(a);
+			float distB = plane.Distance(b);
+
+			if (distA >= 0.f)
+				output->push_back(a);
+
+			if ((distA >= 0.f) != (distB >= 0.f))
+				output->push_back(a + (b - a)*(distA / (distA - distB)));
+		}
+	}
+
+	bool IntersectPlanes(const std::vector<NzPlanef>& planes, const NzBoxf& box)
+	{
+		for (const NzPlanef& plane : planes)
+		{
+			if (plane.Distance(box.GetPositiveVertex(plane.normal)) < 0.f)
+				return false;
+		}
+
+		return true;
+	}
+
+	NzPlanef Flip(const NzPlanef& plane)
+	{
+		return NzPlanef(-plane.normal, -plane.distance);
+	}
+}
+
+NzPortalSystem::NzPortalSystem() :
+m_cameraCell(InvalidCell),
+m_frame(0),
+m_maxDepth(16),
+m_portalTraversalCount(0),
+m_visibleCellCount(0)
+{
+}
+
+NzPortalSystem::~NzPortalSystem()
+{
+	ClearNodes();
+}
+
+unsigned int NzPortalSystem::AddCell(const NzBoxf& bounds)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!bounds.IsValid())
+	{
+		NazaraError("Invalid cell bounds");
+		return InvalidCell;
+	}
+	#endif
+
+	Cell cell;
+	cell.bounds = bounds;
+	cell.visibleFrame = 0;
+
+	m_cells.push_back(std::move(cell));
+
+	// Les noeuds déjà présents peuvent recouper la nouvelle cellule
+	for (unsigned int i = 0; i < m_nodes.size(); ++i)
+	{
+		if (m_nodes[i].node && m_nodes[i].bounded)
+			AssignNode(i);
+	}
+
+	return m_cells.size()-1;
+}
+
+void NzPortalSystem::AddNode(NzSceneNode* node)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!node)
+	{
+		NazaraError("Invalid node");
+		return;
+	}
+	#endif
+
+	if (m_nodeIndices.find(node) != m_nodeIndices.end())
+		return;
+
+	// Un noeud n'appartient qu'à un système à la fois, qui est prévenu de sa destruction
+	if (node->m_portalSystem)
+		node->m_portalSystem->RemoveNode(node);
+
+	node->m_portalSystem = this;
+
+	unsigned int index;
+	if (m_freeNodes.empty())
+	{
+		index = m_nodes.size();
+		m_nodes.push_back(Node());
+	}
+	else
+	{
+		index = m_freeNodes.back();
+		m_freeNodes.pop_back();
+	}
+
+	Node& entry = m_nodes[index];
+	entry.bounded = false;
+	entry.node = node;
+	entry.visibleFrame = 0;
+
+	m_nodeIndices[node] = index;
+
+	if (node->IsDrawable())
+	{
+		const NzBoundingVolumef& volume = node->GetBoundingVolume();
+		if (volume.IsFinite())
+		{
+			entry.aabb = volume.aabb;
+			entry.bounded = true;
+
+			AssignNode(index);
+		}
+	}
+}
+
+void NzPortalSystem::AddNodes(NzNode* root)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!root)
+	{
+		NazaraError("Invalid root");
+		return;
+	}
+	#endif
+
+	for (NzNode* child : root->GetChilds())
+	{
+		if (child->GetNodeType() == nzNodeType_Scene)
+		{
+			NzSceneNode* sceneNode = static_cast<NzSceneNode*>(child);
+			nzSceneNodeType type = sceneNode->GetSceneNodeType();
+			if (type != nzSceneNodeType_Light && type != nzSceneNodeType_Root)
+				AddNode(sceneNode);
+		}
+
+		if (child->HasChilds())
+			AddNodes(child);
+	}
+}
+
+unsigned int NzPortalSystem::AddPortal(unsigned int cellA, unsigned int cellB, const NzVector3f* vertices, unsigned int vertexCount)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (cellA >= m_cells.size() || cellB >= m_cells.size())
+	{
+		NazaraError("Cell index out of range (" + NzString::Number(std::max(cellA, cellB)) + " >= " + NzString::Number(m_cells.size()) + ')');
+		return InvalidCell;
+	}
+
+	if (cellA == cellB)
+	{
+		NazaraError("Portal must link two different cells");
+		return InvalidCell;
+	}
+
+	if (!vertices || vertexCount < 3)
+	{
+		NazaraError("Portal needs at least three vertices");
+		return InvalidCell;
+	}
+	#endif
+
+	// Normale de Newell, robuste aux sommets alignés
+	NzVector3f center = NzVector3f::Zero();
+	NzVector3f normal = NzVector3f::Zero();
+	for (unsigned int i = 0; i < vertexCount; ++i)
+	{
+		const NzVector3f& a = vertices[i];
+		const NzVector3f& b = vertices[(i+1) % vertexCount];
+
+		normal.x += (a.y - b.y)*(a.z + b.z);
+		normal.y += (a.z - b.z)*(a.x + b.x);
+		normal.z += (a.x - b.x)*(a.y + b.y);
+
+		center += a;
+	}
+	center /= static_cast<float>(vertexCount);
+
+	float length = normal.GetLength();
+	if (length < epsilon)
+	{
+		NazaraError("Portal polygon is degenerated");
+		return InvalidCell;
+	}
+	normal /= length;
+
+	Portal portal;
+	portal.cells[0] = cellA;
+	portal.cells[1] = cellB;
+	portal.plane.Set(normal, center);
+	portal.traversing = false;
+	portal.vertices.assign(vertices, vertices + vertexCount);
+
+	// Le plan est orienté vers la cellule B
+	float distA = portal.plane.Distance(m_cells[cellA].bounds.GetCenter());
+	float distB = portal.plane.Distance(m_cells[cellB].bounds.GetCenter());
+	if (distA > epsilon || (distA > -epsilon && distB < -epsilon))
+		portal.plane = Flip(portal.plane);
+
+	unsigned int index = m_portals.size();
+	m_portals.push_back(std::move(portal));
+
+	m_cells[cellA].portals.push_back(index);
+	m_cells[cellB].portals.push_back(index);
+
+	return index;
+}
+
+void NzPortalSystem::Clear()
+{
+	ClearNodes();
+
+	m_cells.clear();
+	m_portals.clear();
+	m_cameraCell = InvalidCell;
+	m_portalTraversalCount = 0;
+	m_visibleCellCount = 0;
+}
+
+void NzPortalSystem::ClearNodes()
+{
+	for (Node& entry : m_nodes)
+	{
+		if (entry.node)
+			entry.node->m_portalSystem = nullptr;
+	}
+
+	for (Cell& cell : m_cells)
+		cell.nodes.clear();
+
+	m_freeNodes.clear();
+	m_nodeIndices.clear();
+	m_nodes.clear();
+}
+
+void NzPortalSystem::ComputeVisibility(const NzVector3f& eyePosition, const NzFrustumf& frustum)
+{
+	m_frame++;
+	m_portalTraversalCount = 0;
+	m_visibleCellCount = 0;
+
+	m_cameraCell = GetCell(eyePosition);
+	if (m_cameraCell == InvalidCell)
+		return; // Hors de toute cellule : rien n'est occulté, le frustum culling suffit
+
+	std::vector<NzPlanef> planes;
+	planes.reserve(nzFrustumPlane_Max+1);
+	for (unsigned int i = 0; i <= nzFrustumPlane_Max; ++i)
+		planes.push_back(frustum.GetPlane(static_cast<nzFrustumPlane>(i)));
+
+	m_farPlane = frustum.GetPlane(nzFrustumPlane_Far);
+
+	VisitCell(m_cameraCell, eyePosition, planes, 0);
+}
+
+unsigned int NzPortalSystem::GetCameraCell() const
+{
+	return m_cameraCell;
+}
+
+unsigned int NzPortalSystem::GetCell(const NzVector3f& point) const
+{
+	// Les cellules peuvent se chevaucher, la plus petite l'emporte
+	unsigned int bestCell = InvalidCell;
+	float bestVolume = 0.f;
+	for (unsigned int i = 0; i < m_cells.size(); ++i)
+	{
+		const NzBoxf& bounds = m_cells[i].bounds;
+		if (bounds.Contains(point))
+		{
+			float volume = bounds.width*bounds.height*bounds.depth;
+			if (bestCell == InvalidCell || volume < bestVolume)
+			{
+				bestCell = i;
+				bestVolume = volume;
+			}
+		}
+	}
+
+	return bestCell;
+}
+
+const NzBoxf& NzPortalSystem::GetCellBounds(unsigned int cell) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (cell >= m_cells.size())
+	{
+		NazaraError("Cell index out of range (" + NzString::Number(cell) + " >= " + NzString::Number(m_cells.size()) + ')');
+
+		static NzBoxf dummy(NzBoxf::Zero());
+		return dummy;
+	}
+	#endif
+
+	return m_cells[cell].bounds;
+}
+
+unsigned int NzPortalSystem::GetCellCount() const
+{
+	return m_cells.size();
+}
+
+unsigned int NzPortalSystem::GetMaxDepth() const
+{
+	return m_maxDepth;
+}
+
+unsigned int NzPortalSystem::GetNodeCellCount(const NzSceneNode* node) const
+{
+	auto it = m_nodeIndices.find(node);
+	if (it == m_nodeIndices.end())
+		return 0;
+
+	return m_nodes[it->second].cells.size();
+}
+
+unsigned int NzPortalSystem::GetNodeCount() const
+{
+	return m_nodeIndices.size();
+}
+
+unsigned int NzPortalSystem::GetPortalCount() const
+{
+	return m_portals.size();
+}
+
+unsigned int NzPortalSystem::GetPortalTraversalCount() const
+{
+	return m_portalTraversalCount;
+}
+
+unsigned int NzPortalSystem::GetVisibleCellCount() const
+{
+	return m_visibleCellCount;
+}
+
+bool NzPortalSystem::HasNode(const NzSceneNode* node) const
+{
+	return m_nodeIndices.find(node) != m_nodeIndices.end();
+}
+
+bool NzPortalSystem::IsCellVisible(unsigned int cell) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (cell >= m_cells.size())
+	{
+		NazaraError("Cell index out of range (" + NzString::Number(cell) + " >= " + NzString::Number(m_cells.size()) + ')');
+		return false;
+	}
+	#endif
+
+	if (m_cameraCell == InvalidCell)
+		return true;
+
+	return m_cells[cell].visibleFrame == m_frame;
+}
+
+bool NzPortalSystem::IsNodeInCell(const NzSceneNode* node, unsigned int cell) const
+{
+	auto it = m_nodeIndices.find(node);
+	if (it == m_nodeIndices.end())
+		return false;
+
+	const std::vector<unsigned int>& cells = m_nodes[it->second].cells;
+	return std::find(cells.begin(), cells.end(), cell) != cells.end();
+}
+
+bool NzPortalSystem::IsNodeOccluded(const NzSceneNode* node) const
+{
+	if (m_cameraCell == InvalidCell)
+		return false;
+
+	auto it = m_nodeIndices.find(node);
+	if (it == m_nodeIndices.end())
+		return false;
+
+	const Node& entry = m_nodes[it->second];
+	return !entry.cells.empty() && entry.visibleFrame != m_frame;
+}
+
+void NzPortalSystem::RemoveNode(NzSceneNode* node)
+{
+	auto it = m_nodeIndices.find(node);
+	if (it == m_nodeIndices.end())
+		return;
+
+	unsigned int index = it->second;
+	m_nodeIndices.erase(it);
+
+	UnassignNode(index);
+	m_nodes[index].node = nullptr;
+
+	node->m_portalSystem = nullptr;
+
+	m_freeNodes.push_back(index);
+}
+
+void NzPortalSystem::SetMaxDepth(unsigned int maxDepth)
+{
+	m_maxDepth = maxDepth;
+}
+
+void NzPortalSystem::Update()
+{
+	// Rattachement des noeuds ayant bougé depuis la dernière mise à jour
+	for (unsigned int i = 0; i < m_nodes.size(); ++i)
+	{
+		Node& entry = m_nodes[i];
+		if (!entry.node || !entry.node->IsDrawable())
+			continue;
+
+		const NzBoundingVolumef& volume = entry.node->GetBoundingVolume();
+		if (volume.IsFinite())
+		{
+			if (entry.bounded && entry.aabb == volume.aabb)
+				continue;
+
+			entry.aabb = volume.aabb;
+			entry.bounded = true;
+
+			AssignNode(i);
+		}
+		else if (entry.bounded)
+		{
+			// Volume infini (ou nul) : le noeud ne dépend plus d'aucune cellule
+			UnassignNode(i);
+			entry.bounded = false;
+		}
+	}
+}
+
+void NzPortalSystem::AssignNode(unsigned int nodeIndex)
+{
+	UnassignNode(nodeIndex);
+
+	Node& entry = m_nodes[nodeIndex];
+
+	// Le centre sert pour les volumes plats (un plan n'a pas d'épaisseur et ne recoupe aucune boîte)
+	NzVector3f center = entry.aabb.GetCenter();
+	for (unsigned int i = 0; i < m_cells.size(); ++i)
+	{
+		Cell& cell = m_cells[i];
+		if (cell.bounds.Intersect(entry.aabb) || cell.bounds.Contains(center))
+		{
+			cell.nodes.push_back(nodeIndex);
+			entry.cells.push_back(i);
+		}
+	}
+}
+
+void NzPortalSystem::UnassignNode(unsigned int nodeIndex)
+{
+	Node& entry = m_nodes[nodeIndex];
+	for (unsigned int cellIndex : entry.cells)
+	{
+		std::vector<unsigned int>& nodes = m_cells[cellIndex].nodes;
+		nodes.erase(std::find(nodes.begin(), nodes.end(), nodeIndex));
+	}
+
+	entry.cells.clear();
+}
+
+void NzPortalSystem::VisitCell(unsigned int cellIndex, const NzVector3f& eyePosition, const std::vector<NzPlanef>& planes, unsigned int depth)
+{
+	Cell& cell = m_cells[cellIndex];
+	if (cell.visibleFrame != m_frame)
+	{
+		cell.visibleFrame = m_frame;
+		m_visibleCellCount++;
+	}
+
+	// Une cellule peut être atteinte par plusieurs chemins, chacun révélant une partie différente
+	for (unsigned int nodeIndex : cell.nodes)
+	{
+		Node& node = m_nodes[nodeIndex];
+		if (node.visibleFrame != m_frame && IntersectPlanes(planes, node.aabb))
+			node.visibleFrame = m_frame;
+	}
+
+	if (depth >= m_maxDepth)
+		return;
+
+	for (unsigned int portalIndex : cell.portals)
+	{
+		Portal& portal = m_portals[portalIndex];
+		if (portal.traversing)
+			continue; // Déjà sur le chemin en cours
+
+		unsigned int target;
+		NzPlanef portalPlane; // Orienté vers la cellule cible
+		if (portal.cells[0] == cellIndex)
+		{
+			target = portal.cells[1];
+			portalPlane = portal.plane;
+		}
+		else
+		{
+			target = portal.cells[0];
+			portalPlane = Flip(portal.plane);
+		}
+
+		// Le portail est réduit à sa partie visible à travers le frustum courant
+		m_clipBuffers[0] = portal.vertices;
+		for (const NzPlanef& plane : planes)
+		{
+			ClipPolygon(m_clipBuffers[0], plane, &m_clipBuffers[1]);
+			std::swap(m_clipBuffers[0], m_clipBuffers[1]);
+
+			if (m_clipBuffers[0].size() < 3)
+				break;
+		}
+
+		const std::vector<NzVector3f>& clipped = m_clipBuffers[0];
+		if (clipped.size() < 3)
+			continue;
+
+		std::vector<NzPlanef> portalPlanes;
+
+		float eyeDistance = portalPlane.Distance(eyePosition);
+		if (eyeDistance < -epsilon)
+		{
+			NzVector3f center = NzVector3f::Zero();
+			for (const NzVector3f& vertex : clipped)
+				center += vertex;
+			center /= static_cast<float>(clipped.size());
+
+			// Un plan par arête, passant par l'oeil, plus le plan du portail lui-même et le plan lointain
+			portalPlanes.reserve(clipped.size() + 2);
+			for (unsigned int i = 0; i < clipped.size(); ++i)
+			{
+				NzVector3f normal = (clipped[i] - eyePosition).CrossProduct(clipped[(i+1) % clipped.size()] - eyePosition);
+
+				float length = normal.GetLength();
+				if (length < epsilon*epsilon)
+					continue; // Arête dégénérée par le découpage
+
+				normal /= length;
+
+				NzPlanef edgePlane(normal, eyePosition);
+				if (edgePlane.Distance(center) < 0.f)
+					edgePlane = Flip(edgePlane);
+
+				portalPlanes.push_back(edgePlane);
+			}
+
+			portalPlanes.push_back(portalPlane);
+			portalPlanes.push_back(m_farPlane);
+		}
+		else
+			// L'observateur est dans le plan du portail (ou derrière, si les cellules se chevauchent) : pas de réduction possible
+			portalPlanes = planes;
+
+		m_portalTraversalCount++;
+
+		portal.traversing = true;
+		VisitCell(target, eyePosition, portalPlanes, depth+1);
+		portal.traversing = false;
+	}
+}
@@ -0,0 +1,711 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/RenderGraph.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/ErrorFlags.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <Nazara/Renderer/Renderer.hpp>
+#include <Nazara/Utility/PixelFormat.hpp>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <Nazara/Graphics/Debug.hpp>
+
+///DOC: Une texture transitoire n'a de contenu garanti qu'entre sa première écriture et sa dernière lecture
+///     au sein d'une exécution du graphe, sa mémoire pouvant ensuite être réutilisée par une autre texture
+
+namespace
+{
+	const unsigned int importedKeyFlag = 0x80000000;
+
+	bool IsDepthFormat(nzPixelFormat format)
+	{
+		nzPixelFormatType type = NzPixelFormat::GetType(format);
+		return type == nzPixelFormatType_Depth || type == nzPixelFormatType_DepthStencil;
+	}
+
+	bool IsSameInfo(const NzRenderGraphTextureInfo& lhs, const NzRenderGraphTextureInfo& rhs)
+	{
+		return lhs.format == rhs.format && lhs.width == rhs.width && lhs.height == rhs.height;
+	}
+}
+
+NzRenderGraph::NzRenderGraph() :
+m_compiled(false),
+m_realized(false)
+{
+}
+
+NzRenderGraph::~NzRenderGraph()
+{
+	// Les render textures référencent les textures du pool, elles doivent être libérées en premier
+	m_renderTextures.clear();
+}
+
+unsigned int NzRenderGraph::AddPass(const NzString& name, ExecuteFunction execute)
+{
+	Pass pass;
+	pass.active = false;
+	pass.execute = std::move(execute);
+	pass.externalOutput = false;
+	pass.name = name;
+	pass.renderTexture = -1;
+
+	m_passes.push_back(std::move(pass));
+	m_compiled = false;
+
+	return m_passes.size()-1;
+}
+
+void NzRenderGraph::AddPassInput(unsigned int pass, unsigned int texture)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (pass >= m_passes.size())
+	{
+		NazaraError("Pass index out of range (" + NzString::Number(pass) + " >= " + NzString::Number(m_passes.size()) + ')');
+		return;
+	}
+
+	if (texture >= m_textures.size())
+	{
+		NazaraError("Texture index out of range (" + NzString::Number(texture) + " >= " + NzString::Number(m_textures.size()) + ')');
+		return;
+	}
+	#endif
+
+	m_passes[pass].inputs.push_back(texture);
+	m_compiled = false;
+}
+
+void NzRenderGraph::AddPassOutput(unsigned int pass, unsigned int texture, bool preserveContent)
+{
+	///DOC: Sans préservation du contenu, la passe s'engage à réécrire entièrement la texture
+	#if NAZARA_GRAPHICS_SAFE
+	if (pass >= m_passes.size())
+	{
+		NazaraError("Pass index out of range (" + NzString::Number(pass) + " >= " + NzString::Number(m_passes.size()) + ')');
+		return;
+	}
+
+	if (texture >= m_textures.size())
+	{
+		NazaraError("Texture index out of range (" + NzString::Number(texture) + " >= " + NzString::Number(m_textures.size()) + ')');
+		return;
+	}
+	#endif
+
+	Output output;
+	output.preserveContent = preserveContent;
+	output.texture = texture;
+
+	m_passes[pass].outputs.push_back(output);
+	m_compiled = false;
+}
+
+unsigned int NzRenderGraph::AddTexture(const NzString& name, const NzRenderGraphTextureInfo& info)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (info.width == 0 || info.height == 0)
+	{
+		NazaraError("Texture \"" + name + "\" size must be over zero");
+		return std::numeric_limits<unsigned int>::max();
+	}
+	#endif
+
+	Texture texture;
+	texture.firstUse = 0;
+	texture.info = info;
+	texture.lastUse = 0;
+	texture.name = name;
+	texture.physicalTexture = -1;
+
+	m_textures.push_back(texture);
+	m_compiled = false;
+
+	return m_textures.size()-1;
+}
+
+void NzRenderGraph::Clear()
+{
+	///DOC: Le pool de textures est conservé afin d'être réutilisé par le prochain graphe
+	m_passes.clear();
+	m_renderTextures.clear();
+	m_textures.clear();
+
+	m_compiled = false;
+	m_realized = false;
+}
+
+bool NzRenderGraph::Compile()
+{
+	// Les render textures référencent des textures du pool susceptibles d'être libérées
+	m_renderTextures.clear();
+
+	for (unsigned int i = 0; i < m_passes.size(); ++i)
+	{
+		if (!CheckPass(i))
+		{
+			NazaraError("Pass \"" + m_passes[i].name + "\" is invalid");
+			return false;
+		}
+	}
+
+	CullPasses();
+	ComputeLifetimes();
+	AssignPhysicalTextures();
+	SetupRenderTextures();
+
+	m_compiled = true;
+	m_realized = false;
+
+	return true;
+}
+
+bool NzRenderGraph::Execute(const NzScene* scene)
+{
+	if (!m_compiled && !Compile())
+	{
+		NazaraError("Failed to compile render graph");
+		return false;
+	}
+
+	if (!m_realized && !Realize())
+	{
+		NazaraError("Failed to realize render graph");
+		return false;
+	}
+
+	for (Pass& pass : m_passes)
+	{
+		if (!pass.active)
+			continue;
+
+		if (pass.renderTexture >= 0)
+		{
+			RenderTextureEntry& entry = m_renderTextures[pass.renderTexture];
+			NzRenderTexture* renderTexture = entry.renderTexture.get();
+
+			NzRenderer::SetTarget(renderTexture);
+			NzRenderer::SetViewport(NzRecti(0, 0, renderTexture->GetWidth(), renderTexture->GetHeight()));
+
+			// Plusieurs passes peuvent partager une render texture, les cibles sont donc rétablies à chaque fois
+			if (!entry.colorTargets.empty())
+				renderTexture->SetColorTargets(&entry.colorTargets[0], entry.colorTargets.size());
+		}
+
+		if (pass.execute)
+			pass.execute(scene);
+	}
+
+	return true;
+}
+
+const NzString& NzRenderGraph::GetPassName(unsigned int pass) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (pass >= m_passes.size())
+	{
+		NazaraError("Pass index out of range (" + NzString::Number(pass) + " >= " + NzString::Number(m_passes.size()) + ')');
+
+		static NzString dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_passes[pass].name;
+}
+
+unsigned int NzRenderGraph::GetPassCount() const
+{
+	return m_passes.size();
+}
+
+int NzRenderGraph::GetPhysicalTextureIndex(unsigned int texture) const
+{
+	///DOC: Renvoie -1 pour une texture importée ou inutilisée par les passes actives
+	#if NAZARA_GRAPHICS_SAFE
+	if (texture >= m_textures.size())
+	{
+		NazaraError("Texture index out of range (" + NzString::Number(texture) + " >= " + NzString::Number(m_textures.size()) + ')');
+		return -1;
+	}
+	#endif
+
+	return m_textures[texture].physicalTexture;
+}
+
+NzRenderGraphStats NzRenderGraph::GetStats() const
+{
+	NzRenderGraphStats stats;
+	stats.activePassCount = 0;
+	stats.culledPassCount = 0;
+	stats.physicalTextureCount = m_pool.size();
+	stats.renderTextureCount = m_renderTextures.size();
+	stats.transientTextureCount = 0;
+
+	for (const Pass& pass : m_passes)
+	{
+		if (pass.active)
+			stats.activePassCount++;
+		else
+			stats.culledPassCount++;
+	}
+
+	for (const Texture& texture : m_textures)
+	{
+		if (texture.physicalTexture >= 0)
+			stats.transientTextureCount++;
+	}
+
+	return stats;
+}
+
+NzTexture* NzRenderGraph::GetTexture(unsigned int texture) const
+{
+	///DOC: Une texture transitoire n'existe qu'après la première exécution du graphe compilé
+	#if NAZARA_GRAPHICS_SAFE
+	if (texture >= m_textures.size())
+	{
+		NazaraError("Texture index out of range (" + NzString::Number(texture) + " >= " + NzString::Number(m_textures.size()) + ')');
+		return nullptr;
+	}
+	#endif
+
+	const Texture& textureData = m_textures[texture];
+	if (textureData.importedTexture)
+		return textureData.importedTexture;
+	else if (textureData.physicalTexture >= 0)
+		return m_pool[textureData.physicalTexture].texture;
+	else
+		return nullptr;
+}
+
+unsigned int NzRenderGraph::GetTextureCount() const
+{
+	return m_textures.size();
+}
+
+const NzString& NzRenderGraph::GetTextureName(unsigned int texture) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (texture >= m_textures.size())
+	{
+		NazaraError("Texture index out of range (" + NzString::Number(texture) + " >= " + NzString::Number(m_textures.size()) + ')');
+
+		static NzString dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_textures[texture].name;
+}
+
+unsigned int NzRenderGraph::ImportTexture(const NzString& name, NzTexture* texture)
+{
+	///DOC: Les passes écrivant dans une texture importée ne sont jamais éliminées
+	#if NAZARA_GRAPHICS_SAFE
+	if (!texture || !texture->IsValid())
+	{
+		NazaraError("Invalid texture");
+		return std::numeric_limits<unsigned int>::max();
+	}
+	#endif
+
+	Texture textureData;
+	textureData.firstUse = 0;
+	textureData.importedTexture = texture;
+	textureData.info.format = texture->GetFormat();
+	textureData.info.height = texture->GetHeight();
+	textureData.info.width = texture->GetWidth();
+	textureData.lastUse = 0;
+	textureData.name = name;
+	textureData.physicalTexture = -1;
+
+	m_textures.push_back(textureData);
+	m_compiled = false;
+
+	return m_textures.size()-1;
+}
+
+bool NzRenderGraph::IsCompiled() const
+{
+	return m_compiled;
+}
+
+bool NzRenderGraph::IsPassActive(unsigned int pass) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (pass >= m_passes.size())
+	{
+		NazaraError("Pass index out of range (" + NzString::Number(pass) + " >= " + NzString::Number(m_passes.size()) + ')');
+		return false;
+	}
+	#endif
+
+	return m_passes[pass].active;
+}
+
+void NzRenderGraph::ReleasePool()
+{
+	m_renderTextures.clear();
+	m_pool.clear();
+
+	for (Texture& texture : m_textures)
+		texture.physicalTexture = -1;
+
+	m_compiled = false;
+	m_realized = false;
+}
+
+void NzRenderGraph::SetPassExternalOutput(unsigned int pass, bool externalOutput)
+{
+	///DOC: Une passe dessinant hors du graphe (vers la cible du viewer par exemple) n'est jamais éliminée
+	#if NAZARA_GRAPHICS_SAFE
+	if (pass >= m_passes.size())
+	{
+		NazaraError("Pass index out of range (" + NzString::Number(pass) + " >= " + NzString::Number(m_passes.size()) + ')');
+		return;
+	}
+	#endif
+
+	m_passes[pass].externalOutput = externalOutput;
+	m_compiled = false;
+}
+
+void NzRenderGraph::AssignPhysicalTextures()
+{
+	for (PhysicalTexture& physicalTexture : m_pool)
+		physicalTexture.used = false;
+
+	// Texture occupant actuellement chaque entrée du pool (-1 si libre)
+	std::vector<int> owners(m_pool.size(), -1);
+
+	for (Texture& texture : m_textures)
+		texture.physicalTexture = -1;
+
+	for (unsigned int i = 0; i < m_passes.size(); ++i)
+	{
+		if (!m_passes[i].active)
+			continue;
+
+		// Allocation des textures dont la vie commence avec cette passe
+		for (unsigned int j = 0; j < m_textures.size(); ++j)
+		{
+			Texture& texture = m_textures[j];
+			if (texture.importedTexture || texture.firstUse != i || texture.lastUse < texture.firstUse)
+				continue;
+
+			// On préfère une entrée déjà utilisée lors de cette compilation, afin de libérer les autres
+			int slot = -1;
+			for (unsigned int k = 0; k < m_pool.size(); ++k)
+			{
+				if (owners[k] < 0 && IsSameInfo(m_pool[k].info, texture.info))
+				{
+					if (m_pool[k].used)
+					{
+						slot = k;
+						break;
+					}
+					else if (slot < 0)
+						slot = k;
+				}
+			}
+
+			if (slot < 0)
+			{
+				PhysicalTexture physicalTexture;
+				physicalTexture.info = texture.info;
+				physicalTexture.used = false;
+
+				m_pool.push_back(physicalTexture);
+				owners.push_back(-1);
+
+				slot = m_pool.size()-1;
+			}
+
+			m_pool[slot].used = true;
+			owners[slot] = j;
+			texture.physicalTexture = slot;
+		}
+
+		// Libération des textures dont la vie s'arrête avec cette passe (après celle-ci, une passe ne pouvant lire et écrire deux alias)
+		for (unsigned int k = 0; k < m_pool.size(); ++k)
+		{
+			if (owners[k] >= 0 && m_textures[owners[k]].lastUse == i)
+				owners[k] = -1;
+		}
+	}
+
+	// Les entrées inutilisées sont libérées, les autres sont compactées
+	std::vector<int> remap(m_pool.size(), -1);
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < m_pool.size(); ++i)
+	{
+		if (m_pool[i].used)
+		{
+			if (count != i)
+				m_pool[count] = m_pool[i];
+
+			remap[i] = count++;
+		}
+	}
+
+	m_pool.resize(count);
+
+	for (Texture& texture : m_textures)
+	{
+		if (texture.physicalTexture >= 0)
+			texture.physicalTexture = remap[texture.physicalTexture];
+	}
+}
+
+bool NzRenderGraph::CheckPass(unsigned int pass) const
+{
+	const Pass& passData = m_passes[pass];
+
+	unsigned int depthCount = 0;
+	unsigned int height = 0;
+	unsigned int width = 0;
+	for (const Output& output : passData.outputs)
+	{
+		const Texture& texture = m_textures[output.texture];
+
+		if (std::find(passData.inputs.begin(), passData.inputs.end(), output.texture) != passData.inputs.end())
+		{
+			NazaraError("Texture \"" + texture.name + "\" is both read and written");
+			return false;
+		}
+
+		if (IsDepthFormat(texture.info.format))
+			depthCount++;
+
+		if (width == 0)
+		{
+			width = texture.info.width;
+			height = texture.info.height;
+		}
+		else if (texture.info.width != width || texture.info.height != height)
+		{
+			NazaraError("Outputs must have the same size (texture \"" + texture.name + "\" is " + NzString::Number(texture.info.width) + 'x' + NzString::Number(texture.info.height) + ", expected " + NzString::Number(width) + 'x' + NzString::Number(height) + ')');
+			return false;
+		}
+	}
+
+	if (depthCount > 1)
+	{
+		NazaraError("A pass can only have one depth output");
+		return false;
+	}
+
+	// Une texture transitoire doit avoir été écrite par une passe précédente avant d'être lue
+	for (unsigned int input : passData.inputs)
+	{
+		const Texture& texture = m_textures[input];
+		if (texture.importedTexture)
+			continue;
+
+		bool written = false;
+		for (unsigned int i = 0; i < pass && !written; ++i)
+		{
+			for (const Output& output : m_passes[i].outputs)
+			{
+				if (output.texture == input)
+				{
+					written = true;
+					break;
+				}
+			}
+		}
+
+		if (!written)
+		{
+			NazaraError("Texture \"" + texture.name + "\" is read before being written");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void NzRenderGraph::ComputeLifetimes()
+{
+	for (Texture& texture : m_textures)
+	{
+		// Une durée de vie vide (fin avant le début) indique une texture inutilisée
+		texture.firstUse = std::numeric_limits<unsigned int>::max();
+		texture.lastUse = 0;
+	}
+
+	for (unsigned int i = 0; i < m_passes.size(); ++i)
+	{
+		const Pass& pass = m_passes[i];
+		if (!pass.active)
+			continue;
+
+		for (unsigned int input : pass.inputs)
+		{
+			Texture& texture = m_textures[input];
+			texture.firstUse = std::min(texture.firstUse, i);
+			texture.lastUse = std::max(texture.lastUse, i);
+		}
+
+		for (const Output& output : pass.outputs)
+		{
+			Texture& texture = m_textures[output.texture];
+			texture.firstUse = std::min(texture.firstUse, i);
+			texture.lastUse = std::max(texture.lastUse, i);
+		}
+	}
+}
+
+void NzRenderGraph::CullPasses()
+{
+	// On remonte les passes en partant de la fin, en retenant quelles textures ont un contenu attendu par une passe active
+	std::vector<bool> needed(m_textures.size(), false);
+
+	for (int i = m_passes.size()-1; i >= 0; --i)
+	{
+		Pass& pass = m_passes[i];
+
+		pass.active = pass.externalOutput;
+		for (const Output& output : pass.outputs)
+		{
+			if (needed[output.texture] || m_textures[output.texture].importedTexture)
+			{
+				pass.active = true;
+				break;
+			}
+		}
+
+		if (!pass.active)
+			continue;
+
+		// Le contenu précédent d'une sortie n'est attendu que si la passe le préserve
+		for (const Output& output : pass.outputs)
+			needed[output.texture] = output.preserveContent;
+
+		for (unsigned int input : pass.inputs)
+			needed[input] = true;
+	}
+}
+
+unsigned int NzRenderGraph::GetAttachmentKey(unsigned int texture) const
+{
+	// Deux textures aliasées partagent la même clé, et donc la même render texture
+	const Texture& textureData = m_textures[texture];
+	if (textureData.importedTexture)
+		return importedKeyFlag | texture;
+	else
+		return textureData.physicalTexture;
+}
+
+bool NzRenderGraph::Realize()
+{
+	try
+	{
+		NzErrorFlags errFlags(nzErrorFlag_ThrowException);
+
+		for (PhysicalTexture& physicalTexture : m_pool)
+		{
+			if (physicalTexture.texture)
+				continue;
+
+			const NzRenderGraphTextureInfo& info = physicalTexture.info;
+
+			physicalTexture.texture = new NzTexture;
+			physicalTexture.texture->SetPersistent(false);
+			physicalTexture.texture->Create(nzImageType_2D, info.format, info.width, info.height);
+		}
+
+		for (RenderTextureEntry& entry : m_renderTextures)
+		{
+			entry.renderTexture.reset(new NzRenderTexture);
+
+			NzRenderTexture* renderTexture = entry.renderTexture.get();
+			renderTexture->Create(true);
+
+			for (unsigned int i = 0; i < entry.colorTextures.size(); ++i)
+				renderTexture->AttachTexture(nzAttachmentPoint_Color, i, GetTexture(entry.colorTextures[i]));
+
+			if (entry.depthTexture >= 0)
+			{
+				NzTexture* depthTexture = GetTexture(entry.depthTexture);
+				nzAttachmentPoint attachmentPoint = (NzPixelFormat::GetType(depthTexture->GetFormat()) == nzPixelFormatType_DepthStencil) ? nzAttachmentPoint_DepthStencil : nzAttachmentPoint_Depth;
+
+				renderTexture->AttachTexture(attachmentPoint, 0, depthTexture);
+			}
+
+			renderTexture->Unlock();
+
+			if (!renderTexture->IsComplete())
+			{
+				NazaraError("Incomplete render texture");
+				return false;
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		NazaraError("Failed to create render graph textures: " + NzString(e.what()));
+		return false;
+	}
+
+	m_realized = true;
+
+	return true;
+}
+
+void NzRenderGraph::SetupRenderTextures()
+{
+	// Les passes écrivant dans les mêmes textures physiques partagent une render texture
+	m_renderTextures.clear();
+
+	std::vector<unsigned int> keys;
+	for (Pass& pass : m_passes)
+	{
+		pass.renderTexture = -1;
+		if (!pass.active || pass.outputs.empty())
+			continue;
+
+		std::vector<unsigned int> colorTextures;
+		int depthTexture = -1;
+		for (const Output& output : pass.outputs)
+		{
+			if (IsDepthFormat(m_textures[output.texture].info.format))
+				depthTexture = output.texture;
+			else
+				colorTextures.push_back(output.texture);
+		}
+
+		keys.clear();
+		for (unsigned int texture : colorTextures)
+			keys.push_back(GetAttachmentKey(texture));
+
+		keys.push_back((depthTexture >= 0) ? GetAttachmentKey(depthTexture) : std::numeric_limits<unsigned int>::max());
+
+		for (unsigned int i = 0; i < m_renderTextures.size(); ++i)
+		{
+			if (m_renderTextures[i].attachmentKeys == keys)
+			{
+				pass.renderTexture = i;
+				break;
+			}
+		}
+
+		if (pass.renderTexture < 0)
+		{
+			RenderTextureEntry entry;
+			entry.attachmentKeys = keys;
+			entry.colorTextures = std::move(colorTextures);
+			entry.depthTexture = depthTexture;
+
+			for (unsigned int i = 0; i < entry.colorTextures.size(); ++i)
+				entry.colorTargets.push_back(static_cast<nzUInt8>(i));
+
+			m_renderTextures.push_back(std::move(entry));
+			pass.renderTexture = m_renderTextures.size()-1;
+		}
+	}
+}
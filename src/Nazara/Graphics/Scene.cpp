@@ -6,17 +6,36 @@
 #include <Nazara/Core/Clock.hpp>
 #include <Nazara/Core/Error.hpp>
 #include <Nazara/Core/ErrorFlags.hpp>
+#include <Nazara/Core/RWLock.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
 #include <Nazara/Graphics/Camera.hpp>
 #include <Nazara/Graphics/ColorBackground.hpp>
+#include <Nazara/Graphics/PortalSystem.hpp>
 #include <Nazara/Graphics/RenderTechniques.hpp>
 #include <Nazara/Graphics/SceneRoot.hpp>
 #include <Nazara/Renderer/Config.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <set>
 #include <vector>
 #include <Nazara/Graphics/Debug.hpp>
 
+namespace
+{
+	struct UpdateEntry
+	{
+		NzUpdatable* object;
+		nzUInt64 lastUpdate; // Temps de la scène (en microsecondes) lors de la dernière mise à jour
+		bool parallel;
+	};
+
+	// Temps écoulé depuis la dernière mise à jour de l'objet en cours, propre à chaque thread (voir GetUpdateTime)
+	thread_local const NzSceneImpl* currentScene = nullptr;
+	thread_local float currentUpdateTime;
+}
+
 struct NzSceneImpl
 {
 	NzSceneImpl(NzScene* scene) :
@@ -24,25 +43,98 @@ struct NzSceneImpl
 	{
 	}
 
+	nzUInt64 GetTime() const
+	{
+		return (clockFunction) ? clockFunction() : NzGetMicroseconds();
+	}
+
 	std::unique_ptr<NzAbstractBackground> background;
 	std::unique_ptr<NzAbstractRenderTechnique> renderTechnique;
-	std::vector<NzUpdatable*> updateList;
+	std::vector<UpdateEntry> updateLists[nzUpdateFrequency_Max+1];
 	std::vector<NzUpdatable*> visibleUpdateList;
-	NzClock updateClock;
+	NzClockFunction clockFunction = nullptr;
 	NzColor ambientColor = NzColor(25,25,25);
+	NzRWLock spatialLock;
+	NzSceneOctree spatialIndex; // Avant la racine : les noeuds s'en retirent lors de sa destruction
 	NzSceneRoot root;
-	NzAbstractViewer* viewer;
-	bool update;
-	float frameTime;
-	float updateTime;
+	NzAbstractViewer* viewer = nullptr;
+	NzPortalSystem* portalSystem = nullptr;
+	bool parallelUpdate = false;
+	bool update = false;
+	float updateBudget = 0.f;
+	float updateTime = 0.f;
 	int renderTechniqueRanking;
+	nzUInt64 lastUpdateTime;
+	nzUInt64 sceneTime = 0;
+	unsigned int updateCursors[nzUpdateFrequency_Max+1] = {0};
+	unsigned int updateDeferredCount = 0;
 	unsigned int updatePerSecond = 60;
+	unsigned int updateSliceCount = 4;
 };
 
+namespace
+{
+	void InsertEntry(NzSceneImpl* impl, nzUpdateFrequency frequency, const UpdateEntry& entry)
+	{
+		std::vector<UpdateEntry>& entries = impl->updateLists[frequency];
+
+		// Les objets indépendants sont gardés en tête de liste, pour être répartis entre les workers sans tri
+		if (entry.parallel)
+		{
+			auto it = entries.insert(std::find_if(entries.begin(), entries.end(), [](const UpdateEntry& e) { return !e.parallel; }), entry);
+
+			unsigned int& cursor = impl->updateCursors[frequency];
+			if (static_cast<unsigned int>(it - entries.begin()) < cursor)
+				cursor++;
+		}
+		else
+			entries.push_back(entry);
+	}
+
+	void UpdateEntries(const NzSceneImpl* impl, UpdateEntry* entries, unsigned int entryCount)
+	{
+		currentScene = impl;
+		for (unsigned int i = 0; i < entryCount; ++i)
+		{
+			UpdateEntry& entry = entries[i];
+			currentUpdateTime = (impl->sceneTime - entry.lastUpdate)/1000000.f;
+			entry.lastUpdate = impl->sceneTime;
+
+			entry.object->Update();
+		}
+		currentScene = nullptr;
+	}
+
+	// Met à jour au plus maxCount objets de la liste en partant du curseur, tant que l'échéance n'est pas dépassée
+	unsigned int UpdateRoundRobin(NzSceneImpl* impl, nzUpdateFrequency frequency, unsigned int maxCount, nzUInt64 deadline)
+	{
+		std::vector<UpdateEntry>& entries = impl->updateLists[frequency];
+		unsigned int& cursor = impl->updateCursors[frequency];
+
+		unsigned int count = 0;
+		while (count < maxCount && cursor < entries.size())
+		{
+			if (deadline != 0 && impl->GetTime() >= deadline)
+				break;
+
+			// Le curseur est avancé avant la mise à jour, l'objet peut ainsi se désenregistrer sans perturber le tourniquet
+			unsigned int index = cursor++;
+			if (cursor >= entries.size())
+				cursor = 0;
+
+			UpdateEntries(impl, &entries[index], 1);
+			count++;
+		}
+
+		return count;
+	}
+}
+
 NzScene::NzScene()
 {
 	m_impl = new NzSceneImpl(this);
 	m_impl->background.reset(new NzColorBackground);
+	m_impl->lastUpdateTime = m_impl->GetTime();
 	m_impl->renderTechnique.reset(NzRenderTechniques::GetByRanking(-1, &m_impl->renderTechniqueRanking));
 }
 
@@ -78,6 +170,16 @@ void NzScene::Cull()
 
 	m_impl->visibleUpdateList.clear();
 
+	// Les noeuds déplacés depuis l'Update sont relus avant le rendu, pour les requêtes suivantes
+	UpdateSpatialIndex();
+
+	// Cellules et portails : les noeuds cachés derrière les murs seront écartés avant même le test du frustum
+	if (m_impl->portalSystem)
+	{
+		m_impl->portalSystem->Update();
+		m_impl->portalSystem->ComputeVisibility(m_impl->viewer->GetEyePosition(), m_impl->viewer->GetFrustum());
+	}
+
 	// Frustum culling
 	RecursiveFrustumCull(m_impl->renderTechnique->GetRenderQueue(), m_impl->viewer->GetFrustum(), &m_impl->root);
 
@@ -113,6 +215,11 @@ void NzScene::Draw()
 	}
 }
 
+void NzScene::EnableParallelUpdate(bool parallel)
+{
+	m_impl->parallelUpdate = parallel;
+}
+
 NzColor NzScene::GetAmbientColor() const
 {
 	return m_impl->ambientColor;
@@ -123,6 +230,11 @@ NzAbstractBackground* NzScene::GetBackground() const
 	return m_impl->background.get();
 }
 
+NzPortalSystem* NzScene::GetPortalSystem() const
+{
+	return m_impl->portalSystem;
+}
+
 NzAbstractRenderTechnique* NzScene::GetRenderTechnique() const
 {
 	return m_impl->renderTechnique.get();
@@ -138,9 +250,23 @@ NzAbstractViewer* NzScene::GetViewer() const
 	return m_impl->viewer;
 }
 
+float NzScene::GetUpdateBudget() const
+{
+	return m_impl->updateBudget;
+}
+
+unsigned int NzScene::GetUpdateDeferredCount() const
+{
+	return m_impl->updateDeferredCount;
+}
+
 float NzScene::GetUpdateTime() const
 {
-	return m_impl->updateTime;
+	// Durant sa mise à jour, un objet obtient le temps écoulé depuis sa propre dernière mise à jour
+	if (currentScene == m_impl)
+		return currentUpdateTime;
+	else
+		return m_impl->updateTime;
 }
 
 unsigned int NzScene::GetUpdatePerSecond() const
@@ -148,7 +274,83 @@ unsigned int NzScene::GetUpdatePerSecond() const
 	return m_impl->updatePerSecond;
 }
 
-void NzScene::RegisterForUpdate(NzUpdatable* object)
+unsigned int NzScene::GetUpdateSliceCount() const
+{
+	return m_impl->updateSliceCount;
+}
+
+bool NzScene::IsParallelUpdateEnabled() const
+{
+	return m_impl->parallelUpdate;
+}
+
+unsigned int NzScene::QueryBox(const NzBoxf& box, NzSceneNode** results, unsigned int maxResults, nzUInt32 mask) const
+{
+	///DOC: Les requêtes ne modifient pas l'index et peuvent être lancées depuis plusieurs threads à la fois ;
+	///     elles reflètent l'état des noeuds lors du dernier UpdateSpatialIndex (appelé par Update et Cull)
+	NzReadLockGuard lock(m_impl->spatialLock);
+	return m_impl->spatialIndex.QueryBox(box, results, maxResults, mask);
+}
+
+void NzScene::QueryBoxes(const NzBoxf* boxes, unsigned int queryCount, NzSceneNode** results, unsigned int maxResultsPerQuery, unsigned int* resultCounts, nzUInt32 mask) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (queryCount > 0 && (!boxes || !resultCounts || (!results && maxResultsPerQuery > 0)))
+	{
+		NazaraError("Invalid buffers");
+		return;
+	}
+	#endif
+
+	// Un seul verrouillage pour tout le lot, la requête i écrit dans results[i*maxResultsPerQuery]
+	NzReadLockGuard lock(m_impl->spatialLock);
+	for (unsigned int i = 0; i < queryCount; ++i)
+		resultCounts[i] = m_impl->spatialIndex.QueryBox(boxes[i], &results[i*maxResultsPerQuery], maxResultsPerQuery, mask);
+}
+
+unsigned int NzScene::QueryRay(const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzSceneQueryHit* hits, unsigned int maxHits, nzUInt32 mask) const
+{
+	NzReadLockGuard lock(m_impl->spatialLock);
+	return m_impl->spatialIndex.QueryRay(origin, direction, maxDistance, hits, maxHits, mask);
+}
+
+void NzScene::QueryRays(const NzVector3f* origins, const NzVector3f* directions, unsigned int queryCount, float maxDistance, NzSceneQueryHit* hits, unsigned int maxHitsPerQuery, unsigned int* hitCounts, nzUInt32 mask) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (queryCount > 0 && (!origins || !directions || !hitCounts || (!hits && maxHitsPerQuery > 0)))
+	{
+		NazaraError("Invalid buffers");
+		return;
+	}
+	#endif
+
+	NzReadLockGuard lock(m_impl->spatialLock);
+	for (unsigned int i = 0; i < queryCount; ++i)
+		hitCounts[i] = m_impl->spatialIndex.QueryRay(origins[i], directions[i], maxDistance, &hits[i*maxHitsPerQuery], maxHitsPerQuery, mask);
+}
+
+unsigned int NzScene::QuerySphere(const NzSpheref& sphere, NzSceneNode** results, unsigned int maxResults, nzUInt32 mask) const
+{
+	NzReadLockGuard lock(m_impl->spatialLock);
+	return m_impl->spatialIndex.QuerySphere(sphere, results, maxResults, mask);
+}
+
+void NzScene::QuerySpheres(const NzSpheref* spheres, unsigned int queryCount, NzSceneNode** results, unsigned int maxResultsPerQuery, unsigned int* resultCounts, nzUInt32 mask) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (queryCount > 0 && (!spheres || !resultCounts || (!results && maxResultsPerQuery > 0)))
+	{
+		NazaraError("Invalid buffers");
+		return;
+	}
+	#endif
+
+	NzReadLockGuard lock(m_impl->spatialLock);
+	for (unsigned int i = 0; i < queryCount; ++i)
+		resultCounts[i] = m_impl->spatialIndex.QuerySphere(spheres[i], &results[i*maxResultsPerQuery], maxResultsPerQuery, mask);
+}
+
+void NzScene::RegisterForUpdate(NzUpdatable* object, nzUpdateFrequency frequency, bool parallel)
 {
 	#if NAZARA_GRAPHICS_SAFE
 	if (!object)
@@ -156,9 +358,20 @@ void NzScene::RegisterForUpdate(NzUpdatable* object)
 		NazaraError("Invalid object");
 		return;
 	}
+
+	if (frequency > nzUpdateFrequency_Max)
+	{
+		NazaraError("Update frequency out of enum");
+		return;
+	}
 	#endif
 
-	m_impl->updateList.push_back(object);
+	UpdateEntry entry;
+	entry.object = object;
+	entry.lastUpdate = m_impl->sceneTime;
+	entry.parallel = parallel;
+
+	InsertEntry(m_impl, frequency, entry);
 }
 
 void NzScene::SetAmbientColor(const NzColor& color)
@@ -171,6 +384,18 @@ void NzScene::SetBackground(NzAbstractBackground* background)
 	m_impl->background.reset(background);
 }
 
+void NzScene::SetClockFunction(NzClockFunction clockFunction)
+{
+	m_impl->clockFunction = clockFunction;
+	m_impl->lastUpdateTime = m_impl->GetTime();
+}
+
+void NzScene::SetPortalSystem(NzPortalSystem* portalSystem)
+{
+	// Non possédé par la scène, qui ne fait que l'interroger lors du Cull
+	m_impl->portalSystem = portalSystem;
+}
+
 void NzScene::SetRenderTechnique(NzAbstractRenderTechnique* renderTechnique)
 {
 	m_impl->renderTechnique.reset(renderTechnique);
@@ -186,11 +411,67 @@ void NzScene::SetViewer(NzAbstractViewer& viewer)
 	SetViewer(&viewer);
 }
 
+void NzScene::SetUpdateBudget(float milliseconds)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (milliseconds < 0.f)
+	{
+		NazaraError("Update budget must be positive");
+		return;
+	}
+	#endif
+
+	m_impl->updateBudget = milliseconds;
+}
+
+void NzScene::SetUpdateFrequency(NzUpdatable* object, nzUpdateFrequency frequency)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (frequency > nzUpdateFrequency_Max)
+	{
+		NazaraError("Update frequency out of enum");
+		return;
+	}
+	#endif
+
+	for (unsigned int i = 0; i <= nzUpdateFrequency_Max; ++i)
+	{
+		std::vector<UpdateEntry>& entries = m_impl->updateLists[i];
+		auto it = std::find_if(entries.begin(), entries.end(), [object](const UpdateEntry& entry) { return entry.object == object; });
+		if (it != entries.end())
+		{
+			if (i == frequency)
+				return;
+
+			UpdateEntry entry = *it;
+			UnregisterForUpdate(object);
+
+			InsertEntry(m_impl, frequency, entry);
+			return;
+		}
+	}
+
+	NazaraError("Object is not registered for update");
+}
+
 void NzScene::SetUpdatePerSecond(unsigned int updatePerSecond)
 {
 	m_impl->updatePerSecond = updatePerSecond;
 }
 
+void NzScene::SetUpdateSliceCount(unsigned int sliceCount)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (sliceCount == 0)
+	{
+		NazaraError("Slice count must be over zero");
+		return;
+	}
+	#endif
+
+	m_impl->updateSliceCount = sliceCount;
+}
+
 void NzScene::UnregisterForUpdate(NzUpdatable* object)
 {
 	#if NAZARA_GRAPHICS_SAFE
@@ -201,23 +482,92 @@ void NzScene::UnregisterForUpdate(NzUpdatable* object)
 	}
 	#endif
 
-	auto it = std::find(m_impl->updateList.begin(), m_impl->updateList.end(), object);
-	if (it != m_impl->updateList.end())
-		m_impl->updateList.erase(it);
+	for (unsigned int i = 0; i <= nzUpdateFrequency_Max; ++i)
+	{
+		std::vector<UpdateEntry>& entries = m_impl->updateLists[i];
+		auto it = std::find_if(entries.begin(), entries.end(), [object](const UpdateEntry& entry) { return entry.object == object; });
+		if (it != entries.end())
+		{
+			// Le curseur doit continuer de désigner le même objet pour ne pas rompre le tourniquet
+			unsigned int index = it - entries.begin();
+			unsigned int& cursor = m_impl->updateCursors[i];
+			if (index < cursor)
+				cursor--;
+
+			entries.erase(it);
+			if (cursor >= entries.size())
+				cursor = 0;
+
+			return;
+		}
+	}
 }
 
 void NzScene::Update()
 {
-	m_impl->update = (m_impl->updatePerSecond == 0 || m_impl->updateClock.GetMilliseconds() > 1000/m_impl->updatePerSecond);
-	if (m_impl->update)
+	// Les noeuds déplacés depuis la dernière fois sont relus ici, sur le thread principal : les requêtes (éventuellement
+	// lancées par les objets mis à jour en parallèle) ne modifient jamais l'index et n'ont besoin que du verrou en lecture
+	UpdateSpatialIndex();
+
+	nzUInt64 now = m_impl->GetTime();
+	nzUInt64 elapsedTime = now - m_impl->lastUpdateTime;
+
+	m_impl->update = (m_impl->updatePerSecond == 0 || elapsedTime > 1000000/m_impl->updatePerSecond);
+	if (!m_impl->update)
+		return;
+
+	m_impl->lastUpdateTime = now;
+	m_impl->sceneTime += elapsedTime;
+	m_impl->updateTime = elapsedTime/1000000.f;
+
+	nzUInt64 deadline = (m_impl->updateBudget > 0.f) ? now + static_cast<nzUInt64>(m_impl->updateBudget*1000.f) : 0;
+
+	// Les objets mis à jour à chaque fois, indépendamment du budget
+	std::vector<UpdateEntry>& alwaysEntries = m_impl->updateLists[nzUpdateFrequency_Always];
+	if (m_impl->parallelUpdate && NzTaskScheduler::GetWorkerCount() > 1)
 	{
-		m_impl->updateTime = m_impl->updateClock.GetSeconds();
-		m_impl->updateClock.Restart();
+		// Les objets indépendants se trouvent en tête de liste (voir InsertEntry)
+		unsigned int parallelCount = std::find_if(alwaysEntries.begin(), alwaysEntries.end(), [](const UpdateEntry& entry) { return !entry.parallel; }) - alwaysEntries.begin();
+
+		if (parallelCount > 0)
+		{
+			unsigned int workerCount = std::min(NzTaskScheduler::GetWorkerCount(), parallelCount);
+			std::div_t div = std::div(static_cast<int>(parallelCount), static_cast<int>(workerCount));
+			for (unsigned int i = 0; i < workerCount; ++i)
+				NzTaskScheduler::AddTask(UpdateEntries, static_cast<const NzSceneImpl*>(m_impl), &alwaysEntries[i*div.quot], (i == workerCount-1) ? div.quot + div.rem : div.quot);
+
+			NzTaskScheduler::WaitForTasks();
+		}
 
-		for (NzUpdatable* updatable : m_impl->updateList)
-			///TODO: Multihreading
-			updatable->Update();
+		if (parallelCount < alwaysEntries.size())
+			UpdateEntries(m_impl, &alwaysEntries[parallelCount], alwaysEntries.size() - parallelCount);
+	}
+	else if (!alwaysEntries.empty())
+		UpdateEntries(m_impl, &alwaysEntries[0], alwaysEntries.size());
+
+	// Les objets normaux reprennent là où le budget s'est épuisé la dernière fois, les reportés passent donc en premier
+	unsigned int normalCount = m_impl->updateLists[nzUpdateFrequency_Normal].size();
+	unsigned int normalUpdated = 0;
+	if (normalCount > 0)
+	{
+		// Au moins un objet est mis à jour à chaque fois pour garantir la progression
+		normalUpdated = UpdateRoundRobin(m_impl, nzUpdateFrequency_Normal, 1, 0);
+		normalUpdated += UpdateRoundRobin(m_impl, nzUpdateFrequency_Normal, normalCount - normalUpdated, deadline);
 	}
+
+	m_impl->updateDeferredCount = normalCount - std::min(normalUpdated, normalCount);
+
+	// Les objets de basse fréquence sont répartis en tranches, un objet est donc mis à jour toutes les updateSliceCount mises à jour
+	unsigned int lowCount = m_impl->updateLists[nzUpdateFrequency_Low].size();
+	if (lowCount > 0 && m_impl->updateDeferredCount == 0)
+		UpdateRoundRobin(m_impl, nzUpdateFrequency_Low, (lowCount + m_impl->updateSliceCount - 1)/m_impl->updateSliceCount, deadline);
+}
+
+void NzScene::UpdateSpatialIndex()
+{
+	///DOC: À n'appeler que depuis le thread principal, hors des mises à jour parallèles
+	NzWriteLockGuard lock(m_impl->spatialLock);
+	m_impl->spatialIndex.Update();
 }
 
 void NzScene::UpdateVisible()
@@ -234,6 +584,18 @@ NzScene::operator const NzSceneNode&() const
 	return m_impl->root;
 }
 
+void NzScene::AddToSpatialIndex(NzSceneNode* node)
+{
+	NzWriteLockGuard lock(m_impl->spatialLock);
+	m_impl->spatialIndex.Insert(node);
+}
+
+void NzScene::InvalidateSpatialIndex(NzSceneNode* node)
+{
+	NzWriteLockGuard lock(m_impl->spatialLock);
+	m_impl->spatialIndex.Invalidate(node);
+}
+
 void NzScene::RecursiveFrustumCull(NzAbstractRenderQueue* renderQueue, const NzFrustumf& frustum, NzNode* node)
 {
 	for (NzNode* child : node->GetChilds())
@@ -243,7 +605,9 @@ void NzScene::RecursiveFrustumCull(NzAbstractRenderQueue* renderQueue, const NzF
 			NzSceneNode* sceneNode = static_cast<NzSceneNode*>(child);
 
 			///TODO: Empêcher le rendu des enfants si le parent est cullé selon un flag
-			sceneNode->UpdateVisibility(frustum);
+			bool occluded = m_impl->portalSystem && m_impl->portalSystem->IsNodeOccluded(sceneNode);
+
+			sceneNode->UpdateVisibility(frustum, occluded);
 			if (sceneNode->IsVisible())
 				sceneNode->AddToRenderQueue(renderQueue);
 		}
@@ -252,3 +616,9 @@ void NzScene::RecursiveFrustumCull(NzAbstractRenderQueue* renderQueue, const NzF
 			RecursiveFrustumCull(renderQueue, frustum, child);
 	}
 }
+
+void NzScene::RemoveFromSpatialIndex(NzSceneNode* node)
+{
+	NzWriteLockGuard lock(m_impl->spatialLock);
+	m_impl->spatialIndex.Remove(node);
+}
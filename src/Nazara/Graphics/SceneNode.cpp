@@ -4,25 +4,40 @@
 
 #include <Nazara/Graphics/SceneNode.hpp>
 #include <Nazara/Graphics/Config.hpp>
+#include <Nazara/Graphics/PortalSystem.hpp>
 #include <Nazara/Graphics/Scene.hpp>
 #include <Nazara/Graphics/Debug.hpp>
 
 NzSceneNode::NzSceneNode() :
 m_scene(nullptr),
+m_queryMask(0xFFFFFFFF),
 m_drawingEnabled(true),
-m_visible(false)
+m_visible(false),
+m_portalSystem(nullptr)
 {
 }
 
 NzSceneNode::NzSceneNode(const NzSceneNode& sceneNode) :
 NzNode(sceneNode),
 m_scene(sceneNode.m_scene),
+m_queryMask(sceneNode.m_queryMask),
 m_drawingEnabled(sceneNode.m_drawingEnabled),
-m_visible(false)
+m_visible(false),
+m_portalSystem(nullptr)
 {
+	// Le volume englobant ne sera lu que plus tard, la classe dérivée n'étant pas encore construite
+	if (m_scene)
+		m_scene->AddToSpatialIndex(this);
 }
 
-NzSceneNode::~NzSceneNode() = default;
+NzSceneNode::~NzSceneNode()
+{
+	if (m_portalSystem)
+		m_portalSystem->RemoveNode(this);
+
+	if (m_scene)
+		m_scene->RemoveFromSpatialIndex(this);
+}
 
 void NzSceneNode::EnableDrawing(bool drawingEnabled)
 {
@@ -34,6 +49,11 @@ nzNodeType NzSceneNode::GetNodeType() const
 	return nzNodeType_Scene;
 }
 
+nzUInt32 NzSceneNode::GetQueryMask() const
+{
+	return m_queryMask;
+}
+
 NzScene* NzSceneNode::GetScene() const
 {
 	return m_scene;
@@ -49,24 +69,48 @@ bool NzSceneNode::IsVisible() const
 	return m_visible;
 }
 
+void NzSceneNode::SetQueryMask(nzUInt32 queryMask)
+{
+	m_queryMask = queryMask;
+
+	NotifyBoundingVolumeChange(); // Le masque est recopié par l'index spatial avec le volume
+}
+
 NzSceneNode& NzSceneNode::operator=(const NzSceneNode& sceneNode)
 {
 	m_drawingEnabled = sceneNode.m_drawingEnabled;
-	m_scene = sceneNode.m_scene;
+	m_queryMask = sceneNode.m_queryMask;
 	m_visible = false;
 
+	SetSpatialScene(sceneNode.m_scene);
+
 	return *this;
 }
 
 NzSceneNode& NzSceneNode::operator=(NzSceneNode&& sceneNode)
 {
 	m_drawingEnabled = sceneNode.m_drawingEnabled;
-	m_scene = sceneNode.m_scene;
+	m_queryMask = sceneNode.m_queryMask;
 	m_visible = sceneNode.m_visible;
 
+	SetSpatialScene(sceneNode.m_scene);
+
 	return *this;
 }
 
+void NzSceneNode::Invalidate()
+{
+	NzNode::Invalidate();
+
+	NotifyBoundingVolumeChange();
+}
+
+void NzSceneNode::NotifyBoundingVolumeChange()
+{
+	if (m_scene)
+		m_scene->InvalidateSpatialIndex(this);
+}
+
 void NzSceneNode::OnParenting(const NzNode* parent)
 {
 	if (parent)
@@ -93,11 +137,10 @@ void NzSceneNode::RecursiveSetScene(NzScene* scene, NzNode* node)
 		if (child->GetNodeType() == nzNodeType_Scene)
 		{
 			NzSceneNode* sceneNode = static_cast<NzSceneNode*>(child);
-			sceneNode->SetScene(scene);
+			sceneNode->SetScene(scene); // Se charge de ses propres enfants
 		}
-
-		if (node->HasChilds())
-			RecursiveSetScene(scene, node);
+		else if (child->HasChilds())
+			RecursiveSetScene(scene, child);
 	}
 }
 
@@ -110,16 +153,41 @@ void NzSceneNode::SetScene(NzScene* scene)
 	if (m_scene != scene)
 	{
 		if (m_scene)
+		{
 			Unregister();
+			m_scene->RemoveFromSpatialIndex(this);
+
+			// Un noeud quittant sa scène ne participe plus à sa visibilité
+			if (m_portalSystem)
+				m_portalSystem->RemoveNode(this);
+		}
 
 		m_scene = scene;
 		if (m_scene)
+		{
+			m_scene->AddToSpatialIndex(this);
 			Register();
+		}
 
 		RecursiveSetScene(scene, this);
 	}
 }
 
+void NzSceneNode::SetSpatialScene(NzScene* scene)
+{
+	if (m_scene != scene)
+	{
+		if (m_scene)
+			m_scene->RemoveFromSpatialIndex(this);
+
+		m_scene = scene;
+		if (m_scene)
+			m_scene->AddToSpatialIndex(this);
+	}
+	else
+		NotifyBoundingVolumeChange();
+}
+
 void NzSceneNode::Unregister()
 {
 }
@@ -128,11 +196,11 @@ void NzSceneNode::Update()
 {
 }
 
-void NzSceneNode::UpdateVisibility(const NzFrustumf& frustum)
+void NzSceneNode::UpdateVisibility(const NzFrustumf& frustum, bool occluded)
 {
 	bool wasVisible = m_visible;
 
-	if (m_drawingEnabled)
+	if (m_drawingEnabled && !occluded)
 	{
 		#if NAZARA_GRAPHICS_SAFE
 		if (!IsDrawable())
@@ -0,0 +1,538 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/SceneOctree.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <Nazara/Graphics/SceneNode.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <Nazara/Graphics/Debug.hpp>
+
+namespace
+{
+	// Au-delà, l'agrandissement de la racine ne rajoute plus de niveaux
+	const unsigned int maxGrowthDepth = 24;
+
+	// Une cellule n'est subdivisée qu'à partir de ce nombre d'entrées, pour ne pas allouer de branches presque vides
+	const unsigned int splitThreshold = 8;
+
+	float GetHalfExtent(const NzBoxf& aabb)
+	{
+		return std::max(std::max(aabb.width, aabb.height), aabb.depth)*0.5f;
+	}
+
+	// Contrairement à NzBox::Intersect, deux boîtes qui se touchent se recoupent (et une boîte plate reste détectable)
+	bool Overlap(const NzBoxf& a, const NzBoxf& b)
+	{
+		return a.x <= b.x + b.width  && b.x <= a.x + a.width &&
+		       a.y <= b.y + b.height && b.y <= a.y + a.height &&
+		       a.z <= b.z + b.depth  && b.z <= a.z + a.depth;
+	}
+
+	bool RayIntersect(const NzVector3f& origin, const NzVector3f& invDirection, float maxDistance, const NzBoxf& box, float* distance)
+	{
+		float tMin = 0.f;
+		float tMax = maxDistance;
+
+		const float origins[3] = {origin.x, origin.y, origin.z};
+		const float invDirections[3] = {invDirection.x, invDirection.y, invDirection.z};
+		const float mins[3] = {box.x, box.y, box.z};
+		const float maxs[3] = {box.x + box.width, box.y + box.height, box.z + box.depth};
+
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			if (std::isinf(invDirections[i]))
+			{
+				// Rayon parallèle à la tranche
+				if (origins[i] < mins[i] || origins[i] > maxs[i])
+					return false;
+			}
+			else
+			{
+				float t1 = (mins[i] - origins[i])*invDirections[i];
+				float t2 = (maxs[i] - origins[i])*invDirections[i];
+				if (t1 > t2)
+					std::swap(t1, t2);
+
+				tMin = std::max(tMin, t1);
+				tMax = std::min(tMax, t2);
+				if (tMin > tMax)
+					return false;
+			}
+		}
+
+		if (distance)
+			*distance = tMin;
+
+		return true;
+	}
+
+	float SquaredDistance(const NzVector3f& point, const NzBoxf& box)
+	{
+		float dx = std::max(std::max(box.x - point.x, point.x - (box.x + box.width)), 0.f);
+		float dy = std::max(std::max(box.y - point.y, point.y - (box.y + box.height)), 0.f);
+		float dz = std::max(std::max(box.z - point.z, point.z - (box.z + box.depth)), 0.f);
+
+		return dx*dx + dy*dy + dz*dz;
+	}
+}
+
+NzSceneOctree::NzSceneOctree(float rootSize, unsigned int maxDepth) :
+m_initialSize(rootSize),
+m_initialDepth(maxDepth),
+m_maxDepth(maxDepth)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (rootSize <= 0.f)
+	{
+		NazaraError("Root size must be over zero");
+		m_initialSize = 1024.f;
+	}
+	#endif
+
+	Clear();
+}
+
+NzSceneOctree::~NzSceneOctree() = default;
+
+void NzSceneOctree::Clear()
+{
+	m_cells.clear();
+	m_dirtyEntries.clear();
+	m_entries.clear();
+	m_entryIndices.clear();
+	m_freeEntries.clear();
+	m_infiniteEntries.clear();
+	m_maxDepth = m_initialDepth;
+
+	Cell root;
+	root.center = NzVector3f::Zero();
+	root.children = 0;
+	root.depth = 0;
+	root.halfSize = m_initialSize*0.5f;
+	root.parent = NoCell;
+	root.subtreeCount = 0;
+
+	m_cells.push_back(std::move(root));
+}
+
+unsigned int NzSceneOctree::GetCellCount() const
+{
+	return m_cells.size();
+}
+
+unsigned int NzSceneOctree::GetDepth() const
+{
+	return m_maxDepth;
+}
+
+unsigned int NzSceneOctree::GetNodeCount() const
+{
+	return m_entryIndices.size();
+}
+
+float NzSceneOctree::GetRootSize() const
+{
+	return m_cells[0].halfSize*2.f;
+}
+
+bool NzSceneOctree::HasNode(const NzSceneNode* node) const
+{
+	return m_entryIndices.find(node) != m_entryIndices.end();
+}
+
+bool NzSceneOctree::HasPendingUpdates() const
+{
+	return !m_dirtyEntries.empty();
+}
+
+void NzSceneOctree::Insert(NzSceneNode* node)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!node)
+	{
+		NazaraError("Invalid node");
+		return;
+	}
+	#endif
+
+	auto it = m_entryIndices.find(node);
+	if (it != m_entryIndices.end())
+	{
+		Invalidate(node);
+		return;
+	}
+
+	unsigned int index;
+	if (m_freeEntries.empty())
+	{
+		index = m_entries.size();
+		m_entries.push_back(Entry());
+	}
+	else
+	{
+		index = m_freeEntries.back();
+		m_freeEntries.pop_back();
+	}
+
+	// Le volume englobant ne sera lu qu'au prochain Update (le noeud peut être en cours de construction)
+	Entry& entry = m_entries[index];
+	entry.cell = NoCell;
+	entry.dirty = true;
+	entry.mask = 0;
+	entry.node = node;
+
+	m_dirtyEntries.push_back(index);
+	m_entryIndices[node] = index;
+}
+
+void NzSceneOctree::Invalidate(NzSceneNode* node)
+{
+	auto it = m_entryIndices.find(node);
+	if (it == m_entryIndices.end())
+		return;
+
+	Entry& entry = m_entries[it->second];
+	if (!entry.dirty)
+	{
+		entry.dirty = true;
+		m_dirtyEntries.push_back(it->second);
+	}
+}
+
+unsigned int NzSceneOctree::QueryBox(const NzBoxf& box, NzSceneNode** results, unsigned int maxResults, nzUInt32 mask) const
+{
+	unsigned int count = 0;
+	auto entryFunc = [&](const Entry& entry)
+	{
+		if ((entry.mask & mask) && Overlap(entry.aabb, box))
+		{
+			if (count < maxResults)
+				results[count] = entry.node;
+
+			count++;
+		}
+	};
+
+	Traverse(0, [&box](const NzBoxf& looseBounds) { return Overlap(looseBounds, box); }, entryFunc);
+
+	return count;
+}
+
+unsigned int NzSceneOctree::QueryRay(const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzSceneQueryHit* hits, unsigned int maxHits, nzUInt32 mask) const
+{
+	float length = direction.GetLength();
+
+	#if NAZARA_GRAPHICS_SAFE
+	if (length < std::numeric_limits<float>::epsilon())
+	{
+		NazaraError("Invalid direction");
+		return 0;
+	}
+	#endif
+
+	NzVector3f invDirection(length/direction.x, length/direction.y, length/direction.z);
+
+	// Les hits écrits sont les plus proches, triés par distance (tri par insertion, maxHits restant petit en pratique)
+	unsigned int count = 0;
+	auto addHit = [&](NzSceneNode* node, float distance)
+	{
+		unsigned int written = std::min(count, maxHits);
+		count++;
+
+		if (written == maxHits && (maxHits == 0 || hits[maxHits-1].distance <= distance))
+			return;
+
+		unsigned int pos = (written < maxHits) ? written : maxHits-1;
+		while (pos > 0 && hits[pos-1].distance > distance)
+		{
+			hits[pos] = hits[pos-1];
+			pos--;
+		}
+
+		hits[pos].distance = distance;
+		hits[pos].node = node;
+	};
+
+	Traverse(0, [&](const NzBoxf& looseBounds)
+	{
+		return RayIntersect(origin, invDirection, maxDistance, looseBounds, nullptr);
+	},
+	[&](const Entry& entry)
+	{
+		float distance;
+		if ((entry.mask & mask) && RayIntersect(origin, invDirection, maxDistance, entry.aabb, &distance))
+			addHit(entry.node, distance);
+	});
+
+	return count;
+}
+
+unsigned int NzSceneOctree::QuerySphere(const NzSpheref& sphere, NzSceneNode** results, unsigned int maxResults, nzUInt32 mask) const
+{
+	NzVector3f center = sphere.GetPosition();
+	float squaredRadius = sphere.radius*sphere.radius;
+
+	unsigned int count = 0;
+	Traverse(0, [&](const NzBoxf& looseBounds)
+	{
+		return SquaredDistance(center, looseBounds) <= squaredRadius;
+	},
+	[&](const Entry& entry)
+	{
+		if ((entry.mask & mask) && SquaredDistance(center, entry.aabb) <= squaredRadius)
+		{
+			if (count < maxResults)
+				results[count] = entry.node;
+
+			count++;
+		}
+	});
+
+	return count;
+}
+
+void NzSceneOctree::Remove(NzSceneNode* node)
+{
+	auto it = m_entryIndices.find(node);
+	if (it == m_entryIndices.end())
+		return;
+
+	unsigned int index = it->second;
+	m_entryIndices.erase(it);
+
+	RemoveEntry(index);
+
+	// L'index peut rester dans la liste des entrées invalidées, il y sera ignoré
+	Entry& entry = m_entries[index];
+	entry.dirty = false;
+	entry.node = nullptr;
+
+	m_freeEntries.push_back(index);
+}
+
+void NzSceneOctree::Update()
+{
+	for (unsigned int i = 0; i < m_dirtyEntries.size(); ++i)
+	{
+		unsigned int index = m_dirtyEntries[i];
+
+		Entry& entry = m_entries[index];
+		if (!entry.dirty || !entry.node)
+			continue;
+
+		entry.dirty = false;
+		entry.mask = entry.node->GetQueryMask();
+
+		nzExtend extend = nzExtend_Null;
+		if (entry.node->IsDrawable())
+		{
+			const NzBoundingVolumef& volume = entry.node->GetBoundingVolume();
+			extend = volume.extend;
+			if (extend == nzExtend_Finite)
+				entry.aabb = volume.aabb;
+		}
+
+		switch (extend)
+		{
+			case nzExtend_Finite:
+				// Un noeud qui tient toujours dans sa cellule n'en bouge pas
+				if (entry.cell < InfiniteCell && Fits(m_cells[entry.cell], entry.aabb))
+					break;
+
+				RemoveEntry(index);
+				if (!Fits(m_cells[0], entry.aabb))
+					Grow(entry.aabb);
+
+				InsertEntry(index);
+				break;
+
+			case nzExtend_Infinite:
+				if (entry.cell != InfiniteCell)
+				{
+					RemoveEntry(index);
+
+					entry.cell = InfiniteCell;
+					entry.slot = m_infiniteEntries.size();
+					m_infiniteEntries.push_back(index);
+				}
+				break;
+
+			case nzExtend_Null:
+				RemoveEntry(index);
+				break;
+		}
+	}
+
+	m_dirtyEntries.clear();
+}
+
+bool NzSceneOctree::Fits(const Cell& cell, const NzBoxf& aabb) const
+{
+	NzVector3f center = aabb.GetCenter();
+
+	return GetHalfExtent(aabb) <= cell.halfSize &&
+	       std::abs(center.x - cell.center.x) <= cell.halfSize &&
+	       std::abs(center.y - cell.center.y) <= cell.halfSize &&
+	       std::abs(center.z - cell.center.z) <= cell.halfSize;
+}
+
+void NzSceneOctree::Grow(const NzBoxf& aabb)
+{
+	float halfSize = m_cells[0].halfSize;
+	do
+	{
+		halfSize *= 2.f;
+		if (m_maxDepth < maxGrowthDepth)
+			m_maxDepth++; // On garde la même taille de cellule au niveau le plus fin
+	}
+	while (GetHalfExtent(aabb) > halfSize ||
+	       std::abs(aabb.GetCenter().x) > halfSize ||
+	       std::abs(aabb.GetCenter().y) > halfSize ||
+	       std::abs(aabb.GetCenter().z) > halfSize);
+
+	// Reconstruction complète, rare (la taille double à chaque fois)
+	m_cells.clear();
+
+	Cell root;
+	root.center = NzVector3f::Zero();
+	root.children = 0;
+	root.depth = 0;
+	root.halfSize = halfSize;
+	root.parent = NoCell;
+	root.subtreeCount = 0;
+
+	m_cells.push_back(std::move(root));
+
+	for (unsigned int i = 0; i < m_entries.size(); ++i)
+	{
+		Entry& entry = m_entries[i];
+		if (entry.node && entry.cell < InfiniteCell)
+		{
+			entry.cell = NoCell;
+			InsertEntry(i);
+		}
+	}
+}
+
+void NzSceneOctree::InsertEntry(unsigned int entryIndex)
+{
+	Entry& entry = m_entries[entryIndex];
+
+	NzVector3f center = entry.aabb.GetCenter();
+	float halfExtent = GetHalfExtent(entry.aabb);
+
+	// Descente tant que l'objet tient dans la version lâche d'un fils (demi-taille du fils doublée)
+	unsigned int cellIndex = 0;
+	while (m_cells[cellIndex].children != 0 && halfExtent <= m_cells[cellIndex].halfSize*0.5f)
+	{
+		const Cell& cell = m_cells[cellIndex];
+
+		unsigned int childIndex = 0;
+		if (center.x >= cell.center.x)
+			childIndex |= 1;
+
+		if (center.y >= cell.center.y)
+			childIndex |= 2;
+
+		if (center.z >= cell.center.z)
+			childIndex |= 4;
+
+		cellIndex = cell.children + childIndex;
+	}
+
+	Cell& cell = m_cells[cellIndex];
+	entry.cell = cellIndex;
+	entry.slot = cell.entries.size();
+	cell.entries.push_back(entryIndex);
+
+	for (unsigned int i = cellIndex; i != NoCell; i = m_cells[i].parent)
+		m_cells[i].subtreeCount++;
+
+	if (m_cells[cellIndex].children == 0 && m_cells[cellIndex].depth < m_maxDepth && m_cells[cellIndex].entries.size() > splitThreshold)
+		Split(cellIndex);
+}
+
+void NzSceneOctree::RemoveEntry(unsigned int entryIndex)
+{
+	Entry& entry = m_entries[entryIndex];
+	if (entry.cell == NoCell)
+		return;
+
+	std::vector<unsigned int>& entries = (entry.cell == InfiniteCell) ? m_infiniteEntries : m_cells[entry.cell].entries;
+
+	unsigned int last = entries.back();
+	entries[entry.slot] = last;
+	m_entries[last].slot = entry.slot;
+	entries.pop_back();
+
+	if (entry.cell != InfiniteCell)
+	{
+		// Les cellules vidées restent allouées, elles sont simplement ignorées par les parcours
+		for (unsigned int i = entry.cell; i != NoCell; i = m_cells[i].parent)
+			m_cells[i].subtreeCount--;
+	}
+
+	entry.cell = NoCell;
+}
+
+void NzSceneOctree::Split(unsigned int cellIndex)
+{
+	unsigned int firstChild = m_cells.size();
+
+	Cell child;
+	child.children = 0;
+	child.depth = m_cells[cellIndex].depth + 1;
+	child.halfSize = m_cells[cellIndex].halfSize*0.5f;
+	child.parent = cellIndex;
+	child.subtreeCount = 0;
+
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		child.center = m_cells[cellIndex].center;
+		child.center.x += (i & 1) ? child.halfSize : -child.halfSize;
+		child.center.y += (i & 2) ? child.halfSize : -child.halfSize;
+		child.center.z += (i & 4) ? child.halfSize : -child.halfSize;
+
+		m_cells.push_back(child);
+	}
+
+	m_cells[cellIndex].children = firstChild;
+
+	// Les entrées assez petites descendent dans les fils (qui peuvent à leur tour se subdiviser)
+	std::vector<unsigned int> entries(m_cells[cellIndex].entries);
+	float childHalfSize = child.halfSize;
+	for (unsigned int entryIndex : entries)
+	{
+		if (GetHalfExtent(m_entries[entryIndex].aabb) <= childHalfSize)
+		{
+			RemoveEntry(entryIndex);
+			InsertEntry(entryIndex);
+		}
+	}
+}
+
+template<typename CellTest, typename EntryFunc>
+void NzSceneOctree::Traverse(unsigned int cellIndex, const CellTest& cellTest, const EntryFunc& entryFunc) const
+{
+	const Cell& cell = m_cells[cellIndex];
+	if (cell.subtreeCount == 0)
+		return;
+
+	float looseSize = cell.halfSize*2.f;
+	NzBoxf looseBounds(cell.center.x - looseSize, cell.center.y - looseSize, cell.center.z - looseSize, looseSize*2.f, looseSize*2.f, looseSize*2.f);
+	if (!cellTest(looseBounds))
+		return;
+
+	for (unsigned int index : cell.entries)
+		entryFunc(m_entries[index]);
+
+	if (cell.children != 0)
+	{
+		for (unsigned int i = 0; i < 8; ++i)
+			Traverse(cell.children + i, cellTest, entryFunc);
+	}
+}
@@ -0,0 +1,471 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/ShadowCascades.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <Nazara/Graphics/AbstractViewer.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <Nazara/Graphics/Light.hpp>
+#include <Nazara/Graphics/SceneNode.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <Nazara/Graphics/Debug.hpp>
+
+NzShadowCascades::NzShadowCascades(unsigned int cascadeCount, unsigned int resolution) :
+m_lightDirection(NzVector3f::Forward()),
+m_lightRight(NzVector3f::Right()),
+m_lightUp(NzVector3f::Up()),
+m_parallelCulling(true),
+m_shadowDistance(0.f),
+m_splitLambda(0.75f),
+m_resolution(resolution)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (m_resolution == 0)
+	{
+		NazaraError("Resolution must be over 0, using default");
+		m_resolution = 2048;
+	}
+	#endif
+
+	SetCascadeCount(cascadeCount);
+}
+
+NzShadowCascades::~NzShadowCascades() = default;
+
+void NzShadowCascades::Clear()
+{
+	///DOC: Les files de rendu sont vidées entièrement (ressources comprises)
+	m_candidates.clear();
+
+	for (Cascade& cascade : m_cascades)
+	{
+		cascade.casters.clear();
+		cascade.casterDepth = 0.f;
+		cascade.renderQueue->Clear(true);
+	}
+}
+
+void NzShadowCascades::ComputeCascades(const NzAbstractViewer* viewer, const NzLight* light)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!light)
+	{
+		NazaraError("Invalid light");
+		return;
+	}
+
+	if (light->GetLightType() != nzLightType_Directional)
+	{
+		NazaraError("Only directional lights are supported");
+		return;
+	}
+	#endif
+
+	ComputeCascades(viewer, light->GetForward());
+}
+
+void NzShadowCascades::ComputeCascades(const NzAbstractViewer* viewer, const NzVector3f& lightDirection)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!viewer)
+	{
+		NazaraError("Invalid viewer");
+		return;
+	}
+	#endif
+
+	// Repère de la lumière, ne dépendant que de sa direction (et non de l'observateur) pour rester stable
+	m_lightDirection = NzVector3f::Normalize(lightDirection);
+
+	NzVector3f up = (std::abs(m_lightDirection.DotProduct(NzVector3f::Up())) > 0.99f) ? NzVector3f::Forward() : NzVector3f::Up();
+	m_lightRight = NzVector3f::Normalize(m_lightDirection.CrossProduct(up));
+	m_lightUp = m_lightRight.CrossProduct(m_lightDirection);
+
+	const NzFrustumf& frustum = viewer->GetFrustum();
+	float zNear = viewer->GetZNear();
+	float zFar = viewer->GetZFar();
+	float shadowDistance = (m_shadowDistance > 0.f) ? std::min(m_shadowDistance, zFar) : zFar;
+
+	NzVector3f nearCorners[4] =
+	{
+		frustum.GetCorner(nzCorner_NearLeftBottom),
+		frustum.GetCorner(nzCorner_NearLeftTop),
+		frustum.GetCorner(nzCorner_NearRightBottom),
+		frustum.GetCorner(nzCorner_NearRightTop)
+	};
+
+	NzVector3f farCorners[4] =
+	{
+		frustum.GetCorner(nzCorner_FarLeftBottom),
+		frustum.GetCorner(nzCorner_FarLeftTop),
+		frustum.GetCorner(nzCorner_FarRightBottom),
+		frustum.GetCorner(nzCorner_FarRightTop)
+	};
+
+	unsigned int cascadeCount = m_cascades.size();
+	for (unsigned int i = 0; i < cascadeCount; ++i)
+	{
+		Cascade& cascade = m_cascades[i];
+		NzShadowCascade& data = cascade.cascade;
+
+		// Découpage pratique : mélange d'une répartition logarithmique et uniforme
+		float splits[2];
+		for (unsigned int j = 0; j < 2; ++j)
+		{
+			float ratio = static_cast<float>(i + j)/cascadeCount;
+			float logSplit = zNear * std::pow(shadowDistance/zNear, ratio);
+			float uniformSplit = zNear + (shadowDistance - zNear)*ratio;
+
+			splits[j] = m_splitLambda*logSplit + (1.f - m_splitLambda)*uniformSplit;
+		}
+
+		data.splitNear = splits[0];
+		data.splitFar = splits[1];
+
+		// Les coins de la tranche se trouvent sur les arêtes du frustum, la profondeur y variant linéairement
+		NzVector3f corners[8];
+		float nearFactor = (data.splitNear - zNear)/(zFar - zNear);
+		float farFactor = (data.splitFar - zNear)/(zFar - zNear);
+		for (unsigned int j = 0; j < 4; ++j)
+		{
+			NzVector3f edge = farCorners[j] - nearCorners[j];
+			corners[j] = nearCorners[j] + edge*nearFactor;
+			corners[j+4] = nearCorners[j] + edge*farFactor;
+		}
+
+		NzVector3f center = NzVector3f::Zero();
+		for (const NzVector3f& corner : corners)
+			center += corner;
+
+		center /= 8.f;
+
+		// Une sphère plutôt qu'une boîte : son rayon ne dépend pas de l'orientation de l'observateur,
+		// et est arrondi pour éviter que les imprécisions ne changent la taille des texels d'une image à l'autre
+		float radius = 0.f;
+		for (const NzVector3f& corner : corners)
+			radius = std::max(radius, center.SquaredDistance(corner));
+
+		radius = std::ceil(std::sqrt(radius)*16.f)/16.f;
+
+		// Alignement du centre sur la grille des texels, dans le plan perpendiculaire à la lumière
+		float texelSize = 2.f*radius/m_resolution;
+
+		float x = center.DotProduct(m_lightRight);
+		float y = center.DotProduct(m_lightUp);
+		center += m_lightRight*(std::floor(x/texelSize)*texelSize - x);
+		center += m_lightUp*(std::floor(y/texelSize)*texelSize - y);
+
+		data.center = center;
+		data.radius = radius;
+		data.texelSize = texelSize;
+
+		cascade.casterDepth = 0.f;
+		UpdateMatrices(cascade);
+	}
+}
+
+void NzShadowCascades::CullCasters(const NzNode& root)
+{
+	///DOC: Les cascades doivent avoir été calculées au préalable,
+	///     leur plan proche est ensuite reculé jusqu'au projeteur le plus éloigné
+	m_candidates.clear();
+	CollectCandidates(&root);
+
+	unsigned int cascadeCount = m_cascades.size();
+	unsigned int candidateCount = m_candidates.size();
+
+	// Le parcours de la scène n'est fait qu'une fois, chaque candidat est ensuite testé contre toutes les cascades
+	std::vector<CullResult> results;
+
+	if (m_parallelCulling && candidateCount > 1 && NzTaskScheduler::Initialize() && NzTaskScheduler::GetWorkerCount() > 1)
+	{
+		unsigned int workerCount = std::min(NzTaskScheduler::GetWorkerCount(), candidateCount);
+		results.resize(workerCount);
+
+		// Les tâches sont attendues avant de retourner, les pointeurs restent donc valides
+		std::div_t div = std::div(static_cast<int>(candidateCount), static_cast<int>(workerCount));
+		for (unsigned int i = 0; i < workerCount; ++i)
+		{
+			CullResult* result = &results[i];
+			unsigned int first = i*div.quot;
+			unsigned int count = (i == workerCount-1) ? div.quot + div.rem : div.quot;
+
+			NzTaskScheduler::AddTask([this, first, count, result]() { CullRange(first, count, result); });
+		}
+
+		NzTaskScheduler::WaitForTasks();
+	}
+	else
+	{
+		results.resize(1);
+		CullRange(0, candidateCount, &results[0]);
+	}
+
+	for (unsigned int i = 0; i < cascadeCount; ++i)
+	{
+		Cascade& cascade = m_cascades[i];
+		cascade.casters.clear();
+		cascade.casterDepth = 0.f;
+
+		// Les résultats sont fusionnés dans l'ordre des plages, l'ordre des projeteurs ne dépend donc pas du parallélisme
+		for (CullResult& result : results)
+		{
+			cascade.casters.insert(cascade.casters.end(), result.casters[i].begin(), result.casters[i].end());
+			cascade.casterDepth = std::min(cascade.casterDepth, result.casterDepths[i]);
+		}
+
+		UpdateMatrices(cascade);
+	}
+
+	// Construction des files de rendu, une tâche par cascade (chaque file n'est touchée que par un thread)
+	auto fillQueue = [this](unsigned int i)
+	{
+		Cascade& cascade = m_cascades[i];
+
+		NzForwardRenderQueue* renderQueue = cascade.renderQueue.get();
+		renderQueue->Clear(false);
+
+		for (const NzSceneNode* caster : cascade.casters)
+			caster->AddToRenderQueue(renderQueue);
+	};
+
+	if (m_parallelCulling && cascadeCount > 1 && NzTaskScheduler::GetWorkerCount() > 1)
+	{
+		for (unsigned int i = 0; i < cascadeCount; ++i)
+			NzTaskScheduler::AddTask([fillQueue, i]() { fillQueue(i); });
+
+		NzTaskScheduler::WaitForTasks();
+	}
+	else
+	{
+		for (unsigned int i = 0; i < cascadeCount; ++i)
+			fillQueue(i);
+	}
+}
+
+void NzShadowCascades::EnableParallelCulling(bool parallel)
+{
+	m_parallelCulling = parallel;
+}
+
+unsigned int NzShadowCascades::GetCandidateCount() const
+{
+	return m_candidates.size();
+}
+
+const NzShadowCascade& NzShadowCascades::GetCascade(unsigned int cascade) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (cascade >= m_cascades.size())
+	{
+		NazaraError("Cascade index out of range (" + NzString::Number(cascade) + " >= " + NzString::Number(m_cascades.size()) + ')');
+
+		static NzShadowCascade dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_cascades[cascade].cascade;
+}
+
+unsigned int NzShadowCascades::GetCascadeCount() const
+{
+	return m_cascades.size();
+}
+
+const std::vector<const NzSceneNode*>& NzShadowCascades::GetCasters(unsigned int cascade) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (cascade >= m_cascades.size())
+	{
+		NazaraError("Cascade index out of range (" + NzString::Number(cascade) + " >= " + NzString::Number(m_cascades.size()) + ')');
+
+		static std::vector<const NzSceneNode*> dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_cascades[cascade].casters;
+}
+
+NzForwardRenderQueue* NzShadowCascades::GetRenderQueue(unsigned int cascade) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (cascade >= m_cascades.size())
+	{
+		NazaraError("Cascade index out of range (" + NzString::Number(cascade) + " >= " + NzString::Number(m_cascades.size()) + ')');
+		return nullptr;
+	}
+	#endif
+
+	return m_cascades[cascade].renderQueue.get();
+}
+
+unsigned int NzShadowCascades::GetResolution() const
+{
+	return m_resolution;
+}
+
+float NzShadowCascades::GetShadowDistance() const
+{
+	return m_shadowDistance;
+}
+
+float NzShadowCascades::GetSplitLambda() const
+{
+	return m_splitLambda;
+}
+
+bool NzShadowCascades::IsParallelCullingEnabled() const
+{
+	return m_parallelCulling;
+}
+
+void NzShadowCascades::SetCascadeCount(unsigned int cascadeCount)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (cascadeCount == 0)
+	{
+		NazaraError("Cascade count must be over 0");
+		return;
+	}
+	#endif
+
+	unsigned int oldCount = m_cascades.size();
+	m_cascades.resize(cascadeCount);
+
+	for (unsigned int i = oldCount; i < cascadeCount; ++i)
+	{
+		Cascade& cascade = m_cascades[i];
+		cascade.casterDepth = 0.f;
+		cascade.renderQueue.reset(new NzForwardRenderQueue);
+	}
+}
+
+void NzShadowCascades::SetResolution(unsigned int resolution)
+{
+	///DOC: Prend effet au prochain appel à ComputeCascades
+	#if NAZARA_GRAPHICS_SAFE
+	if (resolution == 0)
+	{
+		NazaraError("Resolution must be over 0");
+		return;
+	}
+	#endif
+
+	m_resolution = resolution;
+}
+
+void NzShadowCascades::SetShadowDistance(float distance)
+{
+	///DOC: Une distance nulle utilise le plan éloigné de l'observateur
+	m_shadowDistance = distance;
+}
+
+void NzShadowCascades::SetSplitLambda(float lambda)
+{
+	///DOC: 0 pour un découpage uniforme, 1 pour un découpage logarithmique
+	#if NAZARA_GRAPHICS_SAFE
+	if (lambda < 0.f || lambda > 1.f)
+	{
+		NazaraError("Lambda must be between 0 and 1");
+		return;
+	}
+	#endif
+
+	m_splitLambda = lambda;
+}
+
+void NzShadowCascades::CollectCandidates(const NzNode* node)
+{
+	// Les caches (matrices, volumes englobants) sont mis à jour ici, avant que les tâches ne lisent les nodes
+	for (const NzNode* child : node->GetChilds())
+	{
+		if (child->GetNodeType() == nzNodeType_Scene)
+		{
+			const NzSceneNode* sceneNode = static_cast<const NzSceneNode*>(child);
+			if (sceneNode->GetSceneNodeType() != nzSceneNodeType_Light && sceneNode->IsDrawingEnabled() && sceneNode->IsDrawable())
+			{
+				const NzBoundingVolumef& volume = sceneNode->GetBoundingVolume();
+				if (volume.IsFinite())
+				{
+					sceneNode->EnsureTransformMatrixUpdate();
+
+					Candidate candidate;
+					candidate.aabb = volume.aabb;
+					candidate.node = sceneNode;
+
+					m_candidates.push_back(candidate);
+				}
+			}
+		}
+
+		if (child->HasChilds())
+			CollectCandidates(child);
+	}
+}
+
+void NzShadowCascades::CullRange(unsigned int first, unsigned int count, CullResult* result) const
+{
+	unsigned int cascadeCount = m_cascades.size();
+
+	result->casters.resize(cascadeCount);
+	result->casterDepths.assign(cascadeCount, 0.f);
+
+	// Centres des cascades dans le repère de la lumière
+	std::vector<NzVector3f> centers(cascadeCount);
+	for (unsigned int i = 0; i < cascadeCount; ++i)
+	{
+		const NzVector3f& center = m_cascades[i].cascade.center;
+		centers[i].Set(center.DotProduct(m_lightRight), center.DotProduct(m_lightUp), center.DotProduct(m_lightDirection));
+	}
+
+	for (unsigned int i = first; i < first + count; ++i)
+	{
+		const Candidate& candidate = m_candidates[i];
+
+		// Passage de l'AABB dans le repère de la lumière (centre projeté, demi-dimensions projetées en valeur absolue)
+		NzVector3f center = candidate.aabb.GetCenter();
+		NzVector3f extent = candidate.aabb.GetLengths()*0.5f;
+
+		NzVector3f lightCenter(center.DotProduct(m_lightRight), center.DotProduct(m_lightUp), center.DotProduct(m_lightDirection));
+		NzVector3f lightExtent(std::abs(m_lightRight.x)*extent.x + std::abs(m_lightRight.y)*extent.y + std::abs(m_lightRight.z)*extent.z,
+		                       std::abs(m_lightUp.x)*extent.x + std::abs(m_lightUp.y)*extent.y + std::abs(m_lightUp.z)*extent.z,
+		                       std::abs(m_lightDirection.x)*extent.x + std::abs(m_lightDirection.y)*extent.y + std::abs(m_lightDirection.z)*extent.z);
+
+		for (unsigned int j = 0; j < cascadeCount; ++j)
+		{
+			float radius = m_cascades[j].cascade.radius;
+			const NzVector3f& cascadeCenter = centers[j];
+
+			// Volume étiré à l'infini dans la direction de la lumière : seul le début du projeteur doit précéder la fin de la cascade
+			if (std::abs(lightCenter.x - cascadeCenter.x) > radius + lightExtent.x ||
+			    std::abs(lightCenter.y - cascadeCenter.y) > radius + lightExtent.y ||
+			    lightCenter.z - lightExtent.z > cascadeCenter.z + radius)
+				continue;
+
+			result->casters[j].push_back(candidate.node);
+			result->casterDepths[j] = std::min(result->casterDepths[j], lightCenter.z - lightExtent.z - cascadeCenter.z);
+		}
+	}
+}
+
+void NzShadowCascades::UpdateMatrices(Cascade& cascade) const
+{
+	NzShadowCascade& data = cascade.cascade;
+
+	// Le plan proche est reculé jusqu'au projeteur le plus éloigné, le plan éloigné couvre la sphère de la tranche
+	float zNear = std::min(-data.radius, cascade.casterDepth);
+	float zFar = data.radius;
+
+	data.viewMatrix.MakeLookAt(data.center, data.center + m_lightDirection, m_lightUp);
+	data.projectionMatrix.MakeOrtho(-data.radius, data.radius, data.radius, -data.radius, zNear, zFar);
+
+	data.viewProjMatrix = data.viewMatrix;
+	data.viewProjMatrix.Concatenate(data.projectionMatrix);
+}
@@ -110,6 +110,7 @@ void NzSprite::SetSize(const NzVector2f& size)
 	m_size = size;
 	m_boundingVolume.MakeNull();
 	m_boundingVolumeUpdated = false;
+	NotifyBoundingVolumeChange();
 }
 
 void NzSprite::SetTexture(NzTexture* texture, bool resizeSprite)
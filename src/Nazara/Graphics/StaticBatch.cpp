@@ -0,0 +1,521 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/StaticBatch.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Graphics/AbstractRenderQueue.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <Nazara/Graphics/Model.hpp>
+#include <Nazara/Utility/BufferMapper.hpp>
+#include <Nazara/Utility/IndexMapper.hpp>
+#include <Nazara/Utility/StaticMesh.hpp>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+#include <Nazara/Graphics/Debug.hpp>
+
+namespace
+{
+	struct BatchSource
+	{
+		const NzStaticMesh* subMesh;
+		NzMatrix4f matrix;
+	};
+
+	void CollectStaticModels(NzNode* node, std::vector<NzModel*>* models)
+	{
+		if (node->GetNodeType() == nzNodeType_Scene && static_cast<NzSceneNode*>(node)->GetSceneNodeType() == nzSceneNodeType_Model)
+		{
+			NzModel* model = static_cast<NzModel*>(node);
+			if (model->IsStatic())
+				models->push_back(model);
+		}
+
+		for (NzNode* child : node->GetChilds())
+			CollectStaticModels(child, models);
+	}
+
+	bool IsBatchable(const NzModel* model)
+	{
+		NzMesh* mesh = model->GetMesh();
+		if (!mesh || mesh->GetAnimationType() != nzAnimationType_Static)
+			return false;
+
+		// Un modèle n'est absorbé que si l'intégralité de ses sous-meshs peut l'être
+		const NzVertexDeclaration* declaration = NzVertexDeclaration::Get(nzVertexLayout_XYZ_Normal_UV_Tangent);
+
+		unsigned int subMeshCount = mesh->GetSubMeshCount();
+		for (unsigned int i = 0; i < subMeshCount; ++i)
+		{
+			const NzStaticMesh* subMesh = static_cast<const NzStaticMesh*>(mesh->GetSubMesh(i));
+			if (!subMesh->IsValid() || subMesh->GetPrimitiveMode() != nzPrimitiveMode_TriangleList)
+				return false;
+
+			if (subMesh->GetVertexBuffer()->GetVertexDeclaration() != declaration)
+				return false;
+		}
+
+		return subMeshCount > 0;
+	}
+}
+
+NzStaticBatch::NzStaticBatch(float chunkSize) :
+m_boundingVolume(NzBoundingVolumef::Null()),
+m_chunkSize(chunkSize)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (m_chunkSize <= 0.f)
+	{
+		NazaraError("Chunk size must be positive, using default");
+		m_chunkSize = 64.f;
+	}
+	#endif
+
+	m_stats = NzStaticBatchStats();
+}
+
+NzStaticBatch::~NzStaticBatch()
+{
+	Clear();
+}
+
+void NzStaticBatch::AddToRenderQueue(NzAbstractRenderQueue* renderQueue) const
+{
+	// Les sommets sont déjà dans le repère global, la transformation du node est ignorée
+	static const NzMatrix4f identity(NzMatrix4f::Identity());
+
+	for (const Chunk& chunk : m_chunks)
+	{
+		if (!chunk.visible)
+			continue;
+
+		for (unsigned int batchIndex : chunk.batches)
+		{
+			const Batch& batch = m_batches[batchIndex];
+			renderQueue->AddSubMesh(batch.material, batch.subMesh, identity);
+		}
+	}
+}
+
+bool NzStaticBatch::Build(NzNode* root, nzBufferStorage storage, bool disableSources)
+{
+	///DOC: Les modèles statiques (voir NzModel::SetStatic) de la hiérarchie sont fusionnés,
+	///     leur transformation au moment de l'appel est appliquée définitivement aux sommets
+	#if NAZARA_GRAPHICS_SAFE
+	if (!root)
+	{
+		NazaraError("Invalid root node");
+		return false;
+	}
+	#endif
+
+	Clear();
+
+	std::vector<NzModel*> models;
+	CollectStaticModels(root, &models);
+
+	// Première passe : répartition des sous-meshs par chunk (selon le centre de leur AABB globale) et par matériau
+	std::map<NzVector3i, unsigned int> chunkIndices;
+	std::map<std::pair<unsigned int, const NzMaterial*>, unsigned int> batchIndices;
+	std::vector<std::vector<BatchSource>> sources;
+
+	for (NzModel* model : models)
+	{
+		if (!IsBatchable(model))
+			continue;
+
+		const NzMatrix4f& matrix = model->GetTransformMatrix();
+
+		NzMesh* mesh = model->GetMesh();
+		unsigned int subMeshCount = mesh->GetSubMeshCount();
+		for (unsigned int i = 0; i < subMeshCount; ++i)
+		{
+			const NzStaticMesh* subMesh = static_cast<const NzStaticMesh*>(mesh->GetSubMesh(i));
+			const NzMaterial* material = model->GetMaterial(subMesh->GetMaterialIndex());
+
+			NzBoxf aabb(subMesh->GetAABB());
+			aabb.Transform(matrix);
+
+			NzVector3f center = aabb.GetCenter();
+			NzVector3i cell(static_cast<int>(std::floor(center.x/m_chunkSize)),
+			                static_cast<int>(std::floor(center.y/m_chunkSize)),
+			                static_cast<int>(std::floor(center.z/m_chunkSize)));
+
+			unsigned int chunkIndex;
+			auto chunkIt = chunkIndices.find(cell);
+			if (chunkIt == chunkIndices.end())
+			{
+				chunkIndex = m_chunks.size();
+				chunkIndices.insert(std::make_pair(cell, chunkIndex));
+
+				Chunk chunk;
+				chunk.visible = true;
+
+				m_chunks.push_back(std::move(chunk));
+			}
+			else
+				chunkIndex = chunkIt->second;
+
+			unsigned int batchIndex;
+			auto key = std::make_pair(chunkIndex, material);
+			auto batchIt = batchIndices.find(key);
+			if (batchIt == batchIndices.end())
+			{
+				batchIndex = m_batches.size();
+				batchIndices.insert(std::make_pair(key, batchIndex));
+
+				Batch batch;
+				batch.chunk = chunkIndex;
+				batch.material = material;
+				batch.subMesh = nullptr;
+
+				m_batches.push_back(std::move(batch));
+				m_chunks[chunkIndex].batches.push_back(batchIndex);
+				sources.emplace_back();
+			}
+			else
+				batchIndex = batchIt->second;
+
+			sources[batchIndex].push_back(BatchSource{subMesh, matrix});
+			m_stats.sourceSubMeshCount++;
+		}
+
+		m_sourceModels.push_back(model);
+	}
+
+	if (m_batches.empty())
+		return true;
+
+	m_mesh.CreateStatic();
+
+	// Seconde passe : fusion des sommets (transformés) et des indices (décalés) de chaque lot
+	const NzVertexDeclaration* declaration = NzVertexDeclaration::Get(nzVertexLayout_XYZ_Normal_UV_Tangent);
+
+	NzBoxf globalAABB;
+	for (unsigned int batchIndex = 0; batchIndex < m_batches.size(); ++batchIndex)
+	{
+		Batch& batch = m_batches[batchIndex];
+
+		unsigned int indexCount = 0;
+		unsigned int vertexCount = 0;
+		for (const BatchSource& source : sources[batchIndex])
+		{
+			const NzIndexBuffer* indexBuffer = source.subMesh->GetIndexBuffer();
+			unsigned int sourceVertexCount = source.subMesh->GetVertexCount();
+
+			indexCount += (indexBuffer) ? indexBuffer->GetIndexCount() : sourceVertexCount;
+			vertexCount += sourceVertexCount;
+		}
+
+		std::unique_ptr<NzIndexBuffer> indexBuffer(new NzIndexBuffer(vertexCount > std::numeric_limits<nzUInt16>::max(), indexCount, storage, nzBufferUsage_Static));
+		indexBuffer->SetPersistent(false);
+
+		std::unique_ptr<NzVertexBuffer> vertexBuffer(new NzVertexBuffer(declaration, vertexCount, storage, nzBufferUsage_Static));
+		vertexBuffer->SetPersistent(false);
+
+		{
+			NzBufferMapper<NzVertexBuffer> vertexMapper(vertexBuffer.get(), nzBufferAccess_WriteOnly);
+			NzMeshVertex* vertices = static_cast<NzMeshVertex*>(vertexMapper.GetPointer());
+
+			NzIndexMapper indexMapper(indexBuffer.get(), nzBufferAccess_WriteOnly);
+
+			unsigned int firstVertex = 0;
+			unsigned int index = 0;
+			for (const BatchSource& source : sources[batchIndex])
+			{
+				const NzMatrix4f& matrix = source.matrix;
+
+				// Les normales suivent la transposée de l'inverse (pour rester correctes avec une mise à l'échelle non-uniforme)
+				NzMatrix4f normalMatrix;
+				if (matrix.GetInverseAffine(&normalMatrix))
+					normalMatrix.Transpose();
+				else
+					normalMatrix = matrix;
+
+				// Une transformation miroir inverse le sens des triangles
+				bool flipWinding = (matrix.GetDeterminantAffine() < 0.f);
+
+				const NzVertexBuffer* sourceVertexBuffer = source.subMesh->GetVertexBuffer();
+				unsigned int sourceVertexCount = sourceVertexBuffer->GetVertexCount();
+
+				NzBufferMapper<NzVertexBuffer> sourceMapper(sourceVertexBuffer, nzBufferAccess_ReadOnly);
+				const NzMeshVertex* sourceVertices = static_cast<const NzMeshVertex*>(sourceMapper.GetPointer());
+
+				for (unsigned int i = 0; i < sourceVertexCount; ++i)
+				{
+					const NzMeshVertex& in = sourceVertices[i];
+					NzMeshVertex& out = vertices[firstVertex + i];
+
+					out.position = matrix.Transform(in.position);
+					out.normal = normalMatrix.Transform(in.normal, 0.f);
+					out.normal.Normalize();
+					out.tangent = matrix.Transform(in.tangent, 0.f);
+					out.tangent.Normalize();
+					out.uv = in.uv;
+
+					if (firstVertex == 0 && i == 0)
+						batch.aabb.Set(out.position, out.position);
+					else
+						batch.aabb.ExtendTo(out.position);
+				}
+
+				const NzIndexBuffer* sourceIndexBuffer = source.subMesh->GetIndexBuffer();
+				if (sourceIndexBuffer)
+				{
+					NzIndexMapper sourceIndices(sourceIndexBuffer);
+
+					unsigned int sourceIndexCount = sourceIndices.GetIndexCount();
+					for (unsigned int i = 0; i+2 < sourceIndexCount; i += 3)
+					{
+						nzUInt32 a = sourceIndices.Get(i);
+						nzUInt32 b = sourceIndices.Get(i+1);
+						nzUInt32 c = sourceIndices.Get(i+2);
+						if (flipWinding)
+							std::swap(b, c);
+
+						indexMapper.Set(index++, firstVertex + a);
+						indexMapper.Set(index++, firstVertex + b);
+						indexMapper.Set(index++, firstVertex + c);
+					}
+				}
+				else
+				{
+					for (unsigned int i = 0; i+2 < sourceVertexCount; i += 3)
+					{
+						indexMapper.Set(index++, firstVertex + i);
+						indexMapper.Set(index++, firstVertex + ((flipWinding) ? i+2 : i+1));
+						indexMapper.Set(index++, firstVertex + ((flipWinding) ? i+1 : i+2));
+					}
+				}
+
+				firstVertex += sourceVertexCount;
+			}
+
+			// Les éventuels indices orphelins (triangle incomplet) sont neutralisés
+			while (index < indexCount)
+				indexMapper.Set(index++, 0);
+		}
+
+		std::unique_ptr<NzStaticMesh> subMesh(new NzStaticMesh(&m_mesh));
+		if (!subMesh->Create(vertexBuffer.get()))
+		{
+			NazaraError("Failed to create static mesh");
+			Clear();
+
+			return false;
+		}
+		vertexBuffer.release();
+
+		subMesh->SetIndexBuffer(indexBuffer.get());
+		indexBuffer.release();
+
+		subMesh->SetAABB(batch.aabb);
+		subMesh->SetMaterialIndex(batchIndex);
+		subMesh->SetPersistent(false);
+
+		m_mesh.AddSubMesh(subMesh.get());
+		batch.subMesh = subMesh.release();
+
+		if (batchIndex == 0)
+			globalAABB = batch.aabb;
+		else
+			globalAABB.ExtendTo(batch.aabb);
+
+		m_stats.triangleCount += indexCount/3;
+		m_stats.vertexCount += vertexCount;
+	}
+
+	// L'AABB d'un chunk est calculée sur les sommets réels, et non sur les AABB transformées (plus larges) des sous-meshs
+	for (Chunk& chunk : m_chunks)
+	{
+		chunk.aabb = m_batches[chunk.batches.front()].aabb;
+		for (unsigned int batchIndex : chunk.batches)
+			chunk.aabb.ExtendTo(m_batches[batchIndex].aabb);
+	}
+
+	m_boundingVolume.Set(globalAABB);
+	m_boundingVolume.Update(NzMatrix4f::Identity());
+
+	if (disableSources)
+	{
+		for (NzModel* model : m_sourceModels)
+			model->EnableDrawing(false);
+	}
+
+	m_stats.batchCount = m_batches.size();
+	m_stats.chunkCount = m_chunks.size();
+	m_stats.modelCount = m_sourceModels.size();
+	m_stats.visibleBatchCount = m_batches.size();
+
+	NotifyBoundingVolumeChange();
+
+	return true;
+}
+
+void NzStaticBatch::Clear()
+{
+	///DOC: Les modèles sources ne sont pas réactivés (ils peuvent avoir été détruits entre-temps)
+	m_batches.clear();
+	m_chunks.clear();
+	m_sourceModels.clear();
+	m_mesh.Destroy();
+
+	m_boundingVolume.MakeNull();
+	m_stats = NzStaticBatchStats();
+
+	NotifyBoundingVolumeChange();
+}
+
+const NzBoxf& NzStaticBatch::GetBatchAABB(unsigned int batch) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (batch >= m_batches.size())
+	{
+		NazaraError("Batch index out of range (" + NzString::Number(batch) + " >= " + NzString::Number(m_batches.size()) + ')');
+
+		static NzBoxf dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_batches[batch].aabb;
+}
+
+unsigned int NzStaticBatch::GetBatchChunk(unsigned int batch) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (batch >= m_batches.size())
+	{
+		NazaraError("Batch index out of range (" + NzString::Number(batch) + " >= " + NzString::Number(m_batches.size()) + ')');
+		return 0;
+	}
+	#endif
+
+	return m_batches[batch].chunk;
+}
+
+unsigned int NzStaticBatch::GetBatchCount() const
+{
+	return m_batches.size();
+}
+
+const NzMaterial* NzStaticBatch::GetBatchMaterial(unsigned int batch) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (batch >= m_batches.size())
+	{
+		NazaraError("Batch index out of range (" + NzString::Number(batch) + " >= " + NzString::Number(m_batches.size()) + ')');
+		return nullptr;
+	}
+	#endif
+
+	return m_batches[batch].material;
+}
+
+NzStaticMesh* NzStaticBatch::GetBatchMesh(unsigned int batch) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (batch >= m_batches.size())
+	{
+		NazaraError("Batch index out of range (" + NzString::Number(batch) + " >= " + NzString::Number(m_batches.size()) + ')');
+		return nullptr;
+	}
+	#endif
+
+	return m_batches[batch].subMesh;
+}
+
+const NzBoundingVolumef& NzStaticBatch::GetBoundingVolume() const
+{
+	return m_boundingVolume;
+}
+
+const NzBoxf& NzStaticBatch::GetChunkAABB(unsigned int chunk) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (chunk >= m_chunks.size())
+	{
+		NazaraError("Chunk index out of range (" + NzString::Number(chunk) + " >= " + NzString::Number(m_chunks.size()) + ')');
+
+		static NzBoxf dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_chunks[chunk].aabb;
+}
+
+unsigned int NzStaticBatch::GetChunkCount() const
+{
+	return m_chunks.size();
+}
+
+float NzStaticBatch::GetChunkSize() const
+{
+	return m_chunkSize;
+}
+
+nzSceneNodeType NzStaticBatch::GetSceneNodeType() const
+{
+	return nzSceneNodeType_StaticBatch;
+}
+
+const std::vector<NzModel*>& NzStaticBatch::GetSourceModels() const
+{
+	///DOC: Les modèles ne sont pas possédés par le lot
+	return m_sourceModels;
+}
+
+const NzStaticBatchStats& NzStaticBatch::GetStats() const
+{
+	return m_stats;
+}
+
+bool NzStaticBatch::IsChunkVisible(unsigned int chunk) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (chunk >= m_chunks.size())
+	{
+		NazaraError("Chunk index out of range (" + NzString::Number(chunk) + " >= " + NzString::Number(m_chunks.size()) + ')');
+		return false;
+	}
+	#endif
+
+	return m_chunks[chunk].visible;
+}
+
+bool NzStaticBatch::IsDrawable() const
+{
+	return !m_batches.empty();
+}
+
+void NzStaticBatch::SetChunkSize(float chunkSize)
+{
+	///DOC: Prend effet au prochain appel à Build
+	#if NAZARA_GRAPHICS_SAFE
+	if (chunkSize <= 0.f)
+	{
+		NazaraError("Chunk size must be positive");
+		return;
+	}
+	#endif
+
+	m_chunkSize = chunkSize;
+}
+
+bool NzStaticBatch::FrustumCull(const NzFrustumf& frustum)
+{
+	m_stats.visibleBatchCount = 0;
+
+	for (Chunk& chunk : m_chunks)
+	{
+		chunk.visible = frustum.Contains(chunk.aabb);
+		if (chunk.visible)
+			m_stats.visibleBatchCount += chunk.batches.size();
+	}
+
+	return m_stats.visibleBatchCount > 0;
+}
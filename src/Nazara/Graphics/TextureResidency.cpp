@@ -0,0 +1,526 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/TextureResidency.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <algorithm>
+#include <Nazara/Graphics/Debug.hpp>
+
+NzTextureResidency::NzTextureResidency(nzUInt64 memoryBudget, nzUInt64 uploadBudget) :
+m_memoryBudget(memoryBudget),
+m_residentMemory(0),
+m_uploadBudget(uploadBudget),
+m_uploadedBytes(0),
+m_evictionCount(0),
+m_evictionDelay(60),
+m_frame(1), // Le numéro de frame 0 désigne une texture jamais demandée
+m_maxPendingLoads(4),
+m_pendingLoadCount(0),
+m_starvingCount(0)
+{
+}
+
+NzTextureResidency::~NzTextureResidency() = default;
+
+unsigned int NzTextureResidency::AddTexture(unsigned int width, unsigned int height, nzUInt8 bytesPerPixel, nzUInt8 levelCount, nzUInt8 baseLevel)
+{
+	///DOC: Le niveau de base est considéré résident (et ses pixels disponibles) dès l'ajout
+	#if NAZARA_GRAPHICS_SAFE
+	if (width == 0 || height == 0 || bytesPerPixel == 0 || levelCount == 0)
+	{
+		NazaraError("Invalid texture description");
+		return 0;
+	}
+	#endif
+
+	unsigned int index;
+	if (m_freeTextures.empty())
+	{
+		index = m_textures.size();
+		m_textures.resize(index + 1);
+	}
+	else
+	{
+		index = m_freeTextures.back();
+		m_freeTextures.pop_back();
+	}
+
+	Texture& texture = m_textures[index];
+	texture.availableLevel = std::min<nzUInt8>(baseLevel, levelCount - 1);
+	texture.baseLevel = texture.availableLevel;
+	texture.bytesPerPixel = bytesPerPixel;
+	texture.failed = false;
+	texture.height = height;
+	texture.lastRequestFrame = 0;
+	texture.levelCount = levelCount;
+	texture.loading = false;
+	texture.priority = 0.f;
+	texture.requestedLevel = texture.baseLevel;
+	texture.residentLevel = texture.baseLevel;
+	texture.valid = true;
+	texture.width = width;
+
+	m_residentMemory += GetMemory(texture, texture.residentLevel);
+
+	return index;
+}
+
+void NzTextureResidency::BeginFrame()
+{
+	m_frame++;
+}
+
+void NzTextureResidency::Clear()
+{
+	m_freeTextures.clear();
+	m_textures.clear();
+	m_pendingLoadCount = 0;
+	m_residentMemory = 0;
+	m_starvingCount = 0;
+	m_uploadedBytes = 0;
+}
+
+nzUInt8 NzTextureResidency::GetAvailableLevel(unsigned int texture) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return 0;
+	}
+	#endif
+
+	return m_textures[texture].availableLevel;
+}
+
+nzUInt8 NzTextureResidency::GetBaseLevel(unsigned int texture) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return 0;
+	}
+	#endif
+
+	return m_textures[texture].baseLevel;
+}
+
+unsigned int NzTextureResidency::GetEvictionCount() const
+{
+	return m_evictionCount;
+}
+
+unsigned int NzTextureResidency::GetEvictionDelay() const
+{
+	return m_evictionDelay;
+}
+
+unsigned int NzTextureResidency::GetFrame() const
+{
+	return m_frame;
+}
+
+nzUInt8 NzTextureResidency::GetLevelCount(unsigned int texture) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return 0;
+	}
+	#endif
+
+	return m_textures[texture].levelCount;
+}
+
+unsigned int NzTextureResidency::GetMaxPendingLoads() const
+{
+	return m_maxPendingLoads;
+}
+
+nzUInt64 NzTextureResidency::GetMemoryBudget() const
+{
+	return m_memoryBudget;
+}
+
+unsigned int NzTextureResidency::GetPendingLoadCount() const
+{
+	return m_pendingLoadCount;
+}
+
+nzUInt8 NzTextureResidency::GetRequestedLevel(unsigned int texture) const
+{
+	///DOC: Une texture non-demandée durant la frame courante requiert son niveau de base
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return 0;
+	}
+	#endif
+
+	const Texture& entry = m_textures[texture];
+	return (entry.lastRequestFrame == m_frame) ? entry.requestedLevel : entry.baseLevel;
+}
+
+nzUInt8 NzTextureResidency::GetResidentLevel(unsigned int texture) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return 0;
+	}
+	#endif
+
+	return m_textures[texture].residentLevel;
+}
+
+nzUInt64 NzTextureResidency::GetResidentMemory() const
+{
+	return m_residentMemory;
+}
+
+unsigned int NzTextureResidency::GetStarvingCount() const
+{
+	return m_starvingCount;
+}
+
+unsigned int NzTextureResidency::GetTextureCount() const
+{
+	return m_textures.size() - m_freeTextures.size();
+}
+
+nzUInt64 NzTextureResidency::GetUploadBudget() const
+{
+	return m_uploadBudget;
+}
+
+nzUInt64 NzTextureResidency::GetUploadedBytes() const
+{
+	return m_uploadedBytes;
+}
+
+bool NzTextureResidency::IsLoading(unsigned int texture) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return false;
+	}
+	#endif
+
+	return m_textures[texture].loading;
+}
+
+bool NzTextureResidency::IsRequested(unsigned int texture) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return false;
+	}
+	#endif
+
+	return m_textures[texture].lastRequestFrame == m_frame;
+}
+
+bool NzTextureResidency::IsValid(unsigned int texture) const
+{
+	return texture < m_textures.size() && m_textures[texture].valid;
+}
+
+void NzTextureResidency::RemoveTexture(unsigned int texture)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return;
+	}
+	#endif
+
+	Texture& entry = m_textures[texture];
+	if (entry.loading)
+		m_pendingLoadCount--;
+
+	m_residentMemory -= GetMemory(entry, entry.residentLevel);
+
+	entry.valid = false;
+	m_freeTextures.push_back(texture);
+}
+
+void NzTextureResidency::RequestLevel(unsigned int texture, nzUInt8 level, float priority)
+{
+	///DOC: Plusieurs demandes au cours d'une même frame sont combinées (niveau le plus détaillé, priorité la plus haute)
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return;
+	}
+	#endif
+
+	Texture& entry = m_textures[texture];
+	level = std::min(level, entry.baseLevel);
+
+	if (entry.lastRequestFrame != m_frame)
+	{
+		entry.lastRequestFrame = m_frame;
+		entry.priority = priority;
+		entry.requestedLevel = level;
+	}
+	else
+	{
+		entry.priority = std::max(entry.priority, priority);
+		entry.requestedLevel = std::min(entry.requestedLevel, level);
+	}
+}
+
+void NzTextureResidency::Schedule(std::vector<Action>* loads, std::vector<Action>* uploads, std::vector<Action>* evictions)
+{
+	///DOC: Le niveau résident est mis à jour immédiatement, les actions retournées doivent être effectuées par l'appelant
+	///     avant la prochaine frame : les chargements doivent aboutir à SetAvailableLevel (ou SetLoadFailed),
+	///     les envois et les évictions recréent la texture à partir du niveau indiqué
+	#if NAZARA_GRAPHICS_SAFE
+	if (!loads || !uploads || !evictions)
+	{
+		NazaraError("Invalid action lists");
+		return;
+	}
+	#endif
+
+	loads->clear();
+	uploads->clear();
+	evictions->clear();
+
+	m_uploadedBytes = 0;
+
+	// Les textures manquant de détails, les plus visibles (et les plus en retard) en premier
+	std::vector<unsigned int> candidates;
+	for (unsigned int i = 0; i < m_textures.size(); ++i)
+	{
+		const Texture& texture = m_textures[i];
+		if (texture.valid && texture.lastRequestFrame == m_frame && texture.requestedLevel < texture.residentLevel)
+			candidates.push_back(i);
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end(), [this](unsigned int a, unsigned int b)
+	{
+		return GetWeight(m_textures[a]) > GetWeight(m_textures[b]);
+	});
+
+	for (unsigned int i : candidates)
+	{
+		if (m_pendingLoadCount >= m_maxPendingLoads)
+			break;
+
+		Texture& texture = m_textures[i];
+		if (!texture.loading && !texture.failed && texture.availableLevel > texture.requestedLevel)
+		{
+			loads->push_back({i, texture.requestedLevel});
+			texture.loading = true;
+
+			m_pendingLoadCount++;
+		}
+	}
+
+	// Victimes potentielles : les textures inutilisées depuis plus de m_evictionDelay frames, la plus ancienne en premier
+	std::vector<unsigned int> victims;
+	for (unsigned int i = 0; i < m_textures.size(); ++i)
+	{
+		const Texture& texture = m_textures[i];
+		if (texture.valid && texture.residentLevel < texture.baseLevel && m_frame - texture.lastRequestFrame > m_evictionDelay)
+			victims.push_back(i);
+	}
+
+	std::stable_sort(victims.begin(), victims.end(), [this](unsigned int a, unsigned int b)
+	{
+		const Texture& textureA = m_textures[a];
+		const Texture& textureB = m_textures[b];
+		if (textureA.lastRequestFrame != textureB.lastRequestFrame)
+			return textureA.lastRequestFrame < textureB.lastRequestFrame;
+
+		return GetMemory(textureA, textureA.residentLevel) > GetMemory(textureB, textureB.residentLevel);
+	});
+
+	unsigned int victimIndex = 0;
+
+	for (unsigned int i : candidates)
+	{
+		Texture& texture = m_textures[i];
+		if (texture.availableLevel >= texture.residentLevel)
+			continue; // Rien de plus détaillé à envoyer pour l'instant
+
+		// Seul le premier niveau est envoyé, les suivants étant générés par le GPU
+		nzUInt8 level = std::max(texture.requestedLevel, texture.availableLevel);
+		nzUInt64 cost = ComputeLevelSize(texture.width, texture.height, texture.bytesPerPixel, level);
+
+		// Le premier envoi de la frame est toujours accepté, pour qu'une grosse texture ne soit jamais bloquée
+		if (m_uploadedBytes > 0 && m_uploadedBytes + cost > m_uploadBudget)
+			continue;
+
+		bool fits = false;
+		nzUInt64 memory;
+		for (;;)
+		{
+			memory = m_residentMemory - GetMemory(texture, texture.residentLevel) + GetMemory(texture, level);
+			if (memory <= m_memoryBudget)
+			{
+				fits = true;
+				break;
+			}
+
+			if (Evict(victims, &victimIndex, evictions))
+				continue;
+
+			// Plus rien à évincer, on se contente d'un niveau moins détaillé
+			if (level + 1 >= texture.residentLevel)
+				break;
+
+			level++;
+			cost = ComputeLevelSize(texture.width, texture.height, texture.bytesPerPixel, level);
+		}
+
+		if (!fits)
+			continue;
+
+		uploads->push_back({i, level});
+		texture.residentLevel = level;
+
+		m_residentMemory = memory;
+		m_uploadedBytes += cost;
+	}
+
+	// Le budget a pu être réduit depuis la frame précédente
+	while (m_residentMemory > m_memoryBudget && Evict(victims, &victimIndex, evictions));
+
+	m_starvingCount = 0;
+	for (unsigned int i : candidates)
+	{
+		const Texture& texture = m_textures[i];
+		if (texture.requestedLevel < texture.residentLevel)
+			m_starvingCount++;
+	}
+}
+
+void NzTextureResidency::SetAvailableLevel(unsigned int texture, nzUInt8 level)
+{
+	///DOC: Termine le chargement éventuel de la texture
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return;
+	}
+	#endif
+
+	Texture& entry = m_textures[texture];
+	if (entry.loading)
+	{
+		entry.loading = false;
+		m_pendingLoadCount--;
+	}
+
+	entry.availableLevel = std::min(level, entry.baseLevel);
+}
+
+void NzTextureResidency::SetEvictionDelay(unsigned int frameCount)
+{
+	m_evictionDelay = frameCount;
+}
+
+void NzTextureResidency::SetLoadFailed(unsigned int texture)
+{
+	///DOC: La texture ne sera plus chargée, elle conserve les niveaux disponibles
+	#if NAZARA_GRAPHICS_SAFE
+	if (!IsValid(texture))
+	{
+		NazaraError("Invalid texture index (" + NzString::Number(texture) + ')');
+		return;
+	}
+	#endif
+
+	Texture& entry = m_textures[texture];
+	if (entry.loading)
+	{
+		entry.loading = false;
+		m_pendingLoadCount--;
+	}
+
+	entry.failed = true;
+}
+
+void NzTextureResidency::SetMaxPendingLoads(unsigned int loadCount)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (loadCount == 0)
+	{
+		NazaraError("At least one load must be allowed");
+		return;
+	}
+	#endif
+
+	m_maxPendingLoads = loadCount;
+}
+
+void NzTextureResidency::SetMemoryBudget(nzUInt64 budget)
+{
+	m_memoryBudget = budget;
+}
+
+void NzTextureResidency::SetUploadBudget(nzUInt64 budget)
+{
+	m_uploadBudget = budget;
+}
+
+nzUInt64 NzTextureResidency::ComputeLevelSize(unsigned int width, unsigned int height, nzUInt8 bytesPerPixel, nzUInt8 level)
+{
+	return static_cast<nzUInt64>(std::max(width >> level, 1U)) * std::max(height >> level, 1U) * bytesPerPixel;
+}
+
+nzUInt64 NzTextureResidency::ComputeMemory(unsigned int width, unsigned int height, nzUInt8 bytesPerPixel, nzUInt8 firstLevel, nzUInt8 levelCount)
+{
+	nzUInt64 memory = 0;
+	for (nzUInt8 level = firstLevel; level < levelCount; ++level)
+		memory += ComputeLevelSize(width, height, bytesPerPixel, level);
+
+	return memory;
+}
+
+bool NzTextureResidency::Evict(std::vector<unsigned int>& victims, unsigned int* victimIndex, std::vector<Action>* evictions)
+{
+	while (*victimIndex < victims.size())
+	{
+		unsigned int index = victims[(*victimIndex)++];
+
+		Texture& texture = m_textures[index];
+		if (texture.residentLevel >= texture.baseLevel)
+			continue;
+
+		m_residentMemory -= GetMemory(texture, texture.residentLevel);
+		m_residentMemory += GetMemory(texture, texture.baseLevel);
+		m_evictionCount++;
+
+		evictions->push_back({index, texture.baseLevel});
+		texture.residentLevel = texture.baseLevel;
+
+		return true;
+	}
+
+	return false;
+}
+
+nzUInt64 NzTextureResidency::GetMemory(const Texture& texture, nzUInt8 level) const
+{
+	return ComputeMemory(texture.width, texture.height, texture.bytesPerPixel, level, texture.levelCount);
+}
+
+float NzTextureResidency::GetWeight(const Texture& texture) const
+{
+	return texture.priority * (texture.residentLevel - texture.requestedLevel);
+}
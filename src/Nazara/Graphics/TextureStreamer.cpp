@@ -0,0 +1,587 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/TextureStreamer.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/LockGuard.hpp>
+#include <Nazara/Core/Mutex.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <Nazara/Graphics/AbstractViewer.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <Nazara/Graphics/Model.hpp>
+#include <Nazara/Graphics/StaticBatch.hpp>
+#include <Nazara/Renderer/Material.hpp>
+#include <Nazara/Utility/BufferMapper.hpp>
+#include <Nazara/Utility/IndexMapper.hpp>
+#include <Nazara/Utility/Mesh.hpp>
+#include <Nazara/Utility/PixelFormat.hpp>
+#include <Nazara/Utility/StaticMesh.hpp>
+#include <Nazara/Utility/VertexDeclaration.hpp>
+#include <algorithm>
+#include <cmath>
+#include <Nazara/Graphics/Debug.hpp>
+
+namespace
+{
+	bool IsByteFormat(nzPixelFormat format)
+	{
+		switch (format)
+		{
+			case nzPixelFormat_BGR8:
+			case nzPixelFormat_BGRA8:
+			case nzPixelFormat_L8:
+			case nzPixelFormat_LA8:
+			case nzPixelFormat_RGB8:
+			case nzPixelFormat_RGBA8:
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	void Downsample(const nzUInt8* src, unsigned int width, unsigned int height, nzUInt8 bpp, nzUInt8* dst)
+	{
+		// Filtre boîte 2x2, la dernière ligne/colonne d'une dimension impaire est dupliquée
+		unsigned int dstWidth = std::max(width/2, 1U);
+		unsigned int dstHeight = std::max(height/2, 1U);
+
+		for (unsigned int y = 0; y < dstHeight; ++y)
+		{
+			const nzUInt8* row0 = &src[std::min(y*2, height-1)*width*bpp];
+			const nzUInt8* row1 = &src[std::min(y*2 + 1, height-1)*width*bpp];
+
+			for (unsigned int x = 0; x < dstWidth; ++x)
+			{
+				unsigned int x0 = std::min(x*2, width-1)*bpp;
+				unsigned int x1 = std::min(x*2 + 1, width-1)*bpp;
+
+				for (unsigned int c = 0; c < bpp; ++c)
+					*dst++ = static_cast<nzUInt8>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+			}
+		}
+	}
+
+	bool ExtractLevel(const NzImage& source, nzUInt8 level, NzImage* image)
+	{
+		if (!image->Create(nzImageType_2D, source.GetFormat(), source.GetWidth(level), source.GetHeight(level)))
+			return false;
+
+		image->Update(source.GetConstPixels(0, 0, 0, level));
+		return true;
+	}
+
+	bool PrepareImage(NzImage* image)
+	{
+		// Les niveaux de mipmap devant être générés côté CPU, seules les images 2D de composantes 8 bits sont diffusées
+		if (image->GetType() != nzImageType_2D || image->IsCompressed())
+			return false;
+
+		nzPixelFormat format = image->GetFormat();
+		if (!IsByteFormat(format) || !NzTexture::IsFormatSupported(format))
+		{
+			nzPixelFormat newFormat = (NzPixelFormat::HasAlpha(format)) ? nzPixelFormat_BGRA8 : nzPixelFormat_BGR8;
+			if (!NzPixelFormat::IsConversionSupported(format, newFormat) || !image->Convert(newFormat))
+				return false;
+		}
+
+		nzUInt8 maxLevel = NzImage::GetMaxLevel(image->GetWidth(), image->GetHeight());
+		if (image->GetLevelCount() < maxLevel)
+		{
+			nzUInt8 firstLevel = image->GetLevelCount();
+			nzUInt8 bpp = image->GetBytesPerPixel();
+
+			image->SetLevelCount(maxLevel);
+			for (nzUInt8 level = firstLevel; level < maxLevel; ++level)
+				Downsample(image->GetConstPixels(0, 0, 0, level-1), image->GetWidth(level-1), image->GetHeight(level-1), bpp, image->GetPixels(0, 0, 0, level));
+		}
+
+		return true;
+	}
+}
+
+struct NzTextureStreamer::LoadQueue
+{
+	struct Result
+	{
+		std::unique_ptr<NzImage> image; // Nul en cas d'échec
+		unsigned int serial;
+		unsigned int texture;
+	};
+
+	NzMutex mutex;
+	std::vector<Result> results;
+};
+
+NzTextureStreamer::NzTextureStreamer() :
+m_loadQueue(new LoadQueue),
+m_levelBias(0.f),
+m_serial(0)
+{
+	m_stats = NzTextureStreamerStats();
+}
+
+NzTextureStreamer::~NzTextureStreamer()
+{
+	// Les chargements en cours partagent la file des résultats, ils peuvent se terminer après notre destruction
+	Clear();
+}
+
+void NzTextureStreamer::Clear()
+{
+	///DOC: Les textures conservent les niveaux résidents au moment de l'appel
+	for (unsigned int i = 0; i < m_textures.size(); ++i)
+	{
+		if (m_residency.IsValid(i))
+			m_residency.RemoveTexture(i);
+	}
+
+	m_textureIndices.clear();
+	m_textures.clear();
+	m_uvDensities.clear();
+
+	NzTextureStreamerStats stats = NzTextureStreamerStats();
+	stats.evictionCount = m_stats.evictionCount;
+	stats.loadCount = m_stats.loadCount;
+
+	m_stats = stats;
+}
+
+float NzTextureStreamer::GetLevelBias() const
+{
+	return m_levelBias;
+}
+
+NzTextureResidency& NzTextureStreamer::GetResidency()
+{
+	return m_residency;
+}
+
+const NzTextureResidency& NzTextureStreamer::GetResidency() const
+{
+	return m_residency;
+}
+
+const NzTextureStreamerStats& NzTextureStreamer::GetStats() const
+{
+	return m_stats;
+}
+
+bool NzTextureStreamer::IsStreamed(const NzTexture* texture) const
+{
+	return m_textureIndices.find(texture) != m_textureIndices.end();
+}
+
+bool NzTextureStreamer::Register(NzTexture* texture, const NzString& filePath, const NzImageParams& params)
+{
+	///DOC: Remplace NzTexture::LoadFromFile : seul le niveau de base est envoyé au GPU,
+	///     les pixels plus détaillés sont gardés jusqu'au prochain Update puis rechargés à la demande
+	///     Une image ne pouvant être diffusée (compressée, cubemap, ...) est chargée entièrement
+	#if NAZARA_GRAPHICS_SAFE
+	if (!texture)
+	{
+		NazaraError("Invalid texture");
+		return false;
+	}
+	#endif
+
+	if (IsStreamed(texture))
+		Unregister(texture);
+
+	std::unique_ptr<NzImage> image(new NzImage);
+	if (!image->LoadFromFile(filePath, params))
+	{
+		NazaraError("Failed to load image");
+		return false;
+	}
+
+	if (!PrepareImage(image.get()))
+	{
+		NazaraWarning("Image \"" + filePath + "\" cannot be streamed, loading it entirely");
+		return texture->LoadFromImage(*image);
+	}
+
+	nzUInt8 levelCount = image->GetLevelCount();
+	nzUInt8 baseLevel = 0;
+	while (baseLevel + 1 < levelCount && std::max(image->GetWidth(baseLevel), image->GetHeight(baseLevel)) > NAZARA_GRAPHICS_TEXTURESTREAMING_BASE_SIZE)
+		baseLevel++;
+
+	unsigned int index = m_residency.AddTexture(image->GetWidth(), image->GetHeight(), image->GetBytesPerPixel(), levelCount, baseLevel);
+	m_residency.SetAvailableLevel(index, 0);
+
+	if (index >= m_textures.size())
+		m_textures.resize(index + 1);
+
+	Texture& entry = m_textures[index];
+	if (!ExtractLevel(*image, baseLevel, &entry.base))
+	{
+		NazaraError("Failed to extract base level");
+		m_residency.RemoveTexture(index);
+
+		return false;
+	}
+
+	entry.detail = std::move(image);
+	entry.filePath = filePath;
+	entry.params = params;
+	entry.serial = m_serial++;
+	entry.size = std::max(entry.detail->GetWidth(), entry.detail->GetHeight());
+	entry.texture = texture;
+
+	if (!UploadLevel(entry, baseLevel))
+	{
+		NazaraError("Failed to upload base level");
+		m_residency.RemoveTexture(index);
+		entry = Texture();
+
+		return false;
+	}
+
+	m_textureIndices[texture] = index;
+
+	return true;
+}
+
+void NzTextureStreamer::SetLevelBias(float bias)
+{
+	///DOC: Un biais positif réduit les détails demandés (un niveau par unité)
+	m_levelBias = bias;
+}
+
+void NzTextureStreamer::Unregister(NzTexture* texture)
+{
+	///DOC: La texture conserve les niveaux résidents au moment de l'appel
+	auto it = m_textureIndices.find(texture);
+	if (it == m_textureIndices.end())
+	{
+		NazaraError("Texture is not streamed");
+		return;
+	}
+
+	unsigned int index = it->second;
+	m_residency.RemoveTexture(index);
+	m_textureIndices.erase(it);
+
+	// Un éventuel chargement en cours sera ignoré grâce au numéro de série
+	m_textures[index] = Texture();
+}
+
+void NzTextureStreamer::Update(const NzAbstractViewer* viewer, const NzNode& root)
+{
+	///DOC: Doit être appelé une fois par frame, après le culling de la scène (seuls les nodes visibles sont pris en compte)
+	///     et depuis le thread possédant le contexte OpenGL
+	#if NAZARA_GRAPHICS_SAFE
+	if (!viewer)
+	{
+		NazaraError("Invalid viewer");
+		return;
+	}
+	#endif
+
+	m_residency.BeginFrame();
+
+	// Récupération des chargements terminés
+	std::vector<LoadQueue::Result> results;
+	{
+		NzLockGuard lock(m_loadQueue->mutex);
+		std::swap(results, m_loadQueue->results);
+	}
+
+	for (LoadQueue::Result& result : results)
+	{
+		if (!m_residency.IsValid(result.texture) || m_textures[result.texture].serial != result.serial)
+			continue; // Texture retirée entre-temps
+
+		Texture& entry = m_textures[result.texture];
+		if (result.image)
+		{
+			entry.detail = std::move(result.image);
+			m_residency.SetAvailableLevel(result.texture, 0);
+			m_stats.loadCount++;
+		}
+		else
+		{
+			NazaraWarning("Failed to load \"" + entry.filePath + "\", streaming disabled for this texture");
+			m_residency.SetLoadFailed(result.texture);
+		}
+	}
+
+	// Estimation des niveaux requis par les modèles visibles
+	CollectRequests(&root, viewer->GetProjectionMatrix(), viewer->GetEyePosition(), viewer->GetViewport().height, viewer->GetZNear());
+
+	m_residency.Schedule(&m_loads, &m_uploads, &m_evictions);
+
+	for (const NzTextureResidency::Action& eviction : m_evictions)
+	{
+		if (!UploadLevel(m_textures[eviction.texture], eviction.level))
+			NazaraError("Failed to evict texture \"" + m_textures[eviction.texture].filePath + '"');
+	}
+
+	for (const NzTextureResidency::Action& upload : m_uploads)
+	{
+		if (!UploadLevel(m_textures[upload.texture], upload.level))
+			NazaraError("Failed to upload texture \"" + m_textures[upload.texture].filePath + '"');
+	}
+
+	if (!m_loads.empty())
+	{
+		NzTaskScheduler::Initialize();
+
+		for (const NzTextureResidency::Action& load : m_loads)
+		{
+			const Texture& entry = m_textures[load.texture];
+
+			std::shared_ptr<LoadQueue> queue = m_loadQueue;
+			NzString filePath = entry.filePath;
+			NzImageParams params = entry.params;
+			unsigned int serial = entry.serial;
+			unsigned int texture = load.texture;
+
+			NzTaskScheduler::AddTask([queue, filePath, params, serial, texture]()
+			{
+				LoadQueue::Result result;
+				result.image.reset(new NzImage);
+				result.serial = serial;
+				result.texture = texture;
+
+				if (!result.image->LoadFromFile(filePath, params) || !PrepareImage(result.image.get()))
+					result.image.reset();
+
+				NzLockGuard lock(queue->mutex);
+				queue->results.push_back(std::move(result));
+			});
+		}
+	}
+
+	// Les pixels détaillés ne sont gardés que tant qu'ils peuvent encore servir (envoi repoussé par le budget)
+	for (unsigned int i = 0; i < m_textures.size(); ++i)
+	{
+		Texture& entry = m_textures[i];
+		if (entry.detail && !m_residency.IsLoading(i) && m_residency.GetRequestedLevel(i) >= m_residency.GetResidentLevel(i))
+		{
+			entry.detail.reset();
+			m_residency.SetAvailableLevel(i, m_residency.GetBaseLevel(i));
+		}
+	}
+
+	m_stats.evictionCount = m_residency.GetEvictionCount();
+	m_stats.pendingLoadCount = m_residency.GetPendingLoadCount();
+	m_stats.residentMemory = m_residency.GetResidentMemory();
+	m_stats.starvingCount = m_residency.GetStarvingCount();
+	m_stats.textureCount = m_residency.GetTextureCount();
+	m_stats.uploadCount = m_uploads.size();
+	m_stats.uploadedBytes = m_residency.GetUploadedBytes();
+}
+
+nzUInt8 NzTextureStreamer::ComputeRequiredLevel(unsigned int textureSize, float uvDensity, float worldPerPixel, float bias)
+{
+	///DOC: uvDensity : coordonnées de texture par unité du monde, worldPerPixel : unités du monde couvertes par un pixel
+	///     Le niveau retenu est celui dont un texel couvre au plus un pixel
+	float texelsPerPixel = textureSize * uvDensity * worldPerPixel;
+	if (texelsPerPixel <= 0.f)
+		return 0xFF;
+
+	float level = std::log2(texelsPerPixel) + bias;
+	if (level <= 0.f)
+		return 0;
+
+	return static_cast<nzUInt8>(std::min(std::floor(level), 255.f));
+}
+
+float NzTextureStreamer::ComputeUVDensity(const NzStaticMesh* subMesh)
+{
+	///DOC: Racine du rapport entre l'aire des triangles dans l'espace des textures et leur aire dans l'espace du mesh,
+	///     seule la déclaration de sommets par défaut est supportée (une densité de 1 est retournée sinon)
+	#if NAZARA_GRAPHICS_SAFE
+	if (!subMesh || !subMesh->IsValid())
+	{
+		NazaraError("Invalid submesh");
+		return 1.f;
+	}
+	#endif
+
+	const NzVertexBuffer* vertexBuffer = subMesh->GetVertexBuffer();
+	if (vertexBuffer->GetVertexDeclaration() != NzVertexDeclaration::Get(nzVertexLayout_XYZ_Normal_UV_Tangent) || subMesh->GetPrimitiveMode() != nzPrimitiveMode_TriangleList)
+		return 1.f;
+
+	NzBufferMapper<NzVertexBuffer> mapper(vertexBuffer, nzBufferAccess_ReadOnly);
+	const NzMeshVertex* vertices = static_cast<const NzMeshVertex*>(mapper.GetPointer());
+
+	double meshArea = 0.0;
+	double uvArea = 0.0;
+	auto addTriangle = [&](nzUInt32 a, nzUInt32 b, nzUInt32 c)
+	{
+		const NzMeshVertex& vA = vertices[a];
+		const NzMeshVertex& vB = vertices[b];
+		const NzMeshVertex& vC = vertices[c];
+
+		meshArea += 0.5 * NzVector3f::CrossProduct(vB.position - vA.position, vC.position - vA.position).GetLength();
+
+		NzVector2f uvAB = vB.uv - vA.uv;
+		NzVector2f uvAC = vC.uv - vA.uv;
+		uvArea += 0.5 * std::abs(uvAB.x*uvAC.y - uvAB.y*uvAC.x);
+	};
+
+	const NzIndexBuffer* indexBuffer = subMesh->GetIndexBuffer();
+	if (indexBuffer)
+	{
+		NzIndexMapper indices(indexBuffer);
+
+		unsigned int indexCount = indices.GetIndexCount();
+		for (unsigned int i = 0; i + 2 < indexCount; i += 3)
+			addTriangle(indices.Get(i), indices.Get(i+1), indices.Get(i+2));
+	}
+	else
+	{
+		unsigned int vertexCount = vertexBuffer->GetVertexCount();
+		for (unsigned int i = 0; i + 2 < vertexCount; i += 3)
+			addTriangle(i, i+1, i+2);
+	}
+
+	if (meshArea <= 0.0)
+		return 1.f;
+
+	return static_cast<float>(std::sqrt(uvArea / meshArea));
+}
+
+float NzTextureStreamer::ComputeWorldPerPixel(const NzMatrix4f& projectionMatrix, unsigned int viewportHeight, float distance)
+{
+	///DOC: Taille (en unités du monde) couverte par un pixel à la distance donnée de l'observateur
+	float yScale = std::abs(projectionMatrix(1, 1)); // Négatif si l'axe Y est inversé
+	if (viewportHeight == 0 || yScale == 0.f)
+		return 0.f;
+
+	// yScale vaut 1/tan(fov/2) pour une projection en perspective, 2/hauteur pour une projection orthogonale (m44 = 1)
+	if (projectionMatrix(3, 3) == 1.f)
+		return 2.f / (yScale * viewportHeight);
+	else
+		return 2.f * distance / (yScale * viewportHeight);
+}
+
+void NzTextureStreamer::CollectRequests(const NzNode* node, const NzMatrix4f& projectionMatrix, const NzVector3f& eyePosition, unsigned int viewportHeight, float zNear)
+{
+	if (node->GetNodeType() == nzNodeType_Scene)
+	{
+		const NzSceneNode* sceneNode = static_cast<const NzSceneNode*>(node);
+		if (sceneNode->IsVisible())
+		{
+			switch (sceneNode->GetSceneNodeType())
+			{
+				case nzSceneNodeType_Model:
+				{
+					const NzModel* model = static_cast<const NzModel*>(sceneNode);
+					const NzMesh* mesh = model->GetMesh();
+					if (!mesh)
+						break;
+
+					// Échelle moyenne du modèle, la densité de texture étant mesurée dans l'espace du mesh
+					float scale = std::cbrt(std::abs(model->GetTransformMatrix().GetDeterminantAffine()));
+					const NzBoxf& aabb = model->GetBoundingVolume().aabb;
+
+					unsigned int subMeshCount = mesh->GetSubMeshCount();
+					for (unsigned int i = 0; i < subMeshCount; ++i)
+					{
+						const NzSubMesh* subMesh = mesh->GetSubMesh(i);
+						RequestSubMesh(model->GetMaterial(subMesh->GetMaterialIndex()), subMesh, aabb, scale, projectionMatrix, eyePosition, viewportHeight, zNear);
+					}
+					break;
+				}
+
+				case nzSceneNodeType_StaticBatch:
+				{
+					// Les sommets d'un batch sont déjà dans le repère global
+					const NzStaticBatch* batch = static_cast<const NzStaticBatch*>(sceneNode);
+
+					unsigned int batchCount = batch->GetBatchCount();
+					for (unsigned int i = 0; i < batchCount; ++i)
+					{
+						if (batch->IsChunkVisible(batch->GetBatchChunk(i)))
+							RequestSubMesh(batch->GetBatchMaterial(i), batch->GetBatchMesh(i), batch->GetBatchAABB(i), 1.f, projectionMatrix, eyePosition, viewportHeight, zNear);
+					}
+					break;
+				}
+
+				default:
+					break;
+			}
+		}
+	}
+
+	for (const NzNode* child : node->GetChilds())
+		CollectRequests(child, projectionMatrix, eyePosition, viewportHeight, zNear);
+}
+
+void NzTextureStreamer::RequestSubMesh(const NzMaterial* material, const NzSubMesh* subMesh, const NzBoxf& aabb, float scale, const NzMatrix4f& projectionMatrix, const NzVector3f& eyePosition, unsigned int viewportHeight, float zNear)
+{
+	if (!material)
+		return;
+
+	const NzTexture* maps[] = {
+		material->GetAlphaMap(),
+		material->GetDiffuseMap(),
+		material->GetEmissiveMap(),
+		material->GetHeightMap(),
+		material->GetNormalMap(),
+		material->GetSpecularMap()
+	};
+
+	float uvDensity = 1.f;
+	if (subMesh->GetAnimationType() == nzAnimationType_Static)
+	{
+		auto it = m_uvDensities.find(subMesh);
+		if (it == m_uvDensities.end())
+			it = m_uvDensities.insert(std::make_pair(subMesh, ComputeUVDensity(static_cast<const NzStaticMesh*>(subMesh)))).first;
+
+		uvDensity = it->second;
+	}
+
+	if (scale > 0.f)
+		uvDensity /= scale;
+
+	// Le point le plus proche de la sphère englobante détermine le niveau requis
+	NzVector3f center = aabb.GetCenter();
+	float radius = aabb.GetLengths().GetLength() * 0.5f;
+	float distance = std::max(eyePosition.Distance(center) - radius, zNear);
+
+	float worldPerPixel = ComputeWorldPerPixel(projectionMatrix, viewportHeight, distance);
+	float priority = (worldPerPixel > 0.f) ? 2.f*radius/worldPerPixel : 0.f; // Diamètre apparent, en pixels
+
+	for (const NzTexture* map : maps)
+	{
+		if (!map)
+			continue;
+
+		auto it = m_textureIndices.find(map);
+		if (it == m_textureIndices.end())
+			continue;
+
+		unsigned int index = it->second;
+		m_residency.RequestLevel(index, ComputeRequiredLevel(m_textures[index].size, uvDensity, worldPerPixel, m_levelBias), priority);
+	}
+}
+
+bool NzTextureStreamer::UploadLevel(Texture& texture, nzUInt8 level)
+{
+	// La texture est recréée à la taille du niveau, seul celui-ci est envoyé (les suivants sont générés par le GPU)
+	// Sans les pixels détaillés, seul le niveau de base peut être envoyé
+	const NzImage* source;
+	nzUInt8 sourceLevel;
+	if (texture.detail && level < texture.detail->GetLevelCount())
+	{
+		source = texture.detail.get();
+		sourceLevel = level;
+	}
+	else
+	{
+		source = &texture.base;
+		sourceLevel = 0;
+	}
+
+	unsigned int width = source->GetWidth(sourceLevel);
+	unsigned int height = source->GetHeight(sourceLevel);
+	if (!texture.texture->Create(nzImageType_2D, source->GetFormat(), width, height, 1, NzImage::GetMaxLevel(width, height)))
+		return false;
+
+	return texture.texture->Update(source->GetConstPixels(0, 0, 0, sourceLevel));
+}
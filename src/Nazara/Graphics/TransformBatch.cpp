@@ -0,0 +1,352 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Graphics module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Graphics/TransformBatch.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/SimdDispatch.hpp>
+#include <Nazara/Graphics/Config.hpp>
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+#include <Nazara/Graphics/Debug.hpp>
+
+namespace
+{
+	// out[i] = matrices[i] * rhs, les matrices étant stockées ligne par ligne (convention de NzMatrix4)
+	void MultiplyMatrices_Scalar(const float* matrices, const float* rhs, float* out, unsigned int count)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			for (unsigned int row = 0; row < 4; ++row)
+			{
+				const float* a = &matrices[row*4];
+				for (unsigned int column = 0; column < 4; ++column)
+					out[row*4 + column] = a[0]*rhs[column] + a[1]*rhs[4 + column] + a[2]*rhs[8 + column] + a[3]*rhs[12 + column];
+			}
+
+			matrices += 16;
+			out += 16;
+		}
+	}
+
+	NAZARA_SIMD_TARGET_SSE2
+	void MultiplyMatrices_SSE2(const float* matrices, const float* rhs, float* out, unsigned int count)
+	{
+		__m128 r0 = _mm_loadu_ps(&rhs[0]);
+		__m128 r1 = _mm_loadu_ps(&rhs[4]);
+		__m128 r2 = _mm_loadu_ps(&rhs[8]);
+		__m128 r3 = _mm_loadu_ps(&rhs[12]);
+
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			for (unsigned int row = 0; row < 4; ++row)
+			{
+				const float* a = &matrices[row*4];
+
+				__m128 result = _mm_mul_ps(_mm_set1_ps(a[0]), r0);
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(a[1]), r1));
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(a[2]), r2));
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(a[3]), r3));
+
+				_mm_storeu_ps(&out[row*4], result);
+			}
+
+			matrices += 16;
+			out += 16;
+		}
+	}
+
+	NAZARA_SIMD_TARGET_AVX2
+	void MultiplyMatrices_AVX2(const float* matrices, const float* rhs, float* out, unsigned int count)
+	{
+		// Chaque moitié du registre traite une ligne, deux lignes sont donc calculées à la fois
+		__m256 r0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rhs[0]));
+		__m256 r1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rhs[4]));
+		__m256 r2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rhs[8]));
+		__m256 r3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&rhs[12]));
+
+		unsigned int rowPairCount = count*2;
+		for (unsigned int i = 0; i < rowPairCount; ++i)
+		{
+			__m256 rows = _mm256_loadu_ps(matrices);
+
+			__m256 result = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+			result = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), r1, result);
+			result = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), r2, result);
+			result = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), r3, result);
+
+			_mm256_storeu_ps(out, result);
+
+			matrices += 8;
+			out += 8;
+		}
+	}
+
+	NzSimdFunction<void(const float*, const float*, float*, unsigned int)> MultiplyMatrices(MultiplyMatrices_Scalar, MultiplyMatrices_SSE2, nullptr, MultiplyMatrices_AVX2);
+
+	void ComputeNormalMatrix(const float* m, float* out)
+	{
+		// Transposée de l'inverse de la partie 3x3, soit la matrice des cofacteurs divisée par le déterminant
+		float c11 = m[5]*m[10] - m[6]*m[9];
+		float c12 = m[6]*m[8] - m[4]*m[10];
+		float c13 = m[4]*m[9] - m[5]*m[8];
+		float c21 = m[2]*m[9] - m[1]*m[10];
+		float c22 = m[0]*m[10] - m[2]*m[8];
+		float c23 = m[1]*m[8] - m[0]*m[9];
+		float c31 = m[1]*m[6] - m[2]*m[5];
+		float c32 = m[2]*m[4] - m[0]*m[6];
+		float c33 = m[0]*m[5] - m[1]*m[4];
+
+		float det = m[0]*c11 + m[1]*c12 + m[2]*c13;
+		float invDet = (std::fabs(det) > 1e-20f) ? 1.f/det : 0.f;
+
+		const float normal[16] =
+		{
+			c11*invDet, c12*invDet, c13*invDet, 0.f,
+			c21*invDet, c22*invDet, c23*invDet, 0.f,
+			c31*invDet, c32*invDet, c33*invDet, 0.f,
+			0.f,        0.f,        0.f,        1.f
+		};
+
+		std::memcpy(out, normal, 16*sizeof(float));
+	}
+
+	void ComputeCompact3x4(const float* m, float* out)
+	{
+		// Les colonnes deviennent des lignes : un shader les utilise via dot(vec4(position, 1.0), ligne)
+		for (unsigned int column = 0; column < 3; ++column)
+		{
+			for (unsigned int row = 0; row < 4; ++row)
+				out[column*4 + row] = m[row*4 + column];
+		}
+	}
+
+	void ComputeCompactTransform(const float* m, NzCompactTransform* out)
+	{
+		// L'échelle est appliquée aux lignes (voir NzMatrix4::ApplyScale), on la retire avant d'extraire la rotation
+		float rotationMatrix[16];
+		std::memcpy(rotationMatrix, m, 16*sizeof(float));
+		for (unsigned int row = 0; row < 3; ++row)
+		{
+			float* r = &rotationMatrix[row*4];
+			float scale = std::sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+			float invScale = (scale > 0.f) ? 1.f/scale : 0.f;
+
+			r[0] *= invScale;
+			r[1] *= invScale;
+			r[2] *= invScale;
+
+			out->scale[row] = scale;
+		}
+
+		out->rotation = NzMatrix4f(rotationMatrix).GetRotation();
+		out->translation.Set(m[12], m[13], m[14]);
+	}
+}
+
+NzTransformBatch::NzTransformBatch(nzUInt32 flags) :
+m_flags(flags)
+{
+}
+
+unsigned int NzTransformBatch::AddTransform(const NzMatrix4f& worldMatrix)
+{
+	unsigned int index = GetTransformCount();
+
+	const float* matrix = worldMatrix;
+	m_worldMatrices.insert(m_worldMatrices.end(), matrix, matrix + 16);
+
+	// Les résultats sont dimensionnés dès maintenant, des intervalles disjoints peuvent ainsi être calculés en parallèle
+	if (m_flags & nzTransformBatch_Compact)
+		m_compactTransforms.resize(index + 1);
+
+	if (m_flags & nzTransformBatch_Compact3x4)
+		m_compact3x4Matrices.resize((index + 1)*12);
+
+	if (m_flags & nzTransformBatch_Normal)
+		m_normalMatrices.resize((index + 1)*16);
+
+	if (m_flags & nzTransformBatch_WorldView)
+		m_worldViewMatrices.resize((index + 1)*16);
+
+	if (m_flags & nzTransformBatch_WorldViewProj)
+		m_worldViewProjMatrices.resize((index + 1)*16);
+
+	return index;
+}
+
+void NzTransformBatch::Clear()
+{
+	// On garde la mémoire, le batch étant rempli à chaque image
+	m_compactTransforms.clear();
+	m_compact3x4Matrices.clear();
+	m_normalMatrices.clear();
+	m_worldMatrices.clear();
+	m_worldViewMatrices.clear();
+	m_worldViewProjMatrices.clear();
+}
+
+void NzTransformBatch::Compute(const NzMatrix4f& viewMatrix, const NzMatrix4f& projectionMatrix)
+{
+	Compute(viewMatrix, projectionMatrix, 0, GetTransformCount());
+}
+
+void NzTransformBatch::Compute(const NzMatrix4f& viewMatrix, const NzMatrix4f& projectionMatrix, unsigned int firstTransform, unsigned int transformCount)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (firstTransform + transformCount > GetTransformCount())
+	{
+		NazaraError("Transform range out of bounds (" + NzString::Number(firstTransform + transformCount) + " > " + NzString::Number(GetTransformCount()) + ')');
+		return;
+	}
+	#endif
+
+	if (transformCount == 0)
+		return;
+
+	const float* worldMatrices = &m_worldMatrices[firstTransform*16];
+
+	if (m_flags & nzTransformBatch_WorldView)
+		MultiplyMatrices(worldMatrices, viewMatrix, &m_worldViewMatrices[firstTransform*16], transformCount);
+
+	if (m_flags & nzTransformBatch_WorldViewProj)
+	{
+		// World*View*Proj = World*(View*Proj), une seule multiplication par objet
+		NzMatrix4f viewProjMatrix = viewMatrix * projectionMatrix;
+		MultiplyMatrices(worldMatrices, viewProjMatrix, &m_worldViewProjMatrices[firstTransform*16], transformCount);
+	}
+
+	if (m_flags & nzTransformBatch_Normal)
+	{
+		for (unsigned int i = 0; i < transformCount; ++i)
+			ComputeNormalMatrix(&worldMatrices[i*16], &m_normalMatrices[(firstTransform + i)*16]);
+	}
+
+	if (m_flags & nzTransformBatch_Compact3x4)
+	{
+		for (unsigned int i = 0; i < transformCount; ++i)
+			ComputeCompact3x4(&worldMatrices[i*16], &m_compact3x4Matrices[(firstTransform + i)*12]);
+	}
+
+	if (m_flags & nzTransformBatch_Compact)
+	{
+		for (unsigned int i = 0; i < transformCount; ++i)
+			ComputeCompactTransform(&worldMatrices[i*16], &m_compactTransforms[firstTransform + i]);
+	}
+}
+
+const float* NzTransformBatch::GetCompact3x4Matrix(unsigned int index) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!(m_flags & nzTransformBatch_Compact3x4))
+	{
+		NazaraError("Compact 3x4 matrices are not computed by this batch");
+		return nullptr;
+	}
+	#endif
+
+	return &m_compact3x4Matrices[index*12];
+}
+
+const NzCompactTransform& NzTransformBatch::GetCompactTransform(unsigned int index) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!(m_flags & nzTransformBatch_Compact))
+	{
+		NazaraError("Compact transforms are not computed by this batch");
+
+		static NzCompactTransform dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_compactTransforms[index];
+}
+
+nzUInt32 NzTransformBatch::GetFlags() const
+{
+	return m_flags;
+}
+
+NzMatrix4f NzTransformBatch::GetNormalMatrix(unsigned int index) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!(m_flags & nzTransformBatch_Normal))
+	{
+		NazaraError("Normal matrices are not computed by this batch");
+		return NzMatrix4f::Identity();
+	}
+	#endif
+
+	return NzMatrix4f(&m_normalMatrices[index*16]);
+}
+
+unsigned int NzTransformBatch::GetTransformCount() const
+{
+	return m_worldMatrices.size()/16;
+}
+
+NzMatrix4f NzTransformBatch::GetWorldMatrix(unsigned int index) const
+{
+	return NzMatrix4f(&m_worldMatrices[index*16]);
+}
+
+NzMatrix4f NzTransformBatch::GetWorldViewMatrix(unsigned int index) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!(m_flags & nzTransformBatch_WorldView))
+	{
+		NazaraError("WorldView matrices are not computed by this batch");
+		return NzMatrix4f::Identity();
+	}
+	#endif
+
+	return NzMatrix4f(&m_worldViewMatrices[index*16]);
+}
+
+NzMatrix4f NzTransformBatch::GetWorldViewProjMatrix(unsigned int index) const
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!(m_flags & nzTransformBatch_WorldViewProj))
+	{
+		NazaraError("WorldViewProj matrices are not computed by this batch");
+		return NzMatrix4f::Identity();
+	}
+	#endif
+
+	return NzMatrix4f(&m_worldViewProjMatrices[index*16]);
+}
+
+void NzTransformBatch::Reserve(unsigned int transformCount)
+{
+	m_worldMatrices.reserve(transformCount*16);
+
+	if (m_flags & nzTransformBatch_Compact)
+		m_compactTransforms.reserve(transformCount);
+
+	if (m_flags & nzTransformBatch_Compact3x4)
+		m_compact3x4Matrices.reserve(transformCount*12);
+
+	if (m_flags & nzTransformBatch_Normal)
+		m_normalMatrices.reserve(transformCount*16);
+
+	if (m_flags & nzTransformBatch_WorldView)
+		m_worldViewMatrices.reserve(transformCount*16);
+
+	if (m_flags & nzTransformBatch_WorldViewProj)
+		m_worldViewProjMatrices.reserve(transformCount*16);
+}
+
+void NzTransformBatch::SetFlags(nzUInt32 flags)
+{
+	#if NAZARA_GRAPHICS_SAFE
+	if (!m_worldMatrices.empty())
+	{
+		NazaraError("Flags can only be changed while the batch is empty");
+		return;
+	}
+	#endif
+
+	m_flags = flags;
+}
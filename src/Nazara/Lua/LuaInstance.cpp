@@ -10,6 +10,7 @@
 #include <Nazara/Core/Error.hpp>
 #include <Nazara/Core/File.hpp>
 #include <Nazara/Core/MemoryStream.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <stdexcept>
 #include <unordered_map>
@@ -51,6 +52,12 @@ namespace
 		LUA_OPLE  // nzLuaComparison_LessOrEqual
 	};
 
+	int s_gcModes[nzLuaGCMode_Max+1] = {
+		LUA_GCGEN, // nzLuaGCMode_Generational
+		LUA_GCINC, // nzLuaGCMode_Incremental
+		LUA_GCINC  // nzLuaGCMode_Manual
+	};
+
 	int s_operations[nzLuaOperation_Max+1] = {
 		LUA_OPADD, // nzLuaOperation_Addition
 		LUA_OPDIV, // nzLuaOperation_Division
@@ -76,11 +83,14 @@ namespace
 }
 
 NzLuaInstance::NzLuaInstance() :
+m_gcMode(nzLuaGCMode_Incremental),
 m_memoryLimit(0),
 m_memoryUsage(0),
 m_timeLimit(1000),
 m_level(0)
 {
+	ResetGCStats();
+
 	m_state = lua_newstate(MemoryAllocator, this);
 	lua_atpanic(m_state, AtPanic);
 	lua_sethook(m_state, TimeLimiter, LUA_MASKCOUNT, 1000);
@@ -92,6 +102,26 @@ NzLuaInstance::~NzLuaInstance()
 	lua_close(m_state);
 }
 
+bool NzLuaInstance::Call(unsigned int argCount, unsigned int resultCount)
+{
+	if (m_level++ == 0)
+		m_clock.Restart();
+
+	int status = lua_pcall(m_state, argCount, resultCount, 0);
+
+	m_level--;
+
+	if (status != 0)
+	{
+		m_lastError = lua_tostring(m_state, -1);
+		lua_pop(m_state, 1);
+
+		return false;
+	}
+
+	return true;
+}
+
 void NzLuaInstance::CheckAny(int index) const
 {
 	luaL_checkany(m_state, index);
@@ -170,6 +200,23 @@ void* NzLuaInstance::CheckUserdata(int index, const NzString& tname) const
 	return luaL_checkudata(m_state, index, tname.GetConstBuffer());
 }
 
+void NzLuaInstance::CollectGarbage()
+{
+	nzUInt64 freedBytes = m_gcStats.freedBytes;
+	nzUInt64 start = NzGetMicroseconds();
+
+	lua_gc(m_state, LUA_GCCOLLECT, 0);
+
+	nzUInt64 pauseTime = NzGetMicroseconds() - start;
+
+	m_gcStats.collectedBytes += m_gcStats.freedBytes - freedBytes;
+	m_gcStats.cycleCount++;
+	m_gcStats.lastPauseTime = pauseTime;
+	m_gcStats.maxPauseTime = std::max(m_gcStats.maxPauseTime, pauseTime);
+	m_gcStats.memoryUsageAfterCycle = m_memoryUsage;
+	m_gcStats.totalPauseTime += pauseTime;
+}
+
 bool NzLuaInstance::Compare(int index1, int index2, nzLuaComparison comparison) const
 {
 	#ifdef NAZARA_DEBUG
@@ -279,6 +326,19 @@ int NzLuaInstance::GetAbsIndex(int index) const
 	return lua_absindex(m_state, index);
 }
 
+nzLuaGCMode NzLuaInstance::GetGCMode() const
+{
+	return m_gcMode;
+}
+
+NzLuaGCStats NzLuaInstance::GetGCStats() const
+{
+	NzLuaGCStats stats = m_gcStats;
+	stats.heapGrowth = static_cast<nzInt64>(m_memoryUsage) - stats.memoryUsageAfterCycle;
+
+	return stats;
+}
+
 void NzLuaInstance::GetField(const char* fieldName, int index) const
 {
 	lua_getfield(m_state, index, fieldName);
@@ -579,6 +639,21 @@ void NzLuaInstance::Replace(int index)
 	lua_replace(m_state, index);
 }
 
+void NzLuaInstance::ResetGCStats()
+{
+	m_gcStats.allocatedBytes = 0;
+	m_gcStats.collectedBytes = 0;
+	m_gcStats.cycleCount = 0;
+	m_gcStats.freedBytes = 0;
+	m_gcStats.heapGrowth = 0;
+	m_gcStats.lastPauseTime = 0;
+	m_gcStats.maxPauseTime = 0;
+	m_gcStats.memoryUsageAfterCycle = m_memoryUsage;
+	m_gcStats.peakMemoryUsage = m_memoryUsage;
+	m_gcStats.stepCount = 0;
+	m_gcStats.totalPauseTime = 0;
+}
+
 void NzLuaInstance::SetField(const char* name, int index)
 {
 	lua_setfield(m_state, index, name);
@@ -589,6 +664,32 @@ void NzLuaInstance::SetField(const NzString& name, int index)
 	lua_setfield(m_state, index, name.GetConstBuffer());
 }
 
+void NzLuaInstance::SetGCMode(nzLuaGCMode mode)
+{
+	#ifdef NAZARA_DEBUG
+	if (mode > nzLuaGCMode_Max)
+	{
+		NazaraError("Lua GC mode out of enum");
+		return;
+	}
+	#endif
+
+	if (m_gcMode == mode)
+		return;
+
+	// Le passage en mode générationnel déclenche une collecte complète
+	lua_gc(m_state, s_gcModes[mode], 0);
+	lua_gc(m_state, (mode == nzLuaGCMode_Manual) ? LUA_GCSTOP : LUA_GCRESTART, 0);
+
+	m_gcMode = mode;
+}
+
+void NzLuaInstance::SetGCParameters(int pause, int stepMultiplier)
+{
+	lua_gc(m_state, LUA_GCSETPAUSE, pause);
+	lua_gc(m_state, LUA_GCSETSTEPMUL, stepMultiplier);
+}
+
 void NzLuaInstance::SetGlobal(const char* name)
 {
 	lua_setglobal(m_state, name);
@@ -637,6 +738,43 @@ void NzLuaInstance::SetTimeLimit(nzUInt32 timeLimit)
 	}
 }
 
+bool NzLuaInstance::StepGarbageCollector(nzUInt32 timeBudget, unsigned int maxSteps)
+{
+	///DOC: Le budget est exprimé en microsecondes, au moins une étape est effectuée
+	///     Renvoie vrai si un cycle de collecte s'est terminé pendant l'appel
+	nzUInt64 freedBytes = m_gcStats.freedBytes;
+	nzUInt64 start = NzGetMicroseconds();
+	nzUInt64 now;
+
+	bool cycleFinished = false;
+	unsigned int stepCount = 0;
+	do
+	{
+		// Une étape élémentaire (taille nulle) permet de respecter finement le budget
+		cycleFinished = (lua_gc(m_state, LUA_GCSTEP, 0) != 0);
+		stepCount++;
+
+		now = NzGetMicroseconds();
+	}
+	while (!cycleFinished && (maxSteps == 0 || stepCount < maxSteps) && now - start < timeBudget);
+
+	nzUInt64 pauseTime = now - start;
+
+	m_gcStats.collectedBytes += m_gcStats.freedBytes - freedBytes;
+	m_gcStats.lastPauseTime = pauseTime;
+	m_gcStats.maxPauseTime = std::max(m_gcStats.maxPauseTime, pauseTime);
+	m_gcStats.stepCount += stepCount;
+	m_gcStats.totalPauseTime += pauseTime;
+
+	if (cycleFinished)
+	{
+		m_gcStats.cycleCount++;
+		m_gcStats.memoryUsageAfterCycle = m_memoryUsage;
+	}
+
+	return cycleFinished;
+}
+
 bool NzLuaInstance::ToBoolean(int index) const
 {
 	return lua_toboolean(m_state, index) == 1;
@@ -710,33 +848,25 @@ NzLuaInstance* NzLuaInstance::GetInstance(lua_State* state)
 
 bool NzLuaInstance::Run()
 {
-	if (m_level++ == 0)
-		m_clock.Restart();
-
-	int status = lua_pcall(m_state, 0, 0, 0);
-
-	m_level--;
-
-	if (status != 0)
-	{
-		m_lastError = lua_tostring(m_state, -1);
-		lua_pop(m_state, 1);
-
-		return false;
-	}
-
-	return true;
+	return Call(0);
 }
 
 void* NzLuaInstance::MemoryAllocator(void* ud, void* ptr, std::size_t osize, std::size_t nsize)
 {
 	NzLuaInstance* instance = static_cast<NzLuaInstance*>(ud);
+	NzLuaGCStats& gcStats = instance->m_gcStats;
 	nzUInt32& memoryLimit = instance->m_memoryLimit;
 	nzUInt32& memoryUsage = instance->m_memoryUsage;
 
 	if (nsize == 0)
 	{
-		memoryUsage -= osize;
+		// Si ptr est nul, osize contient le type de l'objet et non une taille
+		if (ptr)
+		{
+			gcStats.freedBytes += osize;
+			memoryUsage -= osize;
+		}
+
 		std::free(ptr);
 
 		return nullptr;
@@ -753,9 +883,19 @@ void* NzLuaInstance::MemoryAllocator(void* ud, void* ptr, std::size_t osize, std
 			return nullptr;
 		}
 
+		void* newPtr = std::realloc(ptr, nsize);
+		if (!newPtr)
+			return nullptr;
+
+		if (usage > memoryUsage)
+			gcStats.allocatedBytes += usage - memoryUsage;
+		else
+			gcStats.freedBytes += memoryUsage - usage;
+
+		gcStats.peakMemoryUsage = std::max(gcStats.peakMemoryUsage, usage);
 		memoryUsage = usage;
 
-		return std::realloc(ptr, nsize);
+		return newPtr;
 	}
 }
 
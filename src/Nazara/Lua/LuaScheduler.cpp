@@ -0,0 +1,505 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Lua scripting module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Lua/LuaScheduler.hpp>
+#include <Lua/lauxlib.h>
+#include <Lua/lua.h>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Lua/Config.hpp>
+#include <Nazara/Lua/LuaInstance.hpp>
+#include <algorithm>
+#include <Nazara/Lua/Debug.hpp>
+
+///DOC: Les fonctions d'attente sont exposées au script via la table globale "Scheduler" :
+///     Scheduler.Wait(secondes), Scheduler.WaitFrames(n), Scheduler.WaitEvent(nom), Scheduler.Yield() et Scheduler.Signal(nom)
+///     Un appel direct à coroutine.yield depuis une tâche est équivalent à Scheduler.Yield()
+
+namespace
+{
+	const unsigned int hookInterval = 1000; // Le même intervalle que le hook de NzLuaInstance
+
+	char s_registryKey; // Seule son adresse nous intéresse
+}
+
+NzLuaScheduler::NzLuaScheduler(NzLuaInstance& instance) :
+m_instance(instance),
+m_frameCount(0),
+m_time(0),
+m_wakeupOrder(0),
+m_instructionBudget(0),
+m_nextJobId(1),
+m_runningJob(0)
+{
+	lua_State* state = m_instance.GetInternalState();
+
+	lua_pushlightuserdata(state, this);
+	lua_rawsetp(state, LUA_REGISTRYINDEX, &s_registryKey);
+
+	m_instance.PushTable(0, 5);
+
+	m_instance.PushCFunction(LuaSignal);
+	m_instance.SetField("Signal");
+
+	m_instance.PushCFunction(LuaWait);
+	m_instance.SetField("Wait");
+
+	m_instance.PushCFunction(LuaWaitEvent);
+	m_instance.SetField("WaitEvent");
+
+	m_instance.PushCFunction(LuaWaitFrames);
+	m_instance.SetField("WaitFrames");
+
+	m_instance.PushCFunction(LuaYield);
+	m_instance.SetField("Yield");
+
+	m_instance.SetGlobal("Scheduler");
+}
+
+NzLuaScheduler::~NzLuaScheduler()
+{
+	Clear();
+
+	lua_State* state = m_instance.GetInternalState();
+	if (GetScheduler(state) == this)
+	{
+		lua_pushnil(state);
+		lua_rawsetp(state, LUA_REGISTRYINDEX, &s_registryKey);
+
+		m_instance.PushNil();
+		m_instance.SetGlobal("Scheduler");
+	}
+}
+
+void NzLuaScheduler::Clear()
+{
+	#if NAZARA_LUA_SAFE
+	if (m_runningJob != 0)
+	{
+		NazaraError("Cannot clear scheduler from a running job");
+		return;
+	}
+	#endif
+
+	lua_State* state = m_instance.GetInternalState();
+	for (auto& pair : m_jobs)
+		luaL_unref(state, LUA_REGISTRYINDEX, pair.second.reference);
+
+	m_eventWaiters.clear();
+	m_jobs.clear();
+	m_readyJobs.clear();
+	m_frameWakeups = WakeupQueue();
+	m_timeWakeups = WakeupQueue();
+}
+
+unsigned int NzLuaScheduler::GetFrameCount() const
+{
+	return static_cast<unsigned int>(m_frameCount);
+}
+
+unsigned int NzLuaScheduler::GetInstructionBudget() const
+{
+	return m_instructionBudget;
+}
+
+NzLuaInstance& NzLuaScheduler::GetInstance() const
+{
+	return m_instance;
+}
+
+unsigned int NzLuaScheduler::GetJobCount() const
+{
+	return m_jobs.size();
+}
+
+NzString NzLuaScheduler::GetLastError() const
+{
+	return m_lastError;
+}
+
+unsigned int NzLuaScheduler::GetReadyJobCount() const
+{
+	return m_readyJobs.size();
+}
+
+double NzLuaScheduler::GetTime() const
+{
+	return m_time/1000000.0;
+}
+
+bool NzLuaScheduler::IsJobAlive(unsigned int jobId) const
+{
+	auto it = m_jobs.find(jobId);
+	return it != m_jobs.end() && !it->second.killed;
+}
+
+void NzLuaScheduler::Kill(unsigned int jobId)
+{
+	auto it = m_jobs.find(jobId);
+	if (it == m_jobs.end())
+		return;
+
+	// On ne peut pas libérer le thread d'une tâche en cours d'exécution, on le fera à la fin de sa reprise
+	if (jobId == m_runningJob)
+		it->second.killed = true;
+	else
+		ReleaseJob(jobId);
+}
+
+void NzLuaScheduler::SetInstructionBudget(unsigned int budget)
+{
+	if (m_instructionBudget != budget)
+	{
+		m_instructionBudget = budget;
+
+		for (auto& pair : m_jobs)
+			ApplyHook(pair.second.thread);
+	}
+}
+
+void NzLuaScheduler::Signal(const NzString& event)
+{
+	auto it = m_eventWaiters.find(event);
+	if (it == m_eventWaiters.end())
+		return;
+
+	for (auto& waiter : it->second)
+		MakeReady(waiter.first, waiter.second);
+
+	m_eventWaiters.erase(it);
+}
+
+unsigned int NzLuaScheduler::Start(int argCount)
+{
+	lua_State* state = m_instance.GetInternalState();
+
+	#if NAZARA_LUA_SAFE
+	if (argCount < 0 || lua_gettop(state) < argCount+1)
+	{
+		NazaraError("Not enough values on the stack");
+		return 0;
+	}
+
+	if (!lua_isfunction(state, -argCount-1))
+	{
+		NazaraError("Job must be a function");
+		lua_pop(state, argCount+1);
+
+		return 0;
+	}
+	#endif
+
+	Job job;
+	job.thread = lua_newthread(state);
+	job.reference = luaL_ref(state, LUA_REGISTRYINDEX); // Empêche le ramasse-miettes de collecter le thread
+	job.argCount = argCount;
+	job.instructionCount = 0;
+	job.killed = false;
+	job.serial = 0;
+	job.waitType = WaitType_None;
+
+	lua_xmove(state, job.thread, argCount+1);
+	ApplyHook(job.thread);
+
+	unsigned int jobId = m_nextJobId++;
+	if (m_nextJobId == 0)
+		m_nextJobId = 1;
+
+	m_jobs[jobId] = job;
+
+	// La tâche démarrera à la prochaine mise à jour
+	MakeReady(jobId, job.serial);
+
+	return jobId;
+}
+
+unsigned int NzLuaScheduler::Start(const NzString& code)
+{
+	lua_State* state = m_instance.GetInternalState();
+	if (luaL_loadstring(state, code.GetConstBuffer()) != 0)
+	{
+		m_lastError = lua_tostring(state, -1);
+		lua_pop(state, 1);
+
+		return 0;
+	}
+
+	return Start(0);
+}
+
+unsigned int NzLuaScheduler::Update(float elapsedTime)
+{
+	#if NAZARA_LUA_SAFE
+	if (m_runningJob != 0)
+	{
+		NazaraError("Cannot update scheduler from a running job");
+		return 0;
+	}
+	#endif
+
+	m_frameCount++;
+	if (elapsedTime > 0.f)
+		m_time += static_cast<nzUInt64>(elapsedTime*1000000.0);
+
+	// Seules les tâches dont la condition est remplie sont visitées, les tâches endormies ne coûtent rien
+	while (!m_timeWakeups.empty() && m_timeWakeups.top().date <= m_time)
+	{
+		const Wakeup& wakeup = m_timeWakeups.top();
+		MakeReady(wakeup.jobId, wakeup.serial);
+
+		m_timeWakeups.pop();
+	}
+
+	while (!m_frameWakeups.empty() && m_frameWakeups.top().date <= m_frameCount)
+	{
+		const Wakeup& wakeup = m_frameWakeups.top();
+		MakeReady(wakeup.jobId, wakeup.serial);
+
+		m_frameWakeups.pop();
+	}
+
+	// Les tâches réveillées pendant cette mise à jour (Signal, Start) attendront la suivante
+	std::swap(m_readyJobs, m_resumedJobs);
+
+	unsigned int resumedCount = 0;
+	for (auto& pair : m_resumedJobs)
+	{
+		auto it = m_jobs.find(pair.first);
+		if (it == m_jobs.end() || it->second.serial != pair.second || it->second.killed)
+			continue; // Tâche tuée ou réveil obsolète
+
+		Resume(pair.first);
+		resumedCount++;
+	}
+
+	m_resumedJobs.clear();
+
+	return resumedCount;
+}
+
+bool NzLuaScheduler::Wakeup::operator>(const Wakeup& wakeup) const
+{
+	if (date != wakeup.date)
+		return date > wakeup.date;
+	else
+		return order > wakeup.order; // Ordre de réveil déterministe à date égale
+}
+
+void NzLuaScheduler::ApplyHook(lua_State* thread) const
+{
+	unsigned int count = hookInterval;
+	if (m_instructionBudget > 0)
+	{
+		// On découpe le budget en intervalles égaux ne dépassant pas celui du hook de temps
+		unsigned int steps = (m_instructionBudget + hookInterval - 1)/hookInterval;
+		count = (m_instructionBudget + steps - 1)/steps;
+	}
+
+	lua_sethook(thread, InstructionLimiter, LUA_MASKCOUNT, count);
+}
+
+NzLuaScheduler::Job* NzLuaScheduler::GetRunningJob(lua_State* state, const char* function)
+{
+	auto it = m_jobs.find(m_runningJob);
+	if (it == m_jobs.end() || it->second.thread != state)
+		luaL_error(state, "Scheduler.%s can only be called from a scheduled job", function);
+
+	return &it->second;
+}
+
+void NzLuaScheduler::MakeReady(unsigned int jobId, unsigned int serial)
+{
+	m_readyJobs.push_back(std::make_pair(jobId, serial));
+}
+
+void NzLuaScheduler::ReleaseJob(unsigned int jobId)
+{
+	auto it = m_jobs.find(jobId);
+	Job& job = it->second;
+
+	if (job.waitType == WaitType_Event)
+	{
+		auto waitersIt = m_eventWaiters.find(job.event);
+		if (waitersIt != m_eventWaiters.end())
+		{
+			auto& waiters = waitersIt->second;
+			waiters.erase(std::remove(waiters.begin(), waiters.end(), std::make_pair(jobId, job.serial)), waiters.end());
+			if (waiters.empty())
+				m_eventWaiters.erase(waitersIt);
+		}
+	}
+
+	luaL_unref(m_instance.GetInternalState(), LUA_REGISTRYINDEX, job.reference);
+	m_jobs.erase(it);
+}
+
+void NzLuaScheduler::Resume(unsigned int jobId)
+{
+	Job& job = m_jobs[jobId];
+	job.event.Clear(false);
+	job.instructionCount = 0;
+	job.waitType = WaitType_None;
+
+	int argCount = job.argCount;
+	job.argCount = 0;
+
+	lua_State* thread = job.thread;
+
+	// Même comportement que NzLuaInstance::Run vis-à-vis de la limite de temps
+	if (m_instance.m_level++ == 0)
+		m_instance.m_clock.Restart();
+
+	m_runningJob = jobId;
+	int status = lua_resume(thread, m_instance.GetInternalState(), argCount);
+	m_runningJob = 0;
+
+	m_instance.m_level--;
+
+	// La table a pu être modifiée pendant l'exécution (nouvelles tâches), la référence n'est plus valide
+	Job& resumedJob = m_jobs[jobId];
+	if (status == LUA_YIELD && !resumedJob.killed)
+	{
+		// Les valeurs passées à coroutine.yield n'ont pas d'utilité pour nous
+		lua_settop(thread, 0);
+
+		// Appel direct à coroutine.yield : la tâche reprendra à la prochaine image
+		if (resumedJob.waitType == WaitType_None)
+		{
+			Suspend(resumedJob, WaitType_Frame);
+
+			Wakeup wakeup;
+			wakeup.date = m_frameCount + 1;
+			wakeup.jobId = jobId;
+			wakeup.order = m_wakeupOrder++;
+			wakeup.serial = resumedJob.serial;
+
+			m_frameWakeups.push(wakeup);
+		}
+	}
+	else
+	{
+		if (status != LUA_OK && status != LUA_YIELD)
+		{
+			const char* error = lua_tostring(thread, -1);
+			m_lastError = (error) ? error : "Unknown error";
+		}
+
+		ReleaseJob(jobId);
+	}
+}
+
+void NzLuaScheduler::Suspend(Job& job, WaitType waitType)
+{
+	// Invalide les éventuels réveils encore en attente pour cette tâche
+	job.serial++;
+	job.waitType = waitType;
+}
+
+void NzLuaScheduler::InstructionLimiter(lua_State* state, lua_Debug* debug)
+{
+	NzLuaScheduler* scheduler = GetScheduler(state);
+	if (scheduler && scheduler->m_instructionBudget > 0)
+	{
+		auto it = scheduler->m_jobs.find(scheduler->m_runningJob);
+		if (it != scheduler->m_jobs.end())
+		{
+			it->second.instructionCount += lua_gethookcount(state);
+			if (it->second.instructionCount >= scheduler->m_instructionBudget)
+				luaL_error(state, "maximum instruction count exceeded");
+		}
+	}
+
+	if (NzLuaInstance::GetInstance(state)->m_timeLimit > 0)
+		NzLuaInstance::TimeLimiter(state, debug);
+}
+
+NzLuaScheduler* NzLuaScheduler::GetScheduler(lua_State* state)
+{
+	lua_rawgetp(state, LUA_REGISTRYINDEX, &s_registryKey);
+	NzLuaScheduler* scheduler = static_cast<NzLuaScheduler*>(lua_touserdata(state, -1));
+	lua_pop(state, 1);
+
+	return scheduler;
+}
+
+int NzLuaScheduler::LuaSignal(lua_State* state)
+{
+	NzLuaScheduler* scheduler = GetScheduler(state);
+	const char* event = luaL_checkstring(state, 1);
+
+	scheduler->Signal(event);
+
+	return 0;
+}
+
+// Attention : lua_yield ne revient pas (longjmp), aucun objet à destructeur ne doit vivre dans la portée de l'appel
+
+int NzLuaScheduler::LuaWait(lua_State* state)
+{
+	NzLuaScheduler* scheduler = GetScheduler(state);
+	Job* job = scheduler->GetRunningJob(state, "Wait");
+	double delay = luaL_checknumber(state, 1);
+
+	scheduler->Suspend(*job, WaitType_Time);
+
+	Wakeup wakeup;
+	wakeup.date = scheduler->m_time + static_cast<nzUInt64>(std::max(delay, 0.0)*1000000.0);
+	wakeup.jobId = scheduler->m_runningJob;
+	wakeup.order = scheduler->m_wakeupOrder++;
+	wakeup.serial = job->serial;
+
+	scheduler->m_timeWakeups.push(wakeup);
+
+	return lua_yield(state, 0);
+}
+
+int NzLuaScheduler::LuaWaitEvent(lua_State* state)
+{
+	NzLuaScheduler* scheduler = GetScheduler(state);
+	Job* job = scheduler->GetRunningJob(state, "WaitEvent");
+	const char* event = luaL_checkstring(state, 1);
+
+	scheduler->Suspend(*job, WaitType_Event);
+	job->event = event;
+
+	scheduler->m_eventWaiters[job->event].push_back(std::make_pair(scheduler->m_runningJob, job->serial));
+
+	return lua_yield(state, 0);
+}
+
+int NzLuaScheduler::LuaWaitFrames(lua_State* state)
+{
+	NzLuaScheduler* scheduler = GetScheduler(state);
+	Job* job = scheduler->GetRunningJob(state, "WaitFrames");
+	int frameCount = std::max(luaL_optint(state, 1, 1), 1);
+
+	scheduler->Suspend(*job, WaitType_Frame);
+
+	Wakeup wakeup;
+	wakeup.date = scheduler->m_frameCount + frameCount;
+	wakeup.jobId = scheduler->m_runningJob;
+	wakeup.order = scheduler->m_wakeupOrder++;
+	wakeup.serial = job->serial;
+
+	scheduler->m_frameWakeups.push(wakeup);
+
+	return lua_yield(state, 0);
+}
+
+int NzLuaScheduler::LuaYield(lua_State* state)
+{
+	NzLuaScheduler* scheduler = GetScheduler(state);
+	Job* job = scheduler->GetRunningJob(state, "Yield");
+
+	scheduler->Suspend(*job, WaitType_Frame);
+
+	Wakeup wakeup;
+	wakeup.date = scheduler->m_frameCount + 1;
+	wakeup.jobId = scheduler->m_runningJob;
+	wakeup.order = scheduler->m_wakeupOrder++;
+	wakeup.serial = job->serial;
+
+	scheduler->m_frameWakeups.push(wakeup);
+
+	return lua_yield(state, 0);
+}
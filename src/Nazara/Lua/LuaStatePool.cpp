@@ -0,0 +1,507 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Lua scripting module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Lua/LuaStatePool.hpp>
+#include <Lua/lauxlib.h>
+#include <Lua/lua.h>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <Nazara/Lua/Config.hpp>
+#include <Nazara/Lua/LuaInstance.hpp>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <Nazara/Lua/Debug.hpp>
+
+///DOC: API exposée à chaque état :
+///     Pool.Send(cible, nom[, données[, valeur]]) : message délivré à l'entité cible lors de sa prochaine mise à jour
+///     Pool.Emit(nom[, données[, valeur]]) : effet transmis au moteur (voir GetEffects)
+///     Pool.Receive() : renvoie le prochain message reçu (nom, données, valeur, source) ou nil
+///     Pool.GetEntity() : identifiant de l'entité en cours de mise à jour
+///     Shared.<nom> : copie en lecture seule des données partagées par le moteur (voir SetShared)
+///     La fonction de mise à jour est appelée avec (entité, temps écoulé)
+
+namespace
+{
+	char s_registryKey; // Seule son adresse nous intéresse
+
+	bool DefaultInitializer(NzLuaInstance& instance)
+	{
+		NazaraUnused(instance);
+
+		return true;
+	}
+}
+
+struct NzLuaStatePool::State
+{
+	NzLuaInstance instance;
+	std::unordered_map<unsigned int, std::vector<NzLuaMessage>> inbox;
+	std::vector<NzLuaMessage> outbox;
+	std::vector<NzLuaMessage> received;
+	std::vector<unsigned int> entities;
+	NzString error;
+	unsigned int currentEntity;
+	unsigned int receivedPosition;
+	unsigned int sharedVersion;
+};
+
+NzLuaStatePool::~NzLuaStatePool()
+{
+	Destroy();
+}
+
+bool NzLuaStatePool::Create(unsigned int stateCount)
+{
+	return Create(stateCount, DefaultInitializer);
+}
+
+bool NzLuaStatePool::Create(unsigned int stateCount, NzFunctionRef<bool(NzLuaInstance& instance)> initializer)
+{
+	Destroy();
+
+	if (!NzTaskScheduler::Initialize())
+	{
+		NazaraError("Failed to initialize task scheduler");
+		return false;
+	}
+
+	// Un état par worker par défaut
+	if (stateCount == 0)
+		stateCount = NzTaskScheduler::GetWorkerCount();
+
+	m_states.reserve(stateCount);
+	for (unsigned int i = 0; i < stateCount; ++i)
+	{
+		std::unique_ptr<State> state(new State);
+		state->currentEntity = Engine;
+		state->receivedPosition = 0;
+
+		NzLuaInstance& instance = state->instance;
+		lua_State* luaState = instance.GetInternalState();
+
+		lua_pushlightuserdata(luaState, state.get());
+		lua_rawsetp(luaState, LUA_REGISTRYINDEX, &s_registryKey);
+
+		instance.PushTable(0, 4);
+
+		instance.PushCFunction(LuaEmit);
+		instance.SetField("Emit");
+
+		instance.PushCFunction(LuaGetEntity);
+		instance.SetField("GetEntity");
+
+		instance.PushCFunction(LuaReceive);
+		instance.SetField("Receive");
+
+		instance.PushCFunction(LuaSend);
+		instance.SetField("Send");
+
+		instance.SetGlobal("Pool");
+
+		UpdateShared(*state);
+
+		m_states.emplace_back(std::move(state));
+
+		// Les bindings et scripts doivent être identiques d'un état à l'autre
+		if (!initializer(instance))
+		{
+			NazaraError("Failed to initialize state #" + NzString::Number(i));
+			Destroy();
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void NzLuaStatePool::Destroy()
+{
+	m_effects.clear();
+	m_messages.clear();
+	m_states.clear();
+}
+
+bool NzLuaStatePool::Execute(const NzString& code)
+{
+	#if NAZARA_LUA_SAFE
+	if (m_states.empty())
+	{
+		NazaraError("State pool not created");
+		return false;
+	}
+	#endif
+
+	for (auto& state : m_states)
+	{
+		if (!state->instance.Execute(code))
+		{
+			m_lastError = state->instance.GetLastError();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool NzLuaStatePool::ExecuteFromFile(const NzString& filePath)
+{
+	#if NAZARA_LUA_SAFE
+	if (m_states.empty())
+	{
+		NazaraError("State pool not created");
+		return false;
+	}
+	#endif
+
+	for (auto& state : m_states)
+	{
+		if (!state->instance.ExecuteFromFile(filePath))
+		{
+			m_lastError = state->instance.GetLastError();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const std::vector<NzLuaMessage>& NzLuaStatePool::GetEffects() const
+{
+	return m_effects;
+}
+
+NzString NzLuaStatePool::GetLastError() const
+{
+	return m_lastError;
+}
+
+NzLuaInstance& NzLuaStatePool::GetState(unsigned int index) const
+{
+	#if NAZARA_LUA_SAFE
+	if (index >= m_states.size())
+	{
+		NazaraError("State index out of range (" + NzString::Number(index) + " >= " + NzString::Number(m_states.size()) + ')');
+		throw std::out_of_range("NzLuaStatePool::GetState() : State index out of range");
+	}
+	#endif
+
+	return m_states[index]->instance;
+}
+
+unsigned int NzLuaStatePool::GetStateCount() const
+{
+	return m_states.size();
+}
+
+unsigned int NzLuaStatePool::GetStateIndex(unsigned int entityId) const
+{
+	// Une entité reste toujours dans le même état, ses variables y persistent d'une mise à jour à l'autre
+	return entityId % m_states.size();
+}
+
+bool NzLuaStatePool::IsValid() const
+{
+	return !m_states.empty();
+}
+
+void NzLuaStatePool::Post(unsigned int target, const NzString& name, const NzString& data, double value)
+{
+	#if NAZARA_LUA_SAFE
+	if (m_states.empty())
+	{
+		NazaraError("State pool not created");
+		return;
+	}
+
+	if (target == Engine)
+	{
+		NazaraError("Invalid target");
+		return;
+	}
+	#endif
+
+	NzLuaMessage message;
+	message.data = data;
+	message.name = name;
+	message.source = Engine;
+	message.target = target;
+	message.value = value;
+
+	m_states[GetStateIndex(target)]->inbox[target].push_back(std::move(message));
+}
+
+void NzLuaStatePool::RemoveEntity(unsigned int entityId)
+{
+	if (m_states.empty())
+		return;
+
+	// Supprime les messages en attente pour cette entité
+	m_states[GetStateIndex(entityId)]->inbox.erase(entityId);
+}
+
+void NzLuaStatePool::SetShared(const NzString& name, double value)
+{
+	SharedValue& shared = m_shared[name];
+	shared.isString = false;
+	shared.number = value;
+	shared.string.Clear(false);
+
+	m_sharedVersion++;
+}
+
+void NzLuaStatePool::SetShared(const NzString& name, const NzString& value)
+{
+	SharedValue& shared = m_shared[name];
+	shared.isString = true;
+	shared.number = 0.0;
+	shared.string = value;
+
+	m_sharedVersion++;
+}
+
+bool NzLuaStatePool::Update(const NzString& functionName, const unsigned int* entities, unsigned int entityCount, float elapsedTime)
+{
+	#if NAZARA_LUA_SAFE
+	if (m_states.empty())
+	{
+		NazaraError("State pool not created");
+		return false;
+	}
+	#endif
+
+	m_effects.clear();
+	m_elapsedTime = elapsedTime;
+	m_functionName = functionName;
+
+	for (auto& state : m_states)
+	{
+		state->entities.clear();
+		state->error.Clear(false);
+	}
+
+	for (unsigned int i = 0; i < entityCount; ++i)
+		m_states[GetStateIndex(entities[i])]->entities.push_back(entities[i]);
+
+	unsigned int stateCount = m_states.size();
+	if (stateCount > 1 && NzTaskScheduler::GetWorkerCount() > 1)
+	{
+		// Chaque état n'est manipulé que par une seule tâche à la fois
+		for (unsigned int i = 0; i < stateCount; ++i)
+			NzTaskScheduler::AddTask([this, i]() { UpdateState(i); });
+
+		NzTaskScheduler::WaitForTasks();
+	}
+	else
+	{
+		for (unsigned int i = 0; i < stateCount; ++i)
+			UpdateState(i);
+	}
+
+	MergeMessages();
+
+	bool succeeded = true;
+	for (auto& state : m_states)
+	{
+		if (!state->error.IsEmpty())
+		{
+			if (succeeded)
+			{
+				m_lastError = state->error;
+				succeeded = false;
+			}
+		}
+	}
+
+	return succeeded;
+}
+
+void NzLuaStatePool::MergeMessages()
+{
+	m_messages.clear();
+	for (auto& state : m_states)
+	{
+		std::move(state->outbox.begin(), state->outbox.end(), std::back_inserter(m_messages));
+		state->outbox.clear();
+	}
+
+	// Une entité n'est mise à jour que par un seul état, dans l'ordre de ses envois :
+	// un tri stable sur la source donne le même ordre quel que soit le nombre d'états
+	std::stable_sort(m_messages.begin(), m_messages.end(), [](const NzLuaMessage& message1, const NzLuaMessage& message2)
+	{
+		return message1.source < message2.source;
+	});
+
+	for (NzLuaMessage& message : m_messages)
+	{
+		if (message.target == Engine)
+			m_effects.push_back(std::move(message));
+		else
+			m_states[GetStateIndex(message.target)]->inbox[message.target].push_back(std::move(message));
+	}
+
+	m_messages.clear();
+}
+
+void NzLuaStatePool::UpdateShared(State& state)
+{
+	NzLuaInstance& instance = state.instance;
+
+	// Les valeurs sont copiées dans chaque état, aucune donnée n'est partagée entre les threads
+	instance.PushTable(0, m_shared.size());
+	for (auto& pair : m_shared)
+	{
+		const SharedValue& shared = pair.second;
+		if (shared.isString)
+			instance.PushString(shared.string);
+		else
+			instance.PushNumber(shared.number);
+
+		instance.SetField(pair.first);
+	}
+
+	// Table mandataire en lecture seule
+	instance.PushTable();
+	instance.PushTable(0, 2);
+
+	instance.PushValue(-3);
+	instance.SetField("__index");
+
+	instance.PushCFunction(LuaReadOnly);
+	instance.SetField("__newindex");
+
+	instance.SetMetatable(-2);
+	instance.SetGlobal("Shared");
+
+	instance.Pop();
+
+	state.sharedVersion = m_sharedVersion;
+}
+
+void NzLuaStatePool::UpdateState(unsigned int index)
+{
+	State& state = *m_states[index];
+	if (state.sharedVersion != m_sharedVersion)
+		UpdateShared(state);
+
+	NzLuaInstance& instance = state.instance;
+	for (unsigned int entity : state.entities)
+	{
+		auto it = state.inbox.find(entity);
+		if (it != state.inbox.end())
+		{
+			state.received.swap(it->second);
+			state.inbox.erase(it);
+		}
+
+		state.currentEntity = entity;
+		state.receivedPosition = 0;
+
+		instance.GetGlobal(m_functionName);
+		instance.PushUnsigned(entity);
+		instance.PushNumber(m_elapsedTime);
+
+		if (!instance.Call(2) && state.error.IsEmpty())
+			state.error = instance.GetLastError();
+
+		// Les messages non lus sont perdus
+		state.received.clear();
+	}
+
+	state.currentEntity = Engine;
+}
+
+NzLuaStatePool::State* NzLuaStatePool::GetPoolState(lua_State* state)
+{
+	lua_rawgetp(state, LUA_REGISTRYINDEX, &s_registryKey);
+	State* poolState = static_cast<State*>(lua_touserdata(state, -1));
+	lua_pop(state, 1);
+
+	return poolState;
+}
+
+// Attention : les erreurs Lua font un longjmp, les arguments doivent être vérifiés avant de construire le moindre objet
+
+int NzLuaStatePool::LuaEmit(lua_State* state)
+{
+	State* poolState = GetPoolState(state);
+	const char* name = luaL_checkstring(state, 1);
+	const char* data = luaL_optstring(state, 2, "");
+	double value = luaL_optnumber(state, 3, 0.0);
+
+	if (poolState->currentEntity == Engine)
+		return luaL_error(state, "Pool.Emit can only be called from an entity update");
+
+	poolState->outbox.push_back(NzLuaMessage());
+
+	NzLuaMessage& message = poolState->outbox.back();
+	message.data = data;
+	message.name = name;
+	message.source = poolState->currentEntity;
+	message.target = Engine;
+	message.value = value;
+
+	return 0;
+}
+
+int NzLuaStatePool::LuaGetEntity(lua_State* state)
+{
+	State* poolState = GetPoolState(state);
+	if (poolState->currentEntity == Engine)
+		return 0;
+
+	lua_pushunsigned(state, poolState->currentEntity);
+	return 1;
+}
+
+int NzLuaStatePool::LuaReadOnly(lua_State* state)
+{
+	return luaL_error(state, "Shared is read-only");
+}
+
+int NzLuaStatePool::LuaReceive(lua_State* state)
+{
+	State* poolState = GetPoolState(state);
+	if (poolState->receivedPosition >= poolState->received.size())
+		return 0;
+
+	const NzLuaMessage& message = poolState->received[poolState->receivedPosition++];
+	lua_pushlstring(state, message.name.GetConstBuffer(), message.name.GetSize());
+	lua_pushlstring(state, message.data.GetConstBuffer(), message.data.GetSize());
+	lua_pushnumber(state, message.value);
+	if (message.source == Engine)
+		lua_pushnil(state);
+	else
+		lua_pushunsigned(state, message.source);
+
+	return 4;
+}
+
+int NzLuaStatePool::LuaSend(lua_State* state)
+{
+	State* poolState = GetPoolState(state);
+	unsigned int target = luaL_checkunsigned(state, 1);
+	const char* name = luaL_checkstring(state, 2);
+	const char* data = luaL_optstring(state, 3, "");
+	double value = luaL_optnumber(state, 4, 0.0);
+
+	if (poolState->currentEntity == Engine)
+		return luaL_error(state, "Pool.Send can only be called from an entity update");
+
+	if (target == Engine)
+		return luaL_error(state, "Invalid target (use Pool.Emit to send effects to the engine)");
+
+	poolState->outbox.push_back(NzLuaMessage());
+
+	NzLuaMessage& message = poolState->outbox.back();
+	message.data = data;
+	message.name = name;
+	message.source = poolState->currentEntity;
+	message.target = target;
+	message.value = value;
+
+	return 0;
+}
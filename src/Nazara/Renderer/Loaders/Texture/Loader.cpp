@@ -4,6 +4,7 @@
 
 #include <Nazara/Renderer/Loaders/Texture.hpp>
 #include <Nazara/Renderer/Material.hpp>
+#include <Nazara/Renderer/MaterialRegistry.hpp>
 #include <Nazara/Renderer/Texture.hpp>
 #include <memory>
 #include <Nazara/Renderer/Debug.hpp>
@@ -20,7 +21,22 @@ namespace
 
 	bool Load(NzMaterial* material, NzInputStream& stream, const NzMaterialParams& parameters)
 	{
-		NazaraUnused(parameters);
+		// Une même image chargée par plusieurs matériaux ne donne qu'une texture, ce qui permet de fusionner ces matériaux
+		NzString filePath = stream.GetPath();
+		if (parameters.shareTextures && !filePath.IsEmpty())
+		{
+			NzTexture* texture = NzMaterialRegistry::GetTexture(filePath);
+			if (!texture)
+			{
+				NazaraError("Failed to load diffuse map");
+				return false;
+			}
+
+			material->Reset();
+			material->SetDiffuseMap(texture);
+
+			return true;
+		}
 
 		std::unique_ptr<NzTexture> texture(new NzTexture);
 		texture->SetPersistent(false);
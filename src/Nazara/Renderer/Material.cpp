@@ -7,9 +7,53 @@
 #include <Nazara/Renderer/ShaderProgram.hpp>
 #include <Nazara/Renderer/ShaderProgramManager.hpp>
 #include <cstring>
+#include <cstdint>
 #include <memory>
 #include <Nazara/Renderer/Debug.hpp>
 
+namespace
+{
+	class KeyBuilder
+	{
+		public:
+			KeyBuilder(std::vector<nzUInt32>& key) :
+			m_key(key)
+			{
+				m_key.clear();
+			}
+
+			void Add(float value)
+			{
+				if (value == 0.f)
+					value = 0.f; // -0 et 0 sont équivalents
+
+				nzUInt32 word;
+				std::memcpy(&word, &value, sizeof(float));
+				m_key.push_back(word);
+			}
+
+			void Add(nzUInt32 value)
+			{
+				m_key.push_back(value);
+			}
+
+			void Add(const NzColor& color)
+			{
+				m_key.push_back((static_cast<nzUInt32>(color.r) << 24) | (static_cast<nzUInt32>(color.g) << 16) | (static_cast<nzUInt32>(color.b) << 8) | static_cast<nzUInt32>(color.a));
+			}
+
+			void AddPointer(const void* pointer)
+			{
+				nzUInt64 value = reinterpret_cast<std::uintptr_t>(pointer);
+				m_key.push_back(static_cast<nzUInt32>(value));
+				m_key.push_back(static_cast<nzUInt32>(value >> 32));
+			}
+
+		private:
+			std::vector<nzUInt32>& m_key;
+	};
+}
+
 bool NzMaterialParams::IsValid() const
 {
 	return true;
@@ -152,6 +196,23 @@ void NzMaterial::Apply(const NzShaderProgram* program) const
 	NzRenderer::SetRenderStates(m_states);
 }
 
+nzUInt64 NzMaterial::ComputeHash() const
+{
+	///DOC: Deux matériaux équivalents (voir IsEquivalent) ont le même hash
+	std::vector<nzUInt32> key;
+	BuildKey(&key);
+
+	// FNV-1a
+	nzUInt64 h = 14695981039346656037ULL;
+	for (nzUInt32 word : key)
+	{
+		h ^= word;
+		h *= 1099511628211ULL;
+	}
+
+	return h;
+}
+
 void NzMaterial::Enable(nzRendererParameter renderParameter, bool enable)
 {
 	#ifdef NAZARA_DEBUG
@@ -348,6 +409,21 @@ bool NzMaterial::IsEnabled(nzRendererParameter parameter) const
 	return m_states.parameters[parameter];
 }
 
+bool NzMaterial::IsEquivalent(const NzMaterial& material) const
+{
+	///DOC: Compare le contenu des matériaux (couleurs, états, samplers, textures, programmes personnalisés)
+	if (this == &material)
+		return true;
+
+	std::vector<nzUInt32> key;
+	BuildKey(&key);
+
+	std::vector<nzUInt32> otherKey;
+	material.BuildKey(&otherKey);
+
+	return key == otherKey;
+}
+
 bool NzMaterial::IsLightingEnabled() const
 {
 	return m_lightingEnabled;
@@ -654,48 +730,101 @@ NzMaterial* NzMaterial::GetDefault()
 	return s_defaultMaterial;
 }
 
-void NzMaterial::Copy(const NzMaterial& material)
+void NzMaterial::BuildKey(std::vector<nzUInt32>* key) const
 {
-	m_alphaMap.Reset();
-	m_diffuseMap.Reset();
-	m_emissiveMap.Reset();
-	m_heightMap.Reset();
-	m_normalMap.Reset();
-	m_specularMap.Reset();
+	// Sérialisation canonique de l'état du matériau (les programmes générés en découlent et sont ignorés)
+	KeyBuilder builder(*key);
 
-	for (unsigned int i = 0; i <= nzShaderTarget_Max; ++i)
-		for (ProgramUnit& unit : m_programs[i])
-			unit.program.Reset();
+	builder.Add(m_ambientColor);
+	builder.Add(m_diffuseColor);
+	builder.Add(m_specularColor);
+
+	for (const NzRenderStates::Face* face : {&m_states.backFace, &m_states.frontFace})
+	{
+		builder.Add(static_cast<nzUInt32>(face->stencilCompare));
+		builder.Add(static_cast<nzUInt32>(face->stencilFail));
+		builder.Add(static_cast<nzUInt32>(face->stencilPass));
+		builder.Add(static_cast<nzUInt32>(face->stencilZFail));
+		builder.Add(static_cast<nzUInt32>(face->stencilMask));
+		builder.Add(static_cast<nzUInt32>(face->stencilReference));
+	}
 
-	std::memcpy(this, &material, sizeof(NzMaterial)); // Autorisé dans notre cas, et bien plus rapide
+	builder.Add(static_cast<nzUInt32>(m_states.dstBlend));
+	builder.Add(static_cast<nzUInt32>(m_states.srcBlend));
+	builder.Add(static_cast<nzUInt32>(m_states.faceFilling));
+	builder.Add(static_cast<nzUInt32>(m_states.faceCulling));
+	builder.Add(static_cast<nzUInt32>(m_states.depthFunc));
 
-	// Ensuite une petite astuce pour récupérer correctement les références
-	m_alphaMap.Release();
-	m_diffuseMap.Release();
-	m_emissiveMap.Release();
-	m_heightMap.Release();
-	m_normalMap.Release();
-	m_specularMap.Release();
+	nzUInt32 parameters = 0;
+	for (unsigned int i = 0; i <= nzRendererParameter_Max; ++i)
+	{
+		if (m_states.parameters[i])
+			parameters |= 1U << i;
+	}
+	builder.Add(parameters);
 
-	m_alphaMap = material.m_alphaMap;
-	m_diffuseMap = material.m_diffuseMap;
-	m_emissiveMap = material.m_emissiveMap;
-	m_heightMap = material.m_heightMap;
-	m_normalMap = material.m_normalMap;
-	m_specularMap = material.m_specularMap;
+	builder.Add(m_states.lineWidth);
+	builder.Add(m_states.pointSize);
+
+	for (const NzTextureSampler* sampler : {&m_diffuseSampler, &m_specularSampler})
+	{
+		builder.Add(static_cast<nzUInt32>(sampler->GetAnisotropicLevel()));
+		builder.Add(static_cast<nzUInt32>(sampler->GetFilterMode()));
+		builder.Add(static_cast<nzUInt32>(sampler->GetWrapMode()));
+	}
+
+	// Les textures sont comparées par identité, d'où l'intérêt de les partager (voir NzMaterialRegistry::GetTexture)
+	builder.AddPointer(m_alphaMap);
+	builder.AddPointer(m_diffuseMap);
+	builder.AddPointer(m_emissiveMap);
+	builder.AddPointer(m_heightMap);
+	builder.AddPointer(m_normalMap);
+	builder.AddPointer(m_specularMap);
+
+	builder.Add(static_cast<nzUInt32>((m_alphaTestEnabled) ? 1 : 0) | ((m_lightingEnabled) ? 2 : 0));
+	builder.Add(m_alphaThreshold);
+	builder.Add(m_shininess);
 
 	for (unsigned int i = 0; i <= nzShaderTarget_Max; ++i)
 	{
 		for (unsigned int j = 0; j <= nzShaderFlags_Max; ++j)
 		{
-			NzShaderProgramConstRef& program = m_programs[i][j].program;
-
-			program.Release();
-			program = material.m_programs[i][j].program;
+			const ProgramUnit& unit = m_programs[i][j];
+			if (unit.custom)
+			{
+				builder.Add(static_cast<nzUInt32>(i*(nzShaderFlags_Max+1) + j));
+				builder.AddPointer(unit.program);
+			}
 		}
 	}
 }
 
+void NzMaterial::Copy(const NzMaterial& material)
+{
+	// Copie membre à membre, la partie NzResource (références, listeners) restant propre à chaque instance
+	m_ambientColor = material.m_ambientColor;
+	m_diffuseColor = material.m_diffuseColor;
+	m_specularColor = material.m_specularColor;
+	m_states = material.m_states;
+
+	for (unsigned int i = 0; i <= nzShaderTarget_Max; ++i)
+		for (unsigned int j = 0; j <= nzShaderFlags_Max; ++j)
+			m_programs[i][j] = material.m_programs[i][j];
+
+	m_diffuseSampler = material.m_diffuseSampler;
+	m_specularSampler = material.m_specularSampler;
+	m_alphaMap = material.m_alphaMap;
+	m_diffuseMap = material.m_diffuseMap;
+	m_emissiveMap = material.m_emissiveMap;
+	m_heightMap = material.m_heightMap;
+	m_normalMap = material.m_normalMap;
+	m_specularMap = material.m_specularMap;
+	m_alphaTestEnabled = material.m_alphaTestEnabled;
+	m_lightingEnabled = material.m_lightingEnabled;
+	m_alphaThreshold = material.m_alphaThreshold;
+	m_shininess = material.m_shininess;
+}
+
 void NzMaterial::GenerateProgram(nzShaderTarget target, nzUInt32 flags) const
 {
 	NzShaderProgramManagerParams params;
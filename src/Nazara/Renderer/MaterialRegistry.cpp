@@ -0,0 +1,139 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Renderer/MaterialRegistry.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/File.hpp>
+#include <Nazara/Renderer/Config.hpp>
+#include <memory>
+#include <unordered_map>
+#include <Nazara/Renderer/Debug.hpp>
+
+namespace
+{
+	std::unordered_multimap<nzUInt64, NzMaterialRef> s_materials;
+	std::unordered_map<NzString, NzTextureRef> s_textures;
+	unsigned int s_mergeCount = 0;
+}
+
+void NzMaterialRegistry::Clear()
+{
+	s_materials.clear();
+	s_textures.clear();
+	s_mergeCount = 0;
+}
+
+NzMaterial* NzMaterialRegistry::Find(const NzMaterial& material)
+{
+	auto range = s_materials.equal_range(material.ComputeHash());
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second->IsEquivalent(material))
+			return it->second;
+	}
+
+	return nullptr;
+}
+
+unsigned int NzMaterialRegistry::GetMaterialCount()
+{
+	return s_materials.size();
+}
+
+unsigned int NzMaterialRegistry::GetMergeCount()
+{
+	return s_mergeCount;
+}
+
+NzTexture* NzMaterialRegistry::GetTexture(const NzString& filePath)
+{
+	NzString path = NzFile::AbsolutePath(filePath);
+
+	auto it = s_textures.find(path);
+	if (it != s_textures.end())
+		return it->second;
+
+	std::unique_ptr<NzTexture> texture(new NzTexture);
+	texture->SetPersistent(false);
+
+	if (!texture->LoadFromFile(path))
+	{
+		NazaraError("Failed to load texture from \"" + path + '"');
+		return nullptr;
+	}
+
+	s_textures[path] = texture.get();
+
+	return texture.release();
+}
+
+unsigned int NzMaterialRegistry::GetTextureCount()
+{
+	return s_textures.size();
+}
+
+unsigned int NzMaterialRegistry::Purge()
+{
+	///DOC: Libère les matériaux, puis les textures, qui ne sont plus référencés que par le registre
+	unsigned int count = 0;
+
+	for (auto it = s_materials.begin(); it != s_materials.end();)
+	{
+		if (it->second->GetResourceReferenceCount() == 1)
+		{
+			it = s_materials.erase(it);
+			count++;
+		}
+		else
+			++it;
+	}
+
+	for (auto it = s_textures.begin(); it != s_textures.end();)
+	{
+		if (it->second->GetResourceReferenceCount() == 1)
+		{
+			it = s_textures.erase(it);
+			count++;
+		}
+		else
+			++it;
+	}
+
+	return count;
+}
+
+NzMaterial* NzMaterialRegistry::Register(NzMaterial* material)
+{
+	///DOC: Retourne le matériau équivalent déjà enregistré s'il existe (l'appelant reste alors responsable du sien),
+	///     sinon le matériau est enregistré et retourné
+	#if NAZARA_RENDERER_SAFE
+	if (!material)
+	{
+		NazaraError("Invalid material");
+		return nullptr;
+	}
+	#endif
+
+	if (material == NzMaterial::GetDefault())
+		return material;
+
+	nzUInt64 hash = material->ComputeHash();
+
+	auto range = s_materials.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		NzMaterial* registered = it->second;
+		if (registered->IsEquivalent(*material))
+		{
+			if (registered != material)
+				s_mergeCount++;
+
+			return registered;
+		}
+	}
+
+	s_materials.insert(std::make_pair(hash, NzMaterialRef(material)));
+
+	return material;
+}
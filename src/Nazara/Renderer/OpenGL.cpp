@@ -1226,6 +1226,24 @@ bool NzOpenGL::Initialize()
 		}
 	}
 
+	// VertexAttribBinding
+	if (s_openglVersion >= 430 || IsSupported("GL_ARB_vertex_attrib_binding"))
+	{
+		try
+		{
+			glBindVertexBuffer = reinterpret_cast<PFNGLBINDVERTEXBUFFERPROC>(LoadEntry("glBindVertexBuffer"));
+			glVertexAttribBinding = reinterpret_cast<PFNGLVERTEXATTRIBBINDINGPROC>(LoadEntry("glVertexAttribBinding"));
+			glVertexAttribFormat = reinterpret_cast<PFNGLVERTEXATTRIBFORMATPROC>(LoadEntry("glVertexAttribFormat"));
+			glVertexBindingDivisor = reinterpret_cast<PFNGLVERTEXBINDINGDIVISORPROC>(LoadEntry("glVertexBindingDivisor"));
+
+			s_openGLextensions[nzOpenGLExtension_VertexAttribBinding] = true;
+		}
+		catch (const std::exception& e)
+		{
+			NazaraWarning("Failed to load ARB_vertex_attrib_binding: " + NzString(e.what()));
+		}
+	}
+
 	// Fonctions de substitut
 	if (!glGenerateMipmap)
 		glGenerateMipmap = reinterpret_cast<PFNGLGENERATEMIPMAPEXTPROC>(LoadEntry("glGenerateMipmapEXT", false));
@@ -2034,6 +2052,7 @@ PFNGLBINDRENDERBUFFERPROC         glBindRenderbuffer         = nullptr;
 PFNGLBINDSAMPLERPROC              glBindSampler              = nullptr;
 PFNGLBINDTEXTUREPROC              glBindTexture              = nullptr;
 PFNGLBINDVERTEXARRAYPROC          glBindVertexArray          = nullptr;
+PFNGLBINDVERTEXBUFFERPROC         glBindVertexBuffer         = nullptr;
 PFNGLBLENDFUNCPROC                glBlendFunc                = nullptr;
 PFNGLBLENDFUNCSEPARATEPROC        glBlendFuncSeparate        = nullptr;
 PFNGLBUFFERDATAPROC               glBufferData               = nullptr;
@@ -2183,8 +2202,11 @@ PFNGLUNIFORMMATRIX4FVPROC         glUniformMatrix4fv         = nullptr;
 PFNGLUNMAPBUFFERPROC              glUnmapBuffer              = nullptr;
 PFNGLUSEPROGRAMPROC               glUseProgram               = nullptr;
 PFNGLVERTEXATTRIB4FPROC           glVertexAttrib4f           = nullptr;
+PFNGLVERTEXATTRIBBINDINGPROC      glVertexAttribBinding      = nullptr;
 PFNGLVERTEXATTRIBDIVISORPROC      glVertexAttribDivisor      = nullptr;
+PFNGLVERTEXATTRIBFORMATPROC       glVertexAttribFormat       = nullptr;
 PFNGLVERTEXATTRIBPOINTERPROC      glVertexAttribPointer      = nullptr;
+PFNGLVERTEXBINDINGDIVISORPROC     glVertexBindingDivisor     = nullptr;
 PFNGLVIEWPORTPROC                 glViewport                 = nullptr;
 #if defined(NAZARA_PLATFORM_WINDOWS)
 PFNWGLCHOOSEPIXELFORMATARBPROC    wglChoosePixelFormat       = nullptr;
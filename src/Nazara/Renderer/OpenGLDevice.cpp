@@ -0,0 +1,94 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Renderer/OpenGLDevice.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Renderer/Renderer.hpp>
+#include <Nazara/Renderer/ShaderProgram.hpp>
+#include <Nazara/Renderer/Debug.hpp>
+
+void NzOpenGLDevice::DrawIndexedPrimitives(nzPrimitiveMode mode, unsigned int firstIndex, unsigned int indexCount)
+{
+	NzRenderer::DrawIndexedPrimitives(mode, firstIndex, indexCount);
+}
+
+void NzOpenGLDevice::DrawPrimitives(nzPrimitiveMode mode, unsigned int firstVertex, unsigned int vertexCount)
+{
+	NzRenderer::DrawPrimitives(mode, firstVertex, vertexCount);
+}
+
+void NzOpenGLDevice::SetIndexBuffer(const NzIndexBuffer* indexBuffer)
+{
+	NzRenderer::SetIndexBuffer(indexBuffer);
+}
+
+void NzOpenGLDevice::SetMatrix(nzMatrixType type, const NzMatrix4f& matrix)
+{
+	NzRenderer::SetMatrix(type, matrix);
+}
+
+void NzOpenGLDevice::SetRenderStates(const NzRenderStates& states)
+{
+	NzRenderer::SetRenderStates(states);
+}
+
+void NzOpenGLDevice::SetShaderProgram(const NzShaderProgram* program)
+{
+	NzRenderer::SetShaderProgram(program);
+}
+
+void NzOpenGLDevice::SetTexture(nzUInt8 unit, const NzTexture* texture, const NzTextureSampler& sampler)
+{
+	NzRenderer::SetTexture(unit, texture);
+	NzRenderer::SetTextureSampler(unit, sampler);
+}
+
+void NzOpenGLDevice::SetUniform(const NzShaderProgram* program, int location, nzShaderUniformType type, const void* value)
+{
+	switch (type)
+	{
+		case nzShaderUniformType_Float:
+			program->SendFloat(location, *static_cast<const float*>(value));
+			return;
+
+		case nzShaderUniformType_Integer:
+			program->SendInteger(location, *static_cast<const int*>(value));
+			return;
+
+		case nzShaderUniformType_Matrix4f:
+			program->SendMatrix(location, *static_cast<const NzMatrix4f*>(value));
+			return;
+
+		case nzShaderUniformType_Vector2f:
+			program->SendVector(location, *static_cast<const NzVector2f*>(value));
+			return;
+
+		case nzShaderUniformType_Vector2i:
+			program->SendVector(location, *static_cast<const NzVector2i*>(value));
+			return;
+
+		case nzShaderUniformType_Vector3f:
+			program->SendVector(location, *static_cast<const NzVector3f*>(value));
+			return;
+
+		case nzShaderUniformType_Vector3i:
+			program->SendVector(location, *static_cast<const NzVector3i*>(value));
+			return;
+
+		case nzShaderUniformType_Vector4f:
+			program->SendVector(location, *static_cast<const NzVector4f*>(value));
+			return;
+
+		case nzShaderUniformType_Vector4i:
+			program->SendVector(location, *static_cast<const NzVector4i*>(value));
+			return;
+	}
+
+	NazaraInternalError("Shader uniform type not handled (0x" + NzString::Number(type, 16) + ')');
+}
+
+void NzOpenGLDevice::SetVertexBuffer(const NzVertexBuffer* vertexBuffer)
+{
+	NzRenderer::SetVertexBuffer(vertexBuffer);
+}
@@ -0,0 +1,31 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_OPENGLDEVICE_HPP
+#define NAZARA_OPENGLDEVICE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Renderer/RenderDevice.hpp>
+
+class NzOpenGLDevice : public NzRenderDevice
+{
+	public:
+		NzOpenGLDevice() = default;
+		~NzOpenGLDevice() = default;
+
+		void DrawIndexedPrimitives(nzPrimitiveMode mode, unsigned int firstIndex, unsigned int indexCount);
+		void DrawPrimitives(nzPrimitiveMode mode, unsigned int firstVertex, unsigned int vertexCount);
+
+		void SetIndexBuffer(const NzIndexBuffer* indexBuffer);
+		void SetMatrix(nzMatrixType type, const NzMatrix4f& matrix);
+		void SetRenderStates(const NzRenderStates& states);
+		void SetShaderProgram(const NzShaderProgram* program);
+		void SetTexture(nzUInt8 unit, const NzTexture* texture, const NzTextureSampler& sampler);
+		void SetUniform(const NzShaderProgram* program, int location, nzShaderUniformType type, const void* value);
+		void SetVertexBuffer(const NzVertexBuffer* vertexBuffer);
+};
+
+#endif // NAZARA_OPENGLDEVICE_HPP
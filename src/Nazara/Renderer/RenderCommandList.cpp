@@ -0,0 +1,535 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Renderer/RenderCommandList.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <Nazara/Renderer/Config.hpp>
+#include <Nazara/Renderer/OpenGLDevice.hpp>
+#include <Nazara/Renderer/RenderDevice.hpp>
+#include <cstring>
+#include <Nazara/Renderer/Debug.hpp>
+
+namespace
+{
+	const unsigned int invalidIndex = 0xFFFFFFFF;
+
+	const unsigned int uniformSize[nzShaderUniformType_Max+1] =
+	{
+		sizeof(float),      // nzShaderUniformType_Float
+		sizeof(int),        // nzShaderUniformType_Integer
+		sizeof(NzMatrix4f), // nzShaderUniformType_Matrix4f
+		sizeof(NzVector2f), // nzShaderUniformType_Vector2f
+		sizeof(NzVector2i), // nzShaderUniformType_Vector2i
+		sizeof(NzVector3f), // nzShaderUniformType_Vector3f
+		sizeof(NzVector3i), // nzShaderUniformType_Vector3i
+		sizeof(NzVector4f), // nzShaderUniformType_Vector4f
+		sizeof(NzVector4i)  // nzShaderUniformType_Vector4i
+	};
+
+	bool SamplerEquals(const NzTextureSampler& first, const NzTextureSampler& second)
+	{
+		return first.GetAnisotropicLevel() == second.GetAnisotropicLevel() &&
+		       first.GetFilterMode() == second.GetFilterMode() &&
+		       first.GetWrapMode() == second.GetWrapMode();
+	}
+
+	// État connu du périphérique pendant le rejeu, partagé entre les listes d'une même soumission
+	struct ReplayState
+	{
+		struct TextureUnit
+		{
+			const NzTexture* texture;
+			const NzTextureSampler* sampler = nullptr; // nullptr tant que l'unité n'a pas été utilisée
+		};
+
+		struct Uniform
+		{
+			int location;
+			const nzUInt8* value;
+			nzShaderUniformType type;
+		};
+
+		std::vector<TextureUnit> textureUnits;
+		std::vector<Uniform> uniforms; // Valeurs envoyées au programme courant
+		const NzIndexBuffer* indexBuffer;
+		const NzMatrix4f* matrices[nzMatrixType_World+1] = {nullptr};
+		const NzRenderStates* states = nullptr;
+		const NzShaderProgram* program;
+		const NzVertexBuffer* vertexBuffer;
+		bool indexBufferKnown = false;
+		bool programKnown = false;
+		bool vertexBufferKnown = false;
+	};
+}
+
+NzRenderCommandList::NzRenderCommandList()
+{
+	Clear();
+}
+
+void NzRenderCommandList::Clear()
+{
+	// On garde la mémoire allouée, une liste étant normalement réenregistrée à chaque image
+	m_commands.clear();
+	m_currentTextures.clear();
+	m_currentUniforms.clear();
+	m_matrices.clear();
+	m_states.clear();
+	m_textures.clear();
+	m_uniformData.clear();
+	m_uniforms.clear();
+
+	m_indexBuffer = nullptr;
+	m_program = nullptr;
+	m_vertexBuffer = nullptr;
+	m_statesIndex = invalidIndex;
+	m_textureCount = 0;
+	m_textureFirst = 0;
+	m_texturesUpdated = true;
+	m_uniformCount = 0;
+	m_uniformFirst = 0;
+	m_uniformsUpdated = true;
+
+	for (unsigned int& index : m_matrixIndices)
+		index = invalidIndex;
+}
+
+void NzRenderCommandList::DrawIndexedPrimitives(nzPrimitiveMode mode, unsigned int firstIndex, unsigned int indexCount)
+{
+	#if NAZARA_RENDERER_SAFE
+	if (!m_indexBuffer)
+	{
+		NazaraError("No index buffer");
+		return;
+	}
+	#endif
+
+	PushDraw(true, mode, firstIndex, indexCount);
+}
+
+void NzRenderCommandList::DrawPrimitives(nzPrimitiveMode mode, unsigned int firstVertex, unsigned int vertexCount)
+{
+	PushDraw(false, mode, firstVertex, vertexCount);
+}
+
+unsigned int NzRenderCommandList::GetCommandCount() const
+{
+	return m_commands.size();
+}
+
+unsigned int NzRenderCommandList::GetMemoryUsage() const
+{
+	return m_commands.size()*sizeof(Command) +
+	       m_matrices.size()*sizeof(NzMatrix4f) +
+	       m_states.size()*sizeof(NzRenderStates) +
+	       m_textures.size()*sizeof(TextureBinding) +
+	       m_uniforms.size()*sizeof(UniformBinding) +
+	       m_uniformData.size();
+}
+
+bool NzRenderCommandList::IsEmpty() const
+{
+	return m_commands.empty();
+}
+
+void NzRenderCommandList::Reserve(unsigned int commandCount)
+{
+	m_commands.reserve(commandCount);
+}
+
+void NzRenderCommandList::SetIndexBuffer(const NzIndexBuffer* indexBuffer)
+{
+	m_indexBuffer = indexBuffer;
+}
+
+void NzRenderCommandList::SetMatrix(nzMatrixType type, const NzMatrix4f& matrix)
+{
+	#ifdef NAZARA_DEBUG
+	if (type > nzMatrixType_Max)
+	{
+		NazaraError("Matrix type out of enum");
+		return;
+	}
+	#endif
+
+	#if NAZARA_RENDERER_SAFE
+	if (type > nzMatrixType_World)
+	{
+		NazaraError("Only projection, view and world matrices can be set, others are computed by the renderer");
+		return;
+	}
+	#endif
+
+	unsigned int& index = m_matrixIndices[type];
+	if (index != invalidIndex && std::memcmp(&m_matrices[index], &matrix, sizeof(NzMatrix4f)) == 0)
+		return;
+
+	index = m_matrices.size();
+	m_matrices.push_back(matrix);
+}
+
+void NzRenderCommandList::SetRenderStates(const NzRenderStates& states)
+{
+	// NzRenderStates est copié octet par octet, la comparaison peut donc se faire de la même façon
+	if (m_statesIndex != invalidIndex && std::memcmp(&m_states[m_statesIndex], &states, sizeof(NzRenderStates)) == 0)
+		return;
+
+	m_statesIndex = m_states.size();
+	m_states.push_back(states);
+}
+
+void NzRenderCommandList::SetShaderProgram(const NzShaderProgram* program)
+{
+	if (m_program == program)
+		return;
+
+	m_program = program;
+
+	// Les emplacements des uniformes sont propres à chaque programme
+	m_currentUniforms.clear();
+	m_uniformsUpdated = true;
+}
+
+void NzRenderCommandList::SetTexture(nzUInt8 unit, const NzTexture* texture, const NzTextureSampler& sampler)
+{
+	for (TextureBinding& binding : m_currentTextures)
+	{
+		if (binding.unit == unit)
+		{
+			if (binding.texture != texture || !SamplerEquals(binding.sampler, sampler))
+			{
+				binding.sampler = sampler;
+				binding.texture = texture;
+				m_texturesUpdated = true;
+			}
+
+			return;
+		}
+	}
+
+	m_currentTextures.push_back(TextureBinding{sampler, texture, unit});
+	m_texturesUpdated = true;
+}
+
+void NzRenderCommandList::SetUniform(int location, float value)
+{
+	PushUniform(location, nzShaderUniformType_Float, &value, sizeof(float));
+}
+
+void NzRenderCommandList::SetUniform(int location, int value)
+{
+	PushUniform(location, nzShaderUniformType_Integer, &value, sizeof(int));
+}
+
+void NzRenderCommandList::SetUniform(int location, const NzMatrix4f& matrix)
+{
+	PushUniform(location, nzShaderUniformType_Matrix4f, &matrix, sizeof(NzMatrix4f));
+}
+
+void NzRenderCommandList::SetUniform(int location, const NzVector2f& vector)
+{
+	PushUniform(location, nzShaderUniformType_Vector2f, &vector, sizeof(NzVector2f));
+}
+
+void NzRenderCommandList::SetUniform(int location, const NzVector2i& vector)
+{
+	PushUniform(location, nzShaderUniformType_Vector2i, &vector, sizeof(NzVector2i));
+}
+
+void NzRenderCommandList::SetUniform(int location, const NzVector3f& vector)
+{
+	PushUniform(location, nzShaderUniformType_Vector3f, &vector, sizeof(NzVector3f));
+}
+
+void NzRenderCommandList::SetUniform(int location, const NzVector3i& vector)
+{
+	PushUniform(location, nzShaderUniformType_Vector3i, &vector, sizeof(NzVector3i));
+}
+
+void NzRenderCommandList::SetUniform(int location, const NzVector4f& vector)
+{
+	PushUniform(location, nzShaderUniformType_Vector4f, &vector, sizeof(NzVector4f));
+}
+
+void NzRenderCommandList::SetUniform(int location, const NzVector4i& vector)
+{
+	PushUniform(location, nzShaderUniformType_Vector4i, &vector, sizeof(NzVector4i));
+}
+
+void NzRenderCommandList::SetVertexBuffer(const NzVertexBuffer* vertexBuffer)
+{
+	m_vertexBuffer = vertexBuffer;
+}
+
+NzRenderCommandStats NzRenderCommandList::Submit(NzRenderDevice* device) const
+{
+	return Submit(this, 1, device);
+}
+
+void NzRenderCommandList::Record(NzRenderCommandList* lists, unsigned int count, NzFunctionRef<void(NzRenderCommandList&, unsigned int)> recorder)
+{
+	if (count > 1 && NzTaskScheduler::Initialize() && NzTaskScheduler::GetWorkerCount() > 1)
+	{
+		// Les tâches sont attendues avant de retourner, la référence vers le recorder reste donc valide
+		for (unsigned int i = 0; i < count; ++i)
+			NzTaskScheduler::AddTask([lists, recorder, i]() { recorder(lists[i], i); });
+
+		NzTaskScheduler::WaitForTasks();
+	}
+	else
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			recorder(lists[i], i);
+	}
+}
+
+NzRenderCommandStats NzRenderCommandList::Submit(const NzRenderCommandList* lists, unsigned int count, NzRenderDevice* device)
+{
+	NzOpenGLDevice openGLDevice;
+	if (!device)
+		device = &openGLDevice;
+
+	NzRenderCommandStats stats;
+	ReplayState state;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const NzRenderCommandList& list = lists[i];
+		for (const Command& command : list.m_commands)
+		{
+			if (command.states != invalidIndex)
+			{
+				const NzRenderStates& states = list.m_states[command.states];
+				if (state.states != &states && (!state.states || std::memcmp(state.states, &states, sizeof(NzRenderStates)) != 0))
+				{
+					device->SetRenderStates(states);
+					stats.renderStatesChanges++;
+				}
+				else
+					stats.skippedChanges++;
+
+				state.states = &states;
+			}
+
+			if (!state.programKnown || state.program != command.program)
+			{
+				device->SetShaderProgram(command.program);
+				stats.programChanges++;
+
+				state.program = command.program;
+				state.programKnown = true;
+				state.uniforms.clear();
+			}
+			else
+				stats.skippedChanges++;
+
+			if (!state.vertexBufferKnown || state.vertexBuffer != command.vertexBuffer)
+			{
+				device->SetVertexBuffer(command.vertexBuffer);
+				stats.vertexBufferChanges++;
+
+				state.vertexBuffer = command.vertexBuffer;
+				state.vertexBufferKnown = true;
+			}
+			else
+				stats.skippedChanges++;
+
+			if (command.indexed)
+			{
+				if (!state.indexBufferKnown || state.indexBuffer != command.indexBuffer)
+				{
+					device->SetIndexBuffer(command.indexBuffer);
+					stats.indexBufferChanges++;
+
+					state.indexBuffer = command.indexBuffer;
+					state.indexBufferKnown = true;
+				}
+				else
+					stats.skippedChanges++;
+			}
+
+			for (unsigned int j = 0; j <= nzMatrixType_World; ++j)
+			{
+				if (command.matrices[j] == invalidIndex)
+					continue;
+
+				const NzMatrix4f& matrix = list.m_matrices[command.matrices[j]];
+				if (state.matrices[j] != &matrix && (!state.matrices[j] || std::memcmp(state.matrices[j], &matrix, sizeof(NzMatrix4f)) != 0))
+				{
+					device->SetMatrix(static_cast<nzMatrixType>(j), matrix);
+					stats.matrixChanges++;
+				}
+				else
+					stats.skippedChanges++;
+
+				state.matrices[j] = &matrix;
+			}
+
+			for (unsigned int j = 0; j < command.textureCount; ++j)
+			{
+				const TextureBinding& binding = list.m_textures[command.textureFirst + j];
+				if (binding.unit >= state.textureUnits.size())
+					state.textureUnits.resize(binding.unit + 1);
+
+				ReplayState::TextureUnit& textureUnit = state.textureUnits[binding.unit];
+				if (!textureUnit.sampler || textureUnit.texture != binding.texture || !SamplerEquals(*textureUnit.sampler, binding.sampler))
+				{
+					device->SetTexture(binding.unit, binding.texture, binding.sampler);
+					stats.textureChanges++;
+				}
+				else
+					stats.skippedChanges++;
+
+				textureUnit.sampler = &binding.sampler;
+				textureUnit.texture = binding.texture;
+			}
+
+			for (unsigned int j = 0; j < command.uniformCount; ++j)
+			{
+				const UniformBinding& binding = list.m_uniforms[command.uniformFirst + j];
+				const nzUInt8* value = &list.m_uniformData[binding.offset];
+
+				ReplayState::Uniform* uniform = nullptr;
+				for (ReplayState::Uniform& sentUniform : state.uniforms)
+				{
+					if (sentUniform.location == binding.location)
+					{
+						uniform = &sentUniform;
+						break;
+					}
+				}
+
+				if (!uniform)
+				{
+					state.uniforms.push_back(ReplayState::Uniform{binding.location, value, binding.type});
+					uniform = &state.uniforms.back();
+				}
+				else if (uniform->type == binding.type && (uniform->value == value || std::memcmp(uniform->value, value, uniformSize[binding.type]) == 0))
+				{
+					stats.skippedChanges++;
+					continue;
+				}
+
+				device->SetUniform(command.program, binding.location, binding.type, value);
+				stats.uniformChanges++;
+
+				uniform->type = binding.type;
+				uniform->value = value;
+			}
+
+			if (command.indexed)
+				device->DrawIndexedPrimitives(command.primitiveMode, command.first, command.count);
+			else
+				device->DrawPrimitives(command.primitiveMode, command.first, command.count);
+
+			stats.drawCount++;
+		}
+	}
+
+	return stats;
+}
+
+void NzRenderCommandList::PushDraw(bool indexed, nzPrimitiveMode mode, unsigned int first, unsigned int count)
+{
+	#ifdef NAZARA_DEBUG
+	if (mode > nzPrimitiveMode_Max)
+	{
+		NazaraError("Primitive mode out of enum");
+		return;
+	}
+	#endif
+
+	#if NAZARA_RENDERER_SAFE
+	if (!m_program)
+	{
+		NazaraError("No shader program");
+		return;
+	}
+
+	if (!m_vertexBuffer)
+	{
+		NazaraError("No vertex buffer");
+		return;
+	}
+	#endif
+
+	// Les liaisons ne sont recopiées que si elles ont changé depuis le dernier dessin
+	if (m_texturesUpdated)
+	{
+		m_textureFirst = m_textures.size();
+		m_textureCount = m_currentTextures.size();
+		m_textures.insert(m_textures.end(), m_currentTextures.begin(), m_currentTextures.end());
+		m_texturesUpdated = false;
+	}
+
+	if (m_uniformsUpdated)
+	{
+		m_uniformFirst = m_uniforms.size();
+		m_uniformCount = m_currentUniforms.size();
+		m_uniforms.insert(m_uniforms.end(), m_currentUniforms.begin(), m_currentUniforms.end());
+		m_uniformsUpdated = false;
+	}
+
+	Command command;
+	command.count = count;
+	command.first = first;
+	command.indexBuffer = (indexed) ? m_indexBuffer : nullptr;
+	command.indexed = indexed;
+	command.primitiveMode = mode;
+	command.program = m_program;
+	command.states = m_statesIndex;
+	command.textureCount = m_textureCount;
+	command.textureFirst = m_textureFirst;
+	command.uniformCount = m_uniformCount;
+	command.uniformFirst = m_uniformFirst;
+	command.vertexBuffer = m_vertexBuffer;
+
+	for (unsigned int i = 0; i <= nzMatrixType_World; ++i)
+		command.matrices[i] = m_matrixIndices[i];
+
+	m_commands.push_back(command);
+}
+
+void NzRenderCommandList::PushUniform(int location, nzShaderUniformType type, const void* value, unsigned int size)
+{
+	#if NAZARA_RENDERER_SAFE
+	if (!m_program)
+	{
+		NazaraError("No shader program");
+		return;
+	}
+	#endif
+
+	if (location == -1)
+		return; // Uniforme inutilisée par le programme, NzShaderProgram l'ignore de la même façon
+
+	UniformBinding* binding = nullptr;
+	for (UniformBinding& currentBinding : m_currentUniforms)
+	{
+		if (currentBinding.location == location)
+		{
+			if (currentBinding.type == type && std::memcmp(&m_uniformData[currentBinding.offset], value, size) == 0)
+				return;
+
+			binding = &currentBinding;
+			break;
+		}
+	}
+
+	if (!binding)
+	{
+		m_currentUniforms.push_back(UniformBinding{location, type, 0});
+		binding = &m_currentUniforms.back();
+	}
+
+	// Les valeurs précédentes restent référencées par les commandes déjà enregistrées
+	binding->offset = m_uniformData.size();
+	binding->type = type;
+
+	const nzUInt8* ptr = static_cast<const nzUInt8*>(value);
+	m_uniformData.insert(m_uniformData.end(), ptr, ptr + size);
+
+	m_uniformsUpdated = true;
+}
@@ -0,0 +1,8 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Renderer/RenderDevice.hpp>
+#include <Nazara/Renderer/Debug.hpp>
+
+NzRenderDevice::~NzRenderDevice() = default;
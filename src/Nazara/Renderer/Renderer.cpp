@@ -13,35 +13,27 @@
 #include <Nazara/Renderer/DebugDrawer.hpp>
 #include <Nazara/Renderer/HardwareBuffer.hpp>
 #include <Nazara/Renderer/Material.hpp>
+#include <Nazara/Renderer/MaterialRegistry.hpp>
 #include <Nazara/Renderer/OpenGL.hpp>
 #include <Nazara/Renderer/RenderTarget.hpp>
 #include <Nazara/Renderer/ShaderProgram.hpp>
 #include <Nazara/Renderer/ShaderProgramManager.hpp>
+#include <Nazara/Renderer/VertexLayoutCache.hpp>
 #include <Nazara/Renderer/Loaders/Texture.hpp>
 #include <Nazara/Utility/AbstractBuffer.hpp>
 #include <Nazara/Utility/IndexBuffer.hpp>
+#include <Nazara/Utility/PrimitiveMeshCache.hpp>
 #include <Nazara/Utility/Utility.hpp>
 #include <Nazara/Utility/VertexBuffer.hpp>
 #include <Nazara/Utility/VertexDeclaration.hpp>
-#include <map>
 #include <memory>
 #include <set>
 #include <stdexcept>
-#include <tuple>
-#include <unordered_map>
 #include <vector>
 #include <Nazara/Renderer/Debug.hpp>
 
 namespace
 {
-	enum ResourceType
-	{
-		ResourceType_Context,
-		ResourceType_IndexBuffer,
-		ResourceType_VertexBuffer,
-		ResourceType_VertexDeclaration
-	};
-
 	enum UpdateFlags
 	{
 		Update_None = 0,
@@ -67,10 +59,10 @@ namespace
 		bool textureUpdated = true;
 	};
 
-	using VAO_Key = std::tuple<const NzIndexBuffer*, const NzVertexBuffer*, const NzVertexDeclaration*, const NzVertexDeclaration*>;
-	using VAO_Map = std::unordered_map<const NzContext*, std::map<VAO_Key, unsigned int>>;
+	unsigned int CreateVertexLayout(const NzVertexDeclaration* vertexDeclaration, const NzVertexDeclaration* instancingDeclaration);
+	void DestroyVertexLayout(unsigned int layout);
 
-	VAO_Map s_vaos;
+	NzVertexLayoutCache s_vertexLayouts(CreateVertexLayout, DestroyVertexLayout);
 	std::set<unsigned int> s_dirtyTextureUnits;
 	std::vector<TextureUnit> s_textureUnits;
 	GLuint s_currentVAO = 0;
@@ -85,99 +77,104 @@ namespace
 	const NzRenderTarget* s_target;
 	const NzShaderProgram* s_program;
 	const NzVertexBuffer* s_vertexBuffer;
-	const NzVertexDeclaration* s_instancingDeclaration;
 	bool s_capabilities[nzRendererCap_Max+1];
 	bool s_instancing;
 	bool s_useSamplerObjects;
 	bool s_useVertexArrayObjects;
+	bool s_useVertexAttribBinding;
 	unsigned int s_maxColorAttachments;
 	unsigned int s_maxRenderTarget;
 	unsigned int s_maxTextureUnit;
 	unsigned int s_maxVertexAttribs;
 
-	class ResourceListener : public NzResourceListener
+	void SetupAttributes(const NzVertexDeclaration* declaration, unsigned int firstUsage, unsigned int lastUsage, unsigned int binding)
 	{
-		public:
-			void OnResourceReleased(const NzResource* resource, int index) override
+		// Active les attributs de la déclaration et, si possible, décrit leur format indépendamment du buffer
+		for (unsigned int i = firstUsage; i <= lastUsage; ++i)
+		{
+			nzAttributeType type;
+			bool enabled = false;
+			unsigned int offset;
+			if (declaration)
+				declaration->GetAttribute(static_cast<nzAttributeUsage>(i), &enabled, &type, &offset);
+
+			if (enabled)
 			{
-				switch (index)
+				glEnableVertexAttribArray(NzOpenGL::AttributeIndex[i]);
+
+				if (s_useVertexAttribBinding)
 				{
-					case ResourceType_Context:
-					{
-						const NzContext* context = static_cast<const NzContext*>(resource);
-						s_vaos.erase(context);
-						break;
-					}
+					glVertexAttribFormat(NzOpenGL::AttributeIndex[i],
+					                     NzVertexDeclaration::GetAttributeSize(type),
+					                     NzOpenGL::AttributeType[type],
+					                     (type == nzAttributeType_Color) ? GL_TRUE : GL_FALSE,
+					                     offset);
+					glVertexAttribBinding(NzOpenGL::AttributeIndex[i], binding);
+				}
+				else if (binding > 0)
+					glVertexAttribDivisor(NzOpenGL::AttributeIndex[i], 1);
+			}
+			else
+				glDisableVertexAttribArray(NzOpenGL::AttributeIndex[i]);
+		}
+	}
 
-					case ResourceType_IndexBuffer:
-					{
-						const NzIndexBuffer* indexBuffer = static_cast<const NzIndexBuffer*>(resource);
-						for (auto& pair : s_vaos)
-						{
-							auto it = pair.second.begin();
-							while (it != pair.second.end())
-							{
-								const VAO_Key& key = it->first;
-								const NzIndexBuffer* vaoIndexBuffer = std::get<0>(key);
-
-								if (vaoIndexBuffer == indexBuffer)
-									pair.second.erase(it++);
-								else
-									++it;
-							}
-						}
-						break;
-					}
+	void BindVertexBuffer(const NzVertexBuffer* vertexBuffer, unsigned int firstUsage, unsigned int lastUsage, unsigned int binding)
+	{
+		NzHardwareBuffer* bufferImpl = static_cast<NzHardwareBuffer*>(vertexBuffer->GetBuffer()->GetImpl());
+		const NzVertexDeclaration* vertexDeclaration = vertexBuffer->GetVertexDeclaration();
+		unsigned int bufferOffset = vertexBuffer->GetStartOffset();
+		unsigned int stride = vertexDeclaration->GetStride();
 
-					case ResourceType_VertexBuffer:
-					{
-						const NzVertexBuffer* vertexBuffer = static_cast<const NzVertexBuffer*>(resource);
-						for (auto& pair : s_vaos)
-						{
-							auto it = pair.second.begin();
-							while (it != pair.second.end())
-							{
-								const VAO_Key& key = it->first;
-								const NzVertexBuffer* vaoVertexBuffer = std::get<1>(key);
-
-								if (vaoVertexBuffer == vertexBuffer)
-									pair.second.erase(it++);
-								else
-									++it;
-							}
-						}
-						break;
-					}
+		// Avec ARB_vertex_attrib_binding, le format étant déjà connu du VAO, un seul appel suffit
+		if (s_useVertexAttribBinding)
+		{
+			glBindVertexBuffer(binding, bufferImpl->GetOpenGLID(), bufferOffset, stride);
+			return;
+		}
 
-					case ResourceType_VertexDeclaration:
-					{
-						const NzVertexDeclaration* vertexDeclaration = static_cast<const NzVertexDeclaration*>(resource);
-						for (auto& pair : s_vaos)
-						{
-							auto it = pair.second.begin();
-							while (it != pair.second.end())
-							{
-								const VAO_Key& key = it->first;
-								const NzVertexDeclaration* vaoVertexDeclaration = std::get<2>(key);
-								const NzVertexDeclaration* vaoInstancingDeclaration = std::get<3>(key);
-
-								if (vaoVertexDeclaration == vertexDeclaration || vaoInstancingDeclaration == vertexDeclaration)
-									pair.second.erase(it++);
-								else
-									++it;
-							}
-						}
-						break;
-					}
+		// Sinon, il nous faut re-pointer chaque attribut sur le nouveau buffer
+		glBindBuffer(NzOpenGL::BufferTarget[nzBufferType_Vertex], bufferImpl->GetOpenGLID());
+		for (unsigned int i = firstUsage; i <= lastUsage; ++i)
+		{
+			nzAttributeType type;
+			bool enabled;
+			unsigned int offset;
+			vertexDeclaration->GetAttribute(static_cast<nzAttributeUsage>(i), &enabled, &type, &offset);
 
-					default:
-						NazaraInternalError("Unknown resource type");
-						break;
-				}
+			if (enabled)
+			{
+				glVertexAttribPointer(NzOpenGL::AttributeIndex[i],
+				                      NzVertexDeclaration::GetAttributeSize(type),
+				                      NzOpenGL::AttributeType[type],
+				                      (type == nzAttributeType_Color) ? GL_TRUE : GL_FALSE,
+				                      stride,
+				                      reinterpret_cast<void*>(bufferOffset + offset));
 			}
-	};
+		}
+	}
+
+	unsigned int CreateVertexLayout(const NzVertexDeclaration* vertexDeclaration, const NzVertexDeclaration* instancingDeclaration)
+	{
+		GLuint vao;
+		glGenVertexArrays(1, &vao);
+		glBindVertexArray(vao);
 
-	ResourceListener s_listener;
+		// Le format des attributs ne dépend que des déclarations, il n'est programmé qu'une seule fois
+		SetupAttributes(vertexDeclaration, nzAttributeUsage_FirstVertexData, nzAttributeUsage_LastVertexData, 0);
+		SetupAttributes(instancingDeclaration, nzAttributeUsage_FirstInstanceData, nzAttributeUsage_LastInstanceData, 1);
+
+		if (instancingDeclaration && s_useVertexAttribBinding)
+			glVertexBindingDivisor(1, 1);
+
+		return static_cast<unsigned int>(vao);
+	}
+
+	void DestroyVertexLayout(unsigned int layout)
+	{
+		GLuint vao = static_cast<GLuint>(layout);
+		glDeleteVertexArrays(1, &vao);
+	}
 }
 
 void NzRenderer::BeginCondition(const NzGpuQuery& query, nzGpuQueryCondition condition)
@@ -730,6 +727,7 @@ bool NzRenderer::Initialize()
 	s_textureUnits.resize(s_maxTextureUnit);
 	s_useSamplerObjects = NzOpenGL::IsSupported(nzOpenGLExtension_SamplerObjects);
 	s_useVertexArrayObjects = NzOpenGL::IsSupported(nzOpenGLExtension_VertexArrayObjects);
+	s_useVertexAttribBinding = s_useVertexArrayObjects && NzOpenGL::IsSupported(nzOpenGLExtension_VertexAttribBinding);
 	s_vertexBuffer = nullptr;
 	s_updateFlags = (Update_Matrices | Update_Program | Update_VAO);
 
@@ -1356,6 +1354,23 @@ void NzRenderer::SetViewport(const NzRecti& viewport)
 	NzOpenGL::BindViewport(viewport);
 }
 
+void NzRenderer::SetWorldMatrices(const NzMatrix4f& world, const NzMatrix4f& worldView, const NzMatrix4f& worldViewProj)
+{
+	// Matrices précalculées (voir NzTransformBatch), elles doivent correspondre aux matrices de vue et de projection actuelles
+	s_matrices[nzMatrixType_World].matrix = world;
+	s_matrices[nzMatrixType_World].updated = true;
+	s_matrices[nzMatrixType_WorldView].matrix = worldView;
+	s_matrices[nzMatrixType_WorldView].updated = true;
+	s_matrices[nzMatrixType_WorldViewProj].matrix = worldViewProj;
+	s_matrices[nzMatrixType_WorldViewProj].updated = true;
+
+	s_matrices[nzMatrixType_InvWorld].updated = false;
+	s_matrices[nzMatrixType_InvWorldView].updated = false;
+	s_matrices[nzMatrixType_InvWorldViewProj].updated = false;
+
+	s_updateFlags |= Update_Matrices;
+}
+
 void NzRenderer::Uninitialize()
 {
 	if (s_moduleReferenceCounter != 1)
@@ -1375,6 +1390,9 @@ void NzRenderer::Uninitialize()
 	// Loaders
 	NzLoaders_Texture_Unregister();
 
+	// Les matériaux et textures partagés doivent être libérés tant que le contexte existe
+	NzMaterialRegistry::Clear();
+
 	NzTextureSampler::Uninitialize();
 	NzShaderProgramManager::Uninitialize();
 	NzMaterial::Uninitialize();
@@ -1384,37 +1402,18 @@ void NzRenderer::Uninitialize()
 	s_fullscreenQuadBuffer.Reset();
 	s_instanceBuffer.Reset();
 
+	// Les primitives en cache peuvent utiliser des buffers hardware, elles doivent être libérées tant que le contexte existe
+	NzPrimitiveMeshCache::Clear();
+
 	// Libération des VAOs
-	for (auto& pair : s_vaos)
+	for (const NzContext* context : s_vertexLayouts.GetContexts())
 	{
-		const NzContext* context = pair.first;
 		context->SetActive(true);
-
-		for (auto& pair2 : pair.second)
-		{
-			const VAO_Key& key = pair2.first;
-			const NzIndexBuffer* indexBuffer = std::get<0>(key);
-			const NzVertexBuffer* vertexBuffer = std::get<1>(key);
-			const NzVertexDeclaration* vertexDeclaration = std::get<2>(key);
-			const NzVertexDeclaration* instancingDeclaration = std::get<3>(key);
-
-			if (indexBuffer)
-				indexBuffer->RemoveResourceListener(&s_listener);
-
-			vertexBuffer->RemoveResourceListener(&s_listener);
-			vertexDeclaration->RemoveResourceListener(&s_listener);
-
-			if (instancingDeclaration)
-				instancingDeclaration->RemoveResourceListener(&s_listener);
-
-			GLuint vao = static_cast<GLuint>(pair2.second);
-			glDeleteVertexArrays(1, &vao);
-		}
-
+		s_vertexLayouts.Clear(context);
 		context->SetActive(false);
 	}
 
-	s_vaos.clear();
+	s_currentVAO = 0;
 
 	NzOpenGL::Uninitialize();
 
@@ -1582,148 +1581,56 @@ bool NzRenderer::EnsureStateUpdate()
 				NazaraError("No vertex buffer");
 				return false;
 			}
+
+			if (s_instancing && !s_instanceBuffer.GetVertexDeclaration())
+			{
+				NazaraError("Instance buffer has no vertex declaration");
+				return false;
+			}
 			#endif
 
-			bool update;
+			const NzVertexBuffer* instanceBuffer = (s_instancing) ? &s_instanceBuffer : nullptr;
 
 			// Si les VAOs sont supportés, on entoure nos appels par ceux-ci
 			if (s_useVertexArrayObjects)
 			{
-				// Note: Les VAOs ne sont pas partagés entre les contextes, nous avons donc un tableau de VAOs par contexte
-				const NzContext* context = NzContext::GetCurrent();
-
-				auto pair = s_vaos.insert(std::make_pair(context, VAO_Map::mapped_type()));
-				if (pair.second)
-					context->AddResourceListener(&s_listener, ResourceType_Context);
-
-				auto& vaos = pair.first->second;
-
-				// Notre clé est composée de ce qui définit un VAO
+				// Note: Les VAOs ne sont pas partagés entre les contextes, le cache les range donc par contexte
+				// Un VAO ne dépend que des déclarations, les buffers y sont rattachés à chaque changement
 				const NzVertexDeclaration* vertexDeclaration = s_vertexBuffer->GetVertexDeclaration();
-				const NzVertexDeclaration* instancingDeclaration = (s_instancing) ? s_instancingDeclaration : nullptr;
-				VAO_Key key(s_indexBuffer, s_vertexBuffer, vertexDeclaration, instancingDeclaration);
+				const NzVertexDeclaration* instancingDeclaration = (instanceBuffer) ? instanceBuffer->GetVertexDeclaration() : nullptr;
 
-				// On recherche un VAO existant avec notre configuration
-				auto it = vaos.find(key);
-				if (it == vaos.end())
+				s_currentVAO = s_vertexLayouts.GetLayout(NzContext::GetCurrent(), vertexDeclaration, instancingDeclaration);
+				if (s_currentVAO == 0)
 				{
-					// On créé notre VAO
-					glGenVertexArrays(1, &s_currentVAO);
-					glBindVertexArray(s_currentVAO);
-
-					// On l'ajoute à notre liste
-					vaos.insert(std::make_pair(key, static_cast<unsigned int>(s_currentVAO)));
-					if (s_indexBuffer)
-						s_indexBuffer->AddResourceListener(&s_listener, ResourceType_IndexBuffer);
-
-					s_vertexBuffer->AddResourceListener(&s_listener, ResourceType_VertexBuffer);
-					vertexDeclaration->AddResourceListener(&s_listener, ResourceType_VertexDeclaration);
-
-					if (instancingDeclaration)
-						instancingDeclaration->AddResourceListener(&s_listener, ResourceType_VertexDeclaration);
-
-					// Et on indique qu'on veut le programmer
-					update = true;
+					NazaraError("Failed to get vertex layout");
+					return false;
 				}
-				else
-				{
-					// Notre VAO existe déjà, il est donc inutile de le reprogrammer
-					s_currentVAO = it->second;
 
-					update = false;
-				}
+				glBindVertexArray(s_currentVAO);
 			}
 			else
-				update = true; // Fallback si les VAOs ne sont pas supportés
-
-			if (update)
 			{
-				const NzVertexDeclaration* vertexDeclaration;
-				unsigned int bufferOffset;
-				unsigned int stride;
-
-				NzHardwareBuffer* vertexBufferImpl = static_cast<NzHardwareBuffer*>(s_vertexBuffer->GetBuffer()->GetImpl());
-				glBindBuffer(NzOpenGL::BufferTarget[nzBufferType_Vertex], vertexBufferImpl->GetOpenGLID());
-
-				bufferOffset = s_vertexBuffer->GetStartOffset();
-				vertexDeclaration = s_vertexBuffer->GetVertexDeclaration();
-				stride = vertexDeclaration->GetStride();
-				for (unsigned int i = nzAttributeUsage_FirstVertexData; i <= nzAttributeUsage_LastVertexData; ++i)
-				{
-					nzAttributeType type;
-					bool enabled;
-					unsigned int offset;
-					vertexDeclaration->GetAttribute(static_cast<nzAttributeUsage>(i), &enabled, &type, &offset);
-
-					if (enabled)
-					{
-						glEnableVertexAttribArray(NzOpenGL::AttributeIndex[i]);
-						glVertexAttribPointer(NzOpenGL::AttributeIndex[i],
-						                      NzVertexDeclaration::GetAttributeSize(type),
-						                      NzOpenGL::AttributeType[type],
-						                      (type == nzAttributeType_Color) ? GL_TRUE : GL_FALSE,
-						                      stride,
-						                      reinterpret_cast<void*>(bufferOffset + offset));
-					}
-					else
-						glDisableVertexAttribArray(NzOpenGL::AttributeIndex[i]);
-				}
-
-				if (s_instancing)
-				{
-					NzHardwareBuffer* instanceBufferImpl = static_cast<NzHardwareBuffer*>(s_instanceBuffer.GetBuffer()->GetImpl());
-					glBindBuffer(NzOpenGL::BufferTarget[nzBufferType_Vertex], instanceBufferImpl->GetOpenGLID());
-
-					bufferOffset = s_instanceBuffer.GetStartOffset();
-					vertexDeclaration = s_instanceBuffer.GetVertexDeclaration();
-					stride = vertexDeclaration->GetStride();
-					for (unsigned int i = nzAttributeUsage_FirstInstanceData; i <= nzAttributeUsage_LastInstanceData; ++i)
-					{
-						nzAttributeType type;
-						bool enabled;
-						unsigned int offset;
-						vertexDeclaration->GetAttribute(static_cast<nzAttributeUsage>(i), &enabled, &type, &offset);
+				// Fallback si les VAOs ne sont pas supportés, les attributs doivent être respécifiés à chaque fois
+				SetupAttributes(s_vertexBuffer->GetVertexDeclaration(), nzAttributeUsage_FirstVertexData, nzAttributeUsage_LastVertexData, 0);
+				SetupAttributes((instanceBuffer) ? instanceBuffer->GetVertexDeclaration() : nullptr, nzAttributeUsage_FirstInstanceData, nzAttributeUsage_LastInstanceData, 1);
+			}
 
-						if (enabled)
-						{
-							glEnableVertexAttribArray(NzOpenGL::AttributeIndex[i]);
-							glVertexAttribPointer(NzOpenGL::AttributeIndex[i],
-												  NzVertexDeclaration::GetAttributeSize(type),
-												  NzOpenGL::AttributeType[type],
-												  (type == nzAttributeType_Color) ? GL_TRUE : GL_FALSE,
-												  stride,
-												  reinterpret_cast<void*>(bufferOffset + offset));
-							glVertexAttribDivisor(NzOpenGL::AttributeIndex[i], 1);
-						}
-						else
-							glDisableVertexAttribArray(NzOpenGL::AttributeIndex[i]);
-					}
-				}
-				else
-				{
-					for (unsigned int i = nzAttributeUsage_FirstInstanceData; i <= nzAttributeUsage_LastInstanceData; ++i)
-						glDisableVertexAttribArray(NzOpenGL::AttributeIndex[i]);
-				}
+			BindVertexBuffer(s_vertexBuffer, nzAttributeUsage_FirstVertexData, nzAttributeUsage_LastVertexData, 0);
+			if (instanceBuffer)
+				BindVertexBuffer(instanceBuffer, nzAttributeUsage_FirstInstanceData, nzAttributeUsage_LastInstanceData, 1);
 
-				// Et on active l'index buffer (Un seul index buffer par VAO)
-				if (s_indexBuffer)
-				{
-					NzHardwareBuffer* indexBufferImpl = static_cast<NzHardwareBuffer*>(s_indexBuffer->GetBuffer()->GetImpl());
-					glBindBuffer(NzOpenGL::BufferTarget[nzBufferType_Index], indexBufferImpl->GetOpenGLID());
-				}
-				else
-					glBindBuffer(NzOpenGL::BufferTarget[nzBufferType_Index], 0);
+			// Et on active l'index buffer (Un seul index buffer par VAO)
+			if (s_indexBuffer)
+			{
+				NzHardwareBuffer* indexBufferImpl = static_cast<NzHardwareBuffer*>(s_indexBuffer->GetBuffer()->GetImpl());
+				glBindBuffer(NzOpenGL::BufferTarget[nzBufferType_Index], indexBufferImpl->GetOpenGLID());
 			}
+			else
+				glBindBuffer(NzOpenGL::BufferTarget[nzBufferType_Index], 0);
 
+			// En cas de non-support des VAOs, les attributs doivent être respécifiés à chaque frame
 			if (s_useVertexArrayObjects)
-			{
-				// Si nous venons de définir notre VAO, nous devons le débinder pour indiquer la fin de sa construction
-				if (update)
-					glBindVertexArray(0);
-
-				// En cas de non-support des VAOs, les attributs doivent être respécifiés à chaque frame
 				s_updateFlags &= ~Update_VAO;
-			}
 
 			// On invalide les bindings des buffers (pour éviter des bugs)
 			NzOpenGL::SetBuffer(nzBufferType_Index, 0);
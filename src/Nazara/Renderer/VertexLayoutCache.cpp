@@ -0,0 +1,249 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Renderer/VertexLayoutCache.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/String.hpp>
+#include <Nazara/Renderer/Config.hpp>
+#include <Nazara/Renderer/Context.hpp>
+#include <Nazara/Utility/VertexDeclaration.hpp>
+#include <functional>
+#include <Nazara/Renderer/Debug.hpp>
+
+namespace
+{
+	enum ResourceType
+	{
+		ResourceType_Context,
+		ResourceType_VertexDeclaration
+	};
+}
+
+NzVertexLayoutCache::NzVertexLayoutCache(CreateFunction create, DestroyFunction destroy) :
+m_create(create),
+m_destroy(destroy),
+m_lastContext(nullptr),
+m_lastKey(nullptr, nullptr),
+m_lastLayout(0)
+{
+}
+
+NzVertexLayoutCache::~NzVertexLayoutCache()
+{
+	#if NAZARA_RENDERER_SAFE
+	if (!m_contexts.empty())
+		NazaraWarning("Vertex layout cache destroyed with " + NzString::Number(m_stats.layoutCount) + " layout(s) still alive");
+	#endif
+
+	// Les layouts ne peuvent plus être détruits sans leur contexte, nous cessons simplement d'écouter
+	for (auto& pair : m_contexts)
+	{
+		pair.first->RemoveResourceListener(this);
+
+		for (auto& layoutPair : pair.second.layouts)
+			ReleaseDeclarations(layoutPair.first);
+	}
+}
+
+void NzVertexLayoutCache::Clear(const NzContext* context)
+{
+	///DOC: Le contexte doit être actif, ses layouts sont détruits
+	auto it = m_contexts.find(context);
+	if (it == m_contexts.end())
+		return;
+
+	ContextEntry& entry = it->second;
+	for (unsigned int layout : entry.pendingDestruction)
+		m_destroy(layout);
+
+	for (auto& pair : entry.layouts)
+	{
+		ReleaseDeclarations(pair.first);
+		m_destroy(pair.second);
+	}
+
+	m_stats.layoutCount -= entry.layouts.size();
+	m_contexts.erase(it);
+
+	context->RemoveResourceListener(this);
+
+	if (m_lastContext == context)
+		m_lastContext = nullptr;
+}
+
+std::vector<const NzContext*> NzVertexLayoutCache::GetContexts() const
+{
+	std::vector<const NzContext*> contexts;
+	contexts.reserve(m_contexts.size());
+
+	for (auto& pair : m_contexts)
+		contexts.push_back(pair.first);
+
+	return contexts;
+}
+
+unsigned int NzVertexLayoutCache::GetLayout(const NzContext* context, const NzVertexDeclaration* vertexDeclaration, const NzVertexDeclaration* instancingDeclaration)
+{
+	///DOC: Le contexte doit être actif, un layout est créé si aucun ne correspond aux déclarations
+	#if NAZARA_RENDERER_SAFE
+	if (!vertexDeclaration)
+	{
+		NazaraError("Invalid vertex declaration");
+		return 0;
+	}
+	#endif
+
+	Key key(vertexDeclaration, instancingDeclaration);
+
+	// Les changements de buffers se font généralement à déclaration constante, on évite alors le hachage
+	if (m_lastContext == context && m_lastKey == key)
+	{
+		m_stats.hitCount++;
+		return m_lastLayout;
+	}
+
+	auto contextIt = m_contexts.find(context);
+	if (contextIt == m_contexts.end())
+	{
+		contextIt = m_contexts.insert(std::make_pair(context, ContextEntry())).first;
+		context->AddResourceListener(this, ResourceType_Context);
+	}
+
+	ContextEntry& entry = contextIt->second;
+
+	// Le contexte est actif, c'est le moment de détruire les layouts des déclarations libérées
+	if (!entry.pendingDestruction.empty())
+	{
+		for (unsigned int layout : entry.pendingDestruction)
+			m_destroy(layout);
+
+		entry.pendingDestruction.clear();
+	}
+
+	unsigned int layout;
+
+	auto it = entry.layouts.find(key);
+	if (it == entry.layouts.end())
+	{
+		layout = m_create(vertexDeclaration, instancingDeclaration);
+		if (layout == 0)
+		{
+			NazaraError("Failed to create vertex layout");
+			return 0;
+		}
+
+		entry.layouts.insert(std::make_pair(key, layout));
+
+		vertexDeclaration->AddResourceListener(this, ResourceType_VertexDeclaration);
+		if (instancingDeclaration)
+			instancingDeclaration->AddResourceListener(this, ResourceType_VertexDeclaration);
+
+		m_stats.layoutCount++;
+		m_stats.missCount++;
+	}
+	else
+	{
+		layout = it->second;
+		m_stats.hitCount++;
+	}
+
+	m_lastContext = context;
+	m_lastKey = key;
+	m_lastLayout = layout;
+
+	return layout;
+}
+
+const NzVertexLayoutCacheStats& NzVertexLayoutCache::GetStats() const
+{
+	return m_stats;
+}
+
+void NzVertexLayoutCache::ResetStats()
+{
+	unsigned int layoutCount = m_stats.layoutCount;
+
+	m_stats = NzVertexLayoutCacheStats();
+	m_stats.layoutCount = layoutCount;
+}
+
+void NzVertexLayoutCache::OnResourceReleased(const NzResource* resource, int index)
+{
+	switch (index)
+	{
+		case ResourceType_Context:
+			RemoveContext(static_cast<const NzContext*>(resource));
+			break;
+
+		case ResourceType_VertexDeclaration:
+			RemoveDeclaration(static_cast<const NzVertexDeclaration*>(resource));
+			break;
+
+		default:
+			NazaraInternalError("Unknown resource type");
+			break;
+	}
+}
+
+void NzVertexLayoutCache::ReleaseDeclarations(const Key& key)
+{
+	key.first->RemoveResourceListener(this);
+	if (key.second)
+		key.second->RemoveResourceListener(this);
+}
+
+void NzVertexLayoutCache::RemoveContext(const NzContext* context)
+{
+	// Le contexte est en cours de destruction, ses layouts sont libérés avec lui
+	auto it = m_contexts.find(context);
+	if (it == m_contexts.end())
+		return;
+
+	ContextEntry& entry = it->second;
+	for (auto& pair : entry.layouts)
+		ReleaseDeclarations(pair.first);
+
+	m_stats.layoutCount -= entry.layouts.size();
+	m_contexts.erase(it);
+
+	if (m_lastContext == context)
+		m_lastContext = nullptr;
+}
+
+void NzVertexLayoutCache::RemoveDeclaration(const NzVertexDeclaration* declaration)
+{
+	for (auto& pair : m_contexts)
+	{
+		ContextEntry& entry = pair.second;
+
+		auto it = entry.layouts.begin();
+		while (it != entry.layouts.end())
+		{
+			const Key& key = it->first;
+			if (key.first == declaration || key.second == declaration)
+			{
+				// L'autre déclaration est toujours en vie et nous écoute encore
+				const NzVertexDeclaration* otherDeclaration = (key.first == declaration) ? key.second : key.first;
+				if (otherDeclaration && otherDeclaration != declaration)
+					otherDeclaration->RemoveResourceListener(this);
+
+				entry.pendingDestruction.push_back(it->second);
+				entry.layouts.erase(it++);
+
+				m_stats.evictionCount++;
+				m_stats.layoutCount--;
+			}
+			else
+				++it;
+		}
+	}
+
+	m_lastContext = nullptr;
+}
+
+std::size_t NzVertexLayoutCache::KeyHash::operator()(const Key& key) const
+{
+	std::size_t hash = std::hash<const NzVertexDeclaration*>()(key.first);
+	return hash ^ (std::hash<const NzVertexDeclaration*>()(key.second) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+}
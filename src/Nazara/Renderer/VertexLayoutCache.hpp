@@ -0,0 +1,80 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Renderer module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#pragma once
+
+#ifndef NAZARA_VERTEXLAYOUTCACHE_HPP
+#define NAZARA_VERTEXLAYOUTCACHE_HPP
+
+#include <Nazara/Prerequesites.hpp>
+#include <Nazara/Core/NonCopyable.hpp>
+#include <Nazara/Core/ResourceListener.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class NzContext;
+class NzVertexDeclaration;
+
+struct NzVertexLayoutCacheStats
+{
+	unsigned int evictionCount = 0;
+	unsigned int hitCount = 0;
+	unsigned int layoutCount = 0;
+	unsigned int missCount = 0;
+};
+
+// Cache des layouts d'entrée (VAOs) indexé uniquement par les déclarations de sommets et d'instances,
+// les buffers étant rattachés au layout séparément à chaque changement
+// Les layouts ne sont jamais détruits hors de leur contexte : une déclaration libérée place ses layouts
+// en attente de destruction, ceux-ci étant détruits au prochain accès au cache depuis le contexte concerné,
+// un contexte libéré emporte simplement ses layouts avec lui
+class NzVertexLayoutCache : public NzResourceListener, NzNonCopyable
+{
+	public:
+		using CreateFunction = unsigned int (*)(const NzVertexDeclaration* vertexDeclaration, const NzVertexDeclaration* instancingDeclaration);
+		using DestroyFunction = void (*)(unsigned int layout);
+
+		NzVertexLayoutCache(CreateFunction create, DestroyFunction destroy);
+		~NzVertexLayoutCache();
+
+		void Clear(const NzContext* context);
+
+		std::vector<const NzContext*> GetContexts() const;
+		unsigned int GetLayout(const NzContext* context, const NzVertexDeclaration* vertexDeclaration, const NzVertexDeclaration* instancingDeclaration);
+		const NzVertexLayoutCacheStats& GetStats() const;
+
+		void ResetStats();
+
+	private:
+		using Key = std::pair<const NzVertexDeclaration*, const NzVertexDeclaration*>;
+
+		struct KeyHash
+		{
+			std::size_t operator()(const Key& key) const;
+		};
+
+		using LayoutMap = std::unordered_map<Key, unsigned int, KeyHash>;
+
+		struct ContextEntry
+		{
+			LayoutMap layouts;
+			std::vector<unsigned int> pendingDestruction;
+		};
+
+		void OnResourceReleased(const NzResource* resource, int index) override;
+		void ReleaseDeclarations(const Key& key);
+		void RemoveContext(const NzContext* context);
+		void RemoveDeclaration(const NzVertexDeclaration* declaration);
+
+		std::unordered_map<const NzContext*, ContextEntry> m_contexts;
+		CreateFunction m_create;
+		DestroyFunction m_destroy;
+		NzVertexLayoutCacheStats m_stats;
+		const NzContext* m_lastContext;
+		Key m_lastKey;
+		unsigned int m_lastLayout;
+};
+
+#endif // NAZARA_VERTEXLAYOUTCACHE_HPP
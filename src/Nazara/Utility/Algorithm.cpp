@@ -29,7 +29,6 @@
 #include <Nazara/Math/Basic.hpp>
 #include <Nazara/Utility/IndexIterator.hpp>
 #include <algorithm>
-#include <unordered_map>
 #include <Nazara/Utility/Debug.hpp>
 
 namespace
@@ -45,14 +44,25 @@ namespace
 			void Generate(float size, unsigned int recursionLevel, const NzRectf& textureCoords, NzMeshVertex* vertices, NzIndexIterator indices, NzBoxf* aabb, unsigned int indexOffset)
 			{
 				// Grandement inspiré de http://blog.andreaskahler.com/2009/06/creating-icosphere-mesh-in-code.html
+				// Plutôt que de dédoublonner les milieux via une table de hachage, on subdivise les arêtes elles-mêmes:
+				// à chaque niveau, le milieu de l'arête e devient le sommet vertexCount + e, ses deux moitiés les arêtes 2e et 2e+1
+				// et les trois arêtes intérieures du triangle t les arêtes 2*edgeCount + 3t + [0..2]
 				const float t = (1.f + 2.236067f)/2.f;
 
-				m_cache.clear();
-				m_size = size;
+				unsigned int finalIndexCount;
+				unsigned int finalVertexCount;
+				NzComputeIcoSphereIndexVertexCount(recursionLevel, &finalIndexCount, &finalVertexCount);
+
+				unsigned int finalTriangleCount = finalIndexCount/3;
+
+				m_edges.clear();
+				m_edges.reserve(finalTriangleCount*3/2);
+				m_triangles.clear();
+				m_triangles.reserve(finalTriangleCount);
 				m_vertices = vertices;
-				m_vertexIndex = 0;
+				m_vertexCount = 0;
 
-				// Sommets de base
+				// Sommets de base (sur la sphère unité, la transformation est appliquée à la fin)
 				AddVertex({-1.f,  t, 0.f});
 				AddVertex({ 1.f,  t, 0.f});
 				AddVertex({-1.f, -t, 0.f});
@@ -68,59 +78,51 @@ namespace
 				AddVertex({-t, 0.f, -1.f});
 				AddVertex({-t, 0.f,  1.f});
 
-				std::vector<NzVector3ui> triangles;
-				triangles.reserve(20 * NzIntegralPow(4, recursionLevel));
-
 				// Cinq triangles autour du premier point
-				triangles.push_back({0, 11,  5});
-				triangles.push_back({0,  5,  1});
-				triangles.push_back({0,  1,  7});
-				triangles.push_back({0,  7, 10});
-				triangles.push_back({0, 10, 11});
+				AddBaseTriangle(0, 11,  5);
+				AddBaseTriangle(0,  5,  1);
+				AddBaseTriangle(0,  1,  7);
+				AddBaseTriangle(0,  7, 10);
+				AddBaseTriangle(0, 10, 11);
 
 				// Cinq faces adjaçentes
-				triangles.push_back({ 1,  5,  9});
-				triangles.push_back({ 5, 11,  4});
-				triangles.push_back({11, 10,  2});
-				triangles.push_back({10,  7,  6});
-				triangles.push_back({ 7,  1,  8});
+				AddBaseTriangle( 1,  5,  9);
+				AddBaseTriangle( 5, 11,  4);
+				AddBaseTriangle(11, 10,  2);
+				AddBaseTriangle(10,  7,  6);
+				AddBaseTriangle( 7,  1,  8);
 
 				// Cinq triangles autour du troisième point
-				triangles.push_back({3, 9, 4});
-				triangles.push_back({3, 4, 2});
-				triangles.push_back({3, 2, 6});
-				triangles.push_back({3, 6, 8});
-				triangles.push_back({3, 8, 9});
+				AddBaseTriangle(3, 9, 4);
+				AddBaseTriangle(3, 4, 2);
+				AddBaseTriangle(3, 2, 6);
+				AddBaseTriangle(3, 6, 8);
+				AddBaseTriangle(3, 8, 9);
 
 				// Cinq faces adjaçentes
-				triangles.push_back({4, 9,  5});
-				triangles.push_back({2, 4, 11});
-				triangles.push_back({6, 2, 10});
-				triangles.push_back({8, 6,  7});
-				triangles.push_back({9, 8,  1});
+				AddBaseTriangle(4, 9,  5);
+				AddBaseTriangle(2, 4, 11);
+				AddBaseTriangle(6, 2, 10);
+				AddBaseTriangle(8, 6,  7);
+				AddBaseTriangle(9, 8,  1);
 
 				// Et maintenant on affine la sphère
 				for (unsigned int i = 0; i < recursionLevel; ++i)
-				{
-					for (NzVector3ui& triangle : triangles)
-					{
-						unsigned int a = GetMiddleVertex(triangle.x, triangle.y);
-						unsigned int b = GetMiddleVertex(triangle.y, triangle.z);
-						unsigned int c = GetMiddleVertex(triangle.z, triangle.x);
-
-						triangles.push_back({triangle.x, a, c});
-						triangles.push_back({triangle.y, b, a});
-						triangles.push_back({triangle.z, c, b});
+					Subdivide();
 
-						triangle.Set(a, b, c); // Réutilisation du triangle
-					}
+				for (const Triangle& triangle : m_triangles)
+				{
+					*indices++ = triangle.vertices[0] + indexOffset;
+					*indices++ = triangle.vertices[1] + indexOffset;
+					*indices++ = triangle.vertices[2] + indexOffset;
 				}
 
-				for (const NzVector3ui& triangle : triangles)
+				for (unsigned int i = 0; i < m_vertexCount; ++i)
 				{
-					*indices++ = triangle.x + indexOffset;
-					*indices++ = triangle.y + indexOffset;
-					*indices++ = triangle.z + indexOffset;
+					NzMeshVertex& vertex = vertices[i];
+
+					vertex.normal = NzVector3f::Normalize(m_matrix.Transform(vertex.position, 0.f));
+					vertex.position = m_matrix.Transform(size * vertex.position);
 				}
 
 				if (aabb)
@@ -130,37 +132,118 @@ namespace
 				}
 			}
 
-			unsigned int AddVertex(const NzVector3f& position)
+		private:
+			struct Edge
 			{
-				NzMeshVertex& vertex = m_vertices[m_vertexIndex];
+				unsigned int vertices[2];
+			};
 
-				vertex.normal = NzVector3f::Normalize(m_matrix.Transform(position, 0.f));
-				vertex.position = m_matrix.Transform(m_size * position.GetNormal());
+			struct Triangle
+			{
+				unsigned int edges[3]; // Arêtes (0,1), (1,2) et (2,0)
+				unsigned int vertices[3];
+			};
 
-				return m_vertexIndex++;
+			void AddBaseTriangle(unsigned int a, unsigned int b, unsigned int c)
+			{
+				Triangle triangle;
+				triangle.edges[0] = GetBaseEdge(a, b);
+				triangle.edges[1] = GetBaseEdge(b, c);
+				triangle.edges[2] = GetBaseEdge(c, a);
+				triangle.vertices[0] = a;
+				triangle.vertices[1] = b;
+				triangle.vertices[2] = c;
+
+				m_triangles.push_back(triangle);
 			}
 
-			unsigned int GetMiddleVertex(unsigned int index1, unsigned int index2)
+			void AddVertex(const NzVector3f& position)
 			{
-				nzUInt64 key = (static_cast<nzUInt64>(std::min(index1, index2)) << 32) + static_cast<nzUInt32>(std::max(index1, index2));
-				auto it = m_cache.find(key);
-				if (it != m_cache.end())
-					return it->second;
+				m_vertices[m_vertexCount++].position = position.GetNormal();
+			}
 
-				NzVector3f middle = NzVector3f::Lerp(m_vertices[index1].position, m_vertices[index2].position, 0.5f);
+			unsigned int GetBaseEdge(unsigned int a, unsigned int b)
+			{
+				// Seulement trente arêtes pour l'icosaèdre de base, une recherche linéaire suffit
+				for (unsigned int i = 0; i < m_edges.size(); ++i)
+				{
+					const Edge& edge = m_edges[i];
+					if ((edge.vertices[0] == a && edge.vertices[1] == b) || (edge.vertices[0] == b && edge.vertices[1] == a))
+						return i;
+				}
 
-				unsigned int index = AddVertex(middle);
-				m_cache[key] = index;
+				m_edges.push_back({{a, b}});
+				return m_edges.size()-1;
+			}
 
-				return index;
+			// Moitié de l'arête (du niveau précédent) contenant le sommet
+			unsigned int GetHalfEdge(unsigned int edge, unsigned int vertex) const
+			{
+				return 2*edge + ((m_oldEdges[edge].vertices[0] == vertex) ? 0 : 1);
 			}
 
-		private:
-			std::unordered_map<nzUInt64, unsigned int> m_cache;
+			void Subdivide()
+			{
+				unsigned int edgeCount = m_edges.size();
+				unsigned int triangleCount = m_triangles.size();
+				unsigned int vertexCount = m_vertexCount;
+
+				// Un nouveau sommet au milieu de chaque arête
+				for (const Edge& edge : m_edges)
+					AddVertex(NzVector3f::Lerp(m_vertices[edge.vertices[0]].position, m_vertices[edge.vertices[1]].position, 0.5f));
+
+				// Chaque arête est coupée en deux
+				m_oldEdges.assign(m_edges.begin(), m_edges.end());
+				m_edges.resize(2*edgeCount + 3*triangleCount);
+				for (unsigned int i = 0; i < edgeCount; ++i)
+				{
+					const Edge& edge = m_oldEdges[i];
+					unsigned int middle = vertexCount + i;
+
+					m_edges[2*i + 0] = {{edge.vertices[0], middle}};
+					m_edges[2*i + 1] = {{middle, edge.vertices[1]}};
+				}
+
+				m_triangles.resize(4*triangleCount);
+				for (unsigned int i = 0; i < triangleCount; ++i)
+				{
+					Triangle& triangle = m_triangles[i];
+
+					unsigned int x = triangle.vertices[0];
+					unsigned int y = triangle.vertices[1];
+					unsigned int z = triangle.vertices[2];
+
+					unsigned int xy = triangle.edges[0];
+					unsigned int yz = triangle.edges[1];
+					unsigned int zx = triangle.edges[2];
+
+					unsigned int a = vertexCount + xy;
+					unsigned int b = vertexCount + yz;
+					unsigned int c = vertexCount + zx;
+
+					// Arêtes intérieures
+					unsigned int ab = 2*edgeCount + 3*i;
+					unsigned int bc = ab + 1;
+					unsigned int ca = ab + 2;
+
+					m_edges[ab] = {{a, b}};
+					m_edges[bc] = {{b, c}};
+					m_edges[ca] = {{c, a}};
+
+					m_triangles[triangleCount + 3*i + 0] = {{GetHalfEdge(xy, x), ca, GetHalfEdge(zx, x)}, {x, a, c}};
+					m_triangles[triangleCount + 3*i + 1] = {{GetHalfEdge(yz, y), ab, GetHalfEdge(xy, y)}, {y, b, a}};
+					m_triangles[triangleCount + 3*i + 2] = {{GetHalfEdge(zx, z), bc, GetHalfEdge(yz, z)}, {z, c, b}};
+
+					triangle = {{ab, bc, ca}, {a, b, c}}; // Réutilisation du triangle
+				}
+			}
+
+			std::vector<Edge> m_edges;
+			std::vector<Edge> m_oldEdges;
+			std::vector<Triangle> m_triangles;
 			const NzMatrix4f& m_matrix;
 			NzMeshVertex* m_vertices;
-			float m_size;
-			unsigned int m_vertexIndex;
+			unsigned int m_vertexCount;
 	};
 
 	// Source: https://code.google.com/p/vcacne/
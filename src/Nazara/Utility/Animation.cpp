@@ -154,6 +154,77 @@ void NzAnimation::AnimateSkeleton(NzSkeleton* targetSkeleton, unsigned int frame
 	}
 }
 
+void NzAnimation::AnimateSkeleton(NzSkeleton* targetSkeleton, unsigned int frameA, unsigned int frameB, float interpolation, const unsigned int* indices, unsigned int indiceCount) const
+{
+	#if NAZARA_UTILITY_SAFE
+	if (!m_impl)
+	{
+		NazaraError("Animation not created");
+		return;
+	}
+
+	if (m_impl->type != nzAnimationType_Skeletal)
+	{
+		NazaraError("Animation is not skeletal");
+		return;
+	}
+
+	if (!targetSkeleton || !targetSkeleton->IsValid())
+	{
+		NazaraError("Target skeleton is invalid");
+		return;
+	}
+
+	if (targetSkeleton->GetJointCount() != m_impl->jointCount)
+	{
+		NazaraError("Target skeleton joint count must match animation joint count");
+		return;
+	}
+
+	if (frameA >= m_impl->frameCount)
+	{
+		NazaraError("Frame A is out of range (" + NzString::Number(frameA) + " >= " + NzString::Number(m_impl->frameCount) + ')');
+		return;
+	}
+
+	if (frameB >= m_impl->frameCount)
+	{
+		NazaraError("Frame B is out of range (" + NzString::Number(frameB) + " >= " + NzString::Number(m_impl->frameCount) + ')');
+		return;
+	}
+	#endif
+
+	#ifdef NAZARA_DEBUG
+	if (interpolation < 0.f || interpolation > 1.f)
+	{
+		NazaraError("Interpolation must be in range [0..1] (Got " + NzString::Number(interpolation) + ')');
+		return;
+	}
+	#endif
+
+	for (unsigned int i = 0; i < indiceCount; ++i)
+	{
+		unsigned int index = indices[i];
+
+		#if NAZARA_UTILITY_SAFE
+		if (index >= m_impl->jointCount)
+		{
+			NazaraError("Index #" + NzString::Number(i) + " out of range (" + NzString::Number(index) + " >= " + NzString::Number(m_impl->jointCount) + ')');
+			return;
+		}
+		#endif
+
+		NzJoint* joint = targetSkeleton->GetJoint(index);
+
+		NzSequenceJoint& sequenceJointA = m_impl->sequenceJoints[frameA*m_impl->jointCount + index];
+		NzSequenceJoint& sequenceJointB = m_impl->sequenceJoints[frameB*m_impl->jointCount + index];
+
+		joint->SetPosition(NzVector3f::Lerp(sequenceJointA.position, sequenceJointB.position, interpolation));
+		joint->SetRotation(NzQuaternionf::Slerp(sequenceJointA.rotation, sequenceJointB.rotation, interpolation));
+		joint->SetScale(NzVector3f::Lerp(sequenceJointA.scale, sequenceJointB.scale, interpolation));
+	}
+}
+
 bool NzAnimation::CreateSkeletal(unsigned int frameCount, unsigned int jointCount)
 {
 	Destroy();
@@ -814,6 +814,7 @@ void NzMesh::Recenter()
 		aabb.Translate(-center);
 
 		staticMesh->SetAABB(aabb);
+		staticMesh->InvalidateBVH();
 	}
 
 	// Il ne faut pas oublier d'invalider notre AABB
@@ -986,6 +987,7 @@ void NzMesh::Transform(const NzMatrix4f& matrix)
 		}
 
 		staticMesh->SetAABB(aabb);
+		staticMesh->InvalidateBVH();
 	}
 
 	// Il ne faut pas oublier d'invalider notre AABB
@@ -0,0 +1,442 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Utility module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Utility/MeshletList.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Utility/BufferMapper.hpp>
+#include <Nazara/Utility/Config.hpp>
+#include <Nazara/Utility/IndexMapper.hpp>
+#include <Nazara/Utility/Mesh.hpp>
+#include <Nazara/Utility/StaticMesh.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <Nazara/Utility/Debug.hpp>
+
+namespace
+{
+	const unsigned int s_invalidIndex = std::numeric_limits<unsigned int>::max();
+
+	struct MeshletBuilder
+	{
+		const NzVector3f* positions;
+		const nzUInt32* indices;
+		std::vector<unsigned int> adjacencyOffsets;
+		std::vector<unsigned int> adjacency;
+		std::vector<unsigned int> liveTriangles; // Nombre de triangles non-émis utilisant chaque sommet
+		std::vector<unsigned int> vertexMeshlet; // Identifiant du dernier meshlet ayant utilisé chaque sommet
+		std::vector<bool> emitted;
+		std::vector<unsigned int> meshletTriangles;
+		std::vector<unsigned int> meshletVertices;
+		unsigned int maxVertices;
+		unsigned int maxTriangles;
+		unsigned int meshletId;
+	};
+
+	unsigned int CountNewVertices(const MeshletBuilder& builder, unsigned int triangle)
+	{
+		unsigned int count = 0;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			if (builder.vertexMeshlet[builder.indices[triangle*3 + i]] != builder.meshletId)
+				count++;
+		}
+
+		return count;
+	}
+
+	unsigned int FindCandidate(const MeshletBuilder& builder, const unsigned int* vertices, unsigned int vertexCount)
+	{
+		// On favorise les triangles ajoutant le moins de sommets, puis ceux finissant des sommets presque épuisés
+		unsigned int best = s_invalidIndex;
+		unsigned int bestNewVertices = 4;
+		unsigned int bestLiveCount = s_invalidIndex;
+
+		for (unsigned int i = 0; i < vertexCount; ++i)
+		{
+			unsigned int vertex = vertices[i];
+			for (unsigned int j = builder.adjacencyOffsets[vertex]; j < builder.adjacencyOffsets[vertex+1]; ++j)
+			{
+				unsigned int triangle = builder.adjacency[j];
+				if (builder.emitted[triangle])
+					continue;
+
+				unsigned int newVertices = CountNewVertices(builder, triangle);
+				if (builder.meshletVertices.size() + newVertices > builder.maxVertices)
+					continue;
+
+				unsigned int liveCount = builder.liveTriangles[builder.indices[triangle*3 + 0]] +
+				                         builder.liveTriangles[builder.indices[triangle*3 + 1]] +
+				                         builder.liveTriangles[builder.indices[triangle*3 + 2]];
+
+				if (newVertices < bestNewVertices || (newVertices == bestNewVertices && liveCount < bestLiveCount))
+				{
+					best = triangle;
+					bestNewVertices = newVertices;
+					bestLiveCount = liveCount;
+				}
+			}
+		}
+
+		return best;
+	}
+
+	void AddTriangle(MeshletBuilder& builder, unsigned int triangle)
+	{
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			unsigned int vertex = builder.indices[triangle*3 + i];
+			if (builder.vertexMeshlet[vertex] != builder.meshletId)
+			{
+				builder.vertexMeshlet[vertex] = builder.meshletId;
+				builder.meshletVertices.push_back(vertex);
+			}
+
+			builder.liveTriangles[vertex]--;
+		}
+
+		builder.emitted[triangle] = true;
+		builder.meshletTriangles.push_back(triangle);
+	}
+
+	void FlushMeshlet(MeshletBuilder& builder, std::vector<NzMeshlet>& meshlets, std::vector<nzUInt32>& indices)
+	{
+		if (builder.meshletTriangles.empty())
+			return;
+
+		NzMeshlet meshlet;
+		meshlet.firstIndex = indices.size();
+		meshlet.triangleCount = builder.meshletTriangles.size();
+		meshlet.vertexCount = builder.meshletVertices.size();
+
+		// Sphère englobante centrée sur l'AABB des sommets
+		NzVector3f minimum = builder.positions[builder.meshletVertices[0]];
+		NzVector3f maximum = minimum;
+		for (unsigned int vertex : builder.meshletVertices)
+		{
+			minimum.Minimize(builder.positions[vertex]);
+			maximum.Maximize(builder.positions[vertex]);
+		}
+
+		NzVector3f center = (minimum + maximum)*0.5f;
+		float squaredRadius = 0.f;
+		for (unsigned int vertex : builder.meshletVertices)
+			squaredRadius = std::max(squaredRadius, center.SquaredDistance(builder.positions[vertex]));
+
+		meshlet.boundingSphere.Set(center, std::sqrt(squaredRadius));
+
+		// Cône de normales: l'axe est la moyenne des normales, l'ouverture est donnée par la normale la plus éloignée
+		std::vector<NzVector3f> normals;
+		normals.reserve(meshlet.triangleCount);
+
+		NzVector3f axis = NzVector3f::Zero();
+		for (unsigned int triangle : builder.meshletTriangles)
+		{
+			const NzVector3f& p0 = builder.positions[builder.indices[triangle*3 + 0]];
+			const NzVector3f& p1 = builder.positions[builder.indices[triangle*3 + 1]];
+			const NzVector3f& p2 = builder.positions[builder.indices[triangle*3 + 2]];
+
+			NzVector3f normal = (p1 - p0).CrossProduct(p2 - p0);
+			float length = normal.GetLength();
+			if (length <= std::numeric_limits<float>::epsilon())
+				continue; // Triangle dégénéré, sans orientation
+
+			normal /= length;
+			normals.push_back(normal);
+			axis += normal;
+		}
+
+		float axisLength = axis.GetLength();
+		float minDot = 1.f;
+		if (axisLength > std::numeric_limits<float>::epsilon())
+		{
+			axis /= axisLength;
+			for (const NzVector3f& normal : normals)
+				minDot = std::min(minDot, normal.DotProduct(axis));
+		}
+		else
+			minDot = -1.f;
+
+		meshlet.coneAxis = (axisLength > std::numeric_limits<float>::epsilon()) ? axis : NzVector3f::Zero();
+		if (minDot <= 0.1f)
+			meshlet.coneCutoff = 1.f; // Cône trop ouvert (> ~84°), le test d'orientation ne rejettera jamais ce cluster
+		else
+			meshlet.coneCutoff = std::sqrt(1.f - minDot*minDot);
+
+		for (unsigned int triangle : builder.meshletTriangles)
+		{
+			indices.push_back(builder.indices[triangle*3 + 0]);
+			indices.push_back(builder.indices[triangle*3 + 1]);
+			indices.push_back(builder.indices[triangle*3 + 2]);
+		}
+
+		meshlets.push_back(meshlet);
+
+		builder.meshletTriangles.clear();
+		builder.meshletVertices.clear();
+		builder.meshletId++;
+	}
+}
+
+bool NzMeshletList::Build(const NzStaticMesh* staticMesh, unsigned int maxVertices, unsigned int maxTriangles)
+{
+	#if NAZARA_UTILITY_SAFE
+	if (!staticMesh || !staticMesh->IsValid())
+	{
+		NazaraError("Invalid static mesh");
+		return false;
+	}
+
+	if (staticMesh->GetPrimitiveMode() != nzPrimitiveMode_TriangleList)
+	{
+		NazaraError("Only triangle lists can be clustered");
+		return false;
+	}
+	#endif
+
+	unsigned int vertexCount = staticMesh->GetVertexCount();
+	std::vector<NzVector3f> positions(vertexCount);
+	{
+		NzBufferMapper<NzVertexBuffer> mapper(staticMesh->GetVertexBuffer(), nzBufferAccess_ReadOnly);
+		const NzMeshVertex* vertices = static_cast<const NzMeshVertex*>(mapper.GetPointer());
+
+		for (unsigned int i = 0; i < vertexCount; ++i)
+			positions[i] = vertices[i].position;
+	}
+
+	std::vector<nzUInt32> indices;
+	const NzIndexBuffer* indexBuffer = staticMesh->GetIndexBuffer();
+	if (indexBuffer)
+	{
+		NzIndexMapper mapper(indexBuffer);
+
+		unsigned int indexCount = mapper.GetIndexCount();
+		indices.resize(indexCount);
+		for (unsigned int i = 0; i < indexCount; ++i)
+			indices[i] = mapper.Get(i);
+	}
+	else
+	{
+		indices.resize(vertexCount);
+		for (unsigned int i = 0; i < vertexCount; ++i)
+			indices[i] = i;
+	}
+
+	return Build(positions.data(), vertexCount, indices.data(), indices.size(), maxVertices, maxTriangles);
+}
+
+bool NzMeshletList::Build(const NzVector3f* positions, unsigned int vertexCount, const nzUInt32* indices, unsigned int indexCount, unsigned int maxVertices, unsigned int maxTriangles)
+{
+	#if NAZARA_UTILITY_SAFE
+	if (indexCount % 3 != 0)
+	{
+		NazaraError("Index count must be a multiple of three (" + NzString::Number(indexCount) + ')');
+		return false;
+	}
+
+	if (maxVertices < 3 || maxTriangles == 0)
+	{
+		NazaraError("Meshlets must at least be able to hold one triangle");
+		return false;
+	}
+
+	if (indexCount > 0 && (!positions || !indices))
+	{
+		NazaraError("Invalid positions or indices");
+		return false;
+	}
+
+	for (unsigned int i = 0; i < indexCount; ++i)
+	{
+		if (indices[i] >= vertexCount)
+		{
+			NazaraError("Index #" + NzString::Number(i) + " out of range (" + NzString::Number(indices[i]) + " >= " + NzString::Number(vertexCount) + ')');
+			return false;
+		}
+	}
+	#endif
+
+	Clear();
+
+	unsigned int triangleCount = indexCount/3;
+	if (triangleCount == 0)
+		return true;
+
+	MeshletBuilder builder;
+	builder.positions = positions;
+	builder.indices = indices;
+	builder.maxVertices = maxVertices;
+	builder.maxTriangles = maxTriangles;
+	builder.meshletId = 0;
+
+	// Adjacence sommet -> triangles, stockée de façon compacte
+	builder.liveTriangles.assign(vertexCount, 0);
+	for (unsigned int i = 0; i < indexCount; ++i)
+		builder.liveTriangles[indices[i]]++;
+
+	builder.adjacencyOffsets.resize(vertexCount+1);
+	builder.adjacencyOffsets[0] = 0;
+	for (unsigned int i = 0; i < vertexCount; ++i)
+		builder.adjacencyOffsets[i+1] = builder.adjacencyOffsets[i] + builder.liveTriangles[i];
+
+	builder.adjacency.resize(indexCount);
+	std::vector<unsigned int> fill(builder.adjacencyOffsets.begin(), builder.adjacencyOffsets.end()-1);
+	for (unsigned int i = 0; i < indexCount; ++i)
+		builder.adjacency[fill[indices[i]]++] = i/3;
+
+	builder.vertexMeshlet.assign(vertexCount, s_invalidIndex);
+	builder.emitted.assign(triangleCount, false);
+	builder.meshletTriangles.reserve(maxTriangles);
+	builder.meshletVertices.reserve(maxVertices);
+
+	m_indices.reserve(indexCount);
+	m_meshlets.reserve(triangleCount/maxTriangles + 1);
+
+	unsigned int seed = 0;
+	unsigned int emittedCount = 0;
+	while (emittedCount < triangleCount)
+	{
+		unsigned int candidate = s_invalidIndex;
+		if (!builder.meshletTriangles.empty())
+		{
+			// Les voisins du dernier triangle d'abord (le plus souvent suffisant), puis ceux de tout le meshlet
+			unsigned int lastTriangle = builder.meshletTriangles.back();
+			unsigned int lastVertices[3] = {indices[lastTriangle*3 + 0], indices[lastTriangle*3 + 1], indices[lastTriangle*3 + 2]};
+
+			candidate = FindCandidate(builder, lastVertices, 3);
+			if (candidate == s_invalidIndex)
+				candidate = FindCandidate(builder, builder.meshletVertices.data(), builder.meshletVertices.size());
+		}
+
+		if (candidate == s_invalidIndex)
+		{
+			// Plus aucun voisin, on reprend au prochain triangle dans l'ordre du buffer
+			while (builder.emitted[seed])
+				seed++;
+
+			if (builder.meshletVertices.size() + CountNewVertices(builder, seed) > maxVertices)
+			{
+				FlushMeshlet(builder, m_meshlets, m_indices);
+				continue;
+			}
+
+			candidate = seed;
+		}
+
+		AddTriangle(builder, candidate);
+		emittedCount++;
+
+		if (builder.meshletTriangles.size() >= maxTriangles)
+			FlushMeshlet(builder, m_meshlets, m_indices);
+	}
+
+	FlushMeshlet(builder, m_meshlets, m_indices);
+
+	return true;
+}
+
+void NzMeshletList::Clear()
+{
+	m_indices.clear();
+	m_meshlets.clear();
+}
+
+unsigned int NzMeshletList::Cull(const NzFrustumf& frustum, const NzVector3f& eyePosition, unsigned int* visibleMeshlets) const
+{
+	#if NAZARA_UTILITY_SAFE
+	if (!visibleMeshlets && !m_meshlets.empty())
+	{
+		NazaraError("Invalid meshlet array");
+		return 0;
+	}
+	#endif
+
+	// Le frustum et la position de l'observateur doivent être exprimés dans le repère du mesh
+	unsigned int visibleCount = 0;
+	for (unsigned int i = 0; i < m_meshlets.size(); ++i)
+	{
+		const NzMeshlet& meshlet = m_meshlets[i];
+		if (!frustum.Contains(meshlet.boundingSphere))
+			continue;
+
+		// Tous les triangles du cluster tournent le dos à l'observateur
+		NzVector3f toCenter = meshlet.boundingSphere.GetPosition() - eyePosition;
+		if (toCenter.DotProduct(meshlet.coneAxis) >= meshlet.coneCutoff*toCenter.GetLength() + meshlet.boundingSphere.radius)
+			continue;
+
+		visibleMeshlets[visibleCount++] = i;
+	}
+
+	return visibleCount;
+}
+
+unsigned int NzMeshletList::GenerateDrawRanges(const unsigned int* meshlets, unsigned int meshletCount, NzMeshletDrawRange* ranges) const
+{
+	// Les meshlets consécutifs dans le buffer d'indices sont fusionnés en un seul appel de rendu
+	unsigned int rangeCount = 0;
+	for (unsigned int i = 0; i < meshletCount; ++i)
+	{
+		const NzMeshlet& meshlet = m_meshlets[meshlets[i]];
+		if (rangeCount > 0 && ranges[rangeCount-1].firstIndex + ranges[rangeCount-1].indexCount == meshlet.firstIndex)
+			ranges[rangeCount-1].indexCount += meshlet.triangleCount*3;
+		else
+		{
+			ranges[rangeCount].firstIndex = meshlet.firstIndex;
+			ranges[rangeCount].indexCount = meshlet.triangleCount*3;
+			rangeCount++;
+		}
+	}
+
+	return rangeCount;
+}
+
+unsigned int NzMeshletList::GenerateIndices(const unsigned int* meshlets, unsigned int meshletCount, nzUInt32* indices) const
+{
+	unsigned int indexCount = 0;
+	for (unsigned int i = 0; i < meshletCount; ++i)
+	{
+		const NzMeshlet& meshlet = m_meshlets[meshlets[i]];
+		std::memcpy(&indices[indexCount], &m_indices[meshlet.firstIndex], meshlet.triangleCount*3*sizeof(nzUInt32));
+
+		indexCount += meshlet.triangleCount*3;
+	}
+
+	return indexCount;
+}
+
+const nzUInt32* NzMeshletList::GetIndices() const
+{
+	return m_indices.data();
+}
+
+unsigned int NzMeshletList::GetIndexCount() const
+{
+	return m_indices.size();
+}
+
+const NzMeshlet& NzMeshletList::GetMeshlet(unsigned int i) const
+{
+	#if NAZARA_UTILITY_SAFE
+	if (i >= m_meshlets.size())
+	{
+		NazaraError("Meshlet index out of range (" + NzString::Number(i) + " >= " + NzString::Number(m_meshlets.size()) + ')');
+
+		static NzMeshlet dummy;
+		return dummy;
+	}
+	#endif
+
+	return m_meshlets[i];
+}
+
+unsigned int NzMeshletList::GetMeshletCount() const
+{
+	return m_meshlets.size();
+}
+
+bool NzMeshletList::IsEmpty() const
+{
+	return m_meshlets.empty();
+}
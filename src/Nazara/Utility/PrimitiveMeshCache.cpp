@@ -0,0 +1,192 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Utility module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Utility/PrimitiveMeshCache.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Utility/Config.hpp>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <Nazara/Utility/Debug.hpp>
+
+namespace
+{
+	// Les paramètres d'une primitive sont sérialisés dans un tableau de mots (à zéro pour les champs inutilisés)
+	// afin de ne pas dépendre du contenu indéterminé des unions
+	using PrimitiveKey = std::array<nzUInt32, 32>;
+
+	class KeyBuilder
+	{
+		public:
+			KeyBuilder(PrimitiveKey& key) :
+			m_key(key),
+			m_offset(0)
+			{
+				m_key.fill(0);
+			}
+
+			void Add(float value)
+			{
+				std::memcpy(&m_key[m_offset++], &value, sizeof(float));
+			}
+
+			void Add(nzUInt32 value)
+			{
+				m_key[m_offset++] = value;
+			}
+
+			void Add(const NzVector3f& vec)
+			{
+				Add(vec.x);
+				Add(vec.y);
+				Add(vec.z);
+			}
+
+		private:
+			PrimitiveKey& m_key;
+			unsigned int m_offset;
+	};
+
+	struct KeyHash
+	{
+		std::size_t operator()(const PrimitiveKey& key) const
+		{
+			// FNV-1a
+			std::size_t h = 2166136261U;
+			for (nzUInt32 word : key)
+			{
+				h ^= word;
+				h *= 16777619U;
+			}
+
+			return h;
+		}
+	};
+
+	void BuildKey(const NzPrimitive& primitive, const NzMeshParams& params, PrimitiveKey* key)
+	{
+		KeyBuilder builder(*key);
+
+		builder.Add(static_cast<nzUInt32>(params.storage));
+		builder.Add(params.scale);
+		builder.Add(static_cast<nzUInt32>(params.optimizeIndexBuffers));
+
+		for (unsigned int i = 0; i < 4; ++i)
+			for (unsigned int j = 0; j < 4; ++j)
+				builder.Add(primitive.matrix(i, j));
+
+		builder.Add(primitive.textureCoords.x);
+		builder.Add(primitive.textureCoords.y);
+		builder.Add(primitive.textureCoords.width);
+		builder.Add(primitive.textureCoords.height);
+
+		builder.Add(static_cast<nzUInt32>(primitive.type));
+		switch (primitive.type)
+		{
+			case nzPrimitiveType_Box:
+				builder.Add(primitive.box.lengths);
+				builder.Add(primitive.box.subdivision.x);
+				builder.Add(primitive.box.subdivision.y);
+				builder.Add(primitive.box.subdivision.z);
+				break;
+
+			case nzPrimitiveType_Plane:
+				builder.Add(primitive.plane.size.x);
+				builder.Add(primitive.plane.size.y);
+				builder.Add(primitive.plane.subdivision.x);
+				builder.Add(primitive.plane.subdivision.y);
+				break;
+
+			case nzPrimitiveType_Sphere:
+				builder.Add(static_cast<nzUInt32>(primitive.sphere.type));
+				builder.Add(primitive.sphere.size);
+				switch (primitive.sphere.type)
+				{
+					case nzSphereType_Cubic:
+						builder.Add(primitive.sphere.cubic.subdivision);
+						break;
+
+					case nzSphereType_Ico:
+						builder.Add(primitive.sphere.ico.recursionLevel);
+						break;
+
+					case nzSphereType_UV:
+						builder.Add(primitive.sphere.uv.sliceCount);
+						builder.Add(primitive.sphere.uv.stackCount);
+						break;
+				}
+				break;
+		}
+	}
+
+	std::unordered_map<PrimitiveKey, NzMeshRef, KeyHash> s_meshes;
+}
+
+void NzPrimitiveMeshCache::Clear()
+{
+	s_meshes.clear();
+}
+
+NzMesh* NzPrimitiveMeshCache::Get(const NzPrimitive& primitive, const NzMeshParams& params)
+{
+	PrimitiveKey key;
+	BuildKey(primitive, params, &key);
+
+	auto it = s_meshes.find(key);
+	if (it != s_meshes.end())
+		return it->second;
+
+	std::unique_ptr<NzMesh> mesh(new NzMesh);
+	mesh->SetPersistent(false);
+
+	if (!mesh->CreateStatic())
+	{
+		NazaraError("Failed to create mesh");
+		return nullptr;
+	}
+
+	if (!mesh->BuildSubMesh(primitive, params))
+	{
+		NazaraError("Failed to build primitive");
+		return nullptr;
+	}
+
+	s_meshes[key] = mesh.get();
+
+	return mesh.release();
+}
+
+unsigned int NzPrimitiveMeshCache::GetMeshCount()
+{
+	return s_meshes.size();
+}
+
+unsigned int NzPrimitiveMeshCache::Purge()
+{
+	// Les meshes dont le cache est le dernier utilisateur sont libérés
+	unsigned int count = 0;
+	for (auto it = s_meshes.begin(); it != s_meshes.end();)
+	{
+		if (it->second->GetResourceReferenceCount() <= 1)
+		{
+			it = s_meshes.erase(it);
+			count++;
+		}
+		else
+			++it;
+	}
+
+	return count;
+}
+
+bool NzPrimitiveMeshCache::Initialize()
+{
+	return true;
+}
+
+void NzPrimitiveMeshCache::Uninitialize()
+{
+	s_meshes.clear();
+}
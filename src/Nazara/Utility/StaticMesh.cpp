@@ -40,6 +40,8 @@ bool NzStaticMesh::Create(NzVertexBuffer* vertexBuffer)
 
 void NzStaticMesh::Destroy()
 {
+	InvalidateBVH();
+
 	if (m_vertexBuffer)
 	{
 		NotifyDestroy();
@@ -64,6 +66,30 @@ bool NzStaticMesh::GenerateAABB()
 	return true;
 }
 
+bool NzStaticMesh::GenerateBVH()
+{
+	#if NAZARA_UTILITY_SAFE
+	if (!m_vertexBuffer)
+	{
+		NazaraError("Static mesh not created");
+		return false;
+	}
+	#endif
+
+	if (!m_bvh)
+		m_bvh = new NzTriangleBVH;
+
+	if (!m_bvh->Build(this))
+	{
+		NazaraError("Failed to build BVH");
+		InvalidateBVH();
+
+		return false;
+	}
+
+	return true;
+}
+
 const NzBoxf& NzStaticMesh::GetAABB() const
 {
 	return m_aabb;
@@ -74,6 +100,11 @@ nzAnimationType NzStaticMesh::GetAnimationType() const
 	return nzAnimationType_Static;
 }
 
+const NzTriangleBVH* NzStaticMesh::GetBVH() const
+{
+	return m_bvh;
+}
+
 const NzIndexBuffer* NzStaticMesh::GetIndexBuffer() const
 {
 	return m_indexBuffer;
@@ -94,6 +125,13 @@ unsigned int NzStaticMesh::GetVertexCount() const
 	return m_vertexBuffer->GetVertexCount();
 }
 
+void NzStaticMesh::InvalidateBVH()
+{
+	// Le BVH sera reconstruit au prochain appel à GenerateBVH
+	delete m_bvh;
+	m_bvh = nullptr;
+}
+
 bool NzStaticMesh::IsAnimated() const
 {
 	return false;
@@ -111,6 +149,8 @@ void NzStaticMesh::SetAABB(const NzBoxf& aabb)
 
 void NzStaticMesh::SetIndexBuffer(const NzIndexBuffer* indexBuffer)
 {
+	InvalidateBVH();
+
 	if (m_indexBuffer)
 		m_indexBuffer->RemoveResourceListener(this);
 
@@ -124,6 +164,8 @@ void NzStaticMesh::OnResourceReleased(const NzResource* resource, int index)
 {
 	NazaraUnused(index);
 
+	InvalidateBVH();
+
 	if (resource == m_indexBuffer)
 		m_indexBuffer = nullptr;
 	else if (resource == m_vertexBuffer)
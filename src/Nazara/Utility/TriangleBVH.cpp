@@ -0,0 +1,851 @@
+// Copyright (C) 2013 Jérôme Leclercq
+// This file is part of the "Nazara Engine - Utility module"
+// For conditions of distribution and use, see copyright notice in Config.hpp
+
+#include <Nazara/Utility/TriangleBVH.hpp>
+#include <Nazara/Core/Error.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <Nazara/Utility/Config.hpp>
+#include <Nazara/Utility/SubMesh.hpp>
+#include <Nazara/Utility/TriangleIterator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <Nazara/Utility/Debug.hpp>
+
+namespace
+{
+	const unsigned int s_binCount = 16;
+	const unsigned int s_maxDepth = 64; // Borne la taille des piles de parcours
+	const unsigned int s_maxLeafSize = 16; // Au-delà, on découpe même si le SAH préfère une feuille
+	const unsigned int s_minLeafSize = 2;
+	const unsigned int s_packetSize = 4;
+	const float s_traversalCost = 1.f; // Coût d'un test de boîte relativement à un test de triangle
+
+	struct Bounds
+	{
+		void Extend(const NzVector3f& point)
+		{
+			min.Minimize(point);
+			max.Maximize(point);
+		}
+
+		void Extend(const Bounds& bounds)
+		{
+			min.Minimize(bounds.min);
+			max.Maximize(bounds.max);
+		}
+
+		float GetSurfaceArea() const
+		{
+			NzVector3f lengths = max - min;
+			return 2.f*(lengths.x*lengths.y + lengths.y*lengths.z + lengths.z*lengths.x);
+		}
+
+		void Reset()
+		{
+			min.Set(std::numeric_limits<float>::infinity());
+			max.Set(-std::numeric_limits<float>::infinity());
+		}
+
+		NzVector3f min;
+		NzVector3f max;
+	};
+
+	struct Reference
+	{
+		Bounds bounds;
+		NzVector3f centroid;
+		unsigned int triangle;
+	};
+
+	struct Bin
+	{
+		Bounds bounds;
+		unsigned int count;
+	};
+
+	struct StackEntry
+	{
+		unsigned int node;
+		float distance;
+	};
+
+	#if NAZARA_UTILITY_MULTITHREADED_BVH
+	const unsigned int s_parallelDepth = 3; // Jusqu'à 8 sous-arbres construits en parallèle
+	const unsigned int s_parallelMinTriangles = 4096;
+
+	struct SubtreeJob
+	{
+		std::vector<NzTriangleBVH::Node> nodes;
+		Reference* references;
+		unsigned int nodeIndex;
+		unsigned int begin;
+		unsigned int end;
+		unsigned int depth;
+		unsigned int maxDepth;
+	};
+	#endif
+
+	unsigned int BinIndex(float centroid, float minimum, float scale)
+	{
+		return std::min(static_cast<unsigned int>((centroid - minimum)*scale), s_binCount-1);
+	}
+
+	void SetNodeBounds(NzTriangleBVH::Node& node, const Bounds& bounds)
+	{
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			node.min[i] = bounds.min[i];
+			node.max[i] = bounds.max[i];
+		}
+	}
+
+	unsigned int BuildRecursive(std::vector<NzTriangleBVH::Node>& nodes, unsigned int nodeIndex, Reference* references, unsigned int begin, unsigned int end, unsigned int depth, void* jobs)
+	{
+		Bounds bounds;
+		Bounds centroidBounds;
+		bounds.Reset();
+		centroidBounds.Reset();
+
+		for (unsigned int i = begin; i < end; ++i)
+		{
+			bounds.Extend(references[i].bounds);
+			centroidBounds.Extend(references[i].centroid);
+		}
+
+		SetNodeBounds(nodes[nodeIndex], bounds);
+
+		unsigned int count = end - begin;
+		if (count <= s_minLeafSize || depth+1 >= s_maxDepth)
+		{
+			nodes[nodeIndex].offset = begin;
+			nodes[nodeIndex].triangleCount = count;
+			return depth;
+		}
+
+		#if NAZARA_UTILITY_MULTITHREADED_BVH
+		if (jobs && depth == s_parallelDepth && count >= s_parallelMinTriangles)
+		{
+			// Le sous-arbre sera construit par un worker, on se contente de noter le travail à faire
+			SubtreeJob job;
+			job.references = references;
+			job.nodeIndex = nodeIndex;
+			job.begin = begin;
+			job.end = end;
+			job.depth = depth;
+			job.maxDepth = depth;
+
+			static_cast<std::vector<SubtreeJob>*>(jobs)->push_back(std::move(job));
+			return depth;
+		}
+		#else
+		NazaraUnused(jobs);
+		#endif
+
+		// Découpage selon le SAH (Surface Area Heuristic), évalué sur des intervalles réguliers (binning)
+		float bestCost = std::numeric_limits<float>::infinity();
+		unsigned int bestAxis = 0;
+		unsigned int bestBin = 0;
+
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+			if (extent <= std::numeric_limits<float>::epsilon())
+				continue;
+
+			Bin bins[s_binCount];
+			for (Bin& bin : bins)
+			{
+				bin.bounds.Reset();
+				bin.count = 0;
+			}
+
+			float scale = s_binCount/extent;
+			for (unsigned int i = begin; i < end; ++i)
+			{
+				Bin& bin = bins[BinIndex(references[i].centroid[axis], centroidBounds.min[axis], scale)];
+				bin.bounds.Extend(references[i].bounds);
+				bin.count++;
+			}
+
+			// Balayage de droite à gauche pour connaître le coût de la partie droite de chaque plan
+			float rightCosts[s_binCount];
+			Bounds rightBounds;
+			rightBounds.Reset();
+			unsigned int rightCount = 0;
+			for (unsigned int i = s_binCount-1; i > 0; --i)
+			{
+				rightBounds.Extend(bins[i].bounds);
+				rightCount += bins[i].count;
+				rightCosts[i] = (rightCount > 0) ? rightBounds.GetSurfaceArea()*rightCount : 0.f;
+			}
+
+			Bounds leftBounds;
+			leftBounds.Reset();
+			unsigned int leftCount = 0;
+			for (unsigned int i = 0; i < s_binCount-1; ++i)
+			{
+				leftBounds.Extend(bins[i].bounds);
+				leftCount += bins[i].count;
+				if (leftCount == 0 || leftCount == count)
+					continue;
+
+				float cost = leftBounds.GetSurfaceArea()*leftCount + rightCosts[i+1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = i;
+				}
+			}
+		}
+
+		unsigned int middle;
+		if (bestCost < std::numeric_limits<float>::infinity())
+		{
+			float area = bounds.GetSurfaceArea();
+			float splitCost = s_traversalCost + ((area > 0.f) ? bestCost/area : 0.f);
+			if (splitCost >= count && count <= s_maxLeafSize)
+			{
+				// Une feuille coûte moins cher qu'une subdivision
+				nodes[nodeIndex].offset = begin;
+				nodes[nodeIndex].triangleCount = count;
+				return depth;
+			}
+
+			float minimum = centroidBounds.min[bestAxis];
+			float scale = s_binCount/(centroidBounds.max[bestAxis] - minimum);
+			Reference* pivot = std::partition(&references[begin], &references[begin] + count, [=](const Reference& reference)
+			{
+				return BinIndex(reference.centroid[bestAxis], minimum, scale) <= bestBin;
+			});
+
+			middle = pivot - references;
+		}
+		else if (count <= s_maxLeafSize)
+		{
+			// Tous les centres sont confondus, inutile de découper
+			nodes[nodeIndex].offset = begin;
+			nodes[nodeIndex].triangleCount = count;
+			return depth;
+		}
+		else
+			middle = begin + count/2;
+
+		if (middle == begin || middle == end)
+			middle = begin + count/2;
+
+		unsigned int leftIndex = nodes.size();
+		nodes.resize(leftIndex + 2);
+		nodes[nodeIndex].offset = leftIndex;
+		nodes[nodeIndex].triangleCount = 0;
+
+		unsigned int leftDepth = BuildRecursive(nodes, leftIndex, references, begin, middle, depth+1, jobs);
+		unsigned int rightDepth = BuildRecursive(nodes, leftIndex+1, references, middle, end, depth+1, jobs);
+
+		return std::max(leftDepth, rightDepth);
+	}
+
+	#if NAZARA_UTILITY_MULTITHREADED_BVH
+	void BuildSubtree(SubtreeJob* job)
+	{
+		job->nodes.resize(1);
+		job->maxDepth = BuildRecursive(job->nodes, 0, job->references, job->begin, job->end, job->depth, nullptr);
+	}
+	#endif
+
+	bool IntersectNode(const NzTriangleBVH::Node& node, const NzVector3f& origin, const NzVector3f& invDirection, float maxDistance, float* distance)
+	{
+		float tMin = 0.f;
+		float tMax = maxDistance;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			float t1 = (node.min[i] - origin[i])*invDirection[i];
+			float t2 = (node.max[i] - origin[i])*invDirection[i];
+
+			tMin = std::max(tMin, std::min(t1, t2));
+			tMax = std::min(tMax, std::max(t1, t2));
+		}
+
+		*distance = tMin;
+		return tMin <= tMax;
+	}
+
+	bool IntersectTriangle(const NzTriangleBVH::Triangle& triangle, const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzTriangleBVHHit* hit)
+	{
+		// Möller-Trumbore, les triangles sont considérés comme ayant deux faces
+		NzVector3f p = direction.CrossProduct(triangle.edge2);
+		float det = triangle.edge1.DotProduct(p);
+		if (std::fabs(det) < 1e-12f)
+			return false;
+
+		float invDet = 1.f/det;
+		NzVector3f s = origin - triangle.vertex;
+		float u = s.DotProduct(p)*invDet;
+		if (u < 0.f || u > 1.f)
+			return false;
+
+		NzVector3f q = s.CrossProduct(triangle.edge1);
+		float v = direction.DotProduct(q)*invDet;
+		if (v < 0.f || u + v > 1.f)
+			return false;
+
+		float t = triangle.edge2.DotProduct(q)*invDet;
+		if (t < 0.f || t >= maxDistance)
+			return false;
+
+		hit->distance = t;
+		hit->u = u;
+		hit->v = v;
+		hit->triangleIndex = triangle.index;
+
+		return true;
+	}
+
+	NzVector3f ClosestPointOnTriangle(const NzVector3f& point, const NzVector3f& a, const NzVector3f& b, const NzVector3f& c)
+	{
+		// Real-Time Collision Detection (Christer Ericson), 5.1.5
+		NzVector3f ab = b - a;
+		NzVector3f ac = c - a;
+		NzVector3f ap = point - a;
+
+		float d1 = ab.DotProduct(ap);
+		float d2 = ac.DotProduct(ap);
+		if (d1 <= 0.f && d2 <= 0.f)
+			return a;
+
+		NzVector3f bp = point - b;
+		float d3 = ab.DotProduct(bp);
+		float d4 = ac.DotProduct(bp);
+		if (d3 >= 0.f && d4 <= d3)
+			return b;
+
+		float vc = d1*d4 - d3*d2;
+		if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+			return a + ab*(d1/(d1 - d3));
+
+		NzVector3f cp = point - c;
+		float d5 = ab.DotProduct(cp);
+		float d6 = ac.DotProduct(cp);
+		if (d6 >= 0.f && d5 <= d6)
+			return c;
+
+		float vb = d5*d2 - d1*d6;
+		if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+			return a + ac*(d2/(d2 - d6));
+
+		float va = d3*d6 - d5*d4;
+		if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+			return b + (c - b)*((d4 - d3)/((d4 - d3) + (d5 - d6)));
+
+		float denom = 1.f/(va + vb + vc);
+		return a + ab*(vb*denom) + ac*(vc*denom);
+	}
+
+	float SquaredDistanceToNode(const NzTriangleBVH::Node& node, const NzVector3f& point)
+	{
+		float squaredDistance = 0.f;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			float d = std::max(std::max(node.min[i] - point[i], point[i] - node.max[i]), 0.f);
+			squaredDistance += d*d;
+		}
+
+		return squaredDistance;
+	}
+}
+
+bool NzTriangleBVH::Build(NzSubMesh* subMesh)
+{
+	#if NAZARA_UTILITY_SAFE
+	if (!subMesh)
+	{
+		NazaraError("Invalid submesh");
+		return false;
+	}
+	#endif
+
+	Destroy();
+
+	unsigned int triangleCount = subMesh->GetTriangleCount();
+	if (triangleCount == 0)
+		return true;
+
+	m_triangles.reserve(triangleCount);
+
+	NzTriangleIterator iterator(subMesh, nzBufferAccess_ReadOnly);
+	do
+	{
+		Triangle triangle;
+		triangle.vertex = iterator.GetPosition(0);
+		triangle.edge1 = iterator.GetPosition(1) - triangle.vertex;
+		triangle.edge2 = iterator.GetPosition(2) - triangle.vertex;
+		triangle.index = m_triangles.size();
+
+		m_triangles.push_back(triangle);
+	}
+	while (iterator.Advance());
+
+	BuildHierarchy();
+	return true;
+}
+
+bool NzTriangleBVH::Build(const NzVector3f* positions, unsigned int vertexCount, const nzUInt32* indices, unsigned int triangleCount)
+{
+	#if NAZARA_UTILITY_SAFE
+	if (!positions && triangleCount > 0)
+	{
+		NazaraError("Invalid positions");
+		return false;
+	}
+
+	if (!indices && triangleCount*3 > vertexCount)
+	{
+		NazaraError("Triangle count out of range (" + NzString::Number(triangleCount*3) + " vertices needed, " + NzString::Number(vertexCount) + " provided)");
+		return false;
+	}
+	#endif
+
+	Destroy();
+
+	m_triangles.resize(triangleCount);
+	for (unsigned int i = 0; i < triangleCount; ++i)
+	{
+		nzUInt32 i0 = (indices) ? indices[i*3 + 0] : i*3 + 0;
+		nzUInt32 i1 = (indices) ? indices[i*3 + 1] : i*3 + 1;
+		nzUInt32 i2 = (indices) ? indices[i*3 + 2] : i*3 + 2;
+
+		#if NAZARA_UTILITY_SAFE
+		if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+		{
+			NazaraError("Triangle #" + NzString::Number(i) + " references a vertex out of range");
+			m_triangles.clear();
+
+			return false;
+		}
+		#endif
+
+		Triangle& triangle = m_triangles[i];
+		triangle.vertex = positions[i0];
+		triangle.edge1 = positions[i1] - triangle.vertex;
+		triangle.edge2 = positions[i2] - triangle.vertex;
+		triangle.index = i;
+	}
+
+	BuildHierarchy();
+	return true;
+}
+
+void NzTriangleBVH::Destroy()
+{
+	m_depth = 0;
+	m_nodes.clear();
+	m_triangles.clear();
+}
+
+bool NzTriangleBVH::GetClosestPoint(const NzVector3f& point, float maxDistance, NzVector3f* closestPoint, unsigned int* triangleIndex) const
+{
+	#if NAZARA_UTILITY_SAFE
+	if (!closestPoint)
+	{
+		NazaraError("Invalid closest point pointer");
+		return false;
+	}
+	#endif
+
+	if (m_nodes.empty())
+		return false;
+
+	float bestSquaredDistance = maxDistance*maxDistance;
+	bool found = false;
+
+	StackEntry stack[s_maxDepth*2];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = {0, SquaredDistanceToNode(m_nodes[0], point)};
+
+	while (stackSize > 0)
+	{
+		StackEntry entry = stack[--stackSize];
+		if (entry.distance > bestSquaredDistance)
+			continue;
+
+		const Node& node = m_nodes[entry.node];
+		if (node.triangleCount > 0)
+		{
+			for (unsigned int i = 0; i < node.triangleCount; ++i)
+			{
+				const Triangle& triangle = m_triangles[node.offset + i];
+				NzVector3f candidate = ClosestPointOnTriangle(point, triangle.vertex, triangle.vertex + triangle.edge1, triangle.vertex + triangle.edge2);
+
+				float squaredDistance = candidate.SquaredDistance(point);
+				if (squaredDistance <= bestSquaredDistance)
+				{
+					bestSquaredDistance = squaredDistance;
+					found = true;
+
+					*closestPoint = candidate;
+					if (triangleIndex)
+						*triangleIndex = triangle.index;
+				}
+			}
+		}
+		else
+		{
+			float leftDistance = SquaredDistanceToNode(m_nodes[node.offset], point);
+			float rightDistance = SquaredDistanceToNode(m_nodes[node.offset+1], point);
+
+			// Le fils le plus proche est empilé en dernier pour être visité en premier
+			if (leftDistance <= rightDistance)
+			{
+				stack[stackSize++] = {node.offset+1, rightDistance};
+				stack[stackSize++] = {node.offset, leftDistance};
+			}
+			else
+			{
+				stack[stackSize++] = {node.offset, leftDistance};
+				stack[stackSize++] = {node.offset+1, rightDistance};
+			}
+		}
+	}
+
+	return found;
+}
+
+NzBoxf NzTriangleBVH::GetAABB() const
+{
+	if (m_nodes.empty())
+		return NzBoxf::Zero();
+
+	const Node& root = m_nodes[0];
+	return NzBoxf(NzVector3f(root.min), NzVector3f(root.max));
+}
+
+unsigned int NzTriangleBVH::GetDepth() const
+{
+	return m_depth;
+}
+
+unsigned int NzTriangleBVH::GetNodeCount() const
+{
+	return m_nodes.size();
+}
+
+unsigned int NzTriangleBVH::GetTriangleCount() const
+{
+	return m_triangles.size();
+}
+
+bool NzTriangleBVH::IsValid() const
+{
+	return !m_nodes.empty();
+}
+
+bool NzTriangleBVH::Raycast(const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzTriangleBVHHit* hit) const
+{
+	#if NAZARA_UTILITY_SAFE
+	if (!hit)
+	{
+		NazaraError("Invalid hit pointer");
+		return false;
+	}
+	#endif
+
+	hit->distance = maxDistance;
+	hit->u = 0.f;
+	hit->v = 0.f;
+	hit->triangleIndex = InvalidTriangle;
+
+	return Traverse<false>(origin, direction, maxDistance, hit);
+}
+
+bool NzTriangleBVH::RaycastAny(const NzVector3f& origin, const NzVector3f& direction, float maxDistance) const
+{
+	NzTriangleBVHHit hit;
+	return Traverse<true>(origin, direction, maxDistance, &hit);
+}
+
+unsigned int NzTriangleBVH::RaycastPacket(const NzVector3f* origins, const NzVector3f* directions, unsigned int rayCount, float maxDistance, NzTriangleBVHHit* hits) const
+{
+	#if NAZARA_UTILITY_SAFE
+	if (rayCount > 0 && (!origins || !directions || !hits))
+	{
+		NazaraError("Invalid ray or hit arrays");
+		return 0;
+	}
+	#endif
+
+	for (unsigned int i = 0; i < rayCount; ++i)
+	{
+		hits[i].distance = maxDistance;
+		hits[i].u = 0.f;
+		hits[i].v = 0.f;
+		hits[i].triangleIndex = InvalidTriangle;
+	}
+
+	if (m_nodes.empty())
+		return 0;
+
+	// Les rayons sont traités par paquets de quatre, stockés en SoA pour que le compilateur puisse vectoriser
+	// les boucles internes. Un noeud est visité dès qu'au moins un rayon du paquet le touche.
+	unsigned int hitCount = 0;
+	for (unsigned int first = 0; first < rayCount; first += s_packetSize)
+	{
+		unsigned int laneCount = std::min(s_packetSize, rayCount - first);
+
+		float ox[s_packetSize], oy[s_packetSize], oz[s_packetSize];
+		float dx[s_packetSize], dy[s_packetSize], dz[s_packetSize];
+		float ix[s_packetSize], iy[s_packetSize], iz[s_packetSize];
+		float closest[s_packetSize];
+		float hitU[s_packetSize], hitV[s_packetSize];
+		unsigned int hitTriangle[s_packetSize];
+
+		for (unsigned int l = 0; l < s_packetSize; ++l)
+		{
+			// Les voies inutilisées reçoivent une distance négative, elles ne toucheront jamais rien
+			unsigned int ray = first + std::min(l, laneCount-1);
+			ox[l] = origins[ray].x;
+			oy[l] = origins[ray].y;
+			oz[l] = origins[ray].z;
+			dx[l] = directions[ray].x;
+			dy[l] = directions[ray].y;
+			dz[l] = directions[ray].z;
+			ix[l] = 1.f/dx[l];
+			iy[l] = 1.f/dy[l];
+			iz[l] = 1.f/dz[l];
+			closest[l] = (l < laneCount) ? maxDistance : -1.f;
+			hitU[l] = 0.f;
+			hitV[l] = 0.f;
+			hitTriangle[l] = InvalidTriangle;
+		}
+
+		unsigned int stack[s_maxDepth*2];
+		unsigned int stackSize = 0;
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+
+			bool active = false;
+			for (unsigned int l = 0; l < s_packetSize; ++l)
+			{
+				float tx1 = (node.min[0] - ox[l])*ix[l];
+				float tx2 = (node.max[0] - ox[l])*ix[l];
+				float ty1 = (node.min[1] - oy[l])*iy[l];
+				float ty2 = (node.max[1] - oy[l])*iy[l];
+				float tz1 = (node.min[2] - oz[l])*iz[l];
+				float tz2 = (node.max[2] - oz[l])*iz[l];
+
+				float tMin = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), 0.f));
+				float tMax = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), closest[l]));
+
+				active |= (tMin <= tMax);
+			}
+
+			if (!active)
+				continue;
+
+			if (node.triangleCount == 0)
+			{
+				stack[stackSize++] = node.offset+1;
+				stack[stackSize++] = node.offset;
+				continue;
+			}
+
+			for (unsigned int i = 0; i < node.triangleCount; ++i)
+			{
+				const Triangle& triangle = m_triangles[node.offset + i];
+
+				for (unsigned int l = 0; l < s_packetSize; ++l)
+				{
+					float px = dy[l]*triangle.edge2.z - dz[l]*triangle.edge2.y;
+					float py = dz[l]*triangle.edge2.x - dx[l]*triangle.edge2.z;
+					float pz = dx[l]*triangle.edge2.y - dy[l]*triangle.edge2.x;
+
+					float det = triangle.edge1.x*px + triangle.edge1.y*py + triangle.edge1.z*pz;
+					float invDet = 1.f/det;
+
+					float sx = ox[l] - triangle.vertex.x;
+					float sy = oy[l] - triangle.vertex.y;
+					float sz = oz[l] - triangle.vertex.z;
+
+					float u = (sx*px + sy*py + sz*pz)*invDet;
+
+					float qx = sy*triangle.edge1.z - sz*triangle.edge1.y;
+					float qy = sz*triangle.edge1.x - sx*triangle.edge1.z;
+					float qz = sx*triangle.edge1.y - sy*triangle.edge1.x;
+
+					float v = (dx[l]*qx + dy[l]*qy + dz[l]*qz)*invDet;
+					float t = (triangle.edge2.x*qx + triangle.edge2.y*qy + triangle.edge2.z*qz)*invDet;
+
+					bool hit = std::fabs(det) >= 1e-12f && u >= 0.f && v >= 0.f && u + v <= 1.f && t >= 0.f && t < closest[l];
+
+					closest[l] = (hit) ? t : closest[l];
+					hitU[l] = (hit) ? u : hitU[l];
+					hitV[l] = (hit) ? v : hitV[l];
+					hitTriangle[l] = (hit) ? triangle.index : hitTriangle[l];
+				}
+			}
+		}
+
+		for (unsigned int l = 0; l < laneCount; ++l)
+		{
+			if (hitTriangle[l] != InvalidTriangle)
+			{
+				NzTriangleBVHHit& hit = hits[first + l];
+				hit.distance = closest[l];
+				hit.u = hitU[l];
+				hit.v = hitV[l];
+				hit.triangleIndex = hitTriangle[l];
+
+				hitCount++;
+			}
+		}
+	}
+
+	return hitCount;
+}
+
+void NzTriangleBVH::BuildHierarchy()
+{
+	// m_triangles contient à ce stade les triangles dans leur ordre d'origine
+	unsigned int triangleCount = m_triangles.size();
+	if (triangleCount == 0)
+		return;
+
+	std::vector<Reference> references(triangleCount);
+	for (unsigned int i = 0; i < triangleCount; ++i)
+	{
+		const Triangle& triangle = m_triangles[i];
+		NzVector3f v1 = triangle.vertex + triangle.edge1;
+		NzVector3f v2 = triangle.vertex + triangle.edge2;
+
+		Reference& reference = references[i];
+		reference.bounds.min = triangle.vertex;
+		reference.bounds.max = triangle.vertex;
+		reference.bounds.Extend(v1);
+		reference.bounds.Extend(v2);
+		reference.centroid = (reference.bounds.min + reference.bounds.max)*0.5f;
+		reference.triangle = i;
+	}
+
+	m_nodes.reserve(triangleCount*2/s_minLeafSize);
+	m_nodes.resize(1);
+
+	#if NAZARA_UTILITY_MULTITHREADED_BVH
+	std::vector<SubtreeJob> jobs;
+	m_depth = BuildRecursive(m_nodes, 0, &references[0], 0, triangleCount, 0, &jobs);
+
+	if (!jobs.empty())
+	{
+		for (SubtreeJob& job : jobs)
+			NzTaskScheduler::AddTask(BuildSubtree, &job);
+
+		NzTaskScheduler::WaitForTasks();
+
+		// On rapatrie chaque sous-arbre à la suite des noeuds existants en corrigeant les index des fils
+		for (SubtreeJob& job : jobs)
+		{
+			unsigned int base = m_nodes.size() - 1;
+
+			Node root = job.nodes[0];
+			if (root.triangleCount == 0)
+				root.offset += base;
+
+			m_nodes[job.nodeIndex] = root;
+
+			for (unsigned int i = 1; i < job.nodes.size(); ++i)
+			{
+				Node node = job.nodes[i];
+				if (node.triangleCount == 0)
+					node.offset += base;
+
+				m_nodes.push_back(node);
+			}
+
+			m_depth = std::max(m_depth, job.maxDepth);
+		}
+	}
+	#else
+	m_depth = BuildRecursive(m_nodes, 0, &references[0], 0, triangleCount, 0, nullptr);
+	#endif
+
+	// Les triangles sont réordonnés pour que chaque feuille référence une plage contiguë
+	std::vector<Triangle> triangles(triangleCount);
+	for (unsigned int i = 0; i < triangleCount; ++i)
+		triangles[i] = m_triangles[references[i].triangle];
+
+	m_triangles = std::move(triangles);
+}
+
+template<bool AnyHit>
+bool NzTriangleBVH::Traverse(const NzVector3f& origin, const NzVector3f& direction, float maxDistance, NzTriangleBVHHit* hit) const
+{
+	if (m_nodes.empty())
+		return false;
+
+	NzVector3f invDirection(1.f/direction.x, 1.f/direction.y, 1.f/direction.z);
+
+	float distance;
+	if (!IntersectNode(m_nodes[0], origin, invDirection, maxDistance, &distance))
+		return false;
+
+	StackEntry stack[s_maxDepth*2];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = {0, distance};
+
+	float closest = maxDistance;
+	bool found = false;
+
+	while (stackSize > 0)
+	{
+		StackEntry entry = stack[--stackSize];
+		if (entry.distance > closest)
+			continue; // Un triangle plus proche a été trouvé depuis que ce noeud a été empilé
+
+		const Node& node = m_nodes[entry.node];
+		if (node.triangleCount > 0)
+		{
+			for (unsigned int i = 0; i < node.triangleCount; ++i)
+			{
+				if (IntersectTriangle(m_triangles[node.offset + i], origin, direction, closest, hit))
+				{
+					if (AnyHit)
+						return true;
+
+					closest = hit->distance;
+					found = true;
+				}
+			}
+		}
+		else
+		{
+			float leftDistance;
+			float rightDistance;
+			bool left = IntersectNode(m_nodes[node.offset], origin, invDirection, closest, &leftDistance);
+			bool right = IntersectNode(m_nodes[node.offset+1], origin, invDirection, closest, &rightDistance);
+
+			if (left && right)
+			{
+				// Le fils le plus proche est empilé en dernier pour être visité en premier
+				if (leftDistance <= rightDistance)
+				{
+					stack[stackSize++] = {node.offset+1, rightDistance};
+					stack[stackSize++] = {node.offset, leftDistance};
+				}
+				else
+				{
+					stack[stackSize++] = {node.offset, leftDistance};
+					stack[stackSize++] = {node.offset+1, rightDistance};
+				}
+			}
+			else if (left)
+				stack[stackSize++] = {node.offset, leftDistance};
+			else if (right)
+				stack[stackSize++] = {node.offset+1, rightDistance};
+		}
+	}
+
+	return found;
+}
@@ -16,6 +16,7 @@
 #include <Nazara/Utility/Loaders/PCX.hpp>
 #include <Nazara/Utility/Loaders/STB.hpp>
 #include <Nazara/Utility/PixelFormat.hpp>
+#include <Nazara/Utility/PrimitiveMeshCache.hpp>
 #include <Nazara/Utility/VertexDeclaration.hpp>
 #include <Nazara/Utility/Window.hpp>
 #include <Nazara/Utility/Debug.hpp>
@@ -69,6 +70,14 @@ bool NzUtility::Initialize()
 		return false;
 	}
 
+	if (!NzPrimitiveMeshCache::Initialize())
+	{
+		NazaraError("Failed to initialize primitive mesh cache");
+		Uninitialize();
+
+		return false;
+	}
+
 	if (!NzWindow::Initialize())
 	{
 		NazaraError("Failed to initialize window's system");
@@ -126,6 +135,7 @@ void NzUtility::Uninitialize()
 	NzLoaders_STB_Unregister();
 
 	NzWindow::Uninitialize();
+	NzPrimitiveMeshCache::Uninitialize();
 	NzVertexDeclaration::Uninitialize();
 	NzPixelFormat::Uninitialize();
 	NzBuffer::Uninitialize();